@@ -0,0 +1,80 @@
+#!/usr/bin/env python
+
+#
+# Measures throughput of Channel.asyncGet()/asyncPut() against a local
+# PvaServer for different async request pipeline depths, and verifies
+# that completion callbacks are invoked in request order.
+#
+# Usage: asyncPipelineBenchmark.py [nRequests]
+#
+
+import sys
+import time
+import threading
+from pvaccess import INT, PvObject, PvaServer, Channel, QueueFull
+
+N_REQUESTS = 10000
+if len(sys.argv) > 1:
+    N_REQUESTS = int(sys.argv[1])
+
+CHANNEL_NAME = 'benchmark:pipeline'
+PIPELINE_DEPTHS = [1, 2, 4, 8, 16, 32]
+
+class Completions:
+    def __init__(self):
+        self.nCompleted = 0
+        self.nErrors = 0
+        self.lastIndex = -1
+        self.inOrder = True
+        self.done = threading.Event()
+
+    def onComplete(self, index):
+        if index != self.lastIndex+1:
+            self.inOrder = False
+        self.lastIndex = index
+        self.nCompleted += 1
+        if self.nCompleted + self.nErrors == N_REQUESTS:
+            self.done.set()
+
+    def onError(self, msg):
+        self.nErrors += 1
+        if self.nCompleted + self.nErrors == N_REQUESTS:
+            self.done.set()
+
+def submit(f):
+    # Request queue is bounded, so wait for completions if it is full
+    while True:
+        try:
+            f()
+            return
+        except QueueFull:
+            time.sleep(0.0001)
+
+def measure(label, c, depth, issue):
+    c.setAsyncRequestPipelineDepth(depth)
+    completions = Completions()
+    t0 = time.time()
+    for i in range(0,N_REQUESTS):
+        submit(lambda: issue(completions, i))
+    completions.done.wait()
+    dt = time.time() - t0
+    print('%-8s depth %3d: %10.0f requests/s, errors: %d, in order: %s' % (label, depth, N_REQUESTS/dt, completions.nErrors, completions.inOrder))
+
+def issueGet(c, completions, i):
+    c.asyncGet(lambda pv: completions.onComplete(i), completions.onError)
+
+def issuePut(c, completions, i):
+    c.asyncPut(PvObject({'value' : INT}, {'value' : i}), lambda pv: completions.onComplete(i), completions.onError)
+
+server = PvaServer(CHANNEL_NAME, PvObject({'value' : INT}))
+c = Channel(CHANNEL_NAME)
+# Connect and warm up
+c.get()
+
+print('Requests: %s' % N_REQUESTS)
+for depth in PIPELINE_DEPTHS:
+    measure('asyncGet', c, depth, lambda completions, i: issueGet(c, completions, i))
+for depth in PIPELINE_DEPTHS:
+    measure('asyncPut', c, depth, lambda completions, i: issuePut(c, completions, i))
+
+server.stop()
@@ -0,0 +1,45 @@
+#!/usr/bin/env python
+
+#
+# Measures per-call latency of Channel.get()/put()/putGet() against a local
+# PvaServer, with and without channel operation caching.
+#
+# Usage: channelOperationCacheBenchmark.py [nCalls]
+#
+
+import sys
+import time
+from pvaccess import INT, PvObject, PvaServer, Channel
+
+N_CALLS = 1000
+if len(sys.argv) > 1:
+    N_CALLS = int(sys.argv[1])
+
+CHANNEL_NAME = 'benchmark:cache'
+
+def measure(label, f):
+    t0 = time.time()
+    for i in range(0,N_CALLS):
+        f(i)
+    dt = time.time() - t0
+    print('%-10s %8d calls, %10.3f us/call' % (label, N_CALLS, dt/N_CALLS*1.0e6))
+
+def runBenchmark(c, cacheSize):
+    c.setOperationCacheSize(cacheSize)
+    c.resetOperationCacheCounters()
+    print('\nOperation cache size: %s' % cacheSize)
+    measure('get', lambda i: c.get())
+    measure('put', lambda i: c.put(PvObject({'value' : INT}, {'value' : i})))
+    measure('putGet', lambda i: c.putGet(PvObject({'value' : INT}, {'value' : i})))
+    print('Cache counters: %s' % c.getOperationCacheCounters())
+
+server = PvaServer(CHANNEL_NAME, PvObject({'value' : INT}))
+c = Channel(CHANNEL_NAME)
+defaultCacheSize = c.getOperationCacheSize()
+# Connect and warm up
+c.get()
+
+runBenchmark(c, 0)
+runBenchmark(c, defaultCacheSize)
+
+server.stop()
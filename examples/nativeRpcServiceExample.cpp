@@ -0,0 +1,82 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+// Example of native RPC service plugin, which computes statistics of
+// the 'value' double array field of the request. It can be built as
+// a shared library against EPICS base and pvaPy include directories,
+// e.g.:
+//
+//   g++ -shared -fPIC -o libnativeRpcServiceExample.so nativeRpcServiceExample.cpp \
+//       -I$PVAPY_DIR/include -I$EPICS_BASE/include -I$EPICS_BASE/include/os/Linux \
+//       -I$EPICS_BASE/include/compiler/gcc -L$EPICS_BASE/lib/linux-x86_64 -lpvAccess -lpvData -lCom
+//
+// and used with nativeRpcServiceExample.py.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <pv/pvData.h>
+#include <pv/pvAccess.h>
+#include <pv/rpcService.h>
+#include "RpcServicePlugin.h"
+
+namespace pvd = epics::pvData;
+namespace epvaccess = epics::pvAccess;
+
+class ArrayStatisticsService : public epvaccess::RPCService
+{
+public:
+    ArrayStatisticsService()
+        : resultStructurePtr(pvd::getFieldCreate()->createFieldBuilder()
+            ->add("count", pvd::pvULong)
+            ->add("min", pvd::pvDouble)
+            ->add("max", pvd::pvDouble)
+            ->add("mean", pvd::pvDouble)
+            ->add("std", pvd::pvDouble)
+            ->createStructure())
+    {
+    }
+
+    virtual pvd::PVStructurePtr request(const pvd::PVStructurePtr& args)
+    {
+        pvd::PVDoubleArrayPtr pvValuePtr = args->getSubField<pvd::PVDoubleArray>("value");
+        if (!pvValuePtr) {
+            throw epvaccess::RPCRequestException(pvd::Status::STATUSTYPE_ERROR, "Request must contain 'value' double array field.");
+        }
+        pvd::PVDoubleArray::const_svector data = pvValuePtr->view();
+        double minValue = std::numeric_limits<double>::quiet_NaN();
+        double maxValue = minValue;
+        double mean = minValue;
+        double stdDev = minValue;
+        if (!data.empty()) {
+            minValue = data[0];
+            maxValue = data[0];
+            double sum = 0;
+            double sum2 = 0;
+            for (size_t i = 0; i < data.size(); i++) {
+                double x = data[i];
+                minValue = x < minValue ? x : minValue;
+                maxValue = x > maxValue ? x : maxValue;
+                sum += x;
+                sum2 += x*x;
+            }
+            mean = sum/data.size();
+            stdDev = std::sqrt(std::max(sum2/data.size() - mean*mean, 0.0));
+        }
+        pvd::PVStructurePtr resultPtr = pvd::getPVDataCreate()->createPVStructure(resultStructurePtr);
+        resultPtr->getSubField<pvd::PVULong>("count")->put(data.size());
+        resultPtr->getSubField<pvd::PVDouble>("min")->put(minValue);
+        resultPtr->getSubField<pvd::PVDouble>("max")->put(maxValue);
+        resultPtr->getSubField<pvd::PVDouble>("mean")->put(mean);
+        resultPtr->getSubField<pvd::PVDouble>("std")->put(stdDev);
+        return resultPtr;
+    }
+
+private:
+    pvd::StructureConstPtr resultStructurePtr;
+};
+
+extern "C" epvaccess::RPCService* createPvaPyRpcService(const char* serviceName, const char* configuration)
+{
+    return new ArrayStatisticsService();
+}
@@ -0,0 +1,46 @@
+#!/usr/bin/env python
+
+#
+# Hosts native (C++) array statistics service built from
+# nativeRpcServiceExample.cpp together with equivalent python service,
+# and compares their response times.
+#
+# Usage: nativeRpcServiceExample.py [pluginLibrary] [arraySize]
+#
+
+import sys
+import time
+import numpy as np
+from pvaccess import DOUBLE, ULONG, PvObject, RpcServer, RpcClient
+
+PLUGIN_LIBRARY = './libnativeRpcServiceExample.so'
+ARRAY_SIZE = 1000000
+N_REQUESTS = 100
+if len(sys.argv) > 1:
+    PLUGIN_LIBRARY = sys.argv[1]
+if len(sys.argv) > 2:
+    ARRAY_SIZE = int(sys.argv[2])
+
+def pyArrayStatistics(pvRequest):
+    data = pvRequest['value']
+    return PvObject({'count' : ULONG, 'min' : DOUBLE, 'max' : DOUBLE, 'mean' : DOUBLE, 'std' : DOUBLE},
+        {'count' : len(data), 'min' : float(np.min(data)), 'max' : float(np.max(data)), 'mean' : float(np.mean(data)), 'std' : float(np.std(data))})
+
+server = RpcServer()
+server.registerNativeService('native:arrayStatistics', PLUGIN_LIBRARY)
+server.registerService('python:arrayStatistics', pyArrayStatistics)
+server.startListener()
+time.sleep(1)
+
+request = PvObject({'value' : [DOUBLE]})
+request.setScalarArray('value', np.random.uniform(0, 1, ARRAY_SIZE))
+for serviceName in ['native:arrayStatistics', 'python:arrayStatistics']:
+    client = RpcClient(serviceName)
+    response = client.invoke(request)
+    t0 = time.time()
+    for i in range(0,N_REQUESTS):
+        response = client.invoke(request)
+    dt = time.time() - t0
+    print('%-24s %8.2f ms/request, result: %s' % (serviceName, dt/N_REQUESTS*1000, response.get()))
+
+server.stopListener()
@@ -0,0 +1,56 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+// Minimal native RPC service plugin that replies with the plugin id
+// given at build time. Building it twice with different ids, e.g.:
+//
+//   for id in A B; do
+//     g++ -shared -fPIC -DPLUGIN_ID=\"$id\" -o libnativeRpcServicePlugin$id.so nativeRpcServicePlugin.cpp \
+//         -I$PVAPY_DIR/include -I$EPICS_BASE/include -I$EPICS_BASE/include/os/Linux \
+//         -I$EPICS_BASE/include/compiler/gcc -L$EPICS_BASE/lib/linux-x86_64 -lpvAccess -lpvData -lCom
+//   done
+//
+// produces two libraries that export the same default factory function,
+// which are used by nativeRpcServicePluginsExample.py.
+
+#include <pv/pvData.h>
+#include <pv/pvAccess.h>
+#include <pv/rpcService.h>
+#include "RpcServicePlugin.h"
+
+#ifndef PLUGIN_ID
+#define PLUGIN_ID "A"
+#endif
+
+namespace pvd = epics::pvData;
+namespace epvaccess = epics::pvAccess;
+
+class PluginIdService : public epvaccess::RPCService
+{
+public:
+    PluginIdService(const std::string& serviceName_)
+        : serviceName(serviceName_)
+        , resultStructurePtr(pvd::getFieldCreate()->createFieldBuilder()
+            ->add("service", pvd::pvString)
+            ->add("plugin", pvd::pvString)
+            ->createStructure())
+    {
+    }
+
+    virtual pvd::PVStructurePtr request(const pvd::PVStructurePtr& args)
+    {
+        pvd::PVStructurePtr resultPtr = pvd::getPVDataCreate()->createPVStructure(resultStructurePtr);
+        resultPtr->getSubField<pvd::PVString>("service")->put(serviceName);
+        resultPtr->getSubField<pvd::PVString>("plugin")->put(PLUGIN_ID);
+        return resultPtr;
+    }
+
+private:
+    std::string serviceName;
+    pvd::StructureConstPtr resultStructurePtr;
+};
+
+extern "C" epvaccess::RPCService* createPvaPyRpcService(const char* serviceName, const char* configuration)
+{
+    return new PluginIdService(serviceName);
+}
@@ -0,0 +1,38 @@
+#!/usr/bin/env python
+
+#
+# Registers native services from two plugin libraries built from
+# nativeRpcServicePlugin.cpp, which export the same default factory
+# function, and verifies that each service is created by its own library.
+#
+# Usage: nativeRpcServicePluginsExample.py [pluginLibraryA pluginLibraryB]
+#
+
+import sys
+import time
+from pvaccess import PvObject, RpcServer, RpcClient
+
+PLUGIN_LIBRARIES = ['./libnativeRpcServicePluginA.so', './libnativeRpcServicePluginB.so']
+if len(sys.argv) > 2:
+    PLUGIN_LIBRARIES = sys.argv[1:3]
+
+server = RpcServer()
+serviceNames = []
+for i in range(0,len(PLUGIN_LIBRARIES)):
+    serviceName = 'native:plugin%s' % i
+    server.registerNativeService(serviceName, PLUGIN_LIBRARIES[i])
+    serviceNames.append(serviceName)
+server.startListener()
+time.sleep(1)
+
+pluginIds = []
+for serviceName in serviceNames:
+    client = RpcClient(serviceName)
+    response = client.invoke(PvObject({}))
+    print('%-16s -> plugin %s' % (response['service'], response['plugin']))
+    pluginIds.append(response['plugin'])
+server.stopListener()
+
+if len(set(pluginIds)) != len(pluginIds):
+    print('Error: services were created by the same plugin library')
+    sys.exit(1)
@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+
+#
+# Measures native NtNdArray compression and decompression throughput
+# for supported codecs and different image sizes. Images are simulated
+# as noisy uint16 frames, which compress similarly to detector data.
+#
+# Usage: ntNdArrayCodecBenchmark.py [nFrames [level [nThreads]]]
+#
+
+import sys
+import time
+import numpy as np
+from pvaccess import NtNdArray, NtAttribute, PvDimension, PvCodec, PvInt
+
+N_FRAMES = 20
+LEVEL = 5
+N_THREADS = 1
+if len(sys.argv) > 1:
+    N_FRAMES = int(sys.argv[1])
+if len(sys.argv) > 2:
+    LEVEL = int(sys.argv[2])
+if len(sys.argv) > 3:
+    N_THREADS = int(sys.argv[3])
+
+IMAGE_SIZES = [(512,512), (1024,1024), (2048,2048), (4096,4096)]
+
+def createFrame(nx, ny):
+    frame = NtNdArray()
+    frame['uniqueId'] = 1
+    frame['dimension'] = [PvDimension(nx, 0, nx, 1, False), PvDimension(ny, 0, ny, 1, False)]
+    frame['attribute'] = [NtAttribute('ColorMode', PvInt(0))]
+    image = np.random.poisson(100, size=nx*ny).astype(np.uint16)
+    frame.setValue({'ushortValue' : image}, copy=False)
+    return frame
+
+def measure(codecName, frame):
+    size = frame['value'][0]['ushortValue'].nbytes
+    compressTime = 0
+    decompressTime = 0
+    for i in range(0,N_FRAMES):
+        frame2 = NtNdArray(frame.copy())
+        t0 = time.time()
+        frame2.compress(codecName, LEVEL, N_THREADS)
+        t1 = time.time()
+        compressedSize = frame2.getCompressedSize()
+        frame2.decompress()
+        t2 = time.time()
+        compressTime += t1-t0
+        decompressTime += t2-t1
+    compressRate = size*N_FRAMES/compressTime/1.0e6
+    decompressRate = size*N_FRAMES/decompressTime/1.0e6
+    print('%-6s ratio: %6.2f, compress: %8.1f MB/s, decompress: %8.1f MB/s' % (codecName, float(size)/compressedSize, compressRate, decompressRate))
+
+print('Frames: %s, level: %s, threads: %s' % (N_FRAMES, LEVEL, N_THREADS))
+for (nx,ny) in IMAGE_SIZES:
+    frame = createFrame(nx, ny)
+    print('\nImage size: %sx%s' % (nx, ny))
+    for codecName in PvCodec.getNativeCodecNames():
+        measure(codecName, frame)
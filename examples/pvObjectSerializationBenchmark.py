@@ -0,0 +1,58 @@
+#!/usr/bin/env python
+
+#
+# Compares PvObject binary serialization with the previous pickle
+# path (structure and value dictionaries) for NtNdArray frames of
+# different sizes.
+#
+# Usage: pvObjectSerializationBenchmark.py [nFrames]
+#
+
+import sys
+import time
+import pickle
+import numpy as np
+from pvaccess import NtNdArray, NtAttribute, PvDimension, PvInt, PvObject
+
+N_FRAMES = 100
+if len(sys.argv) > 1:
+    N_FRAMES = int(sys.argv[1])
+
+IMAGE_SIZES = [(128,128), (512,512), (1024,1024), (2048,2048)]
+
+def createFrame(nx, ny):
+    frame = NtNdArray()
+    frame['uniqueId'] = 1
+    frame['dimension'] = [PvDimension(nx, 0, nx, 1, False), PvDimension(ny, 0, ny, 1, False)]
+    frame['attribute'] = [NtAttribute('ColorMode', PvInt(0))]
+    frame['compressedSize'] = nx*ny*2
+    frame['uncompressedSize'] = nx*ny*2
+    frame['value'] = {'ushortValue' : np.random.randint(0, 65536, size=nx*ny, dtype=np.uint16)}
+    return frame
+
+# Previous pickle path: structure and value dictionaries
+def dictDumps(frame):
+    return pickle.dumps((frame.getStructureDict(), frame.get(), NtNdArray.StructureId))
+
+def dictLoads(buffer):
+    (structureDict, valueDict, structureId) = pickle.loads(buffer)
+    return PvObject(structureDict, valueDict, structureId)
+
+def measure(label, frame, dumps, loads):
+    t0 = time.time()
+    for i in range(0,N_FRAMES):
+        buffer = dumps(frame)
+    t1 = time.time()
+    for i in range(0,N_FRAMES):
+        frame2 = loads(buffer)
+    t2 = time.time()
+    dumpTime = (t1-t0)/N_FRAMES
+    loadTime = (t2-t1)/N_FRAMES
+    print('%-12s size: %10d bytes, dump: %10.3f ms, load: %10.3f ms, round trip: %10.3f ms' % (label, len(buffer), dumpTime*1.0e3, loadTime*1.0e3, (dumpTime+loadTime)*1.0e3))
+
+for (nx,ny) in IMAGE_SIZES:
+    frame = createFrame(nx, ny)
+    print('\nImage size: %sx%s, frames: %s' % (nx, ny, N_FRAMES))
+    measure('dict pickle', frame, dictDumps, dictLoads)
+    measure('pickle', frame, pickle.dumps, pickle.loads)
+    measure('serialize', frame, lambda f: f.serialize(), PvObject.deserialize)
@@ -0,0 +1,61 @@
+#!/usr/bin/env python
+
+#
+# Compares RpcClient.invoke() with pipelined invokeBatch()/invokeFuture()
+# for different numbers of outstanding requests, against a local
+# RpcServer whose service simulates a short round trip.
+#
+# Usage: rpcClientAsyncBenchmark.py [nRequests] [serviceTime]
+#
+
+import sys
+import time
+from pvaccess import INT, PvObject, PvInt, RpcServer, RpcClient
+
+N_REQUESTS = 2000
+SERVICE_TIME = 0.001
+if len(sys.argv) > 1:
+    N_REQUESTS = int(sys.argv[1])
+if len(sys.argv) > 2:
+    SERVICE_TIME = float(sys.argv[2])
+
+SERVICE_NAME = 'benchmark:rpcAsync'
+MAX_OUTSTANDING_REQUESTS = [1, 4, 16, 64]
+
+def echo(pvRequest):
+    time.sleep(SERVICE_TIME)
+    return PvInt(pvRequest['value'])
+
+server = RpcServer()
+server.setNumWorkers(16)
+server.registerService(SERVICE_NAME, echo)
+server.startListener()
+time.sleep(1)
+
+arguments = [PvObject({'value' : INT}, {'value' : i}) for i in range(0,N_REQUESTS)]
+client = RpcClient(SERVICE_NAME)
+client.setTimeout(10)
+client.invoke(arguments[0])
+
+print('Requests: %s, service time: %s s' % (N_REQUESTS, SERVICE_TIME))
+t0 = time.time()
+for pvArgument in arguments:
+    client.invoke(pvArgument)
+dt = time.time() - t0
+print('%-12s %28s: %10.0f requests/s' % ('invoke', '', N_REQUESTS/dt))
+
+for maxOutstandingRequests in MAX_OUTSTANDING_REQUESTS:
+    client.setMaxOutstandingRequests(maxOutstandingRequests)
+    t0 = time.time()
+    responses = client.invokeBatch(arguments)
+    dt = time.time() - t0
+    inOrder = [r['value'] for r in responses] == list(range(0,N_REQUESTS))
+    print('%-12s max outstanding requests %3d: %10.0f requests/s, in order: %s' % ('invokeBatch', maxOutstandingRequests, N_REQUESTS/dt, inOrder))
+
+    t0 = time.time()
+    futures = [client.invokeFuture(pvArgument) for pvArgument in arguments]
+    responses = [f.result() for f in futures]
+    dt = time.time() - t0
+    print('%-12s max outstanding requests %3d: %10.0f requests/s' % ('invokeFuture', maxOutstandingRequests, N_REQUESTS/dt))
+
+server.stopListener()
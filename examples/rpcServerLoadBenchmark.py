@@ -0,0 +1,88 @@
+#!/usr/bin/env python
+
+#
+# Measures RpcServer throughput and latency with many concurrent
+# RpcClient.invoke() callers, with services called from pvAccess server
+# threads (0 workers), and with services executed by worker threads.
+# The 'slow' service sleeps (releasing GIL) to simulate I/O bound work,
+# while 'fast' service latency shows whether slow requests block others.
+#
+# Usage: rpcServerLoadBenchmark.py [nClients] [nRequestsPerClient] [serviceTime]
+#
+
+import sys
+import time
+import threading
+from pvaccess import INT, PvObject, PvInt, RpcServer, RpcClient
+
+N_CLIENTS = 32
+N_REQUESTS_PER_CLIENT = 20
+SERVICE_TIME = 0.01
+if len(sys.argv) > 1:
+    N_CLIENTS = int(sys.argv[1])
+if len(sys.argv) > 2:
+    N_REQUESTS_PER_CLIENT = int(sys.argv[2])
+if len(sys.argv) > 3:
+    SERVICE_TIME = float(sys.argv[3])
+
+WORKER_COUNTS = [0, 4, 16, 64]
+
+def slowService(pvRequest):
+    time.sleep(SERVICE_TIME)
+    return PvInt(pvRequest['value'])
+
+def fastService(pvRequest):
+    return PvInt(pvRequest['value'])
+
+def runClient(serviceName, nRequests, latencies, errors):
+    client = RpcClient(serviceName)
+    for i in range(0,nRequests):
+        t0 = time.time()
+        try:
+            response = client.invoke(PvObject({'value' : INT}, {'value' : i}))
+            if response['value'] != i:
+                errors.append('Unexpected response %s' % response['value'])
+        except Exception as ex:
+            errors.append(str(ex))
+        latencies.append(time.time()-t0)
+
+def percentile(values, p):
+    values = sorted(values)
+    if not values:
+        return 0
+    return values[min(len(values)-1, int(p*len(values)))]
+
+def measure(nWorkers):
+    prefix = 'benchmark:rpc%d:' % nWorkers
+    server = RpcServer()
+    server.setNumWorkers(nWorkers)
+    server.registerService(prefix+'slow', slowService)
+    server.registerService(prefix+'fast', fastService)
+    server.startListener()
+    time.sleep(1)
+
+    slowLatencies = []
+    fastLatencies = []
+    errors = []
+    threads = []
+    for i in range(0,N_CLIENTS):
+        threads.append(threading.Thread(target=runClient, args=(prefix+'slow', N_REQUESTS_PER_CLIENT, slowLatencies, errors)))
+    threads.append(threading.Thread(target=runClient, args=(prefix+'fast', N_REQUESTS_PER_CLIENT, fastLatencies, errors)))
+    t0 = time.time()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    dt = time.time() - t0
+    nRequests = len(slowLatencies) + len(fastLatencies)
+    print('workers %3d: %8.1f requests/s, slow p50/p99: %7.1f/%7.1f ms, fast p50/p99: %7.1f/%7.1f ms, errors: %d' % (nWorkers, nRequests/dt,
+        percentile(slowLatencies, 0.5)*1000, percentile(slowLatencies, 0.99)*1000,
+        percentile(fastLatencies, 0.5)*1000, percentile(fastLatencies, 0.99)*1000, len(errors)))
+    if nWorkers > 0:
+        print('             service counters: %s' % server.getServiceCounters())
+    server.stopListener()
+    time.sleep(1)
+
+print('Clients: %s, requests per client: %s, slow service time: %s s' % (N_CLIENTS, N_REQUESTS_PER_CLIENT, SERVICE_TIME))
+for nWorkers in WORKER_COUNTS:
+    measure(nWorkers)
@@ -0,0 +1,71 @@
+#!/usr/bin/env python
+
+#
+# Compares passing NtNdArray frames to another process via
+# multiprocessing.Queue and via SharedMemoryPvObjectQueue.
+#
+# Usage: sharedMemoryPvObjectQueueBenchmark.py [nFrames]
+#
+
+import sys
+import time
+import multiprocessing as mp
+import numpy as np
+from pvaccess import NtNdArray, NtAttribute, PvDimension, PvInt, SharedMemoryPvObjectQueue
+
+N_FRAMES = 100
+if len(sys.argv) > 1:
+    N_FRAMES = int(sys.argv[1])
+
+IMAGE_SIZES = [(128,128), (512,512), (1024,1024), (2048,2048)]
+SEGMENT_SIZE = 1024*1024*1024
+
+def createFrame(nx, ny):
+    frame = NtNdArray()
+    frame['uniqueId'] = 1
+    frame['dimension'] = [PvDimension(nx, 0, nx, 1, False), PvDimension(ny, 0, ny, 1, False)]
+    frame['attribute'] = [NtAttribute('ColorMode', PvInt(0))]
+    frame['compressedSize'] = nx*ny*2
+    frame['uncompressedSize'] = nx*ny*2
+    frame['value'] = {'ushortValue' : np.random.randint(0, 65536, size=nx*ny, dtype=np.uint16)}
+    return frame
+
+# Consumer touches frame data, so that views are not released unread
+def mpConsumer(iq, oq, nFrames):
+    for i in range(0,nFrames):
+        frame = iq.get()
+        frame['value'][0]['ushortValue'].sum()
+    oq.put(nFrames)
+
+def shmConsumer(iq, oq, nFrames, useViews):
+    for i in range(0,nFrames):
+        if useViews:
+            frame = iq.getView(10)
+        else:
+            frame = iq.get(10)
+        frame['value'][0]['ushortValue'].sum()
+        frame = None
+    oq.put(nFrames)
+
+# Producer waits for space in the queue if consumer falls behind
+def measure(label, frame, iq, put, consumer, *args):
+    oq = mp.Queue()
+    p = mp.Process(target=consumer, args=(iq,oq,N_FRAMES)+args)
+    p.start()
+    t0 = time.time()
+    for i in range(0,N_FRAMES):
+        put(iq, frame)
+    oq.get()
+    t1 = time.time()
+    p.join()
+    frameTime = (t1-t0)/N_FRAMES
+    print('%-12s frame: %10.3f ms, rate: %10.1f frames/s' % (label, frameTime*1.0e3, 1.0/frameTime))
+
+for (nx,ny) in IMAGE_SIZES:
+    frame = createFrame(nx, ny)
+    print('\nImage size: %sx%s, frames: %s' % (nx, ny, N_FRAMES))
+    measure('mp queue', frame, mp.Queue(), lambda q, f: q.put(f), mpConsumer)
+    iq = SharedMemoryPvObjectQueue('pvapy_benchmark', -1, SEGMENT_SIZE)
+    measure('shm get', frame, iq, lambda q, f: q.put(f, 10), shmConsumer, False)
+    measure('shm view', frame, iq, lambda q, f: q.put(f, 10), shmConsumer, True)
+    iq = None
@@ -5,13 +5,14 @@ from pvapy.hpc.userMpDataProcessor import UserMpDataProcessor
 from pvapy.hpc.userMpWorkerController import UserMpWorkerController
 import multiprocessing as mp
 
-# Example for implementing data processor that spawns separate unix process
+# Example for implementing data processor that spawns separate unix process;
+# PvObjects are passed to the worker process via shared memory queue
 class UmpDataProcessor2(UserMpDataProcessor):
-    def __init__(self):
+    def __init__(self, useSharedMemoryQueue=True):
         UserMpDataProcessor.__init__(self)
         self.udp = UmpDataProcessor()
-        self.iq = mp.Queue()
-        self.uwpc = UserMpWorkerController(2, self.udp, self.iq)
+        self.uwpc = UserMpWorkerController(2, self.udp, useSharedMemoryQueue=useSharedMemoryQueue)
+        self.iq = self.uwpc.inputDataQueue
 
     def start(self):
         self.uwpc.start()
@@ -15,6 +15,10 @@ def main():
     parser = argparse.ArgumentParser(description='PvaPy Mirror Server')
     parser.add_argument('-v', '--version', action='version', version=f'%(prog)s {__version__}')
     parser.add_argument('-cm', '--channel-map', dest='channel_map', default=None, help='Channel map specification given as a comma-separated list of tuples of the form (<mirror_channel>,<source_channel>[,source_provider][,source_queue_size[,n_source_monitors,source_field_request_descriptor]]]); if specified, source provider must be either "pva" or "ca" (default: pva), and source queue size must be >= 0 (default: 0); specifying number of source monitors and source request descriptor is typically used with the data distributor plugin, which must be supported by the source PVA server (example request descriptor: "_[pydistributor=updates:1;group:mirror;trigger:uniqueId]").')
+    parser.add_argument('-mur', '--max-update-rate', type=float, dest='max_update_rate', default=0, help='Maximum update rate for all mirror channels in Hz; values <=0 indicate no rate limit (default: 0)')
+    parser.add_argument('-dec', '--decimation', type=int, dest='decimation', default=1, help='Mirror channels are updated with every N-th source update only; values <=1 indicate no decimation (default: 1)')
+    parser.add_argument('-dbf', '--deadband-field', dest='deadband_field', default=None, help='Source scalar field used for deadband evaluation for all mirror channels (default: None)')
+    parser.add_argument('-db', '--deadband', type=float, dest='deadband', default=0, help='Mirror channels are updated only if the deadband field changes by at least this amount; values <=0 indicate no deadband (default: 0)')
     parser.add_argument('-rt', '--runtime', type=float, dest='runtime', default=0, help='Server runtime in seconds; values <=0 indicate infinite runtime (default: infinite)')
     parser.add_argument('-rp', '--report-period', type=float, dest='report_period', default=0, help='Statistics report period for all channels in seconds; values <=0 indicate no reporting (default: 0)')
 
@@ -78,6 +82,12 @@ def main():
     for (cName,sName,sProviderType,sqSize,nsMonitors,sRequestDescriptor) in mapEntries:
         print(f'Adding mirror channel {cName} using source {sName} (provider type: {sProviderType}; queue size: {sqSize}; number of monitors: {nsMonitors}; request descriptor: {sRequestDescriptor})')
         server.addMirrorRecord(cName,sName,sProviderType,sqSize,nsMonitors,sRequestDescriptor)
+        if args.max_update_rate > 0:
+            server.setMirrorRecordMaxUpdateRate(cName, args.max_update_rate)
+        if args.decimation > 1:
+            server.setMirrorRecordDecimation(cName, args.decimation)
+        if args.deadband_field and args.deadband > 0:
+            server.setMirrorRecordDeadband(cName, args.deadband_field, args.deadband)
 
     print(f'Started mirror server @ {startTime:.3f}')
     sleepTime = 1
@@ -31,6 +31,7 @@ class DataProcessingController:
 
         # Assume NTND Arrays if object id field is not passed in
         self.objectIdField = configDict.get('objectIdField', 'uniqueId')
+        self.objectIdAccessor = pva.FieldAccessor(self.objectIdField)
         # Do not process first object by default
         self.skipInitialUpdates = configDict.get('skipInitialUpdates', 1)
         # Object id processing offset used for statistics calculation
@@ -129,7 +130,7 @@ class DataProcessingController:
 
     def process(self, pvObject):
         now = time.time()
-        objectId = pvObject[self.objectIdField]
+        objectId = self.objectIdAccessor.get(pvObject)
         if self.lastObjectId is None:
             self.lastObjectId = objectId
 
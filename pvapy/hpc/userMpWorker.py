@@ -4,6 +4,7 @@ import threading
 import queue
 import os
 import multiprocessing as mp
+import pvaccess as pva
 from ..utility.loggingManager import LoggingManager
 from .hpcController import HpcController
 
@@ -12,17 +13,18 @@ class UserMpWorker(mp.Process):
     ''' 
     User multiprocessing worker class.
   
-    **UserMpWorker(workerId, userMpDataProcessor, commandRequestQueue, commandResponseQueue, inputDataQueue, logLevel=None, logFile=None)**
+    **UserMpWorker(workerId, userMpDataProcessor, commandRequestQueue, commandResponseQueue, inputDataQueue, logLevel=None, logFile=None, useSharedMemoryViews=False)**
 
     :Parameter: *workerId* (str) - Worker id.
     :Parameter: *userMpDataProceessor* (UserMpDataProcessor) - Instance of the UserMpDataProcessor class that will be processing data.
     :Parameter: *commandRequestQueue* (multiprocessing.Queue) - Command request queue.
     :Parameter: *commandResponseQueue* (multiprocessing.Queue) - Command response queue.
-    :Parameter: *inputDataQueue* (multiprocessing.Queue) - Input data queue.
+    :Parameter: *inputDataQueue* (multiprocessing.Queue or SharedMemoryPvObjectQueue) - Input data queue.
     :Parameter: *logLevel* (str) - Log level; possible values: debug, info, warning, error, critical. If not provided, there will be no log output.
     :Parameter: *logFile* (str) - Log file.
+    :Parameter: *useSharedMemoryViews* (bool) - If True, objects are retrieved from shared memory queue using getView(), so that their arrays reference queue memory instead of being copied. Such objects (and arrays obtained from them) must not be kept after processing, as queue space is reused in queue order and any object that is kept blocks the queue.
     '''
-    def __init__(self, workerId, userMpDataProcessor, commandRequestQueue, commandResponseQueue, inputDataQueue, logLevel=None, logFile=None):
+    def __init__(self, workerId, userMpDataProcessor, commandRequestQueue, commandResponseQueue, inputDataQueue, logLevel=None, logFile=None, useSharedMemoryViews=False):
  
         mp.Process.__init__(self) 
         self.logger = LoggingManager.getLogger(f'{self.__class__.__name__}.{workerId}', logLevel, logFile)
@@ -30,6 +32,8 @@ class UserMpWorker(mp.Process):
         self.userMpDataProcessor = userMpDataProcessor
 
         self.inputDataQueue = inputDataQueue
+        self.isSharedMemoryQueue = isinstance(inputDataQueue, pva.SharedMemoryPvObjectQueue)
+        self.useSharedMemoryViews = useSharedMemoryViews and self.isSharedMemoryQueue
         self.commandRequestQueue = commandRequestQueue
         self.commandResponseQueue = commandResponseQueue
         self.isStopped = True
@@ -71,9 +75,13 @@ class UserMpWorker(mp.Process):
             self.isStopped = True
             self.userMpDataProcessor.stop()
             try:
-                self.logger.debug(f'Emptying input data queue for worker {self.workerId}, queue size is {self.inputDataQueue.qsize()}')
-                while not self.inputDataQueue.empty():
-                    self.inputDataQueue.get(block=True, timeout=HpcController.WAIT_TIME)
+                if self.isSharedMemoryQueue:
+                    self.logger.debug(f'Emptying input data queue for worker {self.workerId}, queue size is {len(self.inputDataQueue)}')
+                    self.inputDataQueue.clear()
+                else:
+                    self.logger.debug(f'Emptying input data queue for worker {self.workerId}, queue size is {self.inputDataQueue.qsize()}')
+                    while not self.inputDataQueue.empty():
+                        self.inputDataQueue.get(block=True, timeout=HpcController.WAIT_TIME)
             except Exception as ex:
                 self.logger.warn(f'Error emptying input data queue for worker {self.workerId}: {ex}')
         return self.getStats()
@@ -103,9 +111,15 @@ class UserMpWorker(mp.Process):
             if self.isStopped:
                 break
             try:
-                inputData = self.inputDataQueue.get(block=True, timeout=HpcController.WAIT_TIME)
+                if self.useSharedMemoryViews:
+                    inputData = self.inputDataQueue.getView(HpcController.WAIT_TIME)
+                elif self.isSharedMemoryQueue:
+                    inputData = self.inputDataQueue.get(HpcController.WAIT_TIME)
+                else:
+                    inputData = self.inputDataQueue.get(block=True, timeout=HpcController.WAIT_TIME)
                 self.process(inputData)
-            except queue.Empty:
+                inputData = None
+            except (queue.Empty, pva.QueueEmpty):
                 pass
             except Exception as ex:
                 self.logger.error(f'Data processing error: {ex}')
@@ -3,6 +3,7 @@
 import os
 import queue
 import multiprocessing as mp
+import pvaccess as pva
 from ..utility.loggingManager import LoggingManager
 from .userMpWorker import UserMpWorker
 from .hpcController import HpcController
@@ -14,26 +15,50 @@ class UserMpWorkerController(HpcController):
     ''' 
     Controller class for user multiprocessing worker process.
   
-    **UserMpWorkerController(workerId, userMpDataProcessor, inputDataQueue, logLevel=None, logFile=None)**
+    **UserMpWorkerController(workerId, userMpDataProcessor, inputDataQueue=None, logLevel=None, logFile=None, useSharedMemoryQueue=False, sharedMemoryQueueLength=-1, sharedMemoryQueueSize=0, useSharedMemoryViews=False)**
 
     :Parameter: *workerId* (str) - Worker id.
     :Parameter: *userMpDataProcessor* (UserMpDataProcessor) - Instance of the UserMpDataProcessor class that will be processing data.
-    :Parameter: *inputDataQueue* (multiprocessing.Queue) - Input data queue.
+    :Parameter: *inputDataQueue* (multiprocessing.Queue or SharedMemoryPvObjectQueue) - Input data queue. If not provided, controller will create one, which will be available as the inputDataQueue attribute.
     :Parameter: *logLevel* (str) - Log level; possible values: debug, info, warning, error, critical. If not provided, there will be no log output.
     :Parameter: *logFile* (str) - Log file.
+    :Parameter: *useSharedMemoryQueue* (bool) - If True and input data queue is not provided, controller will create SharedMemoryPvObjectQueue instead of multiprocessing.Queue; shared memory queue can only be used for passing PvObjects to the worker process, but avoids pickling and copying objects through a pipe.
+    :Parameter: *sharedMemoryQueueLength* (int) - Maximum length of the shared memory queue; value of -1 indicates that the queue length is limited only by the shared memory segment size.
+    :Parameter: *sharedMemoryQueueSize* (int) - Shared memory segment size in bytes; if <= 0, default size of 256MB will be used.
+    :Parameter: *useSharedMemoryViews* (bool) - If True, worker will retrieve objects from shared memory queue without copying array data (see UserMpWorker); user data processor must not keep references to input objects after processing.
     '''
-    def __init__(self, workerId, userMpDataProcessor, inputDataQueue, logLevel=None, logFile=None):
+    def __init__(self, workerId, userMpDataProcessor, inputDataQueue=None, logLevel=None, logFile=None, useSharedMemoryQueue=False, sharedMemoryQueueLength=-1, sharedMemoryQueueSize=0, useSharedMemoryViews=False):
         HpcController.__init__(self, logLevel, logFile) 
         self.workerId = workerId 
+        if inputDataQueue is None:
+            inputDataQueue = self.createInputDataQueue(workerId, useSharedMemoryQueue, sharedMemoryQueueLength, sharedMemoryQueueSize)
         self.inputDataQueue = inputDataQueue
         self.commandRequestQueue = mp.Queue()
         self.commandResponseQueue = mp.Queue()
         self.requestId = 0
-        self.uwProcess = UserMpWorker(workerId, userMpDataProcessor, self.commandRequestQueue, self.commandResponseQueue, inputDataQueue, logLevel, logFile)
+        self.uwProcess = UserMpWorker(workerId, userMpDataProcessor, self.commandRequestQueue, self.commandResponseQueue, inputDataQueue, logLevel, logFile, useSharedMemoryViews)
         self.pid = os.getpid()
         self.statsDict = {}
         self.isStopped = True
 
+    @classmethod
+    def createInputDataQueue(cls, workerId, useSharedMemoryQueue=False, sharedMemoryQueueLength=-1, sharedMemoryQueueSize=0):
+        '''
+        Creates input data queue for a worker process.
+
+        :Parameter: *workerId* (str) - Worker id.
+        :Parameter: *useSharedMemoryQueue* (bool) - If True, SharedMemoryPvObjectQueue will be created instead of multiprocessing.Queue.
+        :Parameter: *sharedMemoryQueueLength* (int) - Maximum length of the shared memory queue.
+        :Parameter: *sharedMemoryQueueSize* (int) - Shared memory segment size in bytes; if <= 0, default size will be used.
+        :Returns: Input data queue
+        '''
+        if not useSharedMemoryQueue:
+            return mp.Queue()
+        name = f'pvapy_worker_{os.getpid()}_{workerId}'
+        if sharedMemoryQueueSize > 0:
+            return pva.SharedMemoryPvObjectQueue(name, sharedMemoryQueueLength, sharedMemoryQueueSize)
+        return pva.SharedMemoryPvObjectQueue(name, sharedMemoryQueueLength)
+
     class ProcessNotResponding(Exception):
         def __init__(self, args):
             Exception.__init__(self, args)
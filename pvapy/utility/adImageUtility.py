@@ -95,6 +95,15 @@ class AdImageUtility:
     # Bitshuffle block size
     BSLZ4_BLOCK_SIZE = 0
 
+    # Use NtNdArray.getImage() if available
+    USE_NATIVE_IMAGE = hasattr(pva.NtNdArray, 'getImage')
+
+    # Codecs implemented natively; python decompressors are used
+    # only for codec variants that are not supported natively
+    NATIVE_CODEC_NAMES = []
+    if hasattr(pva.PvCodec, 'getNativeCodecNames') and hasattr(pva.NtNdArray, 'decompressArray'):
+        NATIVE_CODEC_NAMES = pva.PvCodec.getNativeCodecNames()
+
     @classmethod
     def getCompressedPayload(cls, inputArray):
         if cls.COMPRESSED_PAYLOAD_START is None:
@@ -116,8 +125,21 @@ class AdImageUtility:
         decompressor = utilityMap.get(codecName)
         if not decompressor:
             raise pva.InvalidArgument(f'Unsupported compression: {codecName}')
+        if codecName in cls.NATIVE_CODEC_NAMES:
+            return lambda inputArray, inputType, uncompressedSize: cls.nativeDecompress(codecName, inputArray, inputType, uncompressedSize, decompressor)
         return decompressor
 
+    @classmethod
+    def nativeDecompress(cls, codecName, inputArray, inputType, uncompressedSize, fallbackDecompressor=None):
+        ''' Decompress array using native codec implementation. '''
+        try:
+            return pva.NtNdArray.decompressArray(codecName, np.ascontiguousarray(inputArray, dtype=np.uint8), int(inputType), uncompressedSize)
+        except pva.InvalidRequest:
+            # Codec variant is not supported natively
+            if fallbackDecompressor is None:
+                raise
+            return fallbackDecompressor(inputArray, inputType, uncompressedSize)
+
     @classmethod
     def bloscDecompress(cls, inputArray, inputType, uncompressedSize):
         try:
@@ -179,7 +201,8 @@ class AdImageUtility:
 
         if colorMode is None and nDims > 2:
             raise pva.InvalidArgument('NTNDArray does not contain ColorMode attribute.')
-        colorMode = cls.COLOR_MODE_MONO
+        if colorMode is None:
+            colorMode = cls.COLOR_MODE_MONO
 
         if nDims == 0:
             nx = None
@@ -214,6 +237,18 @@ class AdImageUtility:
 
         # Alternative ways of getting the image array and type
         fieldKey = ntNdArray.getSelectedUnionFieldName()
+
+        # Native image retrieval shapes image without copying data,
+        # and decompresses image into reusable buffer if needed
+        if cls.USE_NATIVE_IMAGE:
+            try:
+                if not isinstance(ntNdArray, pva.NtNdArray):
+                    ntNdArray = pva.NtNdArray(ntNdArray)
+                image = ntNdArray.getImage()
+                return (imageId,image,nx,ny,nz,colorMode,fieldKey)
+            except pva.InvalidRequest:
+                # Unsupported codec, use python decompressors
+                pass
         ###fieldKey = next(iter(ntNdArray['value'][0].keys()))
 
         #imageUnionField = ntNdArray.getUnion()
@@ -297,7 +332,8 @@ class AdImageUtility:
         # Alternative way of setting data
         #u = pva.PvObject({dataFieldKey : [pvaDataType]}, {dataFieldKey : data})
         #ntNdArray.setUnion(u)
-        ntNdArray['value'] = {dataFieldKey : data}
+        # Flattened data is not shared with caller, so it need not be copied
+        ntNdArray.setValue({dataFieldKey : data}, copy=False)
         attrs = [pva.NtAttribute('ColorMode', pva.PvInt(0))]
         ntNdArray['attribute'] = attrs
         if extraFieldsPvObject is not None:
@@ -311,7 +347,6 @@ class AdImageUtility:
         and replaces image data, dimensions, etc. in the provided NtNd Array
         '''
         dataFieldKey = cls.NTNDA_DATA_FIELD_KEY_MAP.get(image.dtype)
-        pvaDataType = cls.PVA_DATA_TYPE_MAP.get(image.dtype)
         data = image.flatten()
         ntNdArray['uniqueId'] = int(imageId)
 
@@ -328,8 +363,7 @@ class AdImageUtility:
         ntNdArray['timeStamp'] = ts
         ntNdArray['dataTimeStamp'] = ts
 
-        u = pva.PvObject({dataFieldKey : [pvaDataType]}, {dataFieldKey : data})
-        ntNdArray.setUnion(u)
+        ntNdArray.setValue({dataFieldKey : data}, copy=False)
         if extraFieldsPvObject is not None:
             ntNdArray.set(extraFieldsPvObject)
         return ntNdArray
@@ -421,7 +455,8 @@ class AdImageUtility:
         ntNdArray['timeStamp'] = ts
         ntNdArray['dataTimeStamp'] = ts
         ntNdArray['descriptor'] = 'Image generated by PvaPy'
-        ntNdArray['value'] = {dataFieldKey : data}
+        # Flattened data is not shared with caller, so it need not be copied
+        ntNdArray.setValue({dataFieldKey : data}, copy=False)
         ntNdArray['attribute'] = attrs
         if extraFieldsPvObject is not None:
             ntNdArray.set(extraFieldsPvObject)
@@ -15,15 +15,27 @@
 #include "ObjectNotFound.h"
 #include "StringUtility.h"
 #include "PyUtility.h"
+#include "PyGilRelease.h"
+#include "PvObject.h"
 #include "CaIoc.h"
 
 namespace bp = boost::python;
+namespace pvd = epics::pvData;
 
 extern "C" int pvapy_registerRecordDeviceDriver(struct dbBase *pbase);
 
 PvaPyLogger CaIoc::logger("CaIoc");
 
 CaIoc::CaIoc() 
+    : dbAddrMutex()
+    , dbAddrMap()
+{
+    PvObject::initializeBoostNumPy();
+}
+
+CaIoc::CaIoc(const CaIoc& caIoc)
+    : dbAddrMutex()
+    , dbAddrMap()
 {
 }
 
@@ -42,6 +54,7 @@ void CaIoc::start()
 
 void CaIoc::stop() 
 {
+    clearDbAddrCache();
     int status = ::iocShutdown();
     if (status) {
         throw InvalidState("iocShutdown() failed with status of " + StringUtility::toString<int>(status));
@@ -92,11 +105,33 @@ void CaIoc::loadRecords(const std::string& fileName, const std::string& substitu
 
 void CaIoc::getRecordDbAddr(const std::string& name, DBADDR *dbAddr)
 {
+    {
+        pvd::Lock lock(dbAddrMutex);
+        std::map<std::string, DBADDR>::const_iterator it = dbAddrMap.find(name);
+        if (it != dbAddrMap.end()) {
+            *dbAddr = it->second;
+            return;
+        }
+    }
+
     int status = dbNameToAddr(name.c_str(), dbAddr);
 
     if (status) {
         throw ObjectNotFound("Record " + name + " not found");
     }
+
+    // Array field buffers are allocated by iocInit(), so addresses
+    // resolved before that are not cached
+    if (dbAddr->precord->lset != NULL) {
+        pvd::Lock lock(dbAddrMutex);
+        dbAddrMap[name] = *dbAddr;
+    }
+}
+
+void CaIoc::clearDbAddrCache()
+{
+    pvd::Lock lock(dbAddrMutex);
+    dbAddrMap.clear();
 }
 
 // Modified from the dbl() code in dbTest.h to return list of record names
@@ -128,6 +163,13 @@ bp::list CaIoc::getRecordNames()
 
 void CaIoc::putField(const std::string& name, const bp::object& pyValue)
 {
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+    if (PyUtility::isNumPyNDArray(pyValue)) {
+        numpy_::ndarray ndArray = bp::extract<numpy_::ndarray>(pyValue);
+        putFieldFromNumPyArray(name, ndArray);
+        return;
+    }
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
     std::string value = PyUtility::extractStringFromPyObject(pyValue);
     putField(name, value);
 }
@@ -182,6 +224,11 @@ void CaIoc::putField(const std::string& name, const std::string& value)
 }
 
 bp::object CaIoc::getField(const std::string& name)
+{
+    return getField(name, false);
+}
+
+bp::object CaIoc::getField(const std::string& name, bool useNumPyArrays)
 {
     if (name.size() == 0) {
         throw InvalidArgument("Record name cannot be empty.");
@@ -189,6 +236,33 @@ bp::object CaIoc::getField(const std::string& name)
 
     DBADDR addr;
     getRecordDbAddr(name, &addr);
+    return readField(addr, useNumPyArrays);
+}
+
+bp::dict CaIoc::getFields(const bp::list& names)
+{
+    return getFields(names, false);
+}
+
+bp::dict CaIoc::getFields(const bp::list& names, bool useNumPyArrays)
+{
+    bp::dict pyDict;
+    int nNames = bp::len(names);
+    for (int i = 0; i < nNames; i++) {
+        std::string name = PyUtility::extractValueFromPyObject<std::string>(names[i]);
+        pyDict[name] = getField(name, useNumPyArrays);
+    }
+    return pyDict;
+}
+
+bp::object CaIoc::readField(DBADDR& addr, bool useNumPyArrays)
+{
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+    if (useNumPyArrays && addr.no_elements > 1 && addr.dbr_field_type != DBR_STRING) {
+        return getFieldAsNumPyArray(addr);
+    }
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+
     long nElements = addr.no_elements; 
     int bufferSize = std::max(static_cast<int>(nElements*addr.field_size), MAX_STRING_SIZE);
 
@@ -219,6 +293,7 @@ bp::object CaIoc::getField(const std::string& name)
 
         case DBR_UCHAR: {
             bufferToPyList<epicsUInt8>(pBuffer, pyList, nElements);
+            break;
         }
 
         case DBR_SHORT: {
@@ -275,6 +350,123 @@ bp::object CaIoc::getField(const std::string& name)
     return pyList;
 }
 
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+numpy_::dtype CaIoc::getNumPyDataType(short dbrType)
+{
+    switch (dbrType) {
+        case DBR_CHAR: {
+            return numpy_::dtype::get_builtin<signed char>();
+        }
+        case DBR_UCHAR: {
+            return numpy_::dtype::get_builtin<epicsUInt8>();
+        }
+        case DBR_SHORT: {
+            return numpy_::dtype::get_builtin<epicsInt16>();
+        }
+        case DBR_USHORT: {
+            return numpy_::dtype::get_builtin<epicsUInt16>();
+        }
+        case DBR_LONG: {
+            return numpy_::dtype::get_builtin<epicsInt32>();
+        }
+        case DBR_ULONG: {
+            return numpy_::dtype::get_builtin<epicsUInt32>();
+        }
+        case DBR_INT64: {
+            return numpy_::dtype::get_builtin<epicsInt64>();
+        }
+        case DBR_UINT64: {
+            return numpy_::dtype::get_builtin<epicsUInt64>();
+        }
+        case DBR_FLOAT: {
+            return numpy_::dtype::get_builtin<epicsFloat32>();
+        }
+        case DBR_DOUBLE: {
+            return numpy_::dtype::get_builtin<epicsFloat64>();
+        }
+        case DBR_ENUM: {
+            return numpy_::dtype::get_builtin<epicsEnum16>();
+        }
+        default: {
+            throw InvalidState("Record field type " + StringUtility::toString<int>(dbrType) + " cannot be represented as NumPy array");
+        }
+    }
+}
+
+// Field data is read directly into NumPy array buffer, without GIL
+bp::object CaIoc::getFieldAsNumPyArray(DBADDR& addr)
+{
+    long nElements = addr.no_elements;
+    numpy_::ndarray ndArray = numpy_::empty(bp::make_tuple(nElements), getNumPyDataType(addr.dbr_field_type));
+    void* pBuffer = ndArray.get_data();
+    long options = 0;
+    long status = 0;
+    if (PyGILState_Check()) {
+        PyGilRelease pyGilRelease;
+        status = dbGetField(&addr, addr.dbr_field_type, pBuffer, &options, &nElements, NULL);
+    }
+    else {
+        status = dbGetField(&addr, addr.dbr_field_type, pBuffer, &options, &nElements, NULL);
+    }
+    if (status) {
+        throw InvalidState("dbGetField() failed with status of " + StringUtility::toString<int>(status));
+    }
+    if (nElements < addr.no_elements) {
+        // Return view of the elements actually in use
+        return bp::object(ndArray.slice(0, nElements));
+    }
+    return ndArray;
+}
+
+// NumPy array is converted to record field type only if needed, and
+// its buffer is passed to dbPutField() without GIL
+void CaIoc::putFieldFromNumPyArray(const std::string& name, const numpy_::ndarray& ndArray)
+{
+    if (name.size() == 0) {
+        throw InvalidArgument("Record name cannot be empty.");
+    }
+
+    DBADDR addr;
+    getRecordDbAddr(name, &addr);
+
+    if (addr.precord->lset == NULL) {
+        throw InvalidState("Record " + name + " cannot be set before ioc is initialized");
+    }
+
+    short dbrType = addr.dbr_field_type;
+    if (dbrType == DBR_STRING) {
+        throw InvalidArgument("Record " + name + " is a string field and cannot be set from NumPy array");
+    }
+    numpy_::dtype dataType = getNumPyDataType(dbrType);
+    numpy_::ndarray array = ndArray;
+    if (ndArray.get_dtype() != dataType || !(ndArray.get_flags() & numpy_::ndarray::C_CONTIGUOUS)) {
+        bp::object pyObject = bp::import("numpy").attr("ascontiguousarray")(ndArray, dataType);
+        array = bp::extract<numpy_::ndarray>(pyObject);
+    }
+
+    long n = 1;
+    for (int i = 0; i < array.get_nd(); i++) {
+        n *= array.shape(i);
+    }
+    if (n > addr.no_elements) {
+        throw InvalidArgument("Record " + name + " can hold at most " + StringUtility::toString<long>(addr.no_elements) + " elements, array has " + StringUtility::toString<long>(n));
+    }
+
+    void* pBuffer = array.get_data();
+    long status = 0;
+    if (PyGILState_Check()) {
+        PyGilRelease pyGilRelease;
+        status = dbPutField(&addr, dbrType, pBuffer, n);
+    }
+    else {
+        status = dbPutField(&addr, dbrType, pBuffer, n);
+    }
+    if (status) {
+        throw InvalidState("dbPutField() failed with status of " + StringUtility::toString<int>(status));
+    }
+}
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+
 void CaIoc::printRecord(const std::string& name, int level)
 {
     if (name.size() == 0) {
@@ -316,6 +508,7 @@ int CaIoc::iocInit()
 
 int CaIoc::iocShutdown() 
 {
+    clearDbAddrCache();
     return ::iocShutdown();
 }
 
@@ -4,15 +4,25 @@
 #ifndef CA_IOC_H
 #define CA_IOC_H
 
+#include <map>
+#include <string>
 #include <boost/python/list.hpp>
+#include <boost/python/dict.hpp>
 #include <iocInit.h>
 #include <dbAddr.h>
+#include <pv/lock.h>
 #include "PvaPyLogger.h"
+#include "pvapy.environment.h"
+
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+#include NUMPY_HEADER_FILE
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
 
 class CaIoc
 {
 public:
     CaIoc();
+    CaIoc(const CaIoc& caIoc);
     virtual ~CaIoc();
 
     virtual void start();
@@ -25,6 +35,9 @@ public:
     virtual void putField(const std::string& name, const boost::python::object& value);
     virtual void putField(const std::string& name, const std::string& value);
     virtual boost::python::object getField(const std::string& name);
+    virtual boost::python::object getField(const std::string& name, bool useNumPyArrays);
+    virtual boost::python::dict getFields(const boost::python::list& names);
+    virtual boost::python::dict getFields(const boost::python::list& names, bool useNumPyArrays);
     virtual void printRecord(const std::string& name, int level);
 
     // Wrappers for calls available in iocsh
@@ -40,7 +53,19 @@ public:
 
 private:
     static PvaPyLogger logger;
+
+    // Record addresses are resolved once and cached until IOC is stopped
     void getRecordDbAddr(const std::string& name, DBADDR *dbAddr);
+    void clearDbAddrCache();
+    boost::python::object readField(DBADDR& addr, bool useNumPyArrays);
+
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+    // Array data is read from and written to NumPy array buffers directly
+    static numpy_::dtype getNumPyDataType(short dbrType);
+    boost::python::object getFieldAsNumPyArray(DBADDR& addr);
+    void putFieldFromNumPyArray(const std::string& name, const numpy_::ndarray& ndArray);
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+
     template <typename T>
     void bufferToPyList(void* buffer, boost::python::list pyList, int nElements) {
         int elementSize = sizeof(T);
@@ -51,6 +76,8 @@ private:
         }
     }
 
+    epics::pvData::Mutex dbAddrMutex;
+    std::map<std::string, DBADDR> dbAddrMap;
 
 };
 
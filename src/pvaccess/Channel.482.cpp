@@ -14,6 +14,8 @@
 #include "ChannelTimeout.h"
 #include "QueueEmpty.h"
 #include "InvalidArgument.h"
+#include "InvalidState.h"
+#include "MonitorDispatcher.h"
 #include "ObjectNotFound.h"
 #include "ObjectAlreadyExists.h"
 #include "PyGilManager.h"
@@ -37,6 +39,11 @@ const int Channel::DefaultMaxPvObjectQueueLength(0);
 const int Channel::MaxAsyncRequestQueueLength(10);
 const int Channel::MaxAsyncRequestWaitTimeout(30);
 const int Channel::AsyncRequestThreadWaitTimeout(1);
+const int Channel::DefaultAsyncRequestPipelineDepth(1);
+const int Channel::DefaultOperationCacheSize(ChannelOperationCache<pvc::PvaClientGetPtr>::DefaultMaxSize);
+const double Channel::DefaultMonitorMaxBatchLatency(0.1);
+const int Channel::MonitorBatchQueueLengthFactor(10);
+const int Channel::MonitorDispatchQueueLength(100);
 const double Channel::ShutdownWaitTime(0.1);
 const double Channel::MonitorStartWaitTime(0.1);
 const double Channel::ThreadStartWaitTime(0.1);
@@ -48,15 +55,32 @@ pvc::PvaClientPtr Channel::pvaClientPtr(pvc::PvaClient::get("pva ca"));
 
 Channel::Channel(const std::string& channelName, PvProvider::ProviderType providerType_) 
     : pvaClientChannelPtr(pvaClientPtr->createChannel(channelName,PvProvider::getProviderName(providerType_)))
+    , monitorStructurePoolPtr(new PvStructurePool())
     , monitorActive(false)
     , monitorRunning(false)
     , processingThreadRunning(false)
     , pvObjectQueue(DefaultMaxPvObjectQueueLength)
     , useInternalPvObjectQueue(true)
+    , monitorQueueLockFree(false)
+    , monitorSharedDispatch(false)
+    , monitorQueueMaxLengthForced(false)
+    , monitorBatchSize(0)
+    , monitorMaxBatchLatency(DefaultMonitorMaxBatchLatency)
+    , batchCounterMutex()
+    , nBatches(0)
+    , batchSizeHistogram()
     , subscriberName()
     , subscriber()
     , subscriberMap()
     , subscriberMutex()
+    , subscriberQueueLength(0)
+    , subscriberDispatcherMap()
+    , monitorTimingEnabled(false)
+    , eventToPushHistogramPtr(new LatencyHistogram())
+    , queueWaitHistogramPtr(new LatencyHistogram())
+    , gilWaitHistogramPtr(new LatencyHistogram())
+    , callbackHistogramPtr(new LatencyHistogram())
+    , monitorQueueTimeStampRing()
     , monitorMutex()
     , processingThreadMutex()
     , processingThreadExitEvent()
@@ -75,6 +99,10 @@ Channel::Channel(const std::string& channelName, PvProvider::ProviderType provid
     , asyncPutThreadExitEvent()
     , asyncGetRequestQueue(MaxAsyncRequestQueueLength)
     , asyncPutRequestQueue(MaxAsyncRequestQueueLength)
+    , asyncRequestPipelineDepth(DefaultAsyncRequestPipelineDepth)
+    , getCache(DefaultOperationCacheSize)
+    , putCache(DefaultOperationCacheSize)
+    , putGetCache(DefaultOperationCacheSize)
     , shutdownInProgress(false)
 {
     PvObject::initializeBoostNumPy();
@@ -85,15 +113,32 @@ Channel::Channel(const std::string& channelName, PvProvider::ProviderType provid
 
 Channel::Channel(const Channel& c) 
     : pvaClientChannelPtr(pvaClientPtr->createChannel(c.pvaClientChannelPtr->getChannelName(),PvProvider::getProviderName(c.providerType)))
+    , monitorStructurePoolPtr(new PvStructurePool())
     , monitorActive(false)
     , monitorRunning(false)
     , processingThreadRunning(false)
     , pvObjectQueue(DefaultMaxPvObjectQueueLength)
     , useInternalPvObjectQueue(true)
+    , monitorQueueLockFree(false)
+    , monitorSharedDispatch(false)
+    , monitorQueueMaxLengthForced(false)
+    , monitorBatchSize(0)
+    , monitorMaxBatchLatency(DefaultMonitorMaxBatchLatency)
+    , batchCounterMutex()
+    , nBatches(0)
+    , batchSizeHistogram()
     , subscriberName()
     , subscriber()
     , subscriberMap()
     , subscriberMutex()
+    , subscriberQueueLength(0)
+    , subscriberDispatcherMap()
+    , monitorTimingEnabled(false)
+    , eventToPushHistogramPtr(new LatencyHistogram())
+    , queueWaitHistogramPtr(new LatencyHistogram())
+    , gilWaitHistogramPtr(new LatencyHistogram())
+    , callbackHistogramPtr(new LatencyHistogram())
+    , monitorQueueTimeStampRing()
     , monitorMutex()
     , processingThreadMutex()
     , processingThreadExitEvent()
@@ -111,6 +156,10 @@ Channel::Channel(const Channel& c)
     , asyncPutThreadExitEvent()
     , asyncGetRequestQueue(MaxAsyncRequestQueueLength)
     , asyncPutRequestQueue(MaxAsyncRequestQueueLength)
+    , asyncRequestPipelineDepth(DefaultAsyncRequestPipelineDepth)
+    , getCache(DefaultOperationCacheSize)
+    , putCache(DefaultOperationCacheSize)
+    , putGetCache(DefaultOperationCacheSize)
     , shutdownInProgress(false)
 {
     PyGilManager::evalInitThreads();
@@ -122,11 +171,14 @@ Channel::~Channel()
 {
     shutdownInProgress = true;
     stopMonitor();
+    MonitorDispatcher::unregisterClient(this);
+    stopSubscriberDispatchers();
     waitForProcessingThreadExit(ShutdownWaitTime);
     waitForAsyncGetThreadExit(AsyncRequestThreadWaitTimeout);
     waitForAsyncPutThreadExit(AsyncRequestThreadWaitTimeout);
     asyncGetRequestQueue.clear();
     asyncPutRequestQueue.clear();
+    invalidateOperationCache();
     pvaClientChannelPtr.reset();
     //epicsThreadSleep(ShutdownWaitTime);
 }
@@ -212,9 +264,12 @@ PvObject* Channel::get(const std::string& requestDescriptor)
     PyThreadState* _pyThreadState;
     _pyThreadState = PyEval_SaveThread();
     try {
-        pvc::PvaClientGetPtr pvaGet = createGetPtr(requestDescriptor);
+        unsigned int cacheGeneration = 0;
+        pvc::PvaClientGetPtr pvaGet = checkoutGetPtr(requestDescriptor, cacheGeneration);
         pvaGet->get();
-        pvd::PVStructurePtr pvStructure = pvaGet->getData()->getPVStructure();
+        // Cached operations reuse their data, so the result must be copied
+        pvd::PVStructurePtr pvStructure = pvd::getPVDataCreate()->createPVStructure(pvaGet->getData()->getPVStructure());
+        checkinGetPtr(requestDescriptor, pvaGet, cacheGeneration);
         PyEval_RestoreThread(_pyThreadState);
         return new PvObject(pvStructure);
     }
@@ -263,11 +318,13 @@ void Channel::put(const PvObject& pvObject, const std::string& requestDescriptor
 {
     connect();
     PyThreadState* _pyThreadState = NULL;
+    unsigned int cacheGeneration = 0;
     try {
-        pvc::PvaClientPutPtr pvaPut = createPutPtr(requestDescriptor);
+        pvc::PvaClientPutPtr pvaPut = checkoutPutPtr(requestDescriptor, cacheGeneration);
         preparePut(pvObject, pvaPut);
         _pyThreadState = PyEval_SaveThread();
         pvaPut->put();
+        checkinPutPtr(requestDescriptor, pvaPut, cacheGeneration);
     }
     catch (std::runtime_error& ex) {
         if (_pyThreadState) {
@@ -287,12 +344,14 @@ void Channel::put(const std::vector<std::string>& values, const std::string& req
 {
     connect();
     PyThreadState* _pyThreadState = NULL;
+    unsigned int cacheGeneration = 0;
     try {
-        pvc::PvaClientPutPtr pvaPut = createPutPtr(requestDescriptor);
+        pvc::PvaClientPutPtr pvaPut = checkoutPutPtr(requestDescriptor, cacheGeneration);
         pvc::PvaClientPutDataPtr pvaData = pvaPut->getData();
         pvaData->putStringArray(values);
         _pyThreadState = PyEval_SaveThread();
         pvaPut->put();
+        checkinPutPtr(requestDescriptor, pvaPut, cacheGeneration);
     }
     catch (std::runtime_error& ex) {
         if (_pyThreadState) {
@@ -312,8 +371,9 @@ void Channel::put(const std::string& value, const std::string& requestDescriptor
 {
     connect();
     PyThreadState* _pyThreadState = NULL;
+    unsigned int cacheGeneration = 0;
     try {
-        pvc::PvaClientPutPtr pvaPut = createPutPtr(requestDescriptor);
+        pvc::PvaClientPutPtr pvaPut = checkoutPutPtr(requestDescriptor, cacheGeneration);
         pvc::PvaClientPutDataPtr pvaData = pvaPut->getData();
         if (pvaData->isValueScalar()) {
             // value is scalar
@@ -329,6 +389,7 @@ void Channel::put(const std::string& value, const std::string& requestDescriptor
         }
         _pyThreadState = PyEval_SaveThread();
         pvaPut->put();
+        checkinPutPtr(requestDescriptor, pvaPut, cacheGeneration);
     }
     catch (std::runtime_error& ex) {
         if (_pyThreadState) {
@@ -491,13 +552,15 @@ void Channel::parsePut(
     for (int i = 0; i < listSize; i++) {
         args[i] = PyUtility::extractStringFromPyObject(pyList[i]);
     }
+    unsigned int cacheGeneration = 0;
     try {
-        pvc::PvaClientPutPtr pvaPut = createPutPtr(requestDescriptor);
+        pvc::PvaClientPutPtr pvaPut = checkoutPutPtr(requestDescriptor, cacheGeneration);
         pvc::PvaClientPutDataPtr pvaData = pvaPut->getData();
         if(zeroArrayLength) pvaData->zeroArrayLength();
         pvaData->parse(args);
         _pyThreadState = PyEval_SaveThread();
         pvaPut->put();
+        checkinPutPtr(requestDescriptor, pvaPut, cacheGeneration);
     }
     catch (std::runtime_error& ex) {
         if (_pyThreadState) {
@@ -519,14 +582,16 @@ PvObject* Channel::parsePutGet(
     for (int i = 0; i < listSize; i++) {
         args[i] = PyUtility::extractStringFromPyObject(pyList[i]);
     }
+    unsigned int cacheGeneration = 0;
     try {
-        pvc::PvaClientPutGetPtr pvaPutGet = createPutGetPtr(requestDescriptor);
+        pvc::PvaClientPutGetPtr pvaPutGet = checkoutPutGetPtr(requestDescriptor, cacheGeneration);
         pvc::PvaClientPutDataPtr pvaData = pvaPutGet->getPutData();
         if(zeroArrayLength) pvaData->zeroArrayLength();
         pvaData->parse(args);
         _pyThreadState = PyEval_SaveThread();
         pvaPutGet->putGet();
-        pvd::PVStructurePtr pvGet = pvaPutGet->getGetData()->getPVStructure();
+        pvd::PVStructurePtr pvGet = pvd::getPVDataCreate()->createPVStructure(pvaPutGet->getGetData()->getPVStructure());
+        checkinPutGetPtr(requestDescriptor, pvaPutGet, cacheGeneration);
         PyEval_RestoreThread(_pyThreadState);
         return new PvObject(pvGet);
     }
@@ -545,13 +610,15 @@ PvObject* Channel::putGet(const PvObject& pvObject, const std::string& requestDe
 {
     connect();
     PyThreadState* _pyThreadState = NULL;
+    unsigned int cacheGeneration = 0;
     try {
-        pvc::PvaClientPutGetPtr pvaPutGet = createPutGetPtr(requestDescriptor);
+        pvc::PvaClientPutGetPtr pvaPutGet = checkoutPutGetPtr(requestDescriptor, cacheGeneration);
         pvd::PVStructurePtr pvPut = pvaPutGet->getPutData()->getPVStructure();
         pvPut << pvObject;
         _pyThreadState = PyEval_SaveThread();
         pvaPutGet->putGet();
-        pvd::PVStructurePtr pvGet = pvaPutGet->getGetData()->getPVStructure();
+        pvd::PVStructurePtr pvGet = pvd::getPVDataCreate()->createPVStructure(pvaPutGet->getGetData()->getPVStructure());
+        checkinPutGetPtr(requestDescriptor, pvaPutGet, cacheGeneration);
         PyEval_RestoreThread(_pyThreadState);
         return new PvObject(pvGet);
     }
@@ -572,14 +639,17 @@ PvObject* Channel::putGet(const std::vector<std::string>& values, const std::str
 {
     connect();
     PyThreadState* _pyThreadState = NULL;
+    unsigned int cacheGeneration = 0;
     try {
-        pvc::PvaClientPutGetPtr pvaPutGet = createPutGetPtr(requestDescriptor);
+        pvc::PvaClientPutGetPtr pvaPutGet = checkoutPutGetPtr(requestDescriptor, cacheGeneration);
         pvc::PvaClientPutDataPtr pvaData = pvaPutGet->getPutData();
         pvaData->putStringArray(values);
         _pyThreadState = PyEval_SaveThread();
         pvaPutGet->putGet();
+        pvd::PVStructurePtr pvGet = pvd::getPVDataCreate()->createPVStructure(pvaPutGet->getGetData()->getPVStructure());
+        checkinPutGetPtr(requestDescriptor, pvaPutGet, cacheGeneration);
         PyEval_RestoreThread(_pyThreadState);
-        return new PvObject(pvaPutGet->getGetData()->getPVStructure());
+        return new PvObject(pvGet);
     }
     catch (std::runtime_error& ex) {
         if (_pyThreadState) {
@@ -598,8 +668,9 @@ PvObject* Channel::putGet(const std::string& value, const std::string& requestDe
 {
     connect();
     PyThreadState* _pyThreadState = NULL;
+    unsigned int cacheGeneration = 0;
     try {
-        pvc::PvaClientPutGetPtr pvaPutGet = createPutGetPtr(requestDescriptor);
+        pvc::PvaClientPutGetPtr pvaPutGet = checkoutPutGetPtr(requestDescriptor, cacheGeneration);
         pvc::PvaClientPutDataPtr pvaData = pvaPutGet->getPutData();
         if (pvaData->isValueScalar()) {
             // value is scalar
@@ -615,8 +686,10 @@ PvObject* Channel::putGet(const std::string& value, const std::string& requestDe
         }
         _pyThreadState = PyEval_SaveThread();
         pvaPutGet->putGet();
+        pvd::PVStructurePtr pvGet = pvd::getPVDataCreate()->createPVStructure(pvaPutGet->getGetData()->getPVStructure());
+        checkinPutGetPtr(requestDescriptor, pvaPutGet, cacheGeneration);
         PyEval_RestoreThread(_pyThreadState);
-        return new PvObject(pvaPutGet->getGetData()->getPVStructure());
+        return new PvObject(pvGet);
     }
     catch (std::runtime_error& ex) {
         if (_pyThreadState) {
@@ -779,12 +852,15 @@ PvObject* Channel::getPut(const std::string& requestDescriptor)
 {
     connect();
     PyThreadState* _pyThreadState = NULL;
+    unsigned int cacheGeneration = 0;
     try {
-        pvc::PvaClientPutGetPtr pvaPutGet = createPutGetPtr(requestDescriptor);
+        pvc::PvaClientPutGetPtr pvaPutGet = checkoutPutGetPtr(requestDescriptor, cacheGeneration);
         _pyThreadState = PyEval_SaveThread();
         pvaPutGet->getPut();
+        pvd::PVStructurePtr pvPut = pvd::getPVDataCreate()->createPVStructure(pvaPutGet->getPutData()->getPVStructure());
+        checkinPutGetPtr(requestDescriptor, pvaPutGet, cacheGeneration);
         PyEval_RestoreThread(_pyThreadState);
-        return new PvObject(pvaPutGet->getPutData()->getPVStructure());
+        return new PvObject(pvPut);
     }
     catch (std::runtime_error& ex) {
         if (_pyThreadState) {
@@ -827,6 +903,9 @@ void Channel::subscribe(const std::string& subscriberName, const bp::object& pyS
             subscriberMap[subscriberName] = pySubscriber;
         }
     }
+    if (subscriberQueueLength > 0) {
+        addSubscriberDispatcher(subscriberName, pySubscriber);
+    }
     logger.trace("Subscribed " + subscriberName + " to monitor channel " + getName() + ".");
 }
 
@@ -852,6 +931,7 @@ void Channel::unsubscribe(const std::string& subscriberName)
         bp::object pySubscriber = subscriberMap[subscriberName];
         subscriberMap.erase(subscriberName);
     }
+    removeSubscriberDispatcher(subscriberName);
     logger.trace("Unsubscribed " + subscriberName + " from channel " + getName() + ".");
 
     // If there is only one subscriber left, stop using map.
@@ -865,6 +945,20 @@ void Channel::unsubscribe(const std::string& subscriberName)
 
 void Channel::callSubscribers(PvObject& pvObject)
 {
+    if (subscriberQueueLength > 0) {
+        // Each subscriber is called from its own worker thread
+        std::map<std::string,SubscriberDispatcher::shared_pointer> subscriberDispatcherMap2;
+        {
+            pvd::Lock lock(subscriberMutex);
+            subscriberDispatcherMap2 = subscriberDispatcherMap;
+        }
+        std::map<std::string,SubscriberDispatcher::shared_pointer>::iterator dIter;
+        for (dIter = subscriberDispatcherMap2.begin(); dIter != subscriberDispatcherMap2.end(); dIter++) {
+            dIter->second->dispatch(pvObject);
+        }
+        return;
+    }
+
     std::string pySubscriberName = this->subscriberName;
     if (pySubscriberName.size()) {
         // Single subscriber
@@ -890,6 +984,36 @@ void Channel::callSubscribers(PvObject& pvObject)
     }
 }
 
+// Must be called with subscriber mutex locked.
+void Channel::addSubscriberDispatcher(const std::string& subscriberName, const bp::object& pySubscriber)
+{
+    SubscriberDispatcher::shared_pointer dispatcherPtr(new SubscriberDispatcher(subscriberName, pySubscriber, subscriberQueueLength));
+    dispatcherPtr->setLatencyHistograms(gilWaitHistogramPtr, callbackHistogramPtr);
+    dispatcherPtr->setTimingEnabled(monitorTimingEnabled);
+    SubscriberDispatcher::start(dispatcherPtr);
+    subscriberDispatcherMap[subscriberName] = dispatcherPtr;
+}
+
+// Must be called with subscriber mutex locked.
+void Channel::removeSubscriberDispatcher(const std::string& subscriberName)
+{
+    std::map<std::string,SubscriberDispatcher::shared_pointer>::iterator it = subscriberDispatcherMap.find(subscriberName);
+    if (it != subscriberDispatcherMap.end()) {
+        it->second->stop();
+        subscriberDispatcherMap.erase(it);
+    }
+}
+
+void Channel::stopSubscriberDispatchers()
+{
+    pvd::Lock lock(subscriberMutex);
+    std::map<std::string,SubscriberDispatcher::shared_pointer>::iterator it;
+    for (it = subscriberDispatcherMap.begin(); it != subscriberDispatcherMap.end(); it++) {
+        it->second->stop();
+    }
+    subscriberDispatcherMap.clear();
+}
+
 void Channel::callSubscriber(const std::string& pySubscriberName, bp::object& pySubscriber, PvObject& pvObject)
 {
     // Acquire GIL. This is required because callSubscribers()
@@ -900,7 +1024,17 @@ void Channel::callSubscriber(const std::string& pySubscriberName, bp::object& py
     // attempting to release GIL.
     // PyGILState_STATE gilState = PyGILState_Ensure();
     // logger.trace("Acquiring python GIL for subscriber " + pySubscriberName);
+    bool recordTiming = monitorTimingEnabled;
+    epicsTimeStamp startTime;
+    if (recordTiming) {
+        epicsTimeGetCurrent(&startTime);
+    }
     PyGilManager::gilStateEnsure();
+    if (recordTiming) {
+        epicsTimeStamp gilTime;
+        epicsTimeGetCurrent(&gilTime);
+        gilWaitHistogramPtr->record(startTime, gilTime);
+    }
 
     // Call python code
     try {
@@ -919,6 +1053,88 @@ void Channel::callSubscriber(const std::string& pySubscriberName, bp::object& py
     // PyGILState_Release(gilState);
     // logger.trace("Releasing python GIL after processing monitor data with " + pySubscriberName);
     PyGilManager::gilStateRelease();
+    if (recordTiming) {
+        epicsTimeStamp endTime;
+        epicsTimeGetCurrent(&endTime);
+        callbackHistogramPtr->record(startTime, endTime);
+    }
+}
+
+void Channel::callSubscribers(std::vector<PvObject>& pvObjectBatch)
+{
+    std::map<std::string,bp::object> subscriberMap2;
+    std::string pySubscriberName = this->subscriberName;
+    if (pySubscriberName.size()) {
+        // Single subscriber
+        subscriberMap2[pySubscriberName] = this->subscriber;
+    }
+    else {
+        // Multiple subscribers
+        pvd::Lock lock(subscriberMutex);
+        subscriberMap2 = subscriberMap;
+    }
+
+    // Entire batch is delivered with a single GIL acquisition
+    bool recordTiming = monitorTimingEnabled;
+    epicsTimeStamp startTime;
+    if (recordTiming) {
+        epicsTimeGetCurrent(&startTime);
+    }
+    PyGilManager::gilStateEnsure();
+    if (recordTiming) {
+        epicsTimeStamp gilTime;
+        epicsTimeGetCurrent(&gilTime);
+        gilWaitHistogramPtr->record(startTime, gilTime);
+    }
+    try {
+        bp::list pyList;
+        for (std::vector<PvObject>::iterator it = pvObjectBatch.begin(); it != pvObjectBatch.end(); it++) {
+            pyList.append(*it);
+        }
+        std::map<std::string,bp::object>::iterator mIter;
+        for (mIter = subscriberMap2.begin(); mIter != subscriberMap2.end(); mIter++) {
+            callBatchSubscriber(mIter->first, mIter->second, pyList);
+        }
+    }
+    catch(const bp::error_already_set&) {
+        logger.error("Could not prepare monitor batch for channel subscribers.");
+        PyErr_Print();
+        PyErr_Clear();
+    }
+    PyGilManager::gilStateRelease();
+    if (recordTiming) {
+        epicsTimeStamp endTime;
+        epicsTimeGetCurrent(&endTime);
+        callbackHistogramPtr->record(startTime, endTime);
+    }
+}
+
+// Must be called with GIL held.
+void Channel::callBatchSubscriber(const std::string& pySubscriberName, bp::object& pySubscriber, bp::list& pyList)
+{
+    try {
+        pySubscriber(pyList);
+    }
+    catch(const bp::error_already_set&) {
+        logger.error("Channel subscriber " + pySubscriberName + " raised python exception.");
+        PyErr_Print();
+        PyErr_Clear();
+    }
+    catch (const std::exception& ex) {
+        logger.error(ex.what());
+    }
+}
+
+void Channel::updateBatchCounters(unsigned int batchSize)
+{
+    // Histogram buckets are keyed by powers of two
+    unsigned int bucket = 1;
+    while (bucket < batchSize) {
+        bucket <<= 1;
+    }
+    pvd::Lock lock(batchCounterMutex);
+    nBatches++;
+    batchSizeHistogram[bucket]++;
 }
 
 void Channel::callConnectionCallback(bool isConnected)
@@ -962,6 +1178,120 @@ void Channel::asyncPut(const PvObject& pvObject, const bp::object& pyCallback, c
     startAsyncPutThread();
 }
 
+void Channel::setAsyncRequestPipelineDepth(int depth)
+{
+    if (depth <= 0) {
+        throw InvalidArgument("Async request pipeline depth must be positive.");
+    }
+    asyncRequestPipelineDepth = depth;
+
+    // Request queues must be able to hold at least one full pipeline
+    asyncGetRequestQueue.setMaxLength(MaxAsyncRequestQueueLength + depth);
+    asyncPutRequestQueue.setMaxLength(MaxAsyncRequestQueueLength + depth);
+}
+
+int Channel::getAsyncRequestPipelineDepth() const
+{
+    return asyncRequestPipelineDepth;
+}
+
+// Issues get without waiting for completion; each request in flight
+// uses its own operation, so that gets can overlap on the network.
+Channel::AsyncOperation<pvc::PvaClientGetPtr> Channel::issueAsyncGet(const AsyncRequestPtr& asyncRequest)
+{
+    AsyncOperation<pvc::PvaClientGetPtr> asyncOperation(asyncRequest);
+    try {
+        pvd::Lock lock(asyncGetThreadMutex);
+        asyncConnect();
+        asyncOperation.pvaOperation = checkoutGetPtr(asyncRequest->requestDescriptor, asyncOperation.cacheGeneration);
+        asyncOperation.pvaOperation->issueGet();
+    }
+    catch (const std::exception& ex) {
+        asyncOperation.pvaOperation.reset();
+        asyncOperation.errorMessage = ex.what();
+    }
+    return asyncOperation;
+}
+
+void Channel::completeAsyncGet(AsyncOperation<pvc::PvaClientGetPtr>& asyncOperation)
+{
+    AsyncRequestPtr asyncRequest = asyncOperation.asyncRequest;
+    try {
+        // Cannot allow shutdown while callback is being executed
+        pvd::Lock lock(asyncGetThreadMutex);
+        if (!asyncOperation.pvaOperation) {
+            throw PvaException(asyncOperation.errorMessage);
+        }
+        pvd::Status status = asyncOperation.pvaOperation->waitGet();
+        if (!status.isOK()) {
+            throw PvaException(status.getMessage());
+        }
+        PvObject pvObject(pvd::getPVDataCreate()->createPVStructure(asyncOperation.pvaOperation->getData()->getPVStructure()));
+        checkinGetPtr(asyncRequest->requestDescriptor, asyncOperation.pvaOperation, asyncOperation.cacheGeneration);
+        if (!shutdownInProgress) {
+            logger.trace("Invoking async get callback");
+            invokePyCallback(asyncRequest->pyCallback, pvObject);
+        }
+    }
+    catch (const std::exception& ex) {
+        if (!shutdownInProgress && !PyUtility::isPyNone(asyncRequest->pyErrorCallback)) {
+            logger.trace("Invoking async get error callback");
+            invokePyCallback(asyncRequest->pyErrorCallback, ex.what());
+        }
+        else {
+            logger.error(ex.what());
+        }
+    }
+}
+
+Channel::AsyncOperation<pvc::PvaClientPutPtr> Channel::issueAsyncPut(const AsyncRequestPtr& asyncRequest)
+{
+    AsyncOperation<pvc::PvaClientPutPtr> asyncOperation(asyncRequest);
+    try {
+        pvd::Lock lock(asyncPutThreadMutex);
+        asyncConnect();
+        asyncOperation.pvaOperation = checkoutPutPtr(asyncRequest->requestDescriptor, asyncOperation.cacheGeneration);
+        preparePut(PvObject(asyncRequest->pvStructurePtr), asyncOperation.pvaOperation);
+        asyncOperation.pvaOperation->issuePut();
+    }
+    catch (const std::exception& ex) {
+        asyncOperation.pvaOperation.reset();
+        asyncOperation.errorMessage = ex.what();
+    }
+    return asyncOperation;
+}
+
+void Channel::completeAsyncPut(AsyncOperation<pvc::PvaClientPutPtr>& asyncOperation)
+{
+    AsyncRequestPtr asyncRequest = asyncOperation.asyncRequest;
+    try {
+        // Cannot allow shutdown while callback is being executed
+        pvd::Lock lock(asyncPutThreadMutex);
+        if (!asyncOperation.pvaOperation) {
+            throw PvaException(asyncOperation.errorMessage);
+        }
+        pvd::Status status = asyncOperation.pvaOperation->waitPut();
+        if (!status.isOK()) {
+            throw PvaException(status.getMessage());
+        }
+        PvObject pvObject(pvd::getPVDataCreate()->createPVStructure(asyncOperation.pvaOperation->getData()->getPVStructure()));
+        checkinPutPtr(asyncRequest->requestDescriptor, asyncOperation.pvaOperation, asyncOperation.cacheGeneration);
+        if (!shutdownInProgress) {
+            logger.trace("Invoking async put callback");
+            invokePyCallback(asyncRequest->pyCallback, pvObject);
+        }
+    }
+    catch (const std::exception& ex) {
+        if (!shutdownInProgress && !PyUtility::isPyNone(asyncRequest->pyErrorCallback)) {
+            logger.trace("Invoking async put error callback");
+            invokePyCallback(asyncRequest->pyErrorCallback, ex.what());
+        }
+        else {
+            logger.error(ex.what());
+        }
+    }
+}
+
 void Channel::invokePyCallback(bp::object& pyCallback, PvObject& pvObject)
 {
     if(PyUtility::isPyNone(pyCallback)) {
@@ -1004,8 +1334,13 @@ void Channel::invokePyCallback(bp::object& pyCallback, std::string errorMsg)
 
 void Channel::setMonitorMaxQueueLength(int maxLength)
 {
-    pvObjectQueue.setMaxLength(maxLength);
-    if (useInternalPvObjectQueue && maxLength != 0 && !processingThreadRunning) {
+    if (useInternalPvObjectQueue && maxLength == 0 && monitorActive && monitorBatchSize > 1) {
+        // Updates would bypass the queue and would not be batched
+        throw InvalidState("Monitor queue cannot be disabled for batched monitor.");
+    }
+    monitorQueueMaxLengthForced = false;
+    setInternalQueueMaxLength(maxLength);
+    if (useInternalPvObjectQueue && maxLength != 0 && !processingThreadRunning && !monitorSharedDispatch) {
         startProcessingThread();
     }
 }
@@ -1015,6 +1350,187 @@ int Channel::getMonitorMaxQueueLength()
     return pvObjectQueue.getMaxLength();
 }
 
+void Channel::setMonitorQueueLockFree(bool lockFree)
+{
+    pvd::Lock lock(monitorMutex);
+    if (monitorActive || processingThreadRunning) {
+        throw InvalidState("Monitor queue type cannot be changed while monitor is active.");
+    }
+    monitorQueueLockFree = lockFree;
+    setInternalQueueMaxLength(pvObjectQueue.getMaxLength());
+}
+
+// Pool holds copies that are queued, one that is being processed,
+// and one that is being made
+int Channel::getMonitorStructurePoolSize()
+{
+    int maxLength = pvObjectQueue.getMaxLength();
+    if (maxLength < 0) {
+        return PvStructurePool::DefaultMaxSize;
+    }
+    if (maxLength == 0) {
+        // Without monitor queue, copies are held by subscriber queues
+        maxLength = subscriberQueueLength;
+    }
+    return maxLength + 2;
+}
+
+// Copy is returned into the pool once released by all subscribers
+pvd::PVStructurePtr Channel::copyMonitorStructure(const pvd::PVStructurePtr& pvStructurePtr)
+{
+    if (!monitorStructurePtr) {
+        // Cache structure and allocate pool for copies on first update
+        monitorStructurePtr = pvStructurePtr->getStructure();
+        monitorStructurePoolPtr->setMaxSize(getMonitorStructurePoolSize());
+        monitorStructurePoolPtr->preallocate(monitorStructurePtr);
+    }
+    return monitorStructurePoolPtr->copy(*pvStructurePtr);
+}
+
+bool Channel::isMonitorQueueLockFree() const
+{
+    return monitorQueueLockFree;
+}
+
+void Channel::setMonitorSubscriberQueueLength(int maxLength)
+{
+    if (maxLength < 0) {
+        throw InvalidArgument("Subscriber queue length cannot be negative.");
+    }
+    pvd::Lock lock(monitorMutex);
+    if (monitorActive) {
+        throw InvalidState("Subscriber dispatch mode cannot be changed while monitor is active.");
+    }
+    stopSubscriberDispatchers();
+    pvd::Lock lock2(subscriberMutex);
+    subscriberQueueLength = maxLength;
+    if (subscriberQueueLength > 0) {
+        if (subscriberName.size()) {
+            addSubscriberDispatcher(subscriberName, subscriber);
+        }
+        std::map<std::string,bp::object>::iterator it;
+        for (it = subscriberMap.begin(); it != subscriberMap.end(); it++) {
+            addSubscriberDispatcher(it->first, it->second);
+        }
+    }
+}
+
+int Channel::getMonitorSubscriberQueueLength() const
+{
+    return subscriberQueueLength;
+}
+
+void Channel::setMonitorSharedDispatch(bool sharedDispatch)
+{
+    pvd::Lock lock(monitorMutex);
+    if (monitorActive || processingThreadRunning) {
+        throw InvalidState("Monitor dispatch mode cannot be changed while monitor is active.");
+    }
+    if (sharedDispatch && monitorBatchSize > 1) {
+        throw InvalidState("Batched monitor cannot be used with shared dispatcher.");
+    }
+    monitorSharedDispatch = sharedDispatch;
+    if (!monitorSharedDispatch) {
+        MonitorDispatcher::unregisterClient(this);
+    }
+}
+
+bool Channel::isMonitorSharedDispatch() const
+{
+    return monitorSharedDispatch;
+}
+
+void Channel::setMonitorTimingEnabled(bool timingEnabled)
+{
+    pvd::Lock lock(monitorMutex);
+    if (monitorActive || processingThreadRunning) {
+        throw InvalidState("Monitor timing cannot be enabled or disabled while monitor is active.");
+    }
+    monitorTimingEnabled = timingEnabled;
+    clearMonitorQueueTimeStamps();
+    pvd::Lock lock2(subscriberMutex);
+    std::map<std::string,SubscriberDispatcher::shared_pointer>::iterator it;
+    for (it = subscriberDispatcherMap.begin(); it != subscriberDispatcherMap.end(); it++) {
+        it->second->setTimingEnabled(timingEnabled);
+    }
+}
+
+bool Channel::isMonitorTimingEnabled() const
+{
+    return monitorTimingEnabled;
+}
+
+void Channel::resetMonitorLatencyHistograms()
+{
+    eventToPushHistogramPtr->reset();
+    queueWaitHistogramPtr->reset();
+    gilWaitHistogramPtr->reset();
+    callbackHistogramPtr->reset();
+}
+
+bp::dict Channel::getMonitorLatencyHistograms()
+{
+    bp::dict pyDict;
+    pyDict[PvaPyConstants::EventToPushLatencyKey] = eventToPushHistogramPtr->toDict();
+    pyDict[PvaPyConstants::QueueWaitLatencyKey] = queueWaitHistogramPtr->toDict();
+    pyDict[PvaPyConstants::GilWaitLatencyKey] = gilWaitHistogramPtr->toDict();
+    pyDict[PvaPyConstants::CallbackLatencyKey] = callbackHistogramPtr->toDict();
+    return pyDict;
+}
+
+// Called by internal queue consumer after each pop.
+void Channel::recordMonitorQueueWait()
+{
+    if (!monitorTimingEnabled || !useInternalPvObjectQueue) {
+        return;
+    }
+    epicsTimeStamp pushTime;
+    if (!monitorQueueTimeStampRing.take(pushTime)) {
+        return;
+    }
+    epicsTimeStamp now;
+    epicsTimeGetCurrent(&now);
+    queueWaitHistogramPtr->record(pushTime, now);
+}
+
+void Channel::clearMonitorQueueTimeStamps()
+{
+    monitorQueueTimeStampRing.reset();
+}
+
+// Lock-free queue has fixed capacity, so internal queue gets recreated
+// with the new length while it is not in use; monitor callback is the
+// only producer, and processing thread the only consumer.
+void Channel::setInternalQueueMaxLength(int maxLength)
+{
+    if (useInternalPvObjectQueue && !monitorActive && !processingThreadRunning) {
+        bool lockFree = monitorQueueLockFree && maxLength > 0;
+        if (lockFree || pvObjectQueue.isLockFree()) {
+            pvObjectQueue = PvObjectQueue(maxLength, lockFree);
+            return;
+        }
+    }
+    pvObjectQueue.setMaxLength(maxLength);
+}
+
+// Queue length that was set only because batching or shared dispatch
+// requires queue is restored once monitor is stopped and queue
+// consumer is done; queue is recreated, so this is called either when
+// there is no consumer, or by the consumer itself.
+void Channel::restoreMonitorQueueMaxLength(bool isQueueConsumer)
+{
+    pvd::Lock lock(monitorMutex);
+    if (!monitorQueueMaxLengthForced || monitorActive || !useInternalPvObjectQueue) {
+        return;
+    }
+    if (!isQueueConsumer && (processingThreadRunning || monitorSharedDispatch)) {
+        // Consumer will restore queue length when it exits
+        return;
+    }
+    monitorQueueMaxLengthForced = false;
+    pvObjectQueue = PvObjectQueue(0);
+}
+
 void Channel::startMonitor()
 {
     startMonitor(defaultRequestDescriptor);
@@ -1034,10 +1550,19 @@ void Channel::startMonitor(const std::string& requestDescriptor)
     // PyEval_InitThreads();
     PyGilManager::evalInitThreads();
     this->monitorRequestDescriptor = requestDescriptor;
+    clearMonitorQueueTimeStamps();
 
     // Unless internal queue is used, and queue length is not zero, 
-    // there is no need for processing thread.
-    if (useInternalPvObjectQueue && pvObjectQueue.getMaxLength() != 0 && !processingThreadRunning) {
+    // there is no need for processing thread. Shared dispatcher
+    // always services internal queue.
+    if (useInternalPvObjectQueue && monitorSharedDispatch) {
+        if (pvObjectQueue.getMaxLength() == 0) {
+            setInternalQueueMaxLength(MonitorDispatchQueueLength);
+            monitorQueueMaxLengthForced = true;
+        }
+        MonitorDispatcher::registerClient(this);
+    }
+    else if (useInternalPvObjectQueue && pvObjectQueue.getMaxLength() != 0 && !processingThreadRunning) {
         startProcessingThread();
     }
 
@@ -1053,7 +1578,14 @@ void Channel::startMonitor(const std::string& requestDescriptor)
     }
 }
 
+#ifdef WINDOWS
 void Channel::monitor(const bp::object& pySubscriber, const std::string& requestDescriptor)
+{
+    monitor(pySubscriber, requestDescriptor, 0, DefaultMonitorMaxBatchLatency);
+}
+#endif
+
+void Channel::monitor(const bp::object& pySubscriber, const std::string& requestDescriptor, int batchSize, double maxLatency)
 {
     // Unsubscribe default subscriber.
     try {
@@ -1063,6 +1595,26 @@ void Channel::monitor(const bp::object& pySubscriber, const std::string& request
         // ok
     }
 
+    if (batchSize < 0) {
+        throw InvalidArgument("Monitor batch size cannot be negative.");
+    }
+    if (maxLatency < 0) {
+        throw InvalidArgument("Monitor batch latency cannot be negative.");
+    }
+    if (batchSize > 1 && subscriberQueueLength > 0) {
+        throw InvalidArgument("Batched monitor cannot be used with per-subscriber queues.");
+    }
+    if (batchSize > 1 && monitorSharedDispatch) {
+        throw InvalidArgument("Batched monitor cannot be used with shared dispatcher.");
+    }
+    monitorBatchSize = batchSize;
+    monitorMaxBatchLatency = maxLatency;
+    if (monitorBatchSize > 1 && pvObjectQueue.getMaxLength() == 0) {
+        // Batching requires monitor queue and processing thread
+        setInternalQueueMaxLength(MonitorBatchQueueLengthFactor*monitorBatchSize);
+        monitorQueueMaxLengthForced = true;
+    }
+
     subscribe(DefaultSubscriberName, pySubscriber);
     if (requestDescriptor == PvaConstants::DefaultKey) {
         startMonitor();
@@ -1097,6 +1649,18 @@ void Channel::resetMonitorCounters()
         ChannelMonitorRequesterImpl* requesterImpl = static_cast<ChannelMonitorRequesterImpl*>(pvaClientMonitorRequesterPtr.get());
         requesterImpl->resetCounters();
     }
+    monitorStructurePoolPtr->resetCounters();
+    resetMonitorLatencyHistograms();
+    {
+        pvd::Lock lock(subscriberMutex);
+        std::map<std::string,SubscriberDispatcher::shared_pointer>::iterator it;
+        for (it = subscriberDispatcherMap.begin(); it != subscriberDispatcherMap.end(); it++) {
+            it->second->resetCounters();
+        }
+    }
+    pvd::Lock lock(batchCounterMutex);
+    nBatches = 0;
+    batchSizeHistogram.clear();
 }
 
 bp::dict Channel::getMonitorCounters()
@@ -1107,6 +1671,29 @@ bp::dict Channel::getMonitorCounters()
         pyDict[PvaPyConstants::NumReceivedCounterKey] = requesterImpl->getNumReceived();
         pyDict[PvaPyConstants::NumOverrunsCounterKey] = requesterImpl->getNumOverruns();
     }
+    if (monitorBatchSize > 1 || nBatches > 0) {
+        pvd::Lock lock(batchCounterMutex);
+        pyDict[PvaPyConstants::NumBatchesCounterKey] = nBatches;
+        pyDict[PvaPyConstants::BatchSizeHistogramKey] = PyUtility::mapToDict<unsigned int,unsigned int>(batchSizeHistogram);
+    }
+    if (!useInternalPvObjectQueue || pvObjectQueue.getMaxLength() != 0) {
+        // Monitor copies are made only for queued updates
+        const std::map<std::string,unsigned int>& poolCounterMap = monitorStructurePoolPtr->getCounterMap();
+        typedef std::map<std::string,unsigned int>::const_iterator MI;
+        for (MI it = poolCounterMap.begin(); it != poolCounterMap.end(); it++) {
+            pyDict[it->first] = it->second;
+        }
+    }
+    if (subscriberQueueLength > 0) {
+        // Per-subscriber drop and lag counters
+        bp::dict subscriberDict;
+        pvd::Lock lock(subscriberMutex);
+        std::map<std::string,SubscriberDispatcher::shared_pointer>::iterator it;
+        for (it = subscriberDispatcherMap.begin(); it != subscriberDispatcherMap.end(); it++) {
+            subscriberDict[it->first] = PyUtility::mapToDict<std::string,unsigned int>(it->second->getCounterMap());
+        }
+        pyDict[PvaPyConstants::SubscriberCountersKey] = subscriberDict;
+    }
     return pyDict;
 }
 
@@ -1115,7 +1702,12 @@ void Channel::startProcessingThread()
     pvd::Lock lock(processingThreadMutex);
     if (!processingThreadRunning) {
         processingThreadRunning = true;
-        epicsThreadCreate("ProcessingThread", epicsThreadPriorityLow, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)processingThread, this);
+        if (monitorBatchSize > 1) {
+            epicsThreadCreate("BatchProcessingThread", epicsThreadPriorityLow, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)batchProcessingThread, this);
+        }
+        else {
+            epicsThreadCreate("ProcessingThread", epicsThreadPriorityLow, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)processingThread, this);
+        }
     }
     else {
         logger.warn("Processing thread is already running.");
@@ -1149,6 +1741,7 @@ void Channel::stopMonitor()
     // Processing thread should exit after monitorActive is set to false
     monitorActive = false;
     monitorRunning = false;
+    monitorBatchSize = 0;
     logger.debug("Stopping monitor");
     if (pvaClientMonitorRequesterPtr) {
         pvaClientMonitorRequesterPtr->unlisten();
@@ -1162,6 +1755,18 @@ void Channel::stopMonitor()
         }
     }
     pvObjectQueue.cancelWaitForItemPushed();
+    if (monitorSharedDispatch) {
+        // Dispatcher clears queue
+        MonitorDispatcher::schedule(this);
+    }
+    restoreMonitorQueueMaxLength(false);
+
+    // Updates that were not delivered yet are discarded
+    pvd::Lock lock2(subscriberMutex);
+    std::map<std::string,SubscriberDispatcher::shared_pointer>::iterator it;
+    for (it = subscriberDispatcherMap.begin(); it != subscriberDispatcherMap.end(); it++) {
+        it->second->clear();
+    }
 }
 
 void Channel::processingThread(Channel* channel)
@@ -1176,6 +1781,7 @@ void Channel::processingThread(Channel* channel)
         // Handle possible exceptions while retrieving data from empty queue.
         try {
             PvObject pvObject = channel->pvObjectQueue.frontAndPop(channel->timeout);
+            channel->recordMonitorQueueWait();
             if (!channel->monitorActive) {
                 break;
             }
@@ -1193,6 +1799,70 @@ void Channel::processingThread(Channel* channel)
     // Processing thread done.
     logger.debug("Exiting monitor data processing thread %s", epicsThreadGetNameSelf());
     channel->pvObjectQueue.clear();
+    channel->clearMonitorQueueTimeStamps();
+    channel->restoreMonitorQueueMaxLength(true);
+    channel->notifyProcessingThreadExit();
+    channel->processingThreadRunning = false;
+}
+
+void Channel::batchProcessingThread(Channel* channel)
+{
+    channel->processingThreadRunning = true;
+    logger.debug("Started monitor data batch processing thread %s", epicsThreadGetNameSelf());
+    std::vector<PvObject> pvObjectBatch;
+    while (true) {
+        if (!channel->monitorActive) {
+            break;
+        }
+
+        // Handle possible exceptions while retrieving data from empty queue.
+        try {
+            unsigned int batchSize = channel->monitorBatchSize;
+            pvObjectBatch.clear();
+            pvObjectBatch.reserve(batchSize);
+            pvObjectBatch.push_back(channel->pvObjectQueue.frontAndPop(channel->timeout));
+            channel->recordMonitorQueueWait();
+
+            // Drain queue until batch is full, or until maximum latency
+            // after the first object in the batch expires
+            epicsTimeStamp batchStartTime;
+            epicsTimeGetCurrent(&batchStartTime);
+            while (pvObjectBatch.size() < batchSize && channel->monitorActive) {
+                try {
+                    pvObjectBatch.push_back(channel->pvObjectQueue.frontAndPop());
+                    channel->recordMonitorQueueWait();
+                }
+                catch (QueueEmpty& ex) {
+                    epicsTimeStamp now;
+                    epicsTimeGetCurrent(&now);
+                    double remainingTime = channel->monitorMaxBatchLatency - epicsTimeDiffInSeconds(&now, &batchStartTime);
+                    if (remainingTime <= 0) {
+                        break;
+                    }
+                    channel->pvObjectQueue.waitForItemPushedIfEmpty(remainingTime);
+                }
+            }
+            if (!channel->monitorActive) {
+                break;
+            }
+            channel->updateBatchCounters(pvObjectBatch.size());
+            channel->callSubscribers(pvObjectBatch);
+        }
+        catch (QueueEmpty& ex) {
+            // Queue empty, no PV changes received.
+        }
+        catch (const std::exception& ex) {
+            // Not good.
+            logger.error("Monitor data batch processing thread caught exception: %s", ex.what());
+        }
+    }
+
+    // Processing thread done.
+    logger.debug("Exiting monitor data batch processing thread %s", epicsThreadGetNameSelf());
+    pvObjectBatch.clear();
+    channel->pvObjectQueue.clear();
+    channel->clearMonitorQueueTimeStamps();
+    channel->restoreMonitorQueueMaxLength(true);
     channel->notifyProcessingThreadExit();
     channel->processingThreadRunning = false;
 }
@@ -1209,11 +1879,24 @@ void Channel::issueConnectThread(Channel* channel)
 //
 void Channel::processMonitorData(pvd::PVStructurePtr pvStructurePtr)
 {
+    bool recordTiming = monitorTimingEnabled;
+    epicsTimeStamp eventTime;
+    if (recordTiming) {
+        epicsTimeGetCurrent(&eventTime);
+    }
     if (useInternalPvObjectQueue && pvObjectQueue.getMaxLength() == 0) {
         // Process object directly
         try {
-            PvObject pvObject(pvStructurePtr);
-            callSubscribers(pvObject);
+            if (subscriberQueueLength > 0) {
+                // Subscriber queues hold updates after monitor element
+                // is released and reused by pvAccess, so they need a copy
+                PvObject pvObject(copyMonitorStructure(pvStructurePtr));
+                callSubscribers(pvObject);
+            }
+            else {
+                PvObject pvObject(pvStructurePtr);
+                callSubscribers(pvObject);
+            }
         }
         catch (const std::exception& ex) {
             // Not good.
@@ -1223,16 +1906,27 @@ void Channel::processMonitorData(pvd::PVStructurePtr pvStructurePtr)
     else {
         // Copy and queue object if possible.
         // It will be either processed by internal thread, or elsewhere.
-        if (!monitorStructurePtr) {
-            // Cache structure on first update
-            monitorStructurePtr = pvStructurePtr->getStructure();
+        PvObject pvObject(copyMonitorStructure(pvStructurePtr));
+        bool recordPushTime = recordTiming && useInternalPvObjectQueue;
+        epicsTimeStamp pushTime;
+        if (recordTiming) {
+            epicsTimeGetCurrent(&pushTime);
+            eventToPushHistogramPtr->record(eventTime, pushTime);
+        }
+        if (recordPushTime) {
+            // Push time must be available before consumer can pop the update
+            monitorQueueTimeStampRing.put(pushTime);
         }
-        pvd::PVStructurePtr pvStructurePtr2(pvd::getPVDataCreate()->createPVStructure(monitorStructurePtr));
-        pvStructurePtr2->copyUnchecked(*pvStructurePtr); // copy
-        PvObject pvObject(pvStructurePtr2);
         bool isPushed = pvObjectQueue.pushIfNotFull(pvObject);
+        if (isPushed && recordPushTime) {
+            // This is the only producer
+            monitorQueueTimeStampRing.commit();
+        }
         if (isPushed) {
             logger.trace("Pushed new monitor element into the queue: %d elements have not been processed.", pvObjectQueue.size());
+            if (monitorSharedDispatch && useInternalPvObjectQueue) {
+                MonitorDispatcher::schedule(this);
+            }
         }
         else {
             logger.trace("Could not push new monitor element into the full queue: %d elements have not been processed.", pvObjectQueue.size());
@@ -1243,6 +1937,8 @@ void Channel::processMonitorData(pvd::PVStructurePtr pvStructurePtr)
 void Channel::onChannelConnect()
 {
     logger.debug("On channel connect called for %s", getName().c_str());
+    // Channel structure may have changed while disconnected
+    invalidateOperationCache();
     if (monitorActive && !monitorRunning) {
         try {
             pvaClientMonitorRequesterPtr = pvc::PvaClientMonitorRequesterPtr(new ChannelMonitorRequesterImpl(getName(), this));
@@ -1278,12 +1974,52 @@ void Channel::onChannelDisconnect()
         callConnectionCallback(false);
     }
     monitorStructurePtr = pvd::StructureConstPtr();
+    monitorStructurePoolPtr->clear();
+    invalidateOperationCache();
 }
 
 void Channel::onMonitorOverrun(epics::pvData::BitSetPtr bitSetPtr)
 {
 }
 
+//
+// Shared monitor dispatcher interface
+//
+std::string Channel::getDispatchName() const
+{
+    return getName();
+}
+
+unsigned int Channel::getDispatchQueueSize()
+{
+    return pvObjectQueue.size();
+}
+
+// Dispatcher calls this method from one worker thread at a time,
+// so it is the only consumer of the internal queue.
+unsigned int Channel::dispatchUpdates(unsigned int maxUpdates)
+{
+    unsigned int nDispatched = 0;
+    while (nDispatched < maxUpdates) {
+        if (!monitorActive) {
+            pvObjectQueue.clear();
+            clearMonitorQueueTimeStamps();
+            restoreMonitorQueueMaxLength(true);
+            break;
+        }
+        try {
+            PvObject pvObject = pvObjectQueue.frontAndPop();
+            recordMonitorQueueWait();
+            callSubscribers(pvObject);
+            nDispatched++;
+        }
+        catch (QueueEmpty& ex) {
+            break;
+        }
+    }
+    return nDispatched;
+}
+
 // Introspection
 bp::dict Channel::getIntrospectionDict()
 {
@@ -1372,6 +2108,96 @@ pvc::PvaClientPutGetPtr Channel::createPutGetPtr(const std::string& requestDescr
     }
 }
 
+// Operation cache methods
+// Cached operations are keyed by the resolved request descriptor, so that
+// changes of the default request descriptor do not result in stale entries.
+
+pvc::PvaClientGetPtr Channel::checkoutGetPtr(const std::string& requestDescriptor, unsigned int& cacheGeneration)
+{
+    std::string cacheKey = (requestDescriptor == PvaConstants::DefaultKey ? defaultRequestDescriptor : requestDescriptor);
+    pvc::PvaClientGetPtr pvaGet = getCache.checkout(cacheKey, cacheGeneration);
+    if (!pvaGet) {
+        pvaGet = createGetPtr(requestDescriptor);
+    }
+    return pvaGet;
+}
+
+void Channel::checkinGetPtr(const std::string& requestDescriptor, const pvc::PvaClientGetPtr& pvaGet, unsigned int cacheGeneration)
+{
+    std::string cacheKey = (requestDescriptor == PvaConstants::DefaultKey ? defaultRequestDescriptor : requestDescriptor);
+    getCache.checkin(cacheKey, pvaGet, cacheGeneration);
+}
+
+pvc::PvaClientPutPtr Channel::checkoutPutPtr(const std::string& requestDescriptor, unsigned int& cacheGeneration)
+{
+    std::string cacheKey = (requestDescriptor == PvaConstants::DefaultKey ? defaultRequestDescriptor : requestDescriptor);
+    pvc::PvaClientPutPtr pvaPut = putCache.checkout(cacheKey, cacheGeneration);
+    if (!pvaPut) {
+        return createPutPtr(requestDescriptor);
+    }
+    // Make sure only fields modified by this put are sent to the server
+    pvaPut->getData()->getChangedBitSet()->clear();
+    return pvaPut;
+}
+
+void Channel::checkinPutPtr(const std::string& requestDescriptor, const pvc::PvaClientPutPtr& pvaPut, unsigned int cacheGeneration)
+{
+    std::string cacheKey = (requestDescriptor == PvaConstants::DefaultKey ? defaultRequestDescriptor : requestDescriptor);
+    putCache.checkin(cacheKey, pvaPut, cacheGeneration);
+}
+
+pvc::PvaClientPutGetPtr Channel::checkoutPutGetPtr(const std::string& requestDescriptor, unsigned int& cacheGeneration)
+{
+    std::string cacheKey = (requestDescriptor == PvaConstants::DefaultKey ? defaultPutGetRequestDescriptor : requestDescriptor);
+    pvc::PvaClientPutGetPtr pvaPutGet = putGetCache.checkout(cacheKey, cacheGeneration);
+    if (!pvaPutGet) {
+        return createPutGetPtr(requestDescriptor);
+    }
+    pvaPutGet->getPutData()->getChangedBitSet()->clear();
+    return pvaPutGet;
+}
+
+void Channel::checkinPutGetPtr(const std::string& requestDescriptor, const pvc::PvaClientPutGetPtr& pvaPutGet, unsigned int cacheGeneration)
+{
+    std::string cacheKey = (requestDescriptor == PvaConstants::DefaultKey ? defaultPutGetRequestDescriptor : requestDescriptor);
+    putGetCache.checkin(cacheKey, pvaPutGet, cacheGeneration);
+}
+
+void Channel::invalidateOperationCache()
+{
+    getCache.clear();
+    putCache.clear();
+    putGetCache.clear();
+}
+
+void Channel::setOperationCacheSize(int maxSize)
+{
+    getCache.setMaxSize(maxSize);
+    putCache.setMaxSize(maxSize);
+    putGetCache.setMaxSize(maxSize);
+}
+
+int Channel::getOperationCacheSize()
+{
+    return getCache.getMaxSize();
+}
+
+void Channel::resetOperationCacheCounters()
+{
+    getCache.resetCounters();
+    putCache.resetCounters();
+    putGetCache.resetCounters();
+}
+
+bp::dict Channel::getOperationCacheCounters()
+{
+    bp::dict pyDict;
+    pyDict["get"] = PyUtility::mapToDict<std::string,unsigned int>(getCache.getCounterMap());
+    pyDict["put"] = PyUtility::mapToDict<std::string,unsigned int>(putCache.getCounterMap());
+    pyDict["putGet"] = PyUtility::mapToDict<std::string,unsigned int>(putGetCache.getCounterMap());
+    return pyDict;
+}
+
 void Channel::setConnectionCallback(const bp::object& callback)
 {
     connectionCallback = callback;
@@ -1398,41 +2224,38 @@ void Channel::asyncGetThread(Channel* channel)
     }
     logger.debug("Started async get thread %s", epicsThreadGetNameSelf());
     float remainingRuntime = MaxAsyncRequestWaitTimeout;
+    std::deque<AsyncOperation<pvc::PvaClientGetPtr> > inFlightQueue;
     while (true) {
         if (channel->shutdownInProgress) {
             pvd::Lock lock(channel->asyncGetThreadMutex);
             logger.debug("Exiting async get thread %s due to shutdown", epicsThreadGetNameSelf());
+            inFlightQueue.clear();
             channel->asyncGetThreadRunning = false;
             break;
         }
 
         try {
-            AsyncRequestPtr asyncRequest = channel->asyncGetRequestQueue.frontAndPop();
-
-            // there were queued requests, reset poll counter
-            remainingRuntime = MaxAsyncRequestWaitTimeout;
-            try {
-                // Cannot allow shutdown while callback is being executed
-                pvd::Lock lock(channel->asyncGetThreadMutex);
-
-                channel->asyncConnect();
-                pvc::PvaClientGetPtr asyncPvaGet = channel->createGetPtr(asyncRequest->requestDescriptor);
-                asyncPvaGet->get();
-                PvObject pvObject(asyncPvaGet->getData()->getPVStructure());
-                if (!channel->shutdownInProgress) {
-                    logger.trace("Invoking async get callback");
-                    channel->invokePyCallback(asyncRequest->pyCallback, pvObject);
-                }
-            }
-            catch (const std::exception& ex) {
-                if (!channel->shutdownInProgress && !PyUtility::isPyNone(asyncRequest->pyErrorCallback)) {
-                    logger.trace("Invoking async get error callback");
-                    channel->invokePyCallback(asyncRequest->pyErrorCallback, ex.what());
+            // Issue new requests while pipeline is not full; if there are
+            // no requests in flight, wait for new requests
+            while (int(inFlightQueue.size()) < channel->asyncRequestPipelineDepth) {
+                AsyncRequestPtr asyncRequest;
+                try {
+                    asyncRequest = channel->asyncGetRequestQueue.frontAndPop();
                 }
-                else {
-                    logger.error(ex.what());
+                catch (QueueEmpty& ex) {
+                    if (inFlightQueue.empty()) {
+                        throw;
+                    }
+                    break;
                 }
+                // there were queued requests, reset poll counter
+                remainingRuntime = MaxAsyncRequestWaitTimeout;
+                inFlightQueue.push_back(channel->issueAsyncGet(asyncRequest));
             }
+
+            // Requests complete in the order they were issued
+            channel->completeAsyncGet(inFlightQueue.front());
+            inFlightQueue.pop_front();
         }
         catch (QueueEmpty& ex) {
             // Queue empty.
@@ -1495,42 +2318,38 @@ void Channel::asyncPutThread(Channel* channel)
     }
     logger.debug("Started async put thread %s", epicsThreadGetNameSelf());
     float remainingRuntime = MaxAsyncRequestWaitTimeout;
+    std::deque<AsyncOperation<pvc::PvaClientPutPtr> > inFlightQueue;
     while (true) {
         if (channel->shutdownInProgress) {
             pvd::Lock lock(channel->asyncPutThreadMutex);
             logger.debug("Exiting async put thread %s due to shutdown", epicsThreadGetNameSelf());
+            inFlightQueue.clear();
             channel->asyncPutThreadRunning = false;
             break;
         }
 
         try {
-            AsyncRequestPtr asyncRequest = channel->asyncPutRequestQueue.frontAndPop();
-
-            // there were queued requests, reset poll counter
-            remainingRuntime = MaxAsyncRequestWaitTimeout;
-            try {
-                // Cannot allow shutdown while callback is being executed
-                pvd::Lock lock(channel->asyncPutThreadMutex);
-
-                channel->asyncConnect();
-                pvc::PvaClientPutPtr asyncPvaPut = channel->createPutPtr(asyncRequest->requestDescriptor);
-                channel->preparePut(PvObject(asyncRequest->pvStructurePtr), asyncPvaPut);
-                asyncPvaPut->put();
-                PvObject pvObject(asyncPvaPut->getData()->getPVStructure());
-                if (!channel->shutdownInProgress) {
-                    logger.trace("Invoking async put callback");
-                    channel->invokePyCallback(asyncRequest->pyCallback, pvObject);
-                }
-            }
-            catch (const std::exception& ex) {
-                if (!channel->shutdownInProgress && !PyUtility::isPyNone(asyncRequest->pyErrorCallback)) {
-                    logger.trace("Invoking async put error callback");
-                    channel->invokePyCallback(asyncRequest->pyErrorCallback, ex.what());
+            // Issue new requests while pipeline is not full; if there are
+            // no requests in flight, wait for new requests
+            while (int(inFlightQueue.size()) < channel->asyncRequestPipelineDepth) {
+                AsyncRequestPtr asyncRequest;
+                try {
+                    asyncRequest = channel->asyncPutRequestQueue.frontAndPop();
                 }
-                else {
-                    logger.error(ex.what());
+                catch (QueueEmpty& ex) {
+                    if (inFlightQueue.empty()) {
+                        throw;
+                    }
+                    break;
                 }
+                // there were queued requests, reset poll counter
+                remainingRuntime = MaxAsyncRequestWaitTimeout;
+                inFlightQueue.push_back(channel->issueAsyncPut(asyncRequest));
             }
+
+            // Requests complete in the order they were issued
+            channel->completeAsyncPut(inFlightQueue.front());
+            inFlightQueue.pop_front();
         }
         catch (QueueEmpty& ex) {
             // Queue empty.
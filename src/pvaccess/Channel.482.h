@@ -7,6 +7,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <deque>
 
 #include "boost/python/list.hpp"
 #include "boost/python/dict.hpp"
@@ -19,7 +20,13 @@
 #include "ChannelMonitorDataProcessor.h"
 #include "ChannelRequesterImpl.h"
 #include "SynchronizedQueue.h"
+#include "ChannelOperationCache.h"
 #include "PvObjectQueue.h"
+#include "PvStructurePool.h"
+#include "LatencyHistogram.h"
+#include "TimeStampRing.h"
+#include "SubscriberDispatcher.h"
+#include "MonitorDispatchClient.h"
 #include "PvaClient.h"
 #include "CaClient.h"
 #include "PvObject.h"
@@ -31,7 +38,7 @@
 #define Py_REFCNT(o)  (((PyObject*)(o))->ob_refcnt)
 #endif
 
-class Channel : public ChannelMonitorDataProcessor
+class Channel : public ChannelMonitorDataProcessor, public MonitorDispatchClient
 {
 public:
 
@@ -41,6 +48,11 @@ public:
     static const int MaxAsyncRequestQueueLength;
     static const int MaxAsyncRequestWaitTimeout;
     static const int AsyncRequestThreadWaitTimeout;
+    static const int DefaultAsyncRequestPipelineDepth;
+    static const int DefaultOperationCacheSize;
+    static const double DefaultMonitorMaxBatchLatency;
+    static const int MonitorBatchQueueLengthFactor;
+    static const int MonitorDispatchQueueLength;
 
     Channel(const std::string& channelName, PvProvider::ProviderType providerType=PvProvider::PvaProviderType);
     Channel(const Channel& channel);
@@ -143,12 +155,14 @@ public:
     virtual void unsubscribe(const std::string& subscriberName);
 
     virtual void callSubscribers(PvObject& pvObject);
+    virtual void callSubscribers(std::vector<PvObject>& pvObjectBatch);
     virtual void startMonitor(const std::string& requestDescriptor);
     virtual void startMonitor();
 #ifndef WINDOWS
-    virtual void monitor(const boost::python::object& pySubscriber, const std::string& requestDescriptor=PvaConstants::DefaultKey);
+    virtual void monitor(const boost::python::object& pySubscriber, const std::string& requestDescriptor=PvaConstants::DefaultKey, int batchSize=0, double maxLatency=DefaultMonitorMaxBatchLatency);
 #else
     virtual void monitor(const boost::python::object& pySubscriber, const std::string& requestDescriptor);
+    virtual void monitor(const boost::python::object& pySubscriber, const std::string& requestDescriptor, int batchSize, double maxLatency);
 #endif
     virtual void monitor(PvObjectQueue& pyObjectQueue);
     virtual void monitor(PvObjectQueue& pyObjectQueue, const std::string& requestDescriptor);
@@ -165,6 +179,28 @@ public:
     virtual std::string getDefaultPutGetRequestDescriptor() const;
     virtual void setMonitorMaxQueueLength(int maxLength);
     virtual int getMonitorMaxQueueLength();
+    virtual void setMonitorQueueLockFree(bool lockFree);
+    virtual bool isMonitorQueueLockFree() const;
+    virtual void setMonitorSubscriberQueueLength(int maxLength);
+    virtual int getMonitorSubscriberQueueLength() const;
+    virtual void setMonitorSharedDispatch(bool sharedDispatch);
+    virtual bool isMonitorSharedDispatch() const;
+
+    // Monitor latency histograms
+    virtual void setMonitorTimingEnabled(bool timingEnabled);
+    virtual bool isMonitorTimingEnabled() const;
+    virtual void resetMonitorLatencyHistograms();
+    virtual boost::python::dict getMonitorLatencyHistograms();
+
+    // Number of async get/put requests that may be in flight at the same time
+    virtual void setAsyncRequestPipelineDepth(int depth);
+    virtual int getAsyncRequestPipelineDepth() const;
+
+    // Get/put/putGet operation cache
+    virtual void setOperationCacheSize(int maxSize);
+    virtual int getOperationCacheSize();
+    virtual void resetOperationCacheCounters();
+    virtual boost::python::dict getOperationCacheCounters();
 
     // Monitor data processing interface
     virtual void processMonitorData(epics::pvData::PVStructurePtr pvStructurePtr);
@@ -174,6 +210,11 @@ public:
     virtual void callConnectionCallback(bool isConnected);
     virtual bool isChannelConnected();
 
+    // Shared monitor dispatcher interface
+    virtual std::string getDispatchName() const;
+    virtual unsigned int getDispatchQueueSize();
+    virtual unsigned int dispatchUpdates(unsigned int maxUpdates);
+
     // Introspection
     virtual boost::python::dict getIntrospectionDict();
 
@@ -187,9 +228,14 @@ private:
     static CaClient caClient;
 
     static void processingThread(Channel* channel);
+    static void batchProcessingThread(Channel* channel);
     static void issueConnectThread(Channel* channel);
 
     void startProcessingThread();
+    void setInternalQueueMaxLength(int maxLength);
+    void restoreMonitorQueueMaxLength(bool isQueueConsumer);
+    int getMonitorStructurePoolSize();
+    epics::pvData::PVStructurePtr copyMonitorStructure(const epics::pvData::PVStructurePtr& pvStructurePtr);
     void startIssueConnectThread();
     void waitForProcessingThreadExit(double timeout);
     void notifyProcessingThreadExit();
@@ -201,7 +247,19 @@ private:
     epics::pvaClient::PvaClientPutPtr createPutPtr(const std::string& requestDescriptor);
     epics::pvaClient::PvaClientPutGetPtr createPutGetPtr(const std::string& requestDescriptor);
 
+    epics::pvaClient::PvaClientGetPtr checkoutGetPtr(const std::string& requestDescriptor, unsigned int& cacheGeneration);
+    void checkinGetPtr(const std::string& requestDescriptor, const epics::pvaClient::PvaClientGetPtr& pvaGet, unsigned int cacheGeneration);
+    epics::pvaClient::PvaClientPutPtr checkoutPutPtr(const std::string& requestDescriptor, unsigned int& cacheGeneration);
+    void checkinPutPtr(const std::string& requestDescriptor, const epics::pvaClient::PvaClientPutPtr& pvaPut, unsigned int cacheGeneration);
+    epics::pvaClient::PvaClientPutGetPtr checkoutPutGetPtr(const std::string& requestDescriptor, unsigned int& cacheGeneration);
+    void checkinPutGetPtr(const std::string& requestDescriptor, const epics::pvaClient::PvaClientPutGetPtr& pvaPutGet, unsigned int cacheGeneration);
+    void invalidateOperationCache();
+
     void callSubscriber(const std::string& pySubscriberName, boost::python::object& pySubscriber, PvObject& pvObject);
+    void callBatchSubscriber(const std::string& pySubscriberName, boost::python::object& pySubscriber, boost::python::list& pyList);
+    void updateBatchCounters(unsigned int batchSize);
+    void recordMonitorQueueWait();
+    void clearMonitorQueueTimeStamps();
     void invokePyCallback(boost::python::object& pyCallback, PvObject& pvObject);
     void invokePyCallback(boost::python::object& pyCallback, std::string errorMsg);
 
@@ -213,12 +271,28 @@ private:
     epics::pvaClient::PvaClientMonitorPtr pvaClientMonitorPtr;
     std::string monitorRequestDescriptor;
     epics::pvData::StructureConstPtr monitorStructurePtr;
+    PvStructurePool::shared_pointer monitorStructurePoolPtr;
 
     bool monitorActive;
     bool monitorRunning;
     bool processingThreadRunning;
     PvObjectQueue pvObjectQueue;
     bool useInternalPvObjectQueue;
+    bool monitorQueueLockFree;
+
+    // Queue is serviced by process-wide dispatcher instead of
+    // channel processing thread
+    bool monitorSharedDispatch;
+
+    // Queue length was set by monitor, and is restored when it stops
+    bool monitorQueueMaxLengthForced;
+
+    // Batched monitor delivery; batch size of 0 or 1 disables batching
+    int monitorBatchSize;
+    double monitorMaxBatchLatency;
+    epics::pvData::Mutex batchCounterMutex;
+    unsigned int nBatches;
+    std::map<unsigned int, unsigned int> batchSizeHistogram;
 
     // Use for single subscriber only
     std::string subscriberName;
@@ -228,6 +302,24 @@ private:
     std::map<std::string, boost::python::object> subscriberMap;
     epics::pvData::Mutex subscriberMutex;
 
+    // Per-subscriber dispatch; queue length of 0 means that all
+    // subscribers are called sequentially from the same thread
+    int subscriberQueueLength;
+    std::map<std::string, SubscriberDispatcher::shared_pointer> subscriberDispatcherMap;
+    void addSubscriberDispatcher(const std::string& subscriberName, const boost::python::object& pySubscriber);
+    void removeSubscriberDispatcher(const std::string& subscriberName);
+    void stopSubscriberDispatchers();
+
+    // Monitor latency instrumentation; push times of updates in the
+    // internal queue are kept in a lock-free ring, in the same order
+    // as queued updates
+    bool monitorTimingEnabled;
+    LatencyHistogram::shared_pointer eventToPushHistogramPtr;
+    LatencyHistogram::shared_pointer queueWaitHistogramPtr;
+    LatencyHistogram::shared_pointer gilWaitHistogramPtr;
+    LatencyHistogram::shared_pointer callbackHistogramPtr;
+    TimeStampRing monitorQueueTimeStampRing;
+
     epics::pvData::Mutex monitorMutex;
     epics::pvData::Mutex processingThreadMutex;
     epicsEvent processingThreadExitEvent;
@@ -295,6 +387,34 @@ private:
     SynchronizedQueue<AsyncRequestPtr> asyncGetRequestQueue;
     SynchronizedQueue<AsyncRequestPtr> asyncPutRequestQueue;
 
+    // Issued async request; error message is set if request could not
+    // be issued, and is reported when request reaches the front of the
+    // pipeline, so that callbacks are always invoked in request order
+    template <class T>
+    struct AsyncOperation {
+        AsyncRequestPtr asyncRequest;
+        T pvaOperation;
+        unsigned int cacheGeneration;
+        std::string errorMessage;
+        AsyncOperation(const AsyncRequestPtr& asyncRequest_)
+        : asyncRequest(asyncRequest_)
+        , pvaOperation()
+        , cacheGeneration(0)
+        , errorMessage()
+        {}
+    };
+
+    int asyncRequestPipelineDepth;
+    AsyncOperation<epics::pvaClient::PvaClientGetPtr> issueAsyncGet(const AsyncRequestPtr& asyncRequest);
+    void completeAsyncGet(AsyncOperation<epics::pvaClient::PvaClientGetPtr>& asyncOperation);
+    AsyncOperation<epics::pvaClient::PvaClientPutPtr> issueAsyncPut(const AsyncRequestPtr& asyncRequest);
+    void completeAsyncPut(AsyncOperation<epics::pvaClient::PvaClientPutPtr>& asyncOperation);
+
+    // Initialized operations, reused across calls with the same request descriptor
+    ChannelOperationCache<epics::pvaClient::PvaClientGetPtr> getCache;
+    ChannelOperationCache<epics::pvaClient::PvaClientPutPtr> putCache;
+    ChannelOperationCache<epics::pvaClient::PvaClientPutGetPtr> putGetCache;
+
     bool shutdownInProgress;
 };
 
@@ -0,0 +1,166 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef CHANNEL_OPERATION_CACHE_H
+#define CHANNEL_OPERATION_CACHE_H
+
+#include <list>
+#include <string>
+#include <map>
+#include <utility>
+#include <pv/pvData.h>
+#include "PvaPyConstants.h"
+
+// LRU cache of initialized channel operations (PvaClientGet, PvaClientPut,
+// PvaClientPutGet) keyed by request descriptor. Operations are checked
+// out for exclusive use and checked back in after successful completion,
+// so concurrent callers never share the same operation object. Clearing
+// the cache invalidates all operations that are currently checked out.
+template <class T>
+class ChannelOperationCache
+{
+public:
+    POINTER_DEFINITIONS(ChannelOperationCache<T>);
+
+    static const int DefaultMaxSize = 8;
+
+    ChannelOperationCache(int maxSize=DefaultMaxSize);
+    virtual ~ChannelOperationCache();
+    void setMaxSize(int maxSize);
+    int getMaxSize();
+    unsigned int size();
+
+    // Returns null pointer if there is no cached operation for a given key
+    T checkout(const std::string& key, unsigned int& generation);
+    void checkin(const std::string& key, const T& t, unsigned int generation);
+    void clear();
+
+    // Statistics
+    void resetCounters();
+    const std::map<std::string,unsigned int>& getCounterMap();
+
+private:
+    typedef std::pair<std::string, T> CacheEntry;
+    typedef typename std::list<CacheEntry>::iterator CacheIterator;
+
+    epics::pvData::Mutex mutex;
+    std::list<CacheEntry> entryList;
+    int maxSize;
+    unsigned int generation;
+
+    // Statistics counters
+    std::map<std::string, unsigned int> counterMap;
+    unsigned int nHits;
+    unsigned int nMisses;
+    unsigned int nEvictions;
+    unsigned int nInvalidations;
+};
+
+template <class T>
+ChannelOperationCache<T>::ChannelOperationCache(int maxSize_)
+    : mutex()
+    , entryList()
+    , maxSize(maxSize_)
+    , generation(0)
+    , counterMap()
+    , nHits(0)
+    , nMisses(0)
+    , nEvictions(0)
+    , nInvalidations(0)
+{
+}
+
+template <class T>
+ChannelOperationCache<T>::~ChannelOperationCache()
+{
+}
+
+template <class T>
+void ChannelOperationCache<T>::setMaxSize(int maxSize)
+{
+    epics::pvData::Lock lock(mutex);
+    this->maxSize = maxSize;
+    while (entryList.size() > 0 && int(entryList.size()) > maxSize) {
+        entryList.pop_back();
+        nEvictions++;
+    }
+}
+
+template <class T>
+int ChannelOperationCache<T>::getMaxSize()
+{
+    return maxSize;
+}
+
+template <class T>
+unsigned int ChannelOperationCache<T>::size()
+{
+    epics::pvData::Lock lock(mutex);
+    return entryList.size();
+}
+
+template <class T>
+T ChannelOperationCache<T>::checkout(const std::string& key, unsigned int& generation)
+{
+    epics::pvData::Lock lock(mutex);
+    generation = this->generation;
+    for (CacheIterator it = entryList.begin(); it != entryList.end(); it++) {
+        if (it->first == key) {
+            T t = it->second;
+            entryList.erase(it);
+            nHits++;
+            return t;
+        }
+    }
+    nMisses++;
+    return T();
+}
+
+template <class T>
+void ChannelOperationCache<T>::checkin(const std::string& key, const T& t, unsigned int generation)
+{
+    epics::pvData::Lock lock(mutex);
+    if (!t || maxSize <= 0 || generation != this->generation) {
+        // Caching disabled, or operation was invalidated while in use
+        return;
+    }
+    // Most recently used operations are kept at the front
+    entryList.push_front(CacheEntry(key, t));
+    while (int(entryList.size()) > maxSize) {
+        entryList.pop_back();
+        nEvictions++;
+    }
+}
+
+template <class T>
+void ChannelOperationCache<T>::clear()
+{
+    epics::pvData::Lock lock(mutex);
+    generation++;
+    nInvalidations++;
+    entryList.clear();
+}
+
+template <class T>
+void ChannelOperationCache<T>::resetCounters()
+{
+    epics::pvData::Lock lock(mutex);
+    nHits = 0;
+    nMisses = 0;
+    nEvictions = 0;
+    nInvalidations = 0;
+}
+
+template <class T>
+const std::map<std::string,unsigned int>& ChannelOperationCache<T>::getCounterMap()
+{
+    epics::pvData::Lock lock(mutex);
+    counterMap[PvaPyConstants::NumCacheHitsCounterKey] = nHits;
+    counterMap[PvaPyConstants::NumCacheMissesCounterKey] = nMisses;
+    counterMap[PvaPyConstants::NumCacheEvictionsCounterKey] = nEvictions;
+    counterMap[PvaPyConstants::NumCacheInvalidationsCounterKey] = nInvalidations;
+    counterMap[PvaPyConstants::NumCachedCounterKey] = entryList.size();
+    return counterMap;
+}
+
+#endif
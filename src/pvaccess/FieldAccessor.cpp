@@ -0,0 +1,60 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "FieldAccessor.h"
+#include "PyPvDataUtility.h"
+
+namespace pvd = epics::pvData;
+namespace bp = boost::python;
+
+FieldAccessor::FieldAccessor(const std::string& fieldPath_)
+    : fieldPath(fieldPath_)
+    , structurePtr()
+    , fieldPathIndexPtr()
+{
+}
+
+FieldAccessor::FieldAccessor(const FieldAccessor& fieldAccessor)
+    : fieldPath(fieldAccessor.fieldPath)
+    , structurePtr(fieldAccessor.structurePtr)
+    , fieldPathIndexPtr(fieldAccessor.fieldPathIndexPtr)
+{
+}
+
+FieldAccessor::~FieldAccessor()
+{
+}
+
+std::string FieldAccessor::getFieldPath() const
+{
+    return fieldPath;
+}
+
+pvd::PVStructurePtr FieldAccessor::getParentStructure(const pvd::PVStructurePtr& pvStructurePtr)
+{
+    // Python calls are serialized by GIL, so no locking is needed here
+    pvd::StructureConstPtr structurePtr2 = pvStructurePtr->getStructure();
+    if (structurePtr2 != structurePtr) {
+        fieldPathIndexPtr = FieldPathCache::getFieldPathIndex(fieldPath, pvStructurePtr);
+        structurePtr = structurePtr2;
+    }
+    return FieldPathCache::getParentStructure(*fieldPathIndexPtr, pvStructurePtr);
+}
+
+bp::object FieldAccessor::get(const PvObject& pvObject)
+{
+    pvd::PVStructurePtr pvStructurePtr = pvObject.getPvStructurePtr();
+    pvd::PVStructurePtr pvParentPtr = getParentStructure(pvStructurePtr);
+    bool useNumPyArrays = false;
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+    useNumPyArrays = pvObject.getUseNumPyArraysFlag();
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+    return PyPvDataUtility::getFieldAsPyObject(fieldPathIndexPtr->fieldName, pvParentPtr, useNumPyArrays);
+}
+
+void FieldAccessor::set(PvObject& pvObject, const bp::object& pyObject)
+{
+    pvd::PVStructurePtr pvStructurePtr = pvObject.getPvStructurePtr();
+    pvd::PVStructurePtr pvParentPtr = getParentStructure(pvStructurePtr);
+    PyPvDataUtility::pyObjectToField(pyObject, fieldPathIndexPtr->fieldName, pvParentPtr);
+}
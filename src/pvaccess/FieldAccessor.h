@@ -0,0 +1,35 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef FIELD_ACCESSOR_H
+#define FIELD_ACCESSOR_H
+
+#include <string>
+#include "boost/python/object.hpp"
+#include "pv/pvData.h"
+#include "FieldPathCache.h"
+#include "PvObject.h"
+
+// Precompiled field path that can be applied to any number of PV objects.
+// Resolved path is remembered for the most recently used structure type,
+// so that repeated access to objects of the same type skips path lookup.
+class FieldAccessor
+{
+public:
+    FieldAccessor(const std::string& fieldPath);
+    FieldAccessor(const FieldAccessor& fieldAccessor);
+    virtual ~FieldAccessor();
+
+    std::string getFieldPath() const;
+    boost::python::object get(const PvObject& pvObject);
+    void set(PvObject& pvObject, const boost::python::object& pyObject);
+
+private:
+    epics::pvData::PVStructurePtr getParentStructure(const epics::pvData::PVStructurePtr& pvStructurePtr);
+
+    std::string fieldPath;
+    epics::pvData::StructureConstPtr structurePtr;
+    FieldPathCache::FieldPathIndexPtr fieldPathIndexPtr;
+};
+
+#endif
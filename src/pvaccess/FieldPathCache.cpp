@@ -0,0 +1,92 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "FieldPathCache.h"
+#include "PyPvDataUtility.h"
+#include "StringUtility.h"
+#include "FieldNotFound.h"
+
+namespace pvd = epics::pvData;
+
+const unsigned int FieldPathCache::MaxNumFieldPaths(10000);
+
+pvd::Mutex FieldPathCache::mutex;
+FieldPathCache::StructureMap FieldPathCache::structureMap;
+unsigned int FieldPathCache::nFieldPaths(0);
+
+FieldPathCache::FieldPathIndexPtr FieldPathCache::getFieldPathIndex(const std::string& fieldPath, const pvd::PVStructurePtr& pvStructurePtr)
+{
+    pvd::StructureConstPtr structurePtr = pvStructurePtr->getStructure();
+    {
+        pvd::Lock lock(mutex);
+        StructureMap::const_iterator it = structureMap.find(structurePtr.get());
+        if (it != structureMap.end()) {
+            std::map<std::string, FieldPathIndexPtr>::const_iterator it2 = it->second.fieldPathMap.find(fieldPath);
+            if (it2 != it->second.fieldPathMap.end()) {
+                return it2->second;
+            }
+        }
+    }
+
+    // Invalid paths will throw exception and will not be cached
+    FieldPathIndexPtr fieldPathIndexPtr = resolveFieldPath(fieldPath, pvStructurePtr);
+    pvd::Lock lock(mutex);
+    if (nFieldPaths >= MaxNumFieldPaths) {
+        structureMap.clear();
+        nFieldPaths = 0;
+    }
+    StructureEntry& entry = structureMap[structurePtr.get()];
+    entry.structurePtr = structurePtr;
+    if (entry.fieldPathMap.insert(std::make_pair(fieldPath, fieldPathIndexPtr)).second) {
+        nFieldPaths++;
+    }
+    return fieldPathIndexPtr;
+}
+
+FieldPathCache::FieldPathIndexPtr FieldPathCache::resolveFieldPath(const std::string& fieldPath, const pvd::PVStructurePtr& pvStructurePtr)
+{
+    std::vector<std::string> fieldNames = StringUtility::split(fieldPath);
+    if (fieldNames.empty()) {
+        throw FieldNotFound("Invalid field path: '%s'", fieldPath.c_str());
+    }
+
+    // Walk structures by name first, so that errors are reported
+    // in the same way as for non-cached access
+    pvd::PVStructurePtr pvStructurePtr2 = PyPvDataUtility::getParentStructureForFieldPath(fieldNames, pvStructurePtr);
+    std::string fieldName = fieldNames[fieldNames.size()-1];
+    PyPvDataUtility::checkFieldExists(fieldName, pvStructurePtr2);
+
+    FieldPathIndex* fieldPathIndex = new FieldPathIndex();
+    FieldPathIndexPtr fieldPathIndexPtr(fieldPathIndex);
+    pvd::PVStructurePtr pvParentPtr = pvStructurePtr;
+    for (size_t i = 0; i < fieldNames.size()-1; i++) {
+        size_t index = pvParentPtr->getStructure()->getFieldIndex(fieldNames[i]);
+        fieldPathIndex->parentIndexList.push_back(index);
+        pvParentPtr = std::tr1::static_pointer_cast<pvd::PVStructure>(pvParentPtr->getPVFields()[index]);
+    }
+    fieldPathIndex->fieldName = fieldName;
+    return fieldPathIndexPtr;
+}
+
+pvd::PVStructurePtr FieldPathCache::getParentStructure(const FieldPathIndex& fieldPathIndex, const pvd::PVStructurePtr& pvStructurePtr)
+{
+    pvd::PVStructurePtr pvParentPtr = pvStructurePtr;
+    for (size_t i = 0; i < fieldPathIndex.parentIndexList.size(); i++) {
+        pvParentPtr = std::tr1::static_pointer_cast<pvd::PVStructure>(pvParentPtr->getPVFields()[fieldPathIndex.parentIndexList[i]]);
+    }
+    return pvParentPtr;
+}
+
+pvd::PVStructurePtr FieldPathCache::getParentStructure(const std::string& fieldPath, const pvd::PVStructurePtr& pvStructurePtr, std::string& fieldName)
+{
+    FieldPathIndexPtr fieldPathIndexPtr = getFieldPathIndex(fieldPath, pvStructurePtr);
+    fieldName = fieldPathIndexPtr->fieldName;
+    return getParentStructure(*fieldPathIndexPtr, pvStructurePtr);
+}
+
+void FieldPathCache::clear()
+{
+    pvd::Lock lock(mutex);
+    structureMap.clear();
+    nFieldPaths = 0;
+}
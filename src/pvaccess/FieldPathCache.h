@@ -0,0 +1,52 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef FIELD_PATH_CACHE_H
+#define FIELD_PATH_CACHE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <pv/pvData.h>
+
+// Process-wide cache of resolved field paths (e.g., 'x.y.z'), keyed by
+// structure introspection pointer, and shared by all PV objects with
+// the same structure. Resolved path contains indices of all structure
+// fields leading to the last field in the path, and the last field name.
+class FieldPathCache
+{
+public:
+    struct FieldPathIndex
+    {
+        std::vector<size_t> parentIndexList;
+        std::string fieldName;
+    };
+    typedef std::tr1::shared_ptr<const FieldPathIndex> FieldPathIndexPtr;
+
+    static const unsigned int MaxNumFieldPaths;
+
+    // Throws FieldNotFound/InvalidRequest for invalid field path
+    static FieldPathIndexPtr getFieldPathIndex(const std::string& fieldPath, const epics::pvData::PVStructurePtr& pvStructurePtr);
+
+    // Caller must make sure that index was resolved for the same structure
+    static epics::pvData::PVStructurePtr getParentStructure(const FieldPathIndex& fieldPathIndex, const epics::pvData::PVStructurePtr& pvStructurePtr);
+    static epics::pvData::PVStructurePtr getParentStructure(const std::string& fieldPath, const epics::pvData::PVStructurePtr& pvStructurePtr, std::string& fieldName);
+    static void clear();
+
+private:
+    // Structure pointer is kept in order to prevent reuse of its address
+    struct StructureEntry
+    {
+        epics::pvData::StructureConstPtr structurePtr;
+        std::map<std::string, FieldPathIndexPtr> fieldPathMap;
+    };
+    typedef std::map<const epics::pvData::Structure*, StructureEntry> StructureMap;
+
+    static FieldPathIndexPtr resolveFieldPath(const std::string& fieldPath, const epics::pvData::PVStructurePtr& pvStructurePtr);
+
+    static epics::pvData::Mutex mutex;
+    static StructureMap structureMap;
+    static unsigned int nFieldPaths;
+};
+
+#endif
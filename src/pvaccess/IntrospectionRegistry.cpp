@@ -0,0 +1,263 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include <sstream>
+#include "boost/python/extract.hpp"
+#include "boost/python/list.hpp"
+#include "boost/python/tuple.hpp"
+#include "boost/python/str.hpp"
+#include "IntrospectionRegistry.h"
+#include "PvaPyConstants.h"
+#include "PyPvDataUtility.h"
+#include "InvalidArgument.h"
+
+namespace pvd = epics::pvData;
+namespace bp = boost::python;
+
+const unsigned int IntrospectionRegistry::DefaultMaxSize(1024);
+
+pvd::Mutex IntrospectionRegistry::mutex;
+unsigned int IntrospectionRegistry::maxSize(DefaultMaxSize);
+unsigned int IntrospectionRegistry::lastStructureId(0);
+std::map<std::string, pvd::StructureConstPtr> IntrospectionRegistry::dictStructureMap;
+std::map<pvd::StructureConstPtr, IntrospectionRegistry::EntryPtr> IntrospectionRegistry::structureEntryMap;
+std::map<std::string, IntrospectionRegistry::EntryPtr> IntrospectionRegistry::introspectionEntryMap;
+IntrospectionRegistry::CacheCounters IntrospectionRegistry::dictCounters;
+IntrospectionRegistry::CacheCounters IntrospectionRegistry::serializationCounters;
+IntrospectionRegistry::CacheCounters IntrospectionRegistry::deserializationCounters;
+unsigned int IntrospectionRegistry::nDictEvictions(0);
+unsigned int IntrospectionRegistry::nStructureEvictions(0);
+
+IntrospectionRegistry::Entry::Entry(unsigned int id_, const pvd::StructureConstPtr& structurePtr_, const std::string& introspectionData_)
+    : id(id_)
+    , structurePtr(structurePtr_)
+    , introspectionData(introspectionData_)
+{
+}
+
+IntrospectionRegistry::CacheCounters::CacheCounters()
+    : nHits(0)
+    , nMisses(0)
+{
+}
+
+void IntrospectionRegistry::CacheCounters::reset()
+{
+    nHits = 0;
+    nMisses = 0;
+}
+
+bp::dict IntrospectionRegistry::CacheCounters::toDict(unsigned int nCached, unsigned int nEvictions) const
+{
+    bp::dict pyDict;
+    unsigned int nRequests = nHits + nMisses;
+    pyDict[PvaPyConstants::NumCacheHitsCounterKey] = nHits;
+    pyDict[PvaPyConstants::NumCacheMissesCounterKey] = nMisses;
+    pyDict[PvaPyConstants::NumCacheEvictionsCounterKey] = nEvictions;
+    pyDict[PvaPyConstants::NumCachedCounterKey] = nCached;
+    pyDict[PvaPyConstants::CacheHitRateCounterKey] = (nRequests > 0 ? double(nHits)/nRequests : 0.0);
+    return pyDict;
+}
+
+IntrospectionRegistry::IntrospectionRegistry()
+{
+}
+
+IntrospectionRegistry::~IntrospectionRegistry()
+{
+}
+
+// Builds key that uniquely describes structure dictionary, preserving
+// field order; returns false for objects that cannot be described
+// by value (e.g., PvObject instances used as field types)
+bool IntrospectionRegistry::getStructureDictKey(const bp::object& pyObject, std::string& key)
+{
+    bp::extract<int> intExtract(pyObject);
+    if (intExtract.check()) {
+        std::ostringstream oss;
+        oss << 'i' << intExtract() << ';';
+        key += oss.str();
+        return true;
+    }
+
+    bp::extract<std::string> stringExtract(pyObject);
+    if (stringExtract.check()) {
+        std::string s = stringExtract();
+        std::ostringstream oss;
+        oss << 's' << s.size() << ':';
+        key += oss.str();
+        key += s;
+        return true;
+    }
+
+    bp::extract<bp::list> listExtract(pyObject);
+    if (listExtract.check()) {
+        bp::list pyList = listExtract();
+        key += '[';
+        for (int i = 0; i < bp::len(pyList); i++) {
+            if (!getStructureDictKey(pyList[i], key)) {
+                return false;
+            }
+        }
+        key += ']';
+        return true;
+    }
+
+    bp::extract<bp::tuple> tupleExtract(pyObject);
+    if (tupleExtract.check()) {
+        bp::tuple pyTuple = tupleExtract();
+        key += '(';
+        for (int i = 0; i < bp::len(pyTuple); i++) {
+            if (!getStructureDictKey(pyTuple[i], key)) {
+                return false;
+            }
+        }
+        key += ')';
+        return true;
+    }
+
+    bp::extract<bp::dict> dictExtract(pyObject);
+    if (dictExtract.check()) {
+        bp::dict pyDict = dictExtract();
+        bp::list keys = pyDict.keys();
+        key += '{';
+        for (int i = 0; i < bp::len(keys); i++) {
+            if (!getStructureDictKey(keys[i], key) || !getStructureDictKey(pyDict[keys[i]], key)) {
+                return false;
+            }
+        }
+        key += '}';
+        return true;
+    }
+    return false;
+}
+
+pvd::StructureConstPtr IntrospectionRegistry::getStructure(const bp::dict& structureDict, const std::string& structureId, const bp::dict& structureFieldIdDict)
+{
+    std::string key;
+    bool canIntern = getStructureDictKey(structureDict, key) && getStructureDictKey(bp::str(structureId), key) && getStructureDictKey(structureFieldIdDict, key);
+    if (canIntern) {
+        pvd::Lock lock(mutex);
+        std::map<std::string, pvd::StructureConstPtr>::const_iterator it = dictStructureMap.find(key);
+        if (it != dictStructureMap.end()) {
+            dictCounters.nHits++;
+            return it->second;
+        }
+        dictCounters.nMisses++;
+    }
+
+    // Structure is created without holding the lock
+    pvd::StructureConstPtr structurePtr = PyPvDataUtility::createStructureFromDict(structureDict, structureId, structureFieldIdDict);
+    if (canIntern) {
+        pvd::Lock lock(mutex);
+        if (dictStructureMap.size() >= maxSize) {
+            nDictEvictions += dictStructureMap.size();
+            dictStructureMap.clear();
+        }
+        dictStructureMap[key] = structurePtr;
+    }
+    return structurePtr;
+}
+
+bool IntrospectionRegistry::findSerializedIntrospection(const pvd::StructureConstPtr& structurePtr, unsigned int& structureId, std::string& introspectionData)
+{
+    pvd::Lock lock(mutex);
+    std::map<pvd::StructureConstPtr, EntryPtr>::const_iterator it = structureEntryMap.find(structurePtr);
+    if (it == structureEntryMap.end()) {
+        serializationCounters.nMisses++;
+        return false;
+    }
+    serializationCounters.nHits++;
+    structureId = it->second->id;
+    introspectionData = it->second->introspectionData;
+    return true;
+}
+
+bool IntrospectionRegistry::findStructure(const std::string& introspectionData, unsigned int& structureId, pvd::StructureConstPtr& structurePtr)
+{
+    pvd::Lock lock(mutex);
+    std::map<std::string, EntryPtr>::const_iterator it = introspectionEntryMap.find(introspectionData);
+    if (it == introspectionEntryMap.end()) {
+        deserializationCounters.nMisses++;
+        return false;
+    }
+    deserializationCounters.nHits++;
+    structureId = it->second->id;
+    structurePtr = it->second->structurePtr;
+    return true;
+}
+
+// Structures with identical introspection data share the same entry,
+// and hence the same id
+unsigned int IntrospectionRegistry::registerStructure(const pvd::StructureConstPtr& structurePtr, const std::string& introspectionData)
+{
+    pvd::Lock lock(mutex);
+    std::map<pvd::StructureConstPtr, EntryPtr>::const_iterator it = structureEntryMap.find(structurePtr);
+    if (it != structureEntryMap.end()) {
+        return it->second->id;
+    }
+    if (structureEntryMap.size() >= maxSize || introspectionEntryMap.size() >= maxSize) {
+        nStructureEvictions += structureEntryMap.size();
+        structureEntryMap.clear();
+        introspectionEntryMap.clear();
+    }
+
+    EntryPtr entryPtr;
+    std::map<std::string, EntryPtr>::const_iterator it2 = introspectionEntryMap.find(introspectionData);
+    if (it2 != introspectionEntryMap.end()) {
+        entryPtr = it2->second;
+    }
+    else {
+        // Ids are never reused, so that streams holding ids of evicted
+        // structures remain consistent
+        entryPtr = EntryPtr(new Entry(++lastStructureId, structurePtr, introspectionData));
+        introspectionEntryMap[introspectionData] = entryPtr;
+    }
+    structureEntryMap[structurePtr] = entryPtr;
+    return entryPtr->id;
+}
+
+void IntrospectionRegistry::setMaxSize(unsigned int maxSize_)
+{
+    if (maxSize_ == 0) {
+        throw InvalidArgument("Maximum registry size must be greater than zero.");
+    }
+    pvd::Lock lock(mutex);
+    maxSize = maxSize_;
+}
+
+unsigned int IntrospectionRegistry::getMaxSize() const
+{
+    pvd::Lock lock(mutex);
+    return maxSize;
+}
+
+bp::dict IntrospectionRegistry::getCounters()
+{
+    pvd::Lock lock(mutex);
+    bp::dict pyDict;
+    unsigned int nRegistered = structureEntryMap.size();
+    pyDict[PvaPyConstants::StructureDictCacheKey] = dictCounters.toDict(dictStructureMap.size(), nDictEvictions);
+    pyDict[PvaPyConstants::SerializationCacheKey] = serializationCounters.toDict(nRegistered, nStructureEvictions);
+    pyDict[PvaPyConstants::DeserializationCacheKey] = deserializationCounters.toDict(nRegistered, nStructureEvictions);
+    pyDict[PvaPyConstants::NumStructureIdsCounterKey] = lastStructureId;
+    return pyDict;
+}
+
+void IntrospectionRegistry::resetCounters()
+{
+    pvd::Lock lock(mutex);
+    dictCounters.reset();
+    serializationCounters.reset();
+    deserializationCounters.reset();
+    nDictEvictions = 0;
+    nStructureEvictions = 0;
+}
+
+void IntrospectionRegistry::clear()
+{
+    pvd::Lock lock(mutex);
+    dictStructureMap.clear();
+    structureEntryMap.clear();
+    introspectionEntryMap.clear();
+}
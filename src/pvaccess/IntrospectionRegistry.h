@@ -0,0 +1,79 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef INTROSPECTION_REGISTRY_H
+#define INTROSPECTION_REGISTRY_H
+
+#include <string>
+#include <map>
+#include "boost/python/dict.hpp"
+#include "pv/pvData.h"
+
+// Process-wide registry of interned structure introspection. Structures
+// created from python dictionaries are keyed by dictionary contents, so
+// that objects of the same type share a single structure instance
+// instead of building it every time. Serialized structure introspection
+// is keyed by both structure and introspection data, and each registered
+// structure is assigned small integer id, which serialization streams
+// can send instead of introspection data after the first transmission.
+// Caches are cleared when they reach maximum size. All state is static;
+// python class instances are handles to the same registry.
+class IntrospectionRegistry
+{
+public:
+    static const unsigned int DefaultMaxSize;
+
+    IntrospectionRegistry();
+    virtual ~IntrospectionRegistry();
+
+    // Structures created from python dictionaries
+    static epics::pvData::StructureConstPtr getStructure(const boost::python::dict& structureDict, const std::string& structureId, const boost::python::dict& structureFieldIdDict=boost::python::dict());
+
+    // Serialized introspection data; find methods return false when
+    // structure is not registered, in which case caller should register it
+    static bool findSerializedIntrospection(const epics::pvData::StructureConstPtr& structurePtr, unsigned int& structureId, std::string& introspectionData);
+    static bool findStructure(const std::string& introspectionData, unsigned int& structureId, epics::pvData::StructureConstPtr& structurePtr);
+    static unsigned int registerStructure(const epics::pvData::StructureConstPtr& structurePtr, const std::string& introspectionData);
+
+    // Python interface
+    void setMaxSize(unsigned int maxSize);
+    unsigned int getMaxSize() const;
+    boost::python::dict getCounters();
+    void resetCounters();
+    void clear();
+
+private:
+    struct Entry
+    {
+        Entry(unsigned int id, const epics::pvData::StructureConstPtr& structurePtr, const std::string& introspectionData);
+        unsigned int id;
+        epics::pvData::StructureConstPtr structurePtr;
+        std::string introspectionData;
+    };
+    typedef std::tr1::shared_ptr<Entry> EntryPtr;
+
+    struct CacheCounters
+    {
+        CacheCounters();
+        void reset();
+        boost::python::dict toDict(unsigned int nCached, unsigned int nEvictions) const;
+        unsigned int nHits;
+        unsigned int nMisses;
+    };
+
+    static bool getStructureDictKey(const boost::python::object& pyObject, std::string& key);
+
+    static epics::pvData::Mutex mutex;
+    static unsigned int maxSize;
+    static unsigned int lastStructureId;
+    static std::map<std::string, epics::pvData::StructureConstPtr> dictStructureMap;
+    static std::map<epics::pvData::StructureConstPtr, EntryPtr> structureEntryMap;
+    static std::map<std::string, EntryPtr> introspectionEntryMap;
+    static CacheCounters dictCounters;
+    static CacheCounters serializationCounters;
+    static CacheCounters deserializationCounters;
+    static unsigned int nDictEvictions;
+    static unsigned int nStructureEvictions;
+};
+
+#endif
@@ -0,0 +1,125 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "LatencyHistogram.h"
+#include "PvaPyConstants.h"
+
+namespace pvd = epics::pvData;
+namespace bp = boost::python;
+
+LatencyHistogram::LatencyHistogram()
+    : mutex()
+    , count(0)
+    , sum(0)
+    , minValue(0)
+    , maxValue(0)
+{
+    for (int i = 0; i < NumBuckets; i++) {
+        buckets[i] = 0;
+    }
+}
+
+LatencyHistogram::~LatencyHistogram()
+{
+}
+
+int LatencyHistogram::getBucketIndex(double value)
+{
+    unsigned long long us = (unsigned long long)(value*1.0e6);
+    int bucketIndex = 0;
+    while (us > 0 && bucketIndex < NumBuckets-1) {
+        us >>= 1;
+        bucketIndex++;
+    }
+    return bucketIndex;
+}
+
+double LatencyHistogram::getBucketUpperBound(int bucketIndex)
+{
+    return double(1ULL << bucketIndex);
+}
+
+void LatencyHistogram::record(double value)
+{
+    if (value < 0) {
+        // Clock adjustments
+        value = 0;
+    }
+    int bucketIndex = getBucketIndex(value);
+    pvd::Lock lock(mutex);
+    buckets[bucketIndex]++;
+    if (count == 0 || value < minValue) {
+        minValue = value;
+    }
+    if (value > maxValue) {
+        maxValue = value;
+    }
+    count++;
+    sum += value;
+}
+
+void LatencyHistogram::record(const epicsTimeStamp& startTime, const epicsTimeStamp& endTime)
+{
+    record(epicsTimeDiffInSeconds(&endTime, &startTime));
+}
+
+void LatencyHistogram::reset()
+{
+    pvd::Lock lock(mutex);
+    for (int i = 0; i < NumBuckets; i++) {
+        buckets[i] = 0;
+    }
+    count = 0;
+    sum = 0;
+    minValue = 0;
+    maxValue = 0;
+}
+
+unsigned long long LatencyHistogram::getCount()
+{
+    pvd::Lock lock(mutex);
+    return count;
+}
+
+// Must be called with mutex locked. Percentile is estimated as
+// the upper bound of the bucket in which it falls, limited by maximum.
+double LatencyHistogram::getPercentile(double fraction) const
+{
+    if (count == 0) {
+        return 0;
+    }
+    unsigned long long threshold = (unsigned long long)(fraction*count);
+    if (threshold == 0) {
+        threshold = 1;
+    }
+    unsigned long long total = 0;
+    for (int i = 0; i < NumBuckets; i++) {
+        total += buckets[i];
+        if (total >= threshold) {
+            double upperBound = getBucketUpperBound(i)*1.0e-6;
+            return upperBound < maxValue ? upperBound : maxValue;
+        }
+    }
+    return maxValue;
+}
+
+bp::dict LatencyHistogram::toDict()
+{
+    bp::dict pyDict;
+    bp::dict bucketDict;
+    pvd::Lock lock(mutex);
+    pyDict[PvaPyConstants::CountKey] = count;
+    pyDict[PvaPyConstants::MinKey] = minValue;
+    pyDict[PvaPyConstants::MaxKey] = maxValue;
+    pyDict[PvaPyConstants::MeanKey] = (count > 0 ? sum/count : 0);
+    pyDict[PvaPyConstants::P50Key] = getPercentile(0.5);
+    pyDict[PvaPyConstants::P90Key] = getPercentile(0.9);
+    pyDict[PvaPyConstants::P99Key] = getPercentile(0.99);
+    for (int i = 0; i < NumBuckets; i++) {
+        if (buckets[i] > 0) {
+            bucketDict[(unsigned long long)getBucketUpperBound(i)] = buckets[i];
+        }
+    }
+    pyDict[PvaPyConstants::BucketsKey] = bucketDict;
+    return pyDict;
+}
@@ -0,0 +1,22 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef MONITOR_DISPATCH_CLIENT_H
+#define MONITOR_DISPATCH_CLIENT_H
+
+#include <string>
+
+// Interface for queues serviced by the shared monitor dispatcher
+class MonitorDispatchClient
+{
+public:
+    virtual ~MonitorDispatchClient() {}
+    virtual std::string getDispatchName() const=0;
+    virtual unsigned int getDispatchQueueSize()=0;
+
+    // Called from dispatcher worker thread; it should process at most
+    // a given number of queued updates and return number processed
+    virtual unsigned int dispatchUpdates(unsigned int maxUpdates)=0;
+};
+
+#endif // MONITOR_DISPATCH_CLIENT_H
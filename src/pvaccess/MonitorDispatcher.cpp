@@ -0,0 +1,260 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "MonitorDispatcher.h"
+#include "PvaPyConstants.h"
+#include "PyGilRelease.h"
+#include "InvalidArgument.h"
+#include "InvalidState.h"
+
+namespace pvd = epics::pvData;
+namespace bp = boost::python;
+
+const unsigned int MonitorDispatcher::MaxUpdatesPerDispatch(10);
+const double MonitorDispatcher::WorkerWaitTimeout(1.0);
+
+PvaPyLogger MonitorDispatcher::logger("MonitorDispatcher");
+pvd::Mutex MonitorDispatcher::mutex;
+std::map<MonitorDispatchClient*, MonitorDispatcher::ClientEntryPtr> MonitorDispatcher::clientMap;
+std::deque<MonitorDispatcher::ClientEntryPtr> MonitorDispatcher::readyQueue;
+epicsEvent MonitorDispatcher::readyEvent;
+int MonitorDispatcher::nWorkers(0);
+int MonitorDispatcher::nRunningWorkers(0);
+
+MonitorDispatcher::ClientEntry::ClientEntry(MonitorDispatchClient* client_)
+    : client(client_)
+    , name(client_->getDispatchName())
+    , scheduled(false)
+    , busy(false)
+    , pending(false)
+    , removed(false)
+    , workerThreadId(0)
+    , idleEvent()
+    , scheduledTime()
+    , nDispatches(0)
+    , nDispatched(0)
+    , totalLatency(0)
+    , maxLatency(0)
+{
+}
+
+MonitorDispatcher::MonitorDispatcher()
+{
+}
+
+MonitorDispatcher::~MonitorDispatcher()
+{
+}
+
+void MonitorDispatcher::setNumWorkers(int nWorkers)
+{
+    if (nWorkers < 0) {
+        throw InvalidArgument("Number of dispatcher worker threads cannot be negative.");
+    }
+    pvd::Lock lock(mutex);
+    if (nRunningWorkers > 0) {
+        throw InvalidState("Number of dispatcher worker threads cannot be changed after dispatcher has been started.");
+    }
+    MonitorDispatcher::nWorkers = nWorkers;
+}
+
+// Default number of workers equals number of available cores
+int MonitorDispatcher::getNumWorkers() const
+{
+    pvd::Lock lock(mutex);
+    if (nWorkers > 0) {
+        return nWorkers;
+    }
+    return epicsThreadGetCPUs();
+}
+
+// Must be called with mutex locked.
+void MonitorDispatcher::startWorkers()
+{
+    if (nRunningWorkers > 0) {
+        return;
+    }
+    nRunningWorkers = nWorkers > 0 ? nWorkers : epicsThreadGetCPUs();
+    logger.debug("Starting %d monitor dispatcher threads", nRunningWorkers);
+    for (int i = 0; i < nRunningWorkers; i++) {
+        epicsThreadCreate("MonitorDispatcher", epicsThreadPriorityLow, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)workerThread, 0);
+    }
+}
+
+void MonitorDispatcher::registerClient(MonitorDispatchClient* client)
+{
+    pvd::Lock lock(mutex);
+    if (clientMap.find(client) == clientMap.end()) {
+        clientMap[client] = ClientEntryPtr(new ClientEntry(client));
+    }
+    startWorkers();
+}
+
+void MonitorDispatcher::unregisterClient(MonitorDispatchClient* client)
+{
+    ClientEntryPtr entryPtr;
+    {
+        pvd::Lock lock(mutex);
+        std::map<MonitorDispatchClient*, ClientEntryPtr>::iterator it = clientMap.find(client);
+        if (it == clientMap.end()) {
+            return;
+        }
+        entryPtr = it->second;
+        clientMap.erase(it);
+        entryPtr->removed = true;
+        for (std::deque<ClientEntryPtr>::iterator qit = readyQueue.begin(); qit != readyQueue.end(); qit++) {
+            if (*qit == entryPtr) {
+                readyQueue.erase(qit);
+                break;
+            }
+        }
+        if (!entryPtr->busy || entryPtr->workerThreadId == epicsThreadGetIdSelf()) {
+            return;
+        }
+    }
+
+    // Worker is servicing client; it may need GIL in order to finish
+    if (PyGILState_Check()) {
+        PyGilRelease pyGilRelease;
+        while (true) {
+            entryPtr->idleEvent.wait(WorkerWaitTimeout);
+            pvd::Lock lock(mutex);
+            if (!entryPtr->busy) {
+                break;
+            }
+        }
+    }
+    else {
+        while (true) {
+            entryPtr->idleEvent.wait(WorkerWaitTimeout);
+            pvd::Lock lock(mutex);
+            if (!entryPtr->busy) {
+                break;
+            }
+        }
+    }
+}
+
+// Must be called with mutex locked.
+void MonitorDispatcher::enqueue(const ClientEntryPtr& entryPtr)
+{
+    entryPtr->scheduled = true;
+    epicsTimeGetCurrent(&entryPtr->scheduledTime);
+    readyQueue.push_back(entryPtr);
+    readyEvent.signal();
+}
+
+void MonitorDispatcher::schedule(MonitorDispatchClient* client)
+{
+    pvd::Lock lock(mutex);
+    std::map<MonitorDispatchClient*, ClientEntryPtr>::iterator it = clientMap.find(client);
+    if (it == clientMap.end()) {
+        return;
+    }
+    ClientEntryPtr entryPtr = it->second;
+    if (entryPtr->busy) {
+        // Worker will requeue client when it is done
+        entryPtr->pending = true;
+    }
+    else if (!entryPtr->scheduled) {
+        enqueue(entryPtr);
+    }
+}
+
+void MonitorDispatcher::workerThread(void*)
+{
+    logger.debug("Started monitor dispatcher thread %s", epicsThreadGetNameSelf());
+    while (true) {
+        ClientEntryPtr entryPtr;
+        {
+            pvd::Lock lock(mutex);
+            if (!readyQueue.empty()) {
+                entryPtr = readyQueue.front();
+                readyQueue.pop_front();
+                entryPtr->scheduled = false;
+                entryPtr->pending = false;
+                entryPtr->busy = true;
+                entryPtr->workerThreadId = epicsThreadGetIdSelf();
+                epicsTimeStamp now;
+                epicsTimeGetCurrent(&now);
+                double latency = epicsTimeDiffInSeconds(&now, &entryPtr->scheduledTime);
+                entryPtr->totalLatency += latency;
+                if (latency > entryPtr->maxLatency) {
+                    entryPtr->maxLatency = latency;
+                }
+                entryPtr->nDispatches++;
+                if (!readyQueue.empty()) {
+                    // Wake up another worker
+                    readyEvent.signal();
+                }
+            }
+        }
+        if (!entryPtr) {
+            readyEvent.wait(WorkerWaitTimeout);
+            continue;
+        }
+
+        unsigned int nDispatched = 0;
+        try {
+            nDispatched = entryPtr->client->dispatchUpdates(MaxUpdatesPerDispatch);
+        }
+        catch (const std::exception& ex) {
+            logger.error("Monitor dispatcher thread caught exception: %s", ex.what());
+        }
+
+        pvd::Lock lock(mutex);
+        entryPtr->busy = false;
+        entryPtr->workerThreadId = 0;
+        entryPtr->nDispatched += nDispatched;
+        if (entryPtr->removed) {
+            entryPtr->idleEvent.signal();
+            continue;
+        }
+        // Client goes to the back of the queue if it has more updates,
+        // which gives other clients fair share of workers
+        if (entryPtr->pending || entryPtr->client->getDispatchQueueSize() > 0) {
+            enqueue(entryPtr);
+        }
+    }
+}
+
+bp::dict MonitorDispatcher::getStats()
+{
+    bp::dict pyDict;
+    bp::dict clientDict;
+    pvd::Lock lock(mutex);
+    pyDict[PvaPyConstants::NumWorkersCounterKey] = nRunningWorkers;
+    pyDict[PvaPyConstants::NumReadyCounterKey] = readyQueue.size();
+    unsigned int nQueuedTotal = 0;
+    for (std::map<MonitorDispatchClient*, ClientEntryPtr>::iterator it = clientMap.begin(); it != clientMap.end(); it++) {
+        ClientEntryPtr entryPtr = it->second;
+        unsigned int nQueued = entryPtr->client->getDispatchQueueSize();
+        nQueuedTotal += nQueued;
+        bp::dict entryDict;
+        entryDict[PvaPyConstants::NumQueuedCounterKey] = nQueued;
+        entryDict[PvaPyConstants::NumDeliveredCounterKey] = entryPtr->nDispatched;
+        entryDict[PvaPyConstants::NumDispatchesCounterKey] = entryPtr->nDispatches;
+        double avgLatency = 0;
+        if (entryPtr->nDispatches > 0) {
+            avgLatency = entryPtr->totalLatency/entryPtr->nDispatches;
+        }
+        entryDict[PvaPyConstants::AvgLatencyCounterKey] = avgLatency;
+        entryDict[PvaPyConstants::MaxLatencyCounterKey] = entryPtr->maxLatency;
+        clientDict[entryPtr->name] = entryDict;
+    }
+    pyDict[PvaPyConstants::NumQueuedCounterKey] = nQueuedTotal;
+    pyDict[PvaPyConstants::ChannelStatsKey] = clientDict;
+    return pyDict;
+}
+
+void MonitorDispatcher::resetStats()
+{
+    pvd::Lock lock(mutex);
+    for (std::map<MonitorDispatchClient*, ClientEntryPtr>::iterator it = clientMap.begin(); it != clientMap.end(); it++) {
+        ClientEntryPtr entryPtr = it->second;
+        entryPtr->nDispatches = 0;
+        entryPtr->nDispatched = 0;
+        entryPtr->totalLatency = 0;
+        entryPtr->maxLatency = 0;
+    }
+}
@@ -0,0 +1,79 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef MONITOR_DISPATCHER_H
+#define MONITOR_DISPATCHER_H
+
+#include <string>
+#include <map>
+#include <deque>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include "boost/python/dict.hpp"
+#include "pv/pvData.h"
+#include "MonitorDispatchClient.h"
+#include "PvaPyLogger.h"
+
+// Process-wide dispatcher that services monitor queues of many channels
+// with a fixed pool of worker threads. Channels with pending updates are
+// serviced in round-robin order, at most MaxUpdatesPerDispatch updates at
+// a time, and a given channel is never serviced by two workers at once,
+// so that update order is preserved. All state is static; python class
+// instances are handles to the same dispatcher.
+class MonitorDispatcher
+{
+public:
+    static const unsigned int MaxUpdatesPerDispatch;
+    static const double WorkerWaitTimeout;
+
+    MonitorDispatcher();
+    virtual ~MonitorDispatcher();
+
+    // Client interface
+    static void registerClient(MonitorDispatchClient* client);
+    static void unregisterClient(MonitorDispatchClient* client);
+    static void schedule(MonitorDispatchClient* client);
+
+    // Python interface
+    void setNumWorkers(int nWorkers);
+    int getNumWorkers() const;
+    boost::python::dict getStats();
+    void resetStats();
+
+private:
+    struct ClientEntry
+    {
+        ClientEntry(MonitorDispatchClient* client);
+        MonitorDispatchClient* client;
+        std::string name;
+        bool scheduled;
+        bool busy;
+        bool pending;
+        bool removed;
+        epicsThreadId workerThreadId;
+        epicsEvent idleEvent;
+        epicsTimeStamp scheduledTime;
+
+        // Statistics
+        unsigned int nDispatches;
+        unsigned int nDispatched;
+        double totalLatency;
+        double maxLatency;
+    };
+    typedef std::tr1::shared_ptr<ClientEntry> ClientEntryPtr;
+
+    static PvaPyLogger logger;
+    static void workerThread(void*);
+    static void startWorkers();
+    static void enqueue(const ClientEntryPtr& entryPtr);
+
+    static epics::pvData::Mutex mutex;
+    static std::map<MonitorDispatchClient*, ClientEntryPtr> clientMap;
+    static std::deque<ClientEntryPtr> readyQueue;
+    static epicsEvent readyEvent;
+    static int nWorkers;
+    static int nRunningWorkers;
+};
+
+#endif
@@ -0,0 +1,1143 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <new>
+#include <epicsThread.h>
+#include "NdArrayCodec.h"
+#include "InvalidArgument.h"
+#include "InvalidRequest.h"
+#include "InvalidState.h"
+
+namespace pvd = epics::pvData;
+
+const char* NdArrayCodec::Lz4CodecName("lz4");
+const char* NdArrayCodec::Bslz4CodecName("bslz4");
+const char* NdArrayCodec::BloscCodecName("blosc");
+
+const char* NdArrayCodec::PayloadStartEnvVarName("PVAPY_COMPRESSED_PAYLOAD_START");
+const char* NdArrayCodec::PayloadEndEnvVarName("PVAPY_COMPRESSED_PAYLOAD_END");
+
+const unsigned int NdArrayCodec::MaxFreeBuffers(8);
+const int NdArrayCodec::MinLevel(0);
+const int NdArrayCodec::MaxLevel(9);
+const int NdArrayCodec::DefaultLevel(5);
+
+pvd::Mutex NdArrayCodec::mutex;
+std::multimap<size_t, char*> NdArrayCodec::freeBufferMap;
+bool NdArrayCodec::payloadInitialized(false);
+size_t NdArrayCodec::payloadStart(0);
+size_t NdArrayCodec::payloadEnd(0);
+
+// Bitshuffle constants; block size for a given element size must be
+// the same as in the bitshuffle library
+static const size_t BitshuffleTargetBlockSize(8192);
+static const size_t BitshuffleBlockMultiple(8);
+static const size_t BitshuffleMinBlockSize(128);
+static const size_t Bslz4BlocksPerTask(16);
+
+// LZ4 block format limits: last match must start at least 12 bytes
+// before the end of input, and last 5 bytes are always literals
+static const size_t Lz4MinMatch(4);
+static const size_t Lz4MatchFindLimit(12);
+static const size_t Lz4LastLiterals(5);
+static const size_t Lz4MaxDistance(65535);
+static const unsigned int Lz4SkipTrigger(6);
+static const unsigned int Lz4MinHashLog(8);
+static const unsigned int Lz4MaxHashLog(16);
+static const size_t Lz4MinChunkSize(256*1024);
+static const size_t Lz4ChunksPerThread(4);
+
+// Blosc1 frame header
+static const size_t BloscHeaderSize(16);
+static const unsigned char BloscDoShuffleFlag(0x01);
+static const unsigned char BloscMemcpyedFlag(0x02);
+static const unsigned char BloscDoBitshuffleFlag(0x04);
+static const unsigned char BloscDoDeltaFlag(0x08);
+static const unsigned char BloscDontSplitFlag(0x10);
+static const unsigned char BloscLzCompressor(0);
+static const unsigned char BloscLz4Compressor(1);
+static const unsigned char BloscFormatVersion(2);
+static const unsigned char BloscLz4FormatVersion(1);
+static const size_t BloscBlockSize(128*1024);
+static const size_t BloscMaxSize(0x7FFFFFFF - 16);
+static const size_t BloscLzMaxDistance(8191);
+
+static pvd::uint32 readLittleEndian32(const unsigned char* p)
+{
+    return pvd::uint32(p[0]) | (pvd::uint32(p[1]) << 8) | (pvd::uint32(p[2]) << 16) | (pvd::uint32(p[3]) << 24);
+}
+
+static pvd::uint32 readBigEndian32(const unsigned char* p)
+{
+    return (pvd::uint32(p[0]) << 24) | (pvd::uint32(p[1]) << 16) | (pvd::uint32(p[2]) << 8) | pvd::uint32(p[3]);
+}
+
+static void writeLittleEndian32(unsigned char* p, size_t value)
+{
+    p[0] = static_cast<unsigned char>(value);
+    p[1] = static_cast<unsigned char>(value >> 8);
+    p[2] = static_cast<unsigned char>(value >> 16);
+    p[3] = static_cast<unsigned char>(value >> 24);
+}
+
+static void writeBigEndian32(unsigned char* p, size_t value)
+{
+    p[0] = static_cast<unsigned char>(value >> 24);
+    p[1] = static_cast<unsigned char>(value >> 16);
+    p[2] = static_cast<unsigned char>(value >> 8);
+    p[3] = static_cast<unsigned char>(value);
+}
+
+static pvd::uint32 read32(const unsigned char* p)
+{
+    pvd::uint32 value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// Writes LZ4 length extension bytes
+static unsigned char* writeLz4Length(unsigned char* op, size_t length)
+{
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<unsigned char>(length);
+    return op;
+}
+
+// Writes LZ4 sequence token and literal run; match length bits
+// of the token are set by the caller
+static unsigned char* writeLz4Literals(unsigned char* op, const unsigned char* literals, size_t literalLength)
+{
+    unsigned char* token = op++;
+    if (literalLength >= 15) {
+        *token = 15 << 4;
+        op = writeLz4Length(op, literalLength - 15);
+    }
+    else {
+        *token = static_cast<unsigned char>(literalLength << 4);
+    }
+    memcpy(op, literals, literalLength);
+    return op + literalLength;
+}
+
+// Reads literal length of LZ4 sequence starting at given position, and
+// advances position to the first literal
+static size_t readLz4LiteralLength(const unsigned char*& ip)
+{
+    size_t literalLength = (*ip++) >> 4;
+    if (literalLength == 15) {
+        unsigned int s;
+        do {
+            s = *ip++;
+            literalLength += s;
+        } while (s == 255);
+    }
+    return literalLength;
+}
+
+// Transposes 8x8 bit matrix, where bytes are rows and bits are columns
+static pvd::uint64 transposeBits(pvd::uint64 x)
+{
+    pvd::uint64 t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+// Copies match byte by byte, as source may overlap destination
+static void copyMatch(unsigned char* op, const unsigned char* match, size_t length)
+{
+    if (size_t(op - match) >= length) {
+        memcpy(op, match, length);
+        return;
+    }
+    for (size_t i = 0; i < length; i++) {
+        op[i] = match[i];
+    }
+}
+
+bool NdArrayCodec::isSupported(const std::string& codecName)
+{
+    return (codecName == Lz4CodecName || codecName == Bslz4CodecName || codecName == BloscCodecName);
+}
+
+NdArrayCodec::BufferPtr NdArrayCodec::getBuffer(size_t size)
+{
+    {
+        pvd::Lock lock(mutex);
+        std::multimap<size_t, char*>::iterator it = freeBufferMap.lower_bound(size);
+        // Much larger buffers are kept for larger images
+        if (it != freeBufferMap.end() && it->first <= 2*size) {
+            size_t capacity = it->first;
+            char* buffer = it->second;
+            freeBufferMap.erase(it);
+            return BufferPtr(buffer, BufferReleaser(capacity));
+        }
+    }
+    size_t capacity = (size > 0 ? size : 1);
+    char* buffer = static_cast<char*>(malloc(capacity));
+    if (!buffer) {
+        throw std::bad_alloc();
+    }
+    return BufferPtr(buffer, BufferReleaser(capacity));
+}
+
+void NdArrayCodec::releaseBuffer(char* buffer, size_t capacity)
+{
+    {
+        pvd::Lock lock(mutex);
+        if (freeBufferMap.size() < MaxFreeBuffers) {
+            freeBufferMap.insert(std::pair<size_t, char*>(capacity, buffer));
+            return;
+        }
+    }
+    free(buffer);
+}
+
+void NdArrayCodec::getPayload(const char*& input, size_t& inputSize)
+{
+    {
+        pvd::Lock lock(mutex);
+        if (!payloadInitialized) {
+            payloadInitialized = true;
+            const char* start = getenv(PayloadStartEnvVarName);
+            const char* end = getenv(PayloadEndEnvVarName);
+            payloadStart = (start ? strtoul(start, NULL, 10) : 0);
+            payloadEnd = (end ? strtoul(end, NULL, 10) : 0);
+        }
+    }
+    size_t end = (payloadEnd && payloadEnd < inputSize ? payloadEnd : inputSize);
+    if (payloadStart && payloadStart >= end) {
+        throw InvalidArgument("Compressed payload boundaries [%llu, %llu) are outside of %llu byte input.", (unsigned long long)payloadStart, (unsigned long long)end, (unsigned long long)inputSize);
+    }
+    input += payloadStart;
+    inputSize = end - payloadStart;
+}
+
+void NdArrayCodec::decompress(const std::string& codecName, const char* input, size_t inputSize, char* output, size_t outputSize, size_t elementSize)
+{
+    if (!elementSize) {
+        throw InvalidArgument("Element size must be greater than zero.");
+    }
+    getPayload(input, inputSize);
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(input);
+    unsigned char* out = reinterpret_cast<unsigned char*>(output);
+    if (codecName == Lz4CodecName) {
+        size_t nBytes = lz4Decompress(in, inputSize, out, outputSize);
+        if (nBytes != outputSize) {
+            throw InvalidArgument("Decompressed lz4 data size of %llu bytes does not match expected size of %llu bytes.", (unsigned long long)nBytes, (unsigned long long)outputSize);
+        }
+    }
+    else if (codecName == Bslz4CodecName) {
+        bslz4Decompress(in, inputSize, out, outputSize, elementSize);
+    }
+    else if (codecName == BloscCodecName) {
+        bloscDecompress(in, inputSize, out, outputSize);
+    }
+    else {
+        throw InvalidRequest("Unsupported codec: %s", codecName.c_str());
+    }
+}
+
+size_t NdArrayCodec::compress(const std::string& codecName, const char* input, size_t inputSize, size_t elementSize, int level, int nThreads, BufferPtr& outputPtr)
+{
+    if (!elementSize) {
+        throw InvalidArgument("Element size must be greater than zero.");
+    }
+    if (level < MinLevel || level > MaxLevel) {
+        throw InvalidArgument("Compression level must be between %d and %d.", MinLevel, MaxLevel);
+    }
+    if (nThreads < 1) {
+        nThreads = epicsThreadGetCPUs();
+    }
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(input);
+    if (codecName == Lz4CodecName) {
+        return lz4Compress(in, inputSize, level, nThreads, outputPtr);
+    }
+    else if (codecName == Bslz4CodecName) {
+        return bslz4Compress(in, inputSize, elementSize, level, nThreads, outputPtr);
+    }
+    else if (codecName == BloscCodecName) {
+        return bloscCompress(in, inputSize, elementSize, level, nThreads, outputPtr);
+    }
+    throw InvalidRequest("Unsupported codec: %s", codecName.c_str());
+}
+
+pvd::Mutex NdArrayCodec::TaskRunner::workerMutex;
+epicsEvent NdArrayCodec::TaskRunner::workerEvent;
+std::deque<NdArrayCodec::TaskRunner*> NdArrayCodec::TaskRunner::workerRequestQueue;
+int NdArrayCodec::TaskRunner::nIdleWorkers(0);
+
+NdArrayCodec::TaskRunner::TaskRunner(size_t nTasks_)
+    : mutex()
+    , doneEvent()
+    , nTasks(nTasks_)
+    , nextTask(0)
+    , nActiveThreads(0)
+    , error()
+{
+}
+
+NdArrayCodec::TaskRunner::~TaskRunner()
+{
+}
+
+void NdArrayCodec::TaskRunner::run(int nThreads)
+{
+    if (size_t(nThreads) > nTasks) {
+        nThreads = int(nTasks);
+    }
+    if (nThreads < 1) {
+        nThreads = 1;
+    }
+    {
+        pvd::Lock lock(mutex);
+        nActiveThreads = nThreads;
+    }
+    if (nThreads > 1) {
+        requestWorkers(this, nThreads-1);
+    }
+    work();
+
+    // Requests that were not picked up by the time calling thread ran
+    // out of tasks are withdrawn, so that workers never see this runner
+    // after it returns
+    if (nThreads > 1) {
+        int nCancelled = cancelWorkers(this);
+        pvd::Lock lock(mutex);
+        nActiveThreads -= nCancelled;
+    }
+    while (true) {
+        {
+            pvd::Lock lock(mutex);
+            if (!nActiveThreads) {
+                break;
+            }
+        }
+        doneEvent.wait();
+    }
+    if (!error.empty()) {
+        throw InvalidState("Compression failed: %s", error.c_str());
+    }
+}
+
+void NdArrayCodec::TaskRunner::requestWorkers(TaskRunner* taskRunner, int nWorkers)
+{
+    pvd::Lock lock(workerMutex);
+    for (int i = 0; i < nWorkers; i++) {
+        workerRequestQueue.push_back(taskRunner);
+    }
+    int nNewWorkers = int(workerRequestQueue.size()) - nIdleWorkers;
+    for (int i = 0; i < nNewWorkers; i++) {
+        // If thread cannot be created, calling thread does the work
+        epicsThreadCreate("NdArrayCodec", epicsThreadPriorityMedium, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)workerThread, NULL);
+    }
+    workerEvent.signal();
+}
+
+int NdArrayCodec::TaskRunner::cancelWorkers(TaskRunner* taskRunner)
+{
+    pvd::Lock lock(workerMutex);
+    int nCancelled = 0;
+    std::deque<TaskRunner*>::iterator it = workerRequestQueue.begin();
+    while (it != workerRequestQueue.end()) {
+        if (*it == taskRunner) {
+            it = workerRequestQueue.erase(it);
+            nCancelled++;
+        }
+        else {
+            it++;
+        }
+    }
+    return nCancelled;
+}
+
+void NdArrayCodec::TaskRunner::workerThread(void*)
+{
+    while (true) {
+        TaskRunner* taskRunner = NULL;
+        {
+            pvd::Lock lock(workerMutex);
+            if (!workerRequestQueue.empty()) {
+                taskRunner = workerRequestQueue.front();
+                workerRequestQueue.pop_front();
+                if (!workerRequestQueue.empty()) {
+                    workerEvent.signal();
+                }
+            }
+            else {
+                nIdleWorkers++;
+            }
+        }
+        if (taskRunner) {
+            taskRunner->work();
+            continue;
+        }
+        workerEvent.wait();
+        pvd::Lock lock(workerMutex);
+        nIdleWorkers--;
+    }
+}
+
+void NdArrayCodec::TaskRunner::work()
+{
+    while (true) {
+        size_t taskId;
+        {
+            pvd::Lock lock(mutex);
+            if (nextTask >= nTasks || !error.empty()) {
+                break;
+            }
+            taskId = nextTask++;
+        }
+        try {
+            runTask(taskId);
+        }
+        catch (std::exception& ex) {
+            pvd::Lock lock(mutex);
+            if (error.empty()) {
+                error = ex.what();
+            }
+        }
+    }
+    pvd::Lock lock(mutex);
+    nActiveThreads--;
+    if (!nActiveThreads) {
+        doneEvent.signal();
+    }
+}
+
+// LZ4 block format: sequences of literal run followed by a match
+// that references previously decoded data
+size_t NdArrayCodec::lz4Decompress(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize)
+{
+    const unsigned char* ip = input;
+    const unsigned char* ipEnd = input + inputSize;
+    unsigned char* op = output;
+    unsigned char* opEnd = output + outputSize;
+    while (ip < ipEnd) {
+        unsigned int token = *ip++;
+        size_t literalLength = token >> 4;
+        if (literalLength == 15) {
+            unsigned int s;
+            do {
+                if (ip >= ipEnd) {
+                    throw InvalidArgument("Invalid lz4 data: truncated literal length.");
+                }
+                s = *ip++;
+                literalLength += s;
+            } while (s == 255);
+        }
+        if (literalLength > size_t(ipEnd - ip) || literalLength > size_t(opEnd - op)) {
+            throw InvalidArgument("Invalid lz4 data: literal run exceeds buffer size.");
+        }
+        memcpy(op, ip, literalLength);
+        ip += literalLength;
+        op += literalLength;
+
+        // Last sequence contains literals only
+        if (ip >= ipEnd) {
+            break;
+        }
+        if (ipEnd - ip < 2) {
+            throw InvalidArgument("Invalid lz4 data: truncated match offset.");
+        }
+        size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > size_t(op - output)) {
+            throw InvalidArgument("Invalid lz4 data: match offset out of range.");
+        }
+        size_t matchLength = token & 15;
+        if (matchLength == 15) {
+            unsigned int s;
+            do {
+                if (ip >= ipEnd) {
+                    throw InvalidArgument("Invalid lz4 data: truncated match length.");
+                }
+                s = *ip++;
+                matchLength += s;
+            } while (s == 255);
+        }
+        matchLength += 4;
+        if (matchLength > size_t(opEnd - op)) {
+            throw InvalidArgument("Invalid lz4 data: match exceeds buffer size.");
+        }
+        copyMatch(op, op - offset, matchLength);
+        op += matchLength;
+    }
+    return op - output;
+}
+
+// BloscLZ format: control byte is either literal run length, or match
+// length and high bits of match distance
+size_t NdArrayCodec::bloscLzDecompress(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize)
+{
+    if (!inputSize) {
+        return 0;
+    }
+    const unsigned char* ip = input;
+    const unsigned char* ipEnd = input + inputSize;
+    unsigned char* op = output;
+    unsigned char* opEnd = output + outputSize;
+    size_t ctrl = (*ip++) & 31;
+    while (true) {
+        if (ctrl >= 32) {
+            size_t length = (ctrl >> 5) - 1;
+            size_t distance = (ctrl & 31) << 8;
+            if (length == 6) {
+                unsigned int code;
+                do {
+                    if (ip >= ipEnd) {
+                        throw InvalidArgument("Invalid blosclz data: truncated match length.");
+                    }
+                    code = *ip++;
+                    length += code;
+                } while (code == 255);
+            }
+            if (ip >= ipEnd) {
+                throw InvalidArgument("Invalid blosclz data: truncated match distance.");
+            }
+            unsigned int code = *ip++;
+            length += 3;
+            distance += code;
+            if (code == 255 && (ctrl & 31) == 31) {
+                // Match from 16-bit distance
+                if (ipEnd - ip < 2) {
+                    throw InvalidArgument("Invalid blosclz data: truncated match distance.");
+                }
+                distance = (size_t(ip[0]) << 8) + ip[1] + BloscLzMaxDistance;
+                ip += 2;
+            }
+            distance += 1;
+            if (distance > size_t(op - output) || length > size_t(opEnd - op)) {
+                throw InvalidArgument("Invalid blosclz data: match out of range.");
+            }
+            copyMatch(op, op - distance, length);
+            op += length;
+        }
+        else {
+            size_t length = ctrl + 1;
+            if (length > size_t(ipEnd - ip) || length > size_t(opEnd - op)) {
+                throw InvalidArgument("Invalid blosclz data: literal run exceeds buffer size.");
+            }
+            memcpy(op, ip, length);
+            ip += length;
+            op += length;
+        }
+        if (ip >= ipEnd) {
+            break;
+        }
+        ctrl = *ip++;
+    }
+    return op - output;
+}
+
+// Reverses bitshuffle transposition of a block whose number of elements
+// is multiple of 8: input contains one row of nElements bits for each
+// bit of each element byte
+void NdArrayCodec::bitUnshuffle(const unsigned char* input, unsigned char* output, size_t nElements, size_t elementSize)
+{
+    size_t rowSize = nElements/8;
+    for (size_t j = 0; j < elementSize; j++) {
+        const unsigned char* rows = input + j*8*rowSize;
+        for (size_t i = 0; i < rowSize; i++) {
+            pvd::uint64 x = 0;
+            for (size_t k = 0; k < 8; k++) {
+                x |= pvd::uint64(rows[k*rowSize + i]) << (8*k);
+            }
+            x = transposeBits(x);
+            unsigned char* out = output + i*8*elementSize + j;
+            for (size_t m = 0; m < 8; m++) {
+                out[m*elementSize] = static_cast<unsigned char>(x >> (8*m));
+            }
+        }
+    }
+}
+
+// Reverses byte shuffle: input contains byte j of all elements, followed
+// by byte j+1, etc.; trailing bytes that do not form an element are
+// not shuffled
+void NdArrayCodec::byteUnshuffle(const unsigned char* input, unsigned char* output, size_t size, size_t elementSize)
+{
+    size_t nElements = size/elementSize;
+    for (size_t j = 0; j < elementSize; j++) {
+        const unsigned char* in = input + j*nElements;
+        for (size_t i = 0; i < nElements; i++) {
+            output[i*elementSize + j] = in[i];
+        }
+    }
+    size_t offset = nElements*elementSize;
+    memcpy(output + offset, input + offset, size - offset);
+}
+
+// Bitshuffle/LZ4 stream: each block of elements is bitshuffled and
+// compressed separately, and is preceded by its big endian compressed
+// size; elements that do not fill a multiple of 8 are stored as is
+void NdArrayCodec::bslz4Decompress(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize, size_t elementSize)
+{
+    size_t blockSize = getBslz4BlockSize(elementSize);
+    std::vector<unsigned char> block(blockSize*elementSize);
+
+    const unsigned char* ip = input;
+    const unsigned char* ipEnd = input + inputSize;
+    unsigned char* op = output;
+    size_t nLeft = outputSize/elementSize;
+    while (nLeft >= BitshuffleBlockMultiple) {
+        size_t nElements = (nLeft >= blockSize ? blockSize : nLeft - nLeft % BitshuffleBlockMultiple);
+        size_t nBytes = nElements*elementSize;
+        if (ipEnd - ip < 4) {
+            throw InvalidArgument("Invalid bslz4 data: truncated block size.");
+        }
+        size_t compressedSize = readBigEndian32(ip);
+        ip += 4;
+        if (compressedSize > size_t(ipEnd - ip)) {
+            throw InvalidArgument("Invalid bslz4 data: block size exceeds input size.");
+        }
+        if (lz4Decompress(ip, compressedSize, &block[0], nBytes) != nBytes) {
+            throw InvalidArgument("Invalid bslz4 data: unexpected decompressed block size.");
+        }
+        bitUnshuffle(&block[0], op, nElements, elementSize);
+        ip += compressedSize;
+        op += nBytes;
+        nLeft -= nElements;
+    }
+    size_t nBytes = outputSize - (op - output);
+    if (nBytes > size_t(ipEnd - ip)) {
+        throw InvalidArgument("Invalid bslz4 data: truncated uncompressed elements.");
+    }
+    memcpy(op, ip, nBytes);
+}
+
+// Blosc1 frame: header, block offsets, and blocks; each block may be
+// split into one stream per element byte
+void NdArrayCodec::bloscDecompress(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize)
+{
+    if (inputSize < BloscHeaderSize) {
+        throw InvalidArgument("Invalid blosc data: truncated header.");
+    }
+    unsigned char version = input[0];
+    unsigned char flags = input[2];
+    size_t typeSize = input[3];
+    size_t nBytes = readLittleEndian32(input + 4);
+    size_t blockSize = readLittleEndian32(input + 8);
+    size_t compressedSize = readLittleEndian32(input + 12);
+    if (nBytes != outputSize) {
+        throw InvalidArgument("Blosc data size of %llu bytes does not match expected size of %llu bytes.", (unsigned long long)nBytes, (unsigned long long)outputSize);
+    }
+    if (compressedSize > inputSize || compressedSize < BloscHeaderSize) {
+        throw InvalidArgument("Invalid blosc data: frame size of %llu bytes is not valid for input size of %llu bytes.", (unsigned long long)compressedSize, (unsigned long long)inputSize);
+    }
+    if (flags & BloscMemcpyedFlag) {
+        if (BloscHeaderSize + nBytes > inputSize) {
+            throw InvalidArgument("Invalid blosc data: truncated frame.");
+        }
+        memcpy(output, input + BloscHeaderSize, nBytes);
+        return;
+    }
+    if (version >= 3 && (flags & BloscDoShuffleFlag) && (flags & BloscDoBitshuffleFlag)) {
+        throw InvalidRequest("Blosc2 extended headers are not supported.");
+    }
+    if (flags & BloscDoDeltaFlag) {
+        throw InvalidRequest("Blosc delta filter is not supported.");
+    }
+    unsigned char compressor = flags >> 5;
+    if (compressor != BloscLzCompressor && compressor != BloscLz4Compressor) {
+        throw InvalidRequest("Blosc compressor %d is not supported.", int(compressor));
+    }
+    if (!nBytes) {
+        return;
+    }
+    if (!blockSize || !typeSize) {
+        throw InvalidArgument("Invalid blosc data: zero block or type size.");
+    }
+    // Header fields are not trusted; block buffer is allocated
+    // with the block size
+    if (blockSize > nBytes) {
+        throw InvalidArgument("Invalid blosc data: block size of %llu bytes exceeds data size of %llu bytes.", (unsigned long long)blockSize, (unsigned long long)nBytes);
+    }
+
+    size_t nBlocks = (nBytes + blockSize - 1)/blockSize;
+    if (nBlocks > (compressedSize - BloscHeaderSize)/4) {
+        throw InvalidArgument("Invalid blosc data: truncated block offsets.");
+    }
+    bool doShuffle = ((flags & BloscDoShuffleFlag) && typeSize > 1);
+    bool doBitshuffle = (flags & BloscDoBitshuffleFlag);
+    std::vector<unsigned char> block((doShuffle || doBitshuffle) ? blockSize : 0);
+    const unsigned char* ipEnd = input + compressedSize;
+    for (size_t i = 0; i < nBlocks; i++) {
+        size_t offset = i*blockSize;
+        size_t bSize = (offset + blockSize > nBytes ? nBytes - offset : blockSize);
+        bool leftoverBlock = (bSize != blockSize);
+        size_t nStreams = (!(flags & BloscDontSplitFlag) && !leftoverBlock ? typeSize : 1);
+        size_t streamSize = bSize/nStreams;
+
+        size_t blockStart = readLittleEndian32(input + BloscHeaderSize + 4*i);
+        if (blockStart >= compressedSize) {
+            throw InvalidArgument("Invalid blosc data: block offset out of range.");
+        }
+        const unsigned char* ip = input + blockStart;
+        unsigned char* dest = (block.size() ? &block[0] : output + offset);
+        for (size_t j = 0; j < nStreams; j++) {
+            if (ipEnd - ip < 4) {
+                throw InvalidArgument("Invalid blosc data: truncated stream size.");
+            }
+            size_t streamCompressedSize = readLittleEndian32(ip);
+            ip += 4;
+            if (streamCompressedSize > size_t(ipEnd - ip)) {
+                throw InvalidArgument("Invalid blosc data: stream size exceeds frame size.");
+            }
+            unsigned char* streamDest = dest + j*streamSize;
+            if (streamCompressedSize == streamSize) {
+                // Incompressible stream is stored as is
+                memcpy(streamDest, ip, streamSize);
+            }
+            else {
+                size_t n = (compressor == BloscLz4Compressor ? lz4Decompress(ip, streamCompressedSize, streamDest, streamSize) : bloscLzDecompress(ip, streamCompressedSize, streamDest, streamSize));
+                if (n != streamSize) {
+                    throw InvalidArgument("Invalid blosc data: unexpected decompressed stream size.");
+                }
+            }
+            ip += streamCompressedSize;
+        }
+
+        if (doShuffle) {
+            byteUnshuffle(dest, output + offset, bSize, typeSize);
+        }
+        else if (doBitshuffle) {
+            size_t nElements = bSize/typeSize;
+            if (version <= 2 && nElements % 8) {
+                // Older format does not shuffle such blocks
+                memcpy(output + offset, dest, bSize);
+                continue;
+            }
+            nElements -= nElements % 8;
+            bitUnshuffle(dest, output + offset, nElements, typeSize);
+            size_t nShuffled = nElements*typeSize;
+            memcpy(output + offset + nShuffled, dest + nShuffled, bSize - nShuffled);
+        }
+    }
+}
+
+// Number of elements in a bitshuffle block
+size_t NdArrayCodec::getBslz4BlockSize(size_t elementSize)
+{
+    size_t blockSize = BitshuffleTargetBlockSize/elementSize;
+    blockSize = blockSize/BitshuffleBlockMultiple*BitshuffleBlockMultiple;
+    if (blockSize < BitshuffleMinBlockSize) {
+        blockSize = BitshuffleMinBlockSize;
+    }
+    return blockSize;
+}
+
+size_t NdArrayCodec::getLz4MaxCompressedSize(size_t inputSize)
+{
+    return inputSize + inputSize/255 + 16;
+}
+
+// Greedy LZ4 compression of a single block. Positions in the hash table
+// are verified before use, so that the table can be reused for multiple
+// inputs without clearing. Lower levels skip faster over data without
+// matches, and higher levels use larger hash table.
+size_t NdArrayCodec::lz4Compress(const unsigned char* input, size_t inputSize, unsigned char* output, int level, std::vector<pvd::uint32>& hashTable, size_t& lastSequenceOffset)
+{
+    const unsigned char* ip = input;
+    const unsigned char* anchor = input;
+    const unsigned char* ipEnd = input + inputSize;
+    unsigned char* op = output;
+    if (inputSize > Lz4MatchFindLimit) {
+        unsigned int hashLog = Lz4MinHashLog + 2 + level/2;
+        while (hashLog > Lz4MinHashLog && (size_t(1) << hashLog) > inputSize) {
+            hashLog--;
+        }
+        if (hashLog > Lz4MaxHashLog) {
+            hashLog = Lz4MaxHashLog;
+        }
+        if (hashTable.size() < (size_t(1) << hashLog)) {
+            hashTable.resize(size_t(1) << hashLog, 0);
+        }
+        unsigned int hashShift = 32 - hashLog;
+        size_t acceleration = (level >= DefaultLevel ? 1 : 1 + DefaultLevel - level);
+        const unsigned char* mfLimit = ipEnd - Lz4MatchFindLimit;
+        const unsigned char* matchLimit = ipEnd - Lz4LastLiterals;
+        ip++;
+        while (ip <= mfLimit) {
+            const unsigned char* match = NULL;
+            size_t searchCount = acceleration << Lz4SkipTrigger;
+            while (ip <= mfLimit) {
+                pvd::uint32 sequence = read32(ip);
+                pvd::uint32& entry = hashTable[(sequence*2654435761U) >> hashShift];
+                size_t candidate = entry;
+                size_t position = ip - input;
+                entry = pvd::uint32(position);
+                if (candidate < position && position - candidate <= Lz4MaxDistance && read32(input + candidate) == sequence) {
+                    match = input + candidate;
+                    break;
+                }
+                ip += (searchCount++ >> Lz4SkipTrigger);
+            }
+            if (!match) {
+                break;
+            }
+
+            // Extend match backwards over pending literals, and forward
+            while (ip > anchor && match > input && ip[-1] == match[-1]) {
+                ip--;
+                match--;
+            }
+            const unsigned char* matchEnd = ip + Lz4MinMatch;
+            const unsigned char* m = match + Lz4MinMatch;
+            while (matchEnd < matchLimit && *matchEnd == *m) {
+                matchEnd++;
+                m++;
+            }
+            size_t matchLength = matchEnd - ip - Lz4MinMatch;
+            size_t offset = ip - match;
+
+            unsigned char* token = op;
+            op = writeLz4Literals(op, anchor, ip - anchor);
+            *op++ = static_cast<unsigned char>(offset);
+            *op++ = static_cast<unsigned char>(offset >> 8);
+            if (matchLength >= 15) {
+                *token |= 15;
+                op = writeLz4Length(op, matchLength - 15);
+            }
+            else {
+                *token |= static_cast<unsigned char>(matchLength);
+            }
+            ip = matchEnd;
+            anchor = ip;
+            if (ip <= mfLimit) {
+                hashTable[(read32(ip - 2)*2654435761U) >> hashShift] = pvd::uint32(ip - 2 - input);
+            }
+        }
+    }
+    lastSequenceOffset = op - output;
+    return writeLz4Literals(op, anchor, ipEnd - anchor) - output;
+}
+
+// Compresses input chunks into separate output slots
+class NdArrayCodec::Lz4TaskRunner : public NdArrayCodec::TaskRunner
+{
+public:
+    Lz4TaskRunner(const unsigned char* input_, size_t inputSize_, size_t chunkSize_, size_t nChunks, int level_)
+        : TaskRunner(nChunks)
+        , input(input_)
+        , inputSize(inputSize_)
+        , chunkSize(chunkSize_)
+        , slotSize(getLz4MaxCompressedSize(chunkSize_))
+        , level(level_)
+        , bufferPtr(getBuffer(nChunks*slotSize))
+        , compressedSizes(nChunks)
+        , lastSequenceOffsets(nChunks)
+    {
+    }
+
+    virtual void runTask(size_t taskId)
+    {
+        size_t offset = taskId*chunkSize;
+        size_t size = (offset + chunkSize > inputSize ? inputSize - offset : chunkSize);
+        std::vector<pvd::uint32> hashTable;
+        compressedSizes[taskId] = lz4Compress(input + offset, size, getSlot(taskId), level, hashTable, lastSequenceOffsets[taskId]);
+    }
+
+    unsigned char* getSlot(size_t taskId)
+    {
+        return reinterpret_cast<unsigned char*>(bufferPtr.get()) + taskId*slotSize;
+    }
+
+    const unsigned char* input;
+    size_t inputSize;
+    size_t chunkSize;
+    size_t slotSize;
+    int level;
+    BufferPtr bufferPtr;
+    std::vector<size_t> compressedSizes;
+    std::vector<size_t> lastSequenceOffsets;
+};
+
+// Input is split into chunks that are compressed in parallel; matches
+// do not cross chunk boundaries. Chunks are merged into a single LZ4
+// block by joining trailing literals of each chunk with leading
+// literals of the next one.
+size_t NdArrayCodec::lz4Compress(const unsigned char* input, size_t inputSize, int level, int nThreads, BufferPtr& outputPtr)
+{
+    size_t nChunks = 1;
+    if (nThreads > 1 && inputSize >= 2*Lz4MinChunkSize) {
+        nChunks = inputSize/Lz4MinChunkSize;
+        if (nChunks > nThreads*Lz4ChunksPerThread) {
+            nChunks = nThreads*Lz4ChunksPerThread;
+        }
+    }
+    std::vector<pvd::uint32> hashTable;
+    size_t lastSequenceOffset;
+    if (nChunks == 1) {
+        outputPtr = getBuffer(getLz4MaxCompressedSize(inputSize));
+        return lz4Compress(input, inputSize, reinterpret_cast<unsigned char*>(outputPtr.get()), level, hashTable, lastSequenceOffset);
+    }
+
+    size_t chunkSize = (inputSize + nChunks - 1)/nChunks;
+    nChunks = (inputSize + chunkSize - 1)/chunkSize;
+    Lz4TaskRunner taskRunner(input, inputSize, chunkSize, nChunks, level);
+    taskRunner.run(nThreads);
+
+    // Merging does not increase total size of compressed chunks
+    size_t outputSize = 0;
+    for (size_t i = 0; i < nChunks; i++) {
+        outputSize += taskRunner.compressedSizes[i];
+    }
+    outputPtr = getBuffer(outputSize);
+    unsigned char* output = reinterpret_cast<unsigned char*>(outputPtr.get());
+    unsigned char* op = output;
+    const unsigned char* literals = input;
+    for (size_t i = 0; i < nChunks; i++) {
+        const unsigned char* chunk = input + i*chunkSize;
+        const unsigned char* chunkEnd = (i == nChunks-1 ? input + inputSize : chunk + chunkSize);
+        const unsigned char* slot = taskRunner.getSlot(i);
+        const unsigned char* lastSequence = slot + taskRunner.lastSequenceOffsets[i];
+        if (lastSequence == slot) {
+            // Chunk without matches
+            continue;
+        }
+        const unsigned char* ip = slot;
+        unsigned char matchToken = *ip & 15;
+        size_t literalLength = readLz4LiteralLength(ip);
+        unsigned char* token = op;
+        op = writeLz4Literals(op, literals, chunk + literalLength - literals);
+        *token |= matchToken;
+        ip += literalLength;
+        memcpy(op, ip, lastSequence - ip);
+        op += lastSequence - ip;
+        ip = lastSequence;
+        literals = chunkEnd - readLz4LiteralLength(ip);
+    }
+    return writeLz4Literals(op, literals, input + inputSize - literals) - output;
+}
+
+// Bitshuffle transposition of a block whose number of elements is
+// multiple of 8
+void NdArrayCodec::bitShuffle(const unsigned char* input, unsigned char* output, size_t nElements, size_t elementSize)
+{
+    size_t rowSize = nElements/8;
+    for (size_t j = 0; j < elementSize; j++) {
+        unsigned char* rows = output + j*8*rowSize;
+        for (size_t i = 0; i < rowSize; i++) {
+            const unsigned char* in = input + i*8*elementSize + j;
+            pvd::uint64 x = 0;
+            for (size_t m = 0; m < 8; m++) {
+                x |= pvd::uint64(in[m*elementSize]) << (8*m);
+            }
+            x = transposeBits(x);
+            for (size_t k = 0; k < 8; k++) {
+                rows[k*rowSize + i] = static_cast<unsigned char>(x >> (8*k));
+            }
+        }
+    }
+}
+
+void NdArrayCodec::byteShuffle(const unsigned char* input, unsigned char* output, size_t size, size_t elementSize)
+{
+    size_t nElements = size/elementSize;
+    for (size_t j = 0; j < elementSize; j++) {
+        unsigned char* out = output + j*nElements;
+        for (size_t i = 0; i < nElements; i++) {
+            out[i] = input[i*elementSize + j];
+        }
+    }
+    size_t offset = nElements*elementSize;
+    memcpy(output + offset, input + offset, size - offset);
+}
+
+// Compresses groups of bitshuffle blocks into output slots, each
+// holding compressed block size and data
+class NdArrayCodec::Bslz4TaskRunner : public NdArrayCodec::TaskRunner
+{
+public:
+    Bslz4TaskRunner(const unsigned char* input_, size_t elementSize_, size_t blockSize_, size_t nBlocks_, size_t nElements_, int level_, unsigned char* output_)
+        : TaskRunner((nBlocks_ + Bslz4BlocksPerTask - 1)/Bslz4BlocksPerTask)
+        , input(input_)
+        , elementSize(elementSize_)
+        , blockSize(blockSize_)
+        , nBlocks(nBlocks_)
+        , nElements(nElements_)
+        , slotSize(4 + getLz4MaxCompressedSize(blockSize_*elementSize_))
+        , level(level_)
+        , output(output_)
+        , compressedSizes(nBlocks_)
+    {
+    }
+
+    virtual void runTask(size_t taskId)
+    {
+        std::vector<unsigned char> block(blockSize*elementSize);
+        std::vector<pvd::uint32> hashTable;
+        size_t lastSequenceOffset;
+        for (size_t i = taskId*Bslz4BlocksPerTask; i < nBlocks && i < (taskId+1)*Bslz4BlocksPerTask; i++) {
+            size_t n = blockSize;
+            if ((i+1)*blockSize > nElements) {
+                n = nElements - i*blockSize;
+            }
+            bitShuffle(input + i*blockSize*elementSize, &block[0], n, elementSize);
+            unsigned char* slot = getSlot(i);
+            compressedSizes[i] = lz4Compress(&block[0], n*elementSize, slot + 4, level, hashTable, lastSequenceOffset);
+            writeBigEndian32(slot, compressedSizes[i]);
+        }
+    }
+
+    unsigned char* getSlot(size_t blockId)
+    {
+        return output + blockId*slotSize;
+    }
+
+    const unsigned char* input;
+    size_t elementSize;
+    size_t blockSize;
+    size_t nBlocks;
+    size_t nElements;
+    size_t slotSize;
+    int level;
+    unsigned char* output;
+    std::vector<size_t> compressedSizes;
+};
+
+// Output has the same format as bitshuffle library output without header;
+// compressed blocks are moved next to each other once all are done
+size_t NdArrayCodec::bslz4Compress(const unsigned char* input, size_t inputSize, size_t elementSize, int level, int nThreads, BufferPtr& outputPtr)
+{
+    size_t blockSize = getBslz4BlockSize(elementSize);
+    size_t nElements = inputSize/elementSize;
+    // Elements that do not fill a multiple of 8 are not shuffled
+    nElements -= nElements % BitshuffleBlockMultiple;
+    size_t nBlocks = (nElements + blockSize - 1)/blockSize;
+    size_t slotSize = 4 + getLz4MaxCompressedSize(blockSize*elementSize);
+    size_t nLeftoverBytes = inputSize - nElements*elementSize;
+    outputPtr = getBuffer(nBlocks*slotSize + nLeftoverBytes);
+    unsigned char* output = reinterpret_cast<unsigned char*>(outputPtr.get());
+    unsigned char* op = output;
+    if (nBlocks) {
+        Bslz4TaskRunner taskRunner(input, elementSize, blockSize, nBlocks, nElements, level, output);
+        taskRunner.run(nThreads);
+        for (size_t i = 0; i < nBlocks; i++) {
+            size_t n = 4 + taskRunner.compressedSizes[i];
+            memmove(op, taskRunner.getSlot(i), n);
+            op += n;
+        }
+    }
+    memcpy(op, input + nElements*elementSize, nLeftoverBytes);
+    return op + nLeftoverBytes - output;
+}
+
+// Shuffles and compresses blosc blocks into output slots, each holding
+// a single stream; incompressible streams are stored as is
+class NdArrayCodec::BloscTaskRunner : public NdArrayCodec::TaskRunner
+{
+public:
+    BloscTaskRunner(const unsigned char* input_, size_t inputSize_, size_t typeSize_, size_t blockSize_, size_t nBlocks, int level_, unsigned char* output_)
+        : TaskRunner(nBlocks)
+        , input(input_)
+        , inputSize(inputSize_)
+        , typeSize(typeSize_)
+        , blockSize(blockSize_)
+        , slotSize(4 + getLz4MaxCompressedSize(blockSize_))
+        , level(level_)
+        , output(output_)
+        , compressedSizes(nBlocks)
+    {
+    }
+
+    virtual void runTask(size_t taskId)
+    {
+        size_t offset = taskId*blockSize;
+        size_t bSize = (offset + blockSize > inputSize ? inputSize - offset : blockSize);
+        const unsigned char* block = input + offset;
+        std::vector<unsigned char> shuffledBlock;
+        if (typeSize > 1) {
+            shuffledBlock.resize(bSize);
+            byteShuffle(block, &shuffledBlock[0], bSize, typeSize);
+            block = &shuffledBlock[0];
+        }
+        unsigned char* slot = getSlot(taskId);
+        std::vector<pvd::uint32> hashTable;
+        size_t lastSequenceOffset;
+        size_t compressedSize = lz4Compress(block, bSize, slot + 4, level, hashTable, lastSequenceOffset);
+        if (compressedSize >= bSize) {
+            memcpy(slot + 4, block, bSize);
+            compressedSize = bSize;
+        }
+        writeLittleEndian32(slot, compressedSize);
+        compressedSizes[taskId] = compressedSize;
+    }
+
+    unsigned char* getSlot(size_t blockId)
+    {
+        return output + blockId*slotSize;
+    }
+
+    const unsigned char* input;
+    size_t inputSize;
+    size_t typeSize;
+    size_t blockSize;
+    size_t slotSize;
+    int level;
+    unsigned char* output;
+    std::vector<size_t> compressedSizes;
+};
+
+// Blosc1 frame with lz4 compressor, byte shuffle, and blocks that are
+// not split into streams; data that does not compress is stored as is
+size_t NdArrayCodec::bloscCompress(const unsigned char* input, size_t inputSize, size_t elementSize, int level, int nThreads, BufferPtr& outputPtr)
+{
+    if (inputSize > BloscMaxSize) {
+        throw InvalidArgument("Input size of %llu bytes exceeds maximum blosc frame size.", (unsigned long long)inputSize);
+    }
+    size_t typeSize = (elementSize > 255 ? 1 : elementSize);
+    size_t blockSize = (inputSize < BloscBlockSize ? inputSize : BloscBlockSize/typeSize*typeSize);
+    size_t nBlocks = (blockSize ? (inputSize + blockSize - 1)/blockSize : 0);
+    size_t slotSize = 4 + getLz4MaxCompressedSize(blockSize);
+    size_t headerSize = BloscHeaderSize + 4*nBlocks;
+    size_t outputSize = headerSize + nBlocks*slotSize;
+    if (outputSize < BloscHeaderSize + inputSize) {
+        outputSize = BloscHeaderSize + inputSize;
+    }
+    outputPtr = getBuffer(outputSize);
+    unsigned char* output = reinterpret_cast<unsigned char*>(outputPtr.get());
+    unsigned char flags = BloscDontSplitFlag | (BloscLz4Compressor << 5);
+    if (typeSize > 1) {
+        flags |= BloscDoShuffleFlag;
+    }
+    output[0] = BloscFormatVersion;
+    output[1] = BloscLz4FormatVersion;
+    output[3] = static_cast<unsigned char>(typeSize);
+    writeLittleEndian32(output + 4, inputSize);
+    writeLittleEndian32(output + 8, blockSize);
+
+    size_t compressedSize = headerSize;
+    if (level > 0 && nBlocks) {
+        BloscTaskRunner taskRunner(input, inputSize, typeSize, blockSize, nBlocks, level, output + headerSize);
+        taskRunner.run(nThreads);
+        unsigned char* op = output + headerSize;
+        for (size_t i = 0; i < nBlocks; i++) {
+            writeLittleEndian32(output + BloscHeaderSize + 4*i, op - output);
+            size_t n = 4 + taskRunner.compressedSizes[i];
+            memmove(op, taskRunner.getSlot(i), n);
+            op += n;
+        }
+        compressedSize = op - output;
+    }
+    if (level == 0 || compressedSize >= BloscHeaderSize + inputSize) {
+        flags |= BloscMemcpyedFlag;
+        memcpy(output + BloscHeaderSize, input, inputSize);
+        compressedSize = BloscHeaderSize + inputSize;
+    }
+    output[2] = flags;
+    writeLittleEndian32(output + 12, compressedSize);
+    return compressedSize;
+}
@@ -0,0 +1,129 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef ND_ARRAY_CODEC_H
+#define ND_ARRAY_CODEC_H
+
+#include <string>
+#include <map>
+#include <deque>
+#include <vector>
+#include <epicsEvent.h>
+#include "pv/pvData.h"
+
+// Native codecs for compressed area detector array data. Supported
+// codecs are lz4 (LZ4 block), bslz4 (bitshuffle/LZ4 stream without
+// header, as produced by area detector codec plugin), and blosc (blosc1
+// frames compressed with blosclz or lz4 for decoding, and with lz4 and
+// byte shuffle for encoding). Codecs do not use python, and can be
+// called without GIL.
+//
+// Compression splits input into blocks that are compressed by the
+// given number of threads; lz4 blocks are merged into a single LZ4
+// block, so that compressed data can be decoded by any LZ4 decoder.
+//
+// Output data is placed into buffers taken from a process-wide pool;
+// buffer is returned to the pool when the last reference is gone, so
+// that repeated processing of images of the same size does not allocate.
+class NdArrayCodec
+{
+public:
+    static const char* Lz4CodecName;
+    static const char* Bslz4CodecName;
+    static const char* BloscCodecName;
+
+    static const char* PayloadStartEnvVarName;
+    static const char* PayloadEndEnvVarName;
+
+    static const unsigned int MaxFreeBuffers;
+    static const int MinLevel;
+    static const int MaxLevel;
+    static const int DefaultLevel;
+
+    typedef std::tr1::shared_ptr<char> BufferPtr;
+
+    static bool isSupported(const std::string& codecName);
+
+    // Returns buffer of at least given size
+    static BufferPtr getBuffer(size_t size);
+
+    // Decodes input into output buffer of uncompressed size; element
+    // size is used for bitshuffle. Compressed payload boundaries can
+    // be adjusted using environment variables, which is needed for
+    // data read from some HDF5 files.
+    static void decompress(const std::string& codecName, const char* input, size_t inputSize, char* output, size_t outputSize, size_t elementSize);
+
+    // Compresses input into a new buffer and returns compressed size;
+    // higher levels trade speed for compression ratio, and blosc level 0
+    // stores data as is. Number of threads less than one means number
+    // of available CPUs.
+    static size_t compress(const std::string& codecName, const char* input, size_t inputSize, size_t elementSize, int level, int nThreads, BufferPtr& outputPtr);
+
+private:
+    // Runs independent tasks using calling thread and threads from a
+    // process-wide worker pool; pool threads are created on demand and
+    // kept for subsequent calls. First error is rethrown after all
+    // workers are done.
+    class TaskRunner
+    {
+    public:
+        TaskRunner(size_t nTasks);
+        virtual ~TaskRunner();
+        void run(int nThreads);
+        virtual void runTask(size_t taskId) = 0;
+    private:
+        static void requestWorkers(TaskRunner* taskRunner, int nWorkers);
+        static int cancelWorkers(TaskRunner* taskRunner);
+        static void workerThread(void*);
+        void work();
+        epics::pvData::Mutex mutex;
+        epicsEvent doneEvent;
+        size_t nTasks;
+        size_t nextTask;
+        int nActiveThreads;
+        std::string error;
+
+        static epics::pvData::Mutex workerMutex;
+        static epicsEvent workerEvent;
+        static std::deque<TaskRunner*> workerRequestQueue;
+        static int nIdleWorkers;
+    };
+
+    class Lz4TaskRunner;
+    class Bslz4TaskRunner;
+    class BloscTaskRunner;
+
+    struct BufferReleaser
+    {
+        BufferReleaser(size_t capacity_) : capacity(capacity_) {}
+        void operator()(char* buffer) { releaseBuffer(buffer, capacity); }
+        size_t capacity;
+    };
+
+    static void releaseBuffer(char* buffer, size_t capacity);
+    static void getPayload(const char*& input, size_t& inputSize);
+
+    static size_t lz4Decompress(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize);
+    static size_t bloscLzDecompress(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize);
+    static void bslz4Decompress(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize, size_t elementSize);
+    static void bloscDecompress(const unsigned char* input, size_t inputSize, unsigned char* output, size_t outputSize);
+    static void bitUnshuffle(const unsigned char* input, unsigned char* output, size_t nElements, size_t elementSize);
+    static void byteUnshuffle(const unsigned char* input, unsigned char* output, size_t size, size_t elementSize);
+
+    static size_t getBslz4BlockSize(size_t elementSize);
+    static size_t getLz4MaxCompressedSize(size_t inputSize);
+    static size_t lz4Compress(const unsigned char* input, size_t inputSize, unsigned char* output, int level, std::vector<epics::pvData::uint32>& hashTable, size_t& lastSequenceOffset);
+    static size_t lz4Compress(const unsigned char* input, size_t inputSize, int level, int nThreads, BufferPtr& outputPtr);
+    static size_t bslz4Compress(const unsigned char* input, size_t inputSize, size_t elementSize, int level, int nThreads, BufferPtr& outputPtr);
+    static size_t bloscCompress(const unsigned char* input, size_t inputSize, size_t elementSize, int level, int nThreads, BufferPtr& outputPtr);
+    static void bitShuffle(const unsigned char* input, unsigned char* output, size_t nElements, size_t elementSize);
+    static void byteShuffle(const unsigned char* input, unsigned char* output, size_t size, size_t elementSize);
+
+    static epics::pvData::Mutex mutex;
+    static std::multimap<size_t, char*> freeBufferMap;
+    static bool payloadInitialized;
+    static size_t payloadStart;
+    static size_t payloadEnd;
+};
+
+#endif
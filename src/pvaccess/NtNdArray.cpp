@@ -6,7 +6,10 @@
 #include "StringUtility.h"
 #include "PyPvDataUtility.h"
 #include "InvalidArgument.h"
+#include "InvalidState.h"
 #include "NtAttribute.h"
+#include "NdArrayCodec.h"
+#include "PyGilRelease.h"
 #include "pv/ntndarray.h"
 
 namespace nt = epics::nt;
@@ -36,6 +39,13 @@ const char* NtNdArray::DisplayFieldKey("display");
 const char* NtNdArray::UncompressedSizeFieldKey("uncompressedSize");
 const char* NtNdArray::UniqueIdFieldKey("uniqueId");
 
+// Area detector color modes
+const char* NtNdArray::ColorModeAttributeName("ColorMode");
+const int NtNdArray::ColorModeMono(0);
+const int NtNdArray::ColorModeRgb1(2);
+const int NtNdArray::ColorModeRgb2(3);
+const int NtNdArray::ColorModeRgb3(4);
+
 bp::dict NtNdArray::createStructureDict(const bp::dict& extraFieldsDict)
 {
     bp::dict structureDict;
@@ -129,6 +139,29 @@ void NtNdArray::setValue(const bp::dict& pyDict)
     setUnion(pyDict);
 }
 
+// Without copy, array value given as NumPy array shares its data
+void NtNdArray::setValue(const bp::dict& pyDict, bool copy)
+{
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+    if (!copy && bp::len(pyDict) == 1) {
+        bp::list keys = pyDict.keys();
+        bp::object pyObject = pyDict[keys[0]];
+        if (PyUtility::isNumPyNDArray(pyObject)) {
+            std::string key = PyUtility::extractStringFromPyObject(keys[0]);
+            pvd::PVUnionPtr pvUnionPtr = PyPvDataUtility::getUnionField(PvaConstants::ValueFieldKey, pvStructurePtr);
+            if (pvUnionPtr->getUnion()->getFieldIndex(key) < 0) {
+                throw InvalidDataType("Invalid array value field name: %s", key.c_str());
+            }
+            pvd::PVScalarArrayPtr pvScalarArrayPtr = pvUnionPtr->select<pvd::PVScalarArray>(key);
+            numpy_::ndarray ndArray = PyUtility::extractValueFromPyObject<numpy_::ndarray>(pyObject);
+            PyPvDataUtility::setScalarArrayFromNumPyArray(ndArray, pvScalarArrayPtr, false);
+            return;
+        }
+    }
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+    setUnion(pyDict);
+}
+
 void NtNdArray::setValue(const PvObject& pvObject)
 {
     setUnion(pvObject);
@@ -151,22 +184,22 @@ PvCodec NtNdArray::getCodec() const
 
 void NtNdArray::setCompressedSize(int value)
 {
-    pvStructurePtr->getSubField<epics::pvData::PVInt>(CompressedSizeFieldKey)->put(value);
+    pvStructurePtr->getSubField<pvd::PVScalar>(CompressedSizeFieldKey)->putFrom<pvd::int32>(value);
 }
 
 int NtNdArray::getCompressedSize() const
 {
-    return pvStructurePtr->getSubField<epics::pvData::PVInt>(CompressedSizeFieldKey)->get();
+    return pvStructurePtr->getSubField<pvd::PVScalar>(CompressedSizeFieldKey)->getAs<pvd::int32>();
 }
 
 void NtNdArray::setUncompressedSize(int value)
 {
-    pvStructurePtr->getSubField<epics::pvData::PVInt>(UncompressedSizeFieldKey)->put(value);
+    pvStructurePtr->getSubField<pvd::PVScalar>(UncompressedSizeFieldKey)->putFrom<pvd::int32>(value);
 }
 
 int NtNdArray::getUncompressedSize() const
 {
-    return pvStructurePtr->getSubField<epics::pvData::PVInt>(UncompressedSizeFieldKey)->get();
+    return pvStructurePtr->getSubField<pvd::PVScalar>(UncompressedSizeFieldKey)->getAs<pvd::int32>();
 }
 
 void NtNdArray::setDimension(const bp::list& pyList)
@@ -249,3 +282,412 @@ void NtNdArray::setDisplay(const PvDisplay& pvDisplay)
     PyPvDataUtility::pyDictToStructureField(pvDisplay, DisplayFieldKey, pvStructurePtr);
 }
 
+
+// Returns -1 if color mode attribute is not present
+int NtNdArray::getColorMode() const
+{
+    pvd::PVStructureArrayPtr attributeArrayPtr = pvStructurePtr->getSubField<pvd::PVStructureArray>(AttributeFieldKey);
+    if (!attributeArrayPtr) {
+        return -1;
+    }
+    pvd::PVStructureArray::const_svector attributes = attributeArrayPtr->view();
+    for (size_t i = 0; i < attributes.size(); i++) {
+        if (!attributes[i]) {
+            continue;
+        }
+        pvd::PVStringPtr namePtr = attributes[i]->getSubField<pvd::PVString>(NtAttribute::NameFieldKey);
+        if (!namePtr || namePtr->get() != ColorModeAttributeName) {
+            continue;
+        }
+        pvd::PVUnionPtr valuePtr = attributes[i]->getSubField<pvd::PVUnion>(ValueFieldKey);
+        pvd::PVScalarPtr pvScalarPtr;
+        if (valuePtr) {
+            pvScalarPtr = std::tr1::dynamic_pointer_cast<pvd::PVScalar>(valuePtr->get());
+        }
+        if (!pvScalarPtr) {
+            throw InvalidArgument("Invalid %s attribute value.", ColorModeAttributeName);
+        }
+        return pvScalarPtr->getAs<pvd::int32>();
+    }
+    return -1;
+}
+
+std::vector<size_t> NtNdArray::getDimensionSizes() const
+{
+    std::vector<size_t> dims;
+    pvd::PVStructureArrayPtr dimensionArrayPtr = pvStructurePtr->getSubField<pvd::PVStructureArray>(DimensionFieldKey);
+    if (!dimensionArrayPtr) {
+        return dims;
+    }
+    pvd::PVStructureArray::const_svector dimensions = dimensionArrayPtr->view();
+    for (size_t i = 0; i < dimensions.size(); i++) {
+        pvd::PVScalarPtr sizePtr;
+        if (dimensions[i]) {
+            sizePtr = dimensions[i]->getSubField<pvd::PVScalar>(PvDimension::SizeFieldKey);
+        }
+        if (!sizePtr) {
+            throw InvalidArgument("Invalid image dimension %d.", int(i));
+        }
+        dims.push_back(sizePtr->getAs<pvd::uint32>());
+    }
+    return dims;
+}
+
+std::string NtNdArray::getCodecName() const
+{
+    pvd::PVStructurePtr codecPtr = pvStructurePtr->getSubField<pvd::PVStructure>(CodecFieldKey);
+    if (!codecPtr) {
+        return "";
+    }
+    pvd::PVStringPtr codecNamePtr = codecPtr->getSubField<pvd::PVString>(PvCodec::NameFieldKey);
+    if (!codecNamePtr) {
+        return "";
+    }
+    return codecNamePtr->get();
+}
+
+pvd::PVScalarArrayPtr NtNdArray::getSelectedValue() const
+{
+    pvd::PVUnionPtr valuePtr = pvStructurePtr->getSubField<pvd::PVUnion>(ValueFieldKey);
+    pvd::PVScalarArrayPtr pvScalarArrayPtr;
+    if (valuePtr) {
+        pvScalarArrayPtr = std::tr1::dynamic_pointer_cast<pvd::PVScalarArray>(valuePtr->get());
+    }
+    if (!pvScalarArrayPtr) {
+        throw InvalidArgument("Image value is not selected.");
+    }
+    return pvScalarArrayPtr;
+}
+
+static const char* getValueFieldKey(pvd::ScalarType scalarType)
+{
+    switch (scalarType) {
+        case pvd::pvBoolean: return NtNdArray::BooleanValueFieldKey;
+        case pvd::pvByte: return NtNdArray::ByteValueFieldKey;
+        case pvd::pvUByte: return NtNdArray::UByteValueFieldKey;
+        case pvd::pvShort: return NtNdArray::ShortValueFieldKey;
+        case pvd::pvUShort: return NtNdArray::UShortValueFieldKey;
+        case pvd::pvInt: return NtNdArray::IntValueFieldKey;
+        case pvd::pvUInt: return NtNdArray::UIntValueFieldKey;
+        case pvd::pvLong: return NtNdArray::LongValueFieldKey;
+        case pvd::pvULong: return NtNdArray::ULongValueFieldKey;
+        case pvd::pvFloat: return NtNdArray::FloatValueFieldKey;
+        case pvd::pvDouble: return NtNdArray::DoubleValueFieldKey;
+        default: throw InvalidDataType("Unsupported image data type: %s", pvd::ScalarTypeFunc::name(scalarType));
+    }
+}
+
+// Keeps codec buffer while scalar array data is in use
+struct CodecBufferDeleter
+{
+    CodecBufferDeleter(const NdArrayCodec::BufferPtr& bufferPtr_) : bufferPtr(bufferPtr_) {}
+    template<typename T> void operator()(T*) { bufferPtr.reset(); }
+    NdArrayCodec::BufferPtr bufferPtr;
+};
+
+template<typename T>
+static pvd::PVScalarArrayPtr createCodecBufferArray(pvd::ScalarType scalarType, const NdArrayCodec::BufferPtr& bufferPtr, size_t nElements)
+{
+    typedef pvd::PVValueArray<T> ArrayType;
+    pvd::PVScalarArrayPtr pvScalarArrayPtr = pvd::getPVDataCreate()->createPVScalarArray(scalarType);
+    pvd::shared_vector<const T> value(reinterpret_cast<const T*>(bufferPtr.get()), CodecBufferDeleter(bufferPtr), 0, nElements);
+    std::tr1::static_pointer_cast<ArrayType>(pvScalarArrayPtr)->replace(value);
+    return pvScalarArrayPtr;
+}
+
+static pvd::PVScalarArrayPtr createCodecBufferArray(pvd::ScalarType scalarType, const NdArrayCodec::BufferPtr& bufferPtr, size_t nElements)
+{
+    switch (scalarType) {
+        case pvd::pvByte: return createCodecBufferArray<pvd::int8>(scalarType, bufferPtr, nElements);
+        case pvd::pvUByte: return createCodecBufferArray<pvd::uint8>(scalarType, bufferPtr, nElements);
+        case pvd::pvShort: return createCodecBufferArray<pvd::int16>(scalarType, bufferPtr, nElements);
+        case pvd::pvUShort: return createCodecBufferArray<pvd::uint16>(scalarType, bufferPtr, nElements);
+        case pvd::pvInt: return createCodecBufferArray<pvd::int32>(scalarType, bufferPtr, nElements);
+        case pvd::pvUInt: return createCodecBufferArray<pvd::uint32>(scalarType, bufferPtr, nElements);
+        case pvd::pvLong: return createCodecBufferArray<pvd::int64>(scalarType, bufferPtr, nElements);
+        case pvd::pvULong: return createCodecBufferArray<pvd::uint64>(scalarType, bufferPtr, nElements);
+        case pvd::pvFloat: return createCodecBufferArray<float>(scalarType, bufferPtr, nElements);
+        case pvd::pvDouble: return createCodecBufferArray<double>(scalarType, bufferPtr, nElements);
+        default: throw InvalidDataType("Unsupported uncompressed image data type: %s", pvd::ScalarTypeFunc::name(scalarType));
+    }
+}
+
+// Codec parameters contain uncompressed data type, either directly,
+// or as a value field of a structure
+static bool getCodecDataType(const pvd::PVStructurePtr& codecPtr, pvd::ScalarType& scalarType)
+{
+    pvd::PVUnionPtr parametersPtr = codecPtr->getSubField<pvd::PVUnion>(PvCodec::ParametersFieldKey);
+    if (!parametersPtr) {
+        return false;
+    }
+    pvd::PVFieldPtr pvFieldPtr = parametersPtr->get();
+    pvd::PVStructurePtr pvStructurePtr = std::tr1::dynamic_pointer_cast<pvd::PVStructure>(pvFieldPtr);
+    if (pvStructurePtr) {
+        pvFieldPtr = pvStructurePtr->getSubField(PvaConstants::ValueFieldKey);
+    }
+    pvd::PVScalarPtr pvScalarPtr = std::tr1::dynamic_pointer_cast<pvd::PVScalar>(pvFieldPtr);
+    if (!pvScalarPtr) {
+        return false;
+    }
+    int dataType = pvScalarPtr->getAs<pvd::int32>();
+    if (dataType < pvd::pvBoolean || dataType >= pvd::pvString) {
+        throw InvalidArgument("Invalid codec data type: %d", dataType);
+    }
+    scalarType = static_cast<pvd::ScalarType>(dataType);
+    return true;
+}
+
+// Expected number of elements is determined from uncompressed size
+// if not given
+pvd::PVScalarArrayPtr NtNdArray::decompressValue(const pvd::PVScalarArrayPtr& pvScalarArrayPtr, size_t nElements) const
+{
+    std::string codecName = getCodecName();
+    pvd::PVStructurePtr codecPtr = pvStructurePtr->getSubField<pvd::PVStructure>(CodecFieldKey);
+    pvd::ScalarType scalarType = pvScalarArrayPtr->getScalarArray()->getElementType();
+    getCodecDataType(codecPtr, scalarType);
+    size_t elementSize = pvd::ScalarTypeFunc::elementSize(scalarType);
+
+    pvd::int64 uncompressedSize = 0;
+    pvd::PVScalarPtr uncompressedSizePtr = pvStructurePtr->getSubField<pvd::PVScalar>(UncompressedSizeFieldKey);
+    if (uncompressedSizePtr) {
+        uncompressedSize = uncompressedSizePtr->getAs<pvd::int64>();
+    }
+    size_t outputSize = nElements*elementSize;
+    if (!nElements) {
+        if (uncompressedSize <= 0 || uncompressedSize % elementSize) {
+            throw InvalidArgument("Invalid uncompressed size of %lld bytes.", (long long)uncompressedSize);
+        }
+        outputSize = uncompressedSize;
+        nElements = outputSize/elementSize;
+    }
+    else if (uncompressedSize > 0 && size_t(uncompressedSize) != outputSize) {
+        throw InvalidArgument("Uncompressed size of %lld bytes does not match image dimensions.", (long long)uncompressedSize);
+    }
+
+    pvd::shared_vector<const void> data;
+    pvScalarArrayPtr->PVScalarArray::getAs<void>(data);
+    size_t inputSize = data.size();
+    pvd::PVScalarPtr compressedSizePtr = pvStructurePtr->getSubField<pvd::PVScalar>(CompressedSizeFieldKey);
+    if (compressedSizePtr && compressedSizePtr->getAs<pvd::int64>() > 0 && size_t(compressedSizePtr->getAs<pvd::int64>()) < inputSize) {
+        inputSize = compressedSizePtr->getAs<pvd::int64>();
+    }
+
+    NdArrayCodec::BufferPtr bufferPtr = NdArrayCodec::getBuffer(outputSize);
+    const char* input = static_cast<const char*>(data.data());
+    if (PyGILState_Check()) {
+        PyGilRelease pyGilRelease;
+        NdArrayCodec::decompress(codecName, input, inputSize, bufferPtr.get(), outputSize, elementSize);
+    }
+    else {
+        NdArrayCodec::decompress(codecName, input, inputSize, bufferPtr.get(), outputSize, elementSize);
+    }
+    return createCodecBufferArray(scalarType, bufferPtr, nElements);
+}
+
+void NtNdArray::compress(const std::string& codecName)
+{
+    compress(codecName, NdArrayCodec::DefaultLevel, 1);
+}
+
+void NtNdArray::compress(const std::string& codecName, int level)
+{
+    compress(codecName, level, 1);
+}
+
+// Compressed data is stored as ubyte array that shares codec buffer,
+// and codec parameters contain original data type
+void NtNdArray::compress(const std::string& codecName, int level, int nThreads)
+{
+    std::string currentCodecName = getCodecName();
+    if (!currentCodecName.empty()) {
+        throw InvalidState("Array is already compressed using %s codec.", currentCodecName.c_str());
+    }
+    pvd::PVScalarArrayPtr pvScalarArrayPtr = getSelectedValue();
+    pvd::ScalarType scalarType = pvScalarArrayPtr->getScalarArray()->getElementType();
+    size_t elementSize = pvd::ScalarTypeFunc::elementSize(scalarType);
+    pvd::shared_vector<const void> data;
+    pvScalarArrayPtr->PVScalarArray::getAs<void>(data);
+
+    NdArrayCodec::BufferPtr bufferPtr;
+    size_t compressedSize;
+    const char* input = static_cast<const char*>(data.data());
+    if (PyGILState_Check()) {
+        PyGilRelease pyGilRelease;
+        compressedSize = NdArrayCodec::compress(codecName, input, data.size(), elementSize, level, nThreads, bufferPtr);
+    }
+    else {
+        compressedSize = NdArrayCodec::compress(codecName, input, data.size(), elementSize, level, nThreads, bufferPtr);
+    }
+
+    pvd::PVUnionPtr valuePtr = pvStructurePtr->getSubField<pvd::PVUnion>(ValueFieldKey);
+    valuePtr->set(UByteValueFieldKey, createCodecBufferArray(pvd::pvUByte, bufferPtr, compressedSize));
+    pvd::PVStructurePtr codecPtr = pvStructurePtr->getSubField<pvd::PVStructure>(CodecFieldKey);
+    codecPtr->getSubField<pvd::PVString>(PvCodec::NameFieldKey)->put(codecName);
+    pvd::PVIntPtr dataTypePtr = pvd::getPVDataCreate()->createPVScalar<pvd::PVInt>();
+    dataTypePtr->put(scalarType);
+    codecPtr->getSubField<pvd::PVUnion>(PvCodec::ParametersFieldKey)->set(dataTypePtr);
+    pvStructurePtr->getSubField<pvd::PVScalar>(CompressedSizeFieldKey)->putFrom<pvd::int64>(compressedSize);
+    pvStructurePtr->getSubField<pvd::PVScalar>(UncompressedSizeFieldKey)->putFrom<pvd::int64>(data.size());
+}
+
+void NtNdArray::decompress()
+{
+    if (getCodecName().empty()) {
+        return;
+    }
+    std::vector<size_t> dims = getDimensionSizes();
+    size_t nElements = 0;
+    for (size_t i = 0; i < dims.size(); i++) {
+        nElements = (i > 0 ? nElements*dims[i] : dims[i]);
+    }
+    pvd::PVScalarArrayPtr pvScalarArrayPtr = decompressValue(getSelectedValue(), nElements);
+    pvd::ScalarType scalarType = pvScalarArrayPtr->getScalarArray()->getElementType();
+    size_t uncompressedSize = pvScalarArrayPtr->getLength()*pvd::ScalarTypeFunc::elementSize(scalarType);
+
+    pvd::PVUnionPtr valuePtr = pvStructurePtr->getSubField<pvd::PVUnion>(ValueFieldKey);
+    valuePtr->set(getValueFieldKey(scalarType), pvScalarArrayPtr);
+    pvd::PVStructurePtr codecPtr = pvStructurePtr->getSubField<pvd::PVStructure>(CodecFieldKey);
+    codecPtr->getSubField<pvd::PVString>(PvCodec::NameFieldKey)->put("");
+    codecPtr->getSubField<pvd::PVUnion>(PvCodec::ParametersFieldKey)->set(pvd::PVFieldPtr());
+    pvStructurePtr->getSubField<pvd::PVScalar>(CompressedSizeFieldKey)->putFrom<pvd::int64>(uncompressedSize);
+    pvStructurePtr->getSubField<pvd::PVScalar>(UncompressedSizeFieldKey)->putFrom<pvd::int64>(uncompressedSize);
+}
+
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+
+static numpy_::dtype getNumPyDtype(pvd::ScalarType scalarType)
+{
+    switch (scalarType) {
+        case pvd::pvBoolean: return numpy_::dtype::get_builtin<pvd::boolean>();
+        case pvd::pvByte: return numpy_::dtype::get_builtin<pvd::int8>();
+        case pvd::pvUByte: return numpy_::dtype::get_builtin<pvd::uint8>();
+        case pvd::pvShort: return numpy_::dtype::get_builtin<pvd::int16>();
+        case pvd::pvUShort: return numpy_::dtype::get_builtin<pvd::uint16>();
+        case pvd::pvInt: return numpy_::dtype::get_builtin<pvd::int32>();
+        case pvd::pvUInt: return numpy_::dtype::get_builtin<pvd::uint32>();
+        case pvd::pvLong: return numpy_::dtype::get_builtin<pvd::int64>();
+        case pvd::pvULong: return numpy_::dtype::get_builtin<pvd::uint64>();
+        case pvd::pvFloat: return numpy_::dtype::get_builtin<float>();
+        case pvd::pvDouble: return numpy_::dtype::get_builtin<double>();
+        default: throw InvalidDataType("Unsupported image data type: %s", pvd::ScalarTypeFunc::name(scalarType));
+    }
+}
+
+// Image shape is (ny, nx) for mono images and (ny, nx, nz) for color
+// images; color image planes and pixels are accessed via strides, so that
+// array shares data with PV scalar array (or with decoded data buffer)
+bp::object NtNdArray::getImage() const
+{
+    std::vector<size_t> dims = getDimensionSizes();
+    if (dims.empty()) {
+        return bp::object();
+    }
+    int colorMode = getColorMode();
+    size_t nx = 0;
+    size_t ny = 0;
+    size_t nz = 1;
+    if (dims.size() == 2 && (colorMode == ColorModeMono || colorMode < 0)) {
+        colorMode = ColorModeMono;
+        nx = dims[0];
+        ny = dims[1];
+    }
+    else if (dims.size() == 3 && colorMode == ColorModeRgb1) {
+        nz = dims[0];
+        nx = dims[1];
+        ny = dims[2];
+    }
+    else if (dims.size() == 3 && colorMode == ColorModeRgb2) {
+        nx = dims[0];
+        nz = dims[1];
+        ny = dims[2];
+    }
+    else if (dims.size() == 3 && colorMode == ColorModeRgb3) {
+        nx = dims[0];
+        ny = dims[1];
+        nz = dims[2];
+    }
+    else {
+        throw InvalidArgument("Invalid combination of %d image dimensions and color mode %d.", int(dims.size()), colorMode);
+    }
+    size_t nElements = nx*ny*nz;
+
+    pvd::PVScalarArrayPtr pvScalarArrayPtr = getSelectedValue();
+    if (!getCodecName().empty()) {
+        pvScalarArrayPtr = decompressValue(pvScalarArrayPtr, nElements);
+    }
+    else if (pvScalarArrayPtr->getLength() != nElements) {
+        throw InvalidArgument("Image array length %llu does not match image dimensions.", (unsigned long long)pvScalarArrayPtr->getLength());
+    }
+
+    pvd::ScalarType scalarType = pvScalarArrayPtr->getScalarArray()->getElementType();
+    size_t s = pvd::ScalarTypeFunc::elementSize(scalarType);
+    bp::tuple shape;
+    bp::tuple strides;
+    if (colorMode == ColorModeMono) {
+        // [NX, NY]
+        shape = bp::make_tuple(ny, nx);
+        strides = bp::make_tuple(nx*s, s);
+    }
+    else if (colorMode == ColorModeRgb1) {
+        // [3, NX, NY]
+        shape = bp::make_tuple(ny, nx, nz);
+        strides = bp::make_tuple(nx*nz*s, nz*s, s);
+    }
+    else if (colorMode == ColorModeRgb2) {
+        // [NX, 3, NY]
+        shape = bp::make_tuple(ny, nx, nz);
+        strides = bp::make_tuple(nz*nx*s, s, nx*s);
+    }
+    else {
+        // [NX, NY, 3]
+        shape = bp::make_tuple(ny, nx, nz);
+        strides = bp::make_tuple(nx*s, s, ny*nx*s);
+    }
+
+    pvd::shared_vector<const void> data;
+    pvScalarArrayPtr->PVScalarArray::getAs<void>(data);
+    bp::object arrayOwner = bp::object(boost::shared_ptr<ScalarArrayPyOwner>(new ScalarArrayPyOwner(pvScalarArrayPtr)));
+    return numpy_::from_data(data.data(), getNumPyDtype(scalarType), shape, strides, arrayOwner);
+}
+
+bp::object NtNdArray::decompressArray(const std::string& codecName, const bp::object& pyInput, int dataType, unsigned long long uncompressedSize)
+{
+    if (dataType <= pvd::pvBoolean || dataType >= pvd::pvString) {
+        throw InvalidArgument("Invalid uncompressed data type: %d", dataType);
+    }
+    pvd::ScalarType scalarType = static_cast<pvd::ScalarType>(dataType);
+    size_t elementSize = pvd::ScalarTypeFunc::elementSize(scalarType);
+    size_t outputSize = uncompressedSize;
+    if (!outputSize || outputSize % elementSize) {
+        throw InvalidArgument("Invalid uncompressed size of %llu bytes.", uncompressedSize);
+    }
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(pyInput.ptr(), &view, PyBUF_SIMPLE) != 0) {
+        PyErr_Clear();
+        throw InvalidArgument("Compressed data must be provided as contiguous bytes-like object.");
+    }
+    NdArrayCodec::BufferPtr bufferPtr = NdArrayCodec::getBuffer(outputSize);
+    try {
+        const char* input = static_cast<const char*>(view.buf);
+        if (PyGILState_Check()) {
+            PyGilRelease pyGilRelease;
+            NdArrayCodec::decompress(codecName, input, view.len, bufferPtr.get(), outputSize, elementSize);
+        }
+        else {
+            NdArrayCodec::decompress(codecName, input, view.len, bufferPtr.get(), outputSize, elementSize);
+        }
+    }
+    catch (...) {
+        PyBuffer_Release(&view);
+        throw;
+    }
+    PyBuffer_Release(&view);
+
+    size_t nElements = outputSize/elementSize;
+    pvd::PVScalarArrayPtr pvScalarArrayPtr = createCodecBufferArray(scalarType, bufferPtr, nElements);
+    bp::object arrayOwner = bp::object(boost::shared_ptr<ScalarArrayPyOwner>(new ScalarArrayPyOwner(pvScalarArrayPtr)));
+    return numpy_::from_data(bufferPtr.get(), getNumPyDtype(scalarType), bp::make_tuple(nElements), bp::make_tuple(elementSize), arrayOwner);
+}
+
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
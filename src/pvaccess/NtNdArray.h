@@ -5,6 +5,7 @@
 #define NT_ND_ARRAY_H
 
 #include <string>
+#include <vector>
 #include "boost/python/dict.hpp"
 #include "boost/python/list.hpp"
 #include "PvObject.h"
@@ -44,6 +45,12 @@ public:
     static const char* UncompressedSizeFieldKey;
     static const char* UniqueIdFieldKey;
 
+    static const char* ColorModeAttributeName;
+    static const int ColorModeMono;
+    static const int ColorModeRgb1;
+    static const int ColorModeRgb2;
+    static const int ColorModeRgb3;
+
     // Static methods
     static boost::python::dict createStructureDict(const boost::python::dict& extraFieldsDict = boost::python::dict());
     static boost::python::dict createStructureFieldIdDict();
@@ -57,6 +64,7 @@ public:
     virtual ~NtNdArray();
 
     virtual void setValue(const boost::python::dict& pyDict);
+    virtual void setValue(const boost::python::dict& pyDict, bool copy);
     virtual void setValue(const PvObject& pvObject);
     virtual boost::python::object getValue() const;
     virtual void setCodec(const PvCodec& pvCodec);
@@ -81,17 +89,39 @@ public:
     virtual PvTimeStamp getTimeStamp() const;
     virtual void setDisplay(const PvDisplay& pvDisplay);
     virtual PvDisplay getDisplay() const;
+
+    // Native compression of array value; codec parameters, compressed
+    // and uncompressed size fields are set automatically
+    virtual void compress(const std::string& codecName);
+    virtual void compress(const std::string& codecName, int level);
+    virtual void compress(const std::string& codecName, int level, int nThreads);
+    virtual void decompress();
+
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+    // Image array shaped according to dimensions and color mode,
+    // decompressed if needed
+    virtual boost::python::object getImage() const;
+
+    // Decompresses bytes-like input into one-dimensional array of the
+    // given data type that owns decoded data buffer
+    static boost::python::object decompressArray(const std::string& codecName, const boost::python::object& pyInput, int dataType, unsigned long long uncompressedSize);
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+
+private:
+    int getColorMode() const;
+    std::vector<size_t> getDimensionSizes() const;
+    std::string getCodecName() const;
+    epics::pvData::PVScalarArrayPtr getSelectedValue() const;
+    epics::pvData::PVScalarArrayPtr decompressValue(const epics::pvData::PVScalarArrayPtr& pvScalarArrayPtr, size_t nElements) const;
 };
 
+// Object data is pickled using PvObject state, which contains
+// binary serialized structure
 struct NtNdArrayPickleSuite : boost::python::pickle_suite
 {
     static boost::python::tuple getinitargs(const NtNdArray& ntNdArray)
     {
-        return boost::python::make_tuple(
-            ntNdArray.getStructureDict(),
-            ntNdArray.get(),
-            NtNdArray::StructureId,
-            NtNdArray::createStructureFieldIdDict());
+        return boost::python::make_tuple();
     }
 };
 
@@ -0,0 +1,39 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef NUMPY_ARRAY_PV_OWNER_H
+#define NUMPY_ARRAY_PV_OWNER_H
+
+#include <Python.h>
+#include "boost/python/object.hpp"
+
+//
+// This class is used as shared_vector deleter for maintaining ownership
+// of python (NumPy) arrays whose data is shared with PV scalar arrays.
+// The deleter may be invoked from any thread, so it holds raw python
+// reference and releases it with GIL held.
+//
+class NumPyArrayPvOwner
+{
+public:
+    NumPyArrayPvOwner(const boost::python::object& pyObject_) :
+        pyObject(pyObject_.ptr()) 
+    {
+        Py_XINCREF(pyObject);
+    }
+
+    void operator()(const void*) 
+    {
+        if (!Py_IsInitialized()) {
+            return;
+        }
+        PyGILState_STATE gilState = PyGILState_Ensure();
+        Py_XDECREF(pyObject);
+        PyGILState_Release(gilState);
+    }
+
+private:
+    PyObject* pyObject;
+};
+
+#endif // NUMPY_ARRAY_PV_OWNER_H
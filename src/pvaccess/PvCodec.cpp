@@ -3,6 +3,7 @@
 
 #include "PvCodec.h"
 #include "PvType.h"
+#include "NdArrayCodec.h"
 
 namespace pvd = epics::pvData;
 namespace bp = boost::python;
@@ -20,6 +21,16 @@ bp::dict PvCodec::createStructureDict()
     return structureDict;
 }
 
+// Codecs supported by NtNdArray compress() and decompress()
+bp::list PvCodec::getNativeCodecNames()
+{
+    bp::list pyList;
+    pyList.append(NdArrayCodec::Lz4CodecName);
+    pyList.append(NdArrayCodec::Bslz4CodecName);
+    pyList.append(NdArrayCodec::BloscCodecName);
+    return pyList;
+}
+
 PvCodec::PvCodec()
     : PvObject(createStructureDict(), StructureId)
 {
@@ -5,6 +5,7 @@
 #define PV_CODEC_H
 
 #include "boost/python/dict.hpp"
+#include "boost/python/list.hpp"
 #include "boost/python/tuple.hpp"
 #include "PvObject.h"
 
@@ -19,6 +20,7 @@ public:
 
     // Static methods
     static boost::python::dict createStructureDict();
+    static boost::python::list getNativeCodecNames();
 
     // Instance methods
     PvCodec();
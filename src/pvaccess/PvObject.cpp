@@ -14,10 +14,14 @@
 #include "boost/python/stl_iterator.hpp"
 
 #include "PvObject.h"
+#include "PvObjectSerializer.h"
+#include "SerializationContext.h"
+#include "IntrospectionRegistry.h"
 #include "PvType.h"
 #include "PvaConstants.h"
 #include "PvaException.h"
 #include "PyPvDataUtility.h"
+#include "PyGilRelease.h"
 #include "StringUtility.h"
 #include "InvalidArgument.h"
 #include "FieldNotFound.h"
@@ -50,7 +54,7 @@ PvObject::PvObject(const pvd::PVStructurePtr& pvStructurePtr_)
 
 PvObject::PvObject(const bp::dict& structureDict)
     : numPyInitialized(initializeBoostNumPy()),
-    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(PyPvDataUtility::createStructureFromDict(structureDict, StructureId))),
+    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(IntrospectionRegistry::getStructure(structureDict, StructureId))),
     dataType(PvType::Structure),
     useNumPyArrays(UseNumPyArraysDefault)
 {
@@ -58,7 +62,7 @@ PvObject::PvObject(const bp::dict& structureDict)
 
 PvObject::PvObject(const bp::dict& structureDict, const std::string& structureId)
     : numPyInitialized(initializeBoostNumPy()),
-    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(PyPvDataUtility::createStructureFromDict(structureDict, structureId))),
+    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(IntrospectionRegistry::getStructure(structureDict, structureId))),
     dataType(PvType::Structure),
     useNumPyArrays(UseNumPyArraysDefault)
 {
@@ -66,7 +70,7 @@ PvObject::PvObject(const bp::dict& structureDict, const std::string& structureId
 
 PvObject::PvObject(const bp::dict& structureDict, const std::string& structureId, const bp::dict& structureFieldIdDict)
     : numPyInitialized(initializeBoostNumPy()),
-    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(PyPvDataUtility::createStructureFromDict(structureDict, structureId, structureFieldIdDict))),
+    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(IntrospectionRegistry::getStructure(structureDict, structureId, structureFieldIdDict))),
     dataType(PvType::Structure),
     useNumPyArrays(UseNumPyArraysDefault)
 {
@@ -74,7 +78,7 @@ PvObject::PvObject(const bp::dict& structureDict, const std::string& structureId
 
 PvObject::PvObject(const bp::dict& structureDict, const bp::dict& valueDict)
     : numPyInitialized(initializeBoostNumPy()),
-    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(PyPvDataUtility::createStructureFromDict(structureDict, StructureId))),
+    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(IntrospectionRegistry::getStructure(structureDict, StructureId))),
     dataType(PvType::Structure),
     useNumPyArrays(UseNumPyArraysDefault)
 {
@@ -83,7 +87,7 @@ PvObject::PvObject(const bp::dict& structureDict, const bp::dict& valueDict)
 
 PvObject::PvObject(const bp::dict& structureDict, const bp::dict& valueDict, const std::string& structureId)
     : numPyInitialized(initializeBoostNumPy()),
-    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(PyPvDataUtility::createStructureFromDict(structureDict, structureId))),
+    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(IntrospectionRegistry::getStructure(structureDict, structureId))),
     dataType(PvType::Structure),
     useNumPyArrays(UseNumPyArraysDefault)
 {
@@ -92,7 +96,7 @@ PvObject::PvObject(const bp::dict& structureDict, const bp::dict& valueDict, con
 
 PvObject::PvObject(const bp::dict& structureDict, const bp::dict& valueDict, const std::string& structureId, const bp::dict& structureFieldIdDict)
     : numPyInitialized(initializeBoostNumPy()),
-    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(PyPvDataUtility::createStructureFromDict(structureDict, structureId, structureFieldIdDict))),
+    pvStructurePtr(pvd::getPVDataCreate()->createPVStructure(IntrospectionRegistry::getStructure(structureDict, structureId, structureFieldIdDict))),
     dataType(PvType::Structure),
     useNumPyArrays(UseNumPyArraysDefault)
 {
@@ -569,6 +573,17 @@ void PvObject::setScalarArray(const bp::object& pyObject)
     setScalarArray(key, pyObject);
 }
 
+void PvObject::setScalarArray(const std::string& key, const bp::object& pyObject, bool copy)
+{
+    PyPvDataUtility::pyObjectToScalarArrayField(pyObject, key, pvStructurePtr, copy);
+}
+
+void PvObject::setScalarArray(const bp::object& pyObject, bool copy)
+{
+    std::string key = PyPvDataUtility::getValueOrSingleFieldName(pvStructurePtr);
+    setScalarArray(key, pyObject, copy);
+}
+
 bp::object PvObject::getScalarArray(const std::string& key) const
 {
     return PyPvDataUtility::getScalarArrayFieldAsPyObject(key, pvStructurePtr, useNumPyArrays);
@@ -829,6 +844,112 @@ PvObject PvObject::copy()
     return PvObject(pvStructurePtr2); 
 }
 
+// Binary serialization; data is encoded and decoded without GIL
+static bp::object serializeStructure(const pvd::PVStructurePtr& pvStructurePtr, PvObjectSerializer::StreamContext* streamContext)
+{
+    size_t size = PvObjectSerializer::getSerializedSize(pvStructurePtr, streamContext);
+    PyObject* pyBytes = PyBytes_FromStringAndSize(NULL, size);
+    if (!pyBytes) {
+        bp::throw_error_already_set();
+    }
+    char* buffer = PyBytes_AS_STRING(pyBytes);
+    size_t serializedSize = 0;
+    try {
+        if (PyGILState_Check()) {
+            PyGilRelease pyGilRelease;
+            serializedSize = PvObjectSerializer::serialize(pvStructurePtr, buffer, size, streamContext);
+        }
+        else {
+            serializedSize = PvObjectSerializer::serialize(pvStructurePtr, buffer, size, streamContext);
+        }
+    }
+    catch (...) {
+        Py_DECREF(pyBytes);
+        throw;
+    }
+
+    // Object modified by another thread after its size was calculated
+    // may need less space; if it needs more, serializer throws
+    if (serializedSize < size && _PyBytes_Resize(&pyBytes, serializedSize) != 0) {
+        bp::throw_error_already_set();
+    }
+    return bp::object(bp::handle<>(pyBytes));
+}
+
+static pvd::PVStructurePtr deserializeStructure(const bp::object& pyBuffer, PvObjectSerializer::StreamContext* streamContext)
+{
+    Py_buffer view;
+    if (PyObject_GetBuffer(pyBuffer.ptr(), &view, PyBUF_SIMPLE) != 0) {
+        PyErr_Clear();
+        throw InvalidArgument("Serialized PV object must be provided as bytes-like object.");
+    }
+    pvd::PVStructurePtr pvStructurePtr;
+    try {
+        const char* buffer = static_cast<const char*>(view.buf);
+        if (PyGILState_Check()) {
+            PyGilRelease pyGilRelease;
+            pvStructurePtr = PvObjectSerializer::deserialize(buffer, view.len, streamContext);
+        }
+        else {
+            pvStructurePtr = PvObjectSerializer::deserialize(buffer, view.len, streamContext);
+        }
+    }
+    catch (...) {
+        PyBuffer_Release(&view);
+        throw;
+    }
+    PyBuffer_Release(&view);
+    return pvStructurePtr;
+}
+
+// Context lock is acquired without GIL, as lock owner needs GIL
+// to complete serialization
+class SerializationContextLock
+{
+public:
+    SerializationContextLock(SerializationContext& serializationContext)
+        : mutex(serializationContext.getMutex())
+    {
+        if (PyGILState_Check()) {
+            PyGilRelease pyGilRelease;
+            mutex.lock();
+        }
+        else {
+            mutex.lock();
+        }
+    }
+    ~SerializationContextLock()
+    {
+        mutex.unlock();
+    }
+private:
+    pvd::Mutex& mutex;
+};
+
+bp::object PvObject::serialize() const
+{
+    return serializeStructure(pvStructurePtr, NULL);
+}
+
+// Context lock is held for the size calculation and serialization,
+// as both depend on structures that were already sent
+bp::object PvObject::serialize(SerializationContext& serializationContext) const
+{
+    SerializationContextLock lock(serializationContext);
+    return serializeStructure(pvStructurePtr, serializationContext.getStreamContext());
+}
+
+PvObject PvObject::deserialize(const bp::object& pyBuffer)
+{
+    return PvObject(deserializeStructure(pyBuffer, NULL));
+}
+
+PvObject PvObject::deserialize(const bp::object& pyBuffer, SerializationContext& serializationContext)
+{
+    SerializationContextLock lock(serializationContext);
+    return PvObject(deserializeStructure(pyBuffer, serializationContext.getStreamContext()));
+}
+
 // Methods specific to Boost NumPy 
 bool PvObject::boostNumPyInitialized(false);
 bool PvObject::initializeBoostNumPy() 
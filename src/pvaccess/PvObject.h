@@ -12,6 +12,7 @@
 
 #include "PvType.h"
 
+class SerializationContext;
 
 class PvObject 
 {
@@ -54,6 +55,12 @@ public:
     // Copy
     PvObject copy();
 
+    // Binary serialization
+    boost::python::object serialize() const;
+    boost::python::object serialize(SerializationContext& serializationContext) const;
+    static PvObject deserialize(const boost::python::object& pyBuffer);
+    static PvObject deserialize(const boost::python::object& pyBuffer, SerializationContext& serializationContext);
+
     // Dictionary methods
     bool has_key(const std::string& fieldPath) const;
     boost::python::list items() const;
@@ -150,6 +157,8 @@ public:
     // Scalar array fields
     void setScalarArray(const std::string& key, const boost::python::object& pyObject);
     void setScalarArray(const boost::python::object& pyObject);
+    void setScalarArray(const std::string& key, const boost::python::object& pyObject, bool copy);
+    void setScalarArray(const boost::python::object& pyObject, bool copy);
     boost::python::object getScalarArray(const std::string& key) const;
     boost::python::object getScalarArray() const;
 
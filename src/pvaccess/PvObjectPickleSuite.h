@@ -9,13 +9,23 @@
 
 #include "PvObject.h"
 
+// Objects are pickled using binary serialization; unpickling creates
+// empty object and replaces its structure with the deserialized one
 struct PvObjectPickleSuite : boost::python::pickle_suite
 {
     static boost::python::tuple getinitargs(const PvObject& pvObject)
     {
-        return boost::python::make_tuple(
-            pvObject.getStructureDict(),
-            pvObject.get());
+        return boost::python::make_tuple(boost::python::dict());
+    }
+
+    static boost::python::tuple getstate(const PvObject& pvObject)
+    {
+        return boost::python::make_tuple(pvObject.serialize());
+    }
+
+    static void setstate(PvObject& pvObject, boost::python::tuple state)
+    {
+        pvObject = PvObject::deserialize(state[0]);
     }
 };
 
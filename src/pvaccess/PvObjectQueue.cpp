@@ -12,12 +12,27 @@ namespace bp = boost::python;
 
 PvObjectQueue::PvObjectQueue(int maxLength)
     : sQueuePtr(new SynchronizedQueue<PvObject>(maxLength))
+    , spscQueuePtr()
 {
     PyGilManager::evalInitThreads();
 }
 
+PvObjectQueue::PvObjectQueue(int maxLength, bool lockFree)
+    : sQueuePtr()
+    , spscQueuePtr()
+{
+    PyGilManager::evalInitThreads();
+    if (lockFree) {
+        spscQueuePtr = std::tr1::shared_ptr<SpscQueue<PvObject> >(new SpscQueue<PvObject>(maxLength));
+    }
+    else {
+        sQueuePtr = std::tr1::shared_ptr<SynchronizedQueue<PvObject> >(new SynchronizedQueue<PvObject>(maxLength));
+    }
+}
+
 PvObjectQueue::PvObjectQueue(const PvObjectQueue& q) 
     : sQueuePtr(q.sQueuePtr)
+    , spscQueuePtr(q.spscQueuePtr)
 {
     PyGilManager::evalInitThreads();
 }
@@ -28,7 +43,7 @@ PvObjectQueue::~PvObjectQueue()
 
 PvObject PvObjectQueue::get() 
 {
-    return sQueuePtr->frontAndPop();
+    return frontAndPop();
 }
 
 PvObject PvObjectQueue::get(double timeout) 
@@ -36,7 +51,7 @@ PvObject PvObjectQueue::get(double timeout)
     PyThreadState *state;
     state = PyEval_SaveThread();
     try {
-        PvObject pvObject = sQueuePtr->frontAndPop(timeout);
+        PvObject pvObject = frontAndPop(timeout);
         PyEval_RestoreThread(state);
         return pvObject;
     }
@@ -52,7 +67,7 @@ PvObject PvObjectQueue::get(double timeout)
 
 void PvObjectQueue::put(const PvObject& pvObject) 
 {
-    sQueuePtr->push(pvObject);
+    push(pvObject);
 }
 
 void PvObjectQueue::put(const PvObject& pvObject, double timeout) 
@@ -60,7 +75,7 @@ void PvObjectQueue::put(const PvObject& pvObject, double timeout)
     PyThreadState *state;
     state = PyEval_SaveThread();
     try {
-        sQueuePtr->push(pvObject, timeout);
+        push(pvObject, timeout);
         PyEval_RestoreThread(state);
         return;
     }
@@ -79,7 +94,7 @@ void PvObjectQueue::waitForPut(double timeout)
     PyThreadState *state;
     state = PyEval_SaveThread();
     try {
-        sQueuePtr->waitForItemPushed(timeout);
+        waitForItemPushed(timeout);
         PyEval_RestoreThread(state);
     }
     catch (...) {
@@ -93,7 +108,7 @@ void PvObjectQueue::waitForGet(double timeout)
     PyThreadState *state;
     state = PyEval_SaveThread();
     try {
-        sQueuePtr->waitForItemPopped(timeout);
+        waitForItemPopped(timeout);
         PyEval_RestoreThread(state);
     }
     catch (...) {
@@ -104,7 +119,7 @@ void PvObjectQueue::waitForGet(double timeout)
 
 bp::dict PvObjectQueue::getCounters()
 {
-    const std::map<std::string,unsigned int> counterMap = sQueuePtr->getCounterMap();
+    const std::map<std::string,unsigned int> counterMap = getCounterMap();
     return PyUtility::mapToDict<std::string,unsigned int>(counterMap);
 }
 
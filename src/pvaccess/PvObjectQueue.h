@@ -9,49 +9,53 @@
 #include "boost/python/dict.hpp"
 #include "PvObject.h"
 #include "SynchronizedQueue.h"
+#include "SpscQueue.h"
 
 // Wrapper around SynchronizedQueue<PvObject>
 // We cannot use inheritance because this object
 // may be created in python and passed to the C++ layer, and the same
-// events/mutexes must work both in python and C++
+// events/mutexes must work both in python and C++.
+// Lock-free queues are backed by SpscQueue<PvObject>; they must be bounded,
+// and can only be used by a single producer and a single consumer thread.
 class PvObjectQueue 
 {
 public:
     POINTER_DEFINITIONS(PvObjectQueue);
 
     PvObjectQueue(int maxLength=SynchronizedQueue<PvObject>::Unlimited);
+    PvObjectQueue(int maxLength, bool lockFree);
     PvObjectQueue(const PvObjectQueue& pvObjectQueue);
     virtual ~PvObjectQueue();
 
-    void setMaxLength(int maxLength) { sQueuePtr->setMaxLength(maxLength); }
-    int getMaxLength() { return sQueuePtr->getMaxLength(); }
-    bool isFull() { return sQueuePtr->isFull(); }
-    bool isEmpty() { return sQueuePtr->isEmpty(); }
-    unsigned int size() { return sQueuePtr->size(); }
-    PvObject back() { return sQueuePtr->back(); } 
-    PvObject front() { return sQueuePtr->front(); } 
-    PvObject frontAndPop() { return sQueuePtr->frontAndPop(); } 
-    PvObject frontAndPop(double timeout) { return sQueuePtr->frontAndPop(timeout); } 
-    void pop() { sQueuePtr->pop(); } 
-    void push(const PvObject& pvObject) { sQueuePtr->push(pvObject); } 
-    void push(const PvObject& pvObject, double timeout) { sQueuePtr->push(pvObject, timeout); } 
-    bool popIfNotEmpty() { return sQueuePtr->popIfNotEmpty(); } 
-    bool pushIfNotFull(const PvObject& pvObject) { return sQueuePtr->pushIfNotFull(pvObject); } 
+    void setMaxLength(int maxLength) { if (spscQueuePtr) { spscQueuePtr->setMaxLength(maxLength); } else { sQueuePtr->setMaxLength(maxLength); } }
+    int getMaxLength() { return spscQueuePtr ? spscQueuePtr->getMaxLength() : sQueuePtr->getMaxLength(); }
+    bool isFull() { return spscQueuePtr ? spscQueuePtr->isFull() : sQueuePtr->isFull(); }
+    bool isEmpty() { return spscQueuePtr ? spscQueuePtr->isEmpty() : sQueuePtr->isEmpty(); }
+    unsigned int size() { return spscQueuePtr ? spscQueuePtr->size() : sQueuePtr->size(); }
+    PvObject back() { return spscQueuePtr ? spscQueuePtr->back() : sQueuePtr->back(); }
+    PvObject front() { return spscQueuePtr ? spscQueuePtr->front() : sQueuePtr->front(); }
+    PvObject frontAndPop() { return spscQueuePtr ? spscQueuePtr->frontAndPop() : sQueuePtr->frontAndPop(); }
+    PvObject frontAndPop(double timeout) { return spscQueuePtr ? spscQueuePtr->frontAndPop(timeout) : sQueuePtr->frontAndPop(timeout); }
+    void pop() { if (spscQueuePtr) { spscQueuePtr->pop(); } else { sQueuePtr->pop(); } }
+    void push(const PvObject& pvObject) { if (spscQueuePtr) { spscQueuePtr->push(pvObject); } else { sQueuePtr->push(pvObject); } }
+    void push(const PvObject& pvObject, double timeout) { if (spscQueuePtr) { spscQueuePtr->push(pvObject, timeout); } else { sQueuePtr->push(pvObject, timeout); } }
+    bool popIfNotEmpty() { return spscQueuePtr ? spscQueuePtr->popIfNotEmpty() : sQueuePtr->popIfNotEmpty(); }
+    bool pushIfNotFull(const PvObject& pvObject) { return spscQueuePtr ? spscQueuePtr->pushIfNotFull(pvObject) : sQueuePtr->pushIfNotFull(pvObject); }
 
-    void waitForItemPushed(double timeout) { sQueuePtr->waitForItemPushed(timeout); }
-    void waitForItemPushedIfEmpty(double timeout) { sQueuePtr->waitForItemPushedIfEmpty(timeout); }
-    void waitForItemPopped(double timeout) { sQueuePtr->waitForItemPopped(timeout); }
-    void waitForItemPoppedIfFull(double timeout) { sQueuePtr->waitForItemPoppedIfFull(timeout); }
-    void cancelWaitForItemPushed() { sQueuePtr->cancelWaitForItemPushed(); }
-    void cancelWaitForItemPopped() { sQueuePtr->cancelWaitForItemPopped(); }
-    void clear() { sQueuePtr->clear(); }
+    void waitForItemPushed(double timeout) { if (spscQueuePtr) { spscQueuePtr->waitForItemPushed(timeout); } else { sQueuePtr->waitForItemPushed(timeout); } }
+    void waitForItemPushedIfEmpty(double timeout) { if (spscQueuePtr) { spscQueuePtr->waitForItemPushedIfEmpty(timeout); } else { sQueuePtr->waitForItemPushedIfEmpty(timeout); } }
+    void waitForItemPopped(double timeout) { if (spscQueuePtr) { spscQueuePtr->waitForItemPopped(timeout); } else { sQueuePtr->waitForItemPopped(timeout); } }
+    void waitForItemPoppedIfFull(double timeout) { if (spscQueuePtr) { spscQueuePtr->waitForItemPoppedIfFull(timeout); } else { sQueuePtr->waitForItemPoppedIfFull(timeout); } }
+    void cancelWaitForItemPushed() { if (spscQueuePtr) { spscQueuePtr->cancelWaitForItemPushed(); } else { sQueuePtr->cancelWaitForItemPushed(); } }
+    void cancelWaitForItemPopped() { if (spscQueuePtr) { spscQueuePtr->cancelWaitForItemPopped(); } else { sQueuePtr->cancelWaitForItemPopped(); } }
+    void clear() { if (spscQueuePtr) { spscQueuePtr->clear(); } else { sQueuePtr->clear(); } }
 
-    void resetCounters() { sQueuePtr->resetCounters(); }
-    const std::map<std::string,unsigned int>& getCounterMap() { return sQueuePtr->getCounterMap(); }
-    void setCounter(const std::string& key, unsigned int value) { sQueuePtr->setCounter(key, value); }
-    void addToCounter(const std::string& key, unsigned int value) { sQueuePtr->addToCounter(key, value); }
-    double getTimeSinceLastPush() { return sQueuePtr->getTimeSinceLastPush(); }
-    double getTimeSinceLastPop() { return sQueuePtr->getTimeSinceLastPop(); }
+    void resetCounters() { if (spscQueuePtr) { spscQueuePtr->resetCounters(); } else { sQueuePtr->resetCounters(); } }
+    const std::map<std::string,unsigned int>& getCounterMap() { return spscQueuePtr ? spscQueuePtr->getCounterMap() : sQueuePtr->getCounterMap(); }
+    void setCounter(const std::string& key, unsigned int value) { if (spscQueuePtr) { spscQueuePtr->setCounter(key, value); } else { sQueuePtr->setCounter(key, value); } }
+    void addToCounter(const std::string& key, unsigned int value) { if (spscQueuePtr) { spscQueuePtr->addToCounter(key, value); } else { sQueuePtr->addToCounter(key, value); } }
+    double getTimeSinceLastPush() { return spscQueuePtr ? spscQueuePtr->getTimeSinceLastPush() : sQueuePtr->getTimeSinceLastPush(); }
+    double getTimeSinceLastPop() { return spscQueuePtr ? spscQueuePtr->getTimeSinceLastPop() : sQueuePtr->getTimeSinceLastPop(); }
 
     // Python interface
     PvObject get();
@@ -60,11 +64,13 @@ public:
     void put(const PvObject& pvObject, double timeout);
     virtual void waitForPut(double timeout);
     virtual void waitForGet(double timeout);
-    void cancelWaitForPut() { sQueuePtr->cancelWaitForItemPushed(); }
-    void cancelWaitForGet() { sQueuePtr->cancelWaitForItemPopped(); }
+    void cancelWaitForPut() { if (spscQueuePtr) { spscQueuePtr->cancelWaitForItemPushed(); } else { sQueuePtr->cancelWaitForItemPushed(); } }
+    void cancelWaitForGet() { if (spscQueuePtr) { spscQueuePtr->cancelWaitForItemPopped(); } else { sQueuePtr->cancelWaitForItemPopped(); } }
     virtual boost::python::dict getCounters();
+    bool isLockFree() const { return spscQueuePtr.get() != 0; }
 private:
     std::tr1::shared_ptr<SynchronizedQueue<PvObject> > sQueuePtr;
+    std::tr1::shared_ptr<SpscQueue<PvObject> > spscQueuePtr;
 };
 
 #endif
@@ -0,0 +1,434 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include <epicsEndian.h>
+#include <pv/byteBuffer.h>
+#include "PvObjectSerializer.h"
+#include "IntrospectionRegistry.h"
+#include "InvalidArgument.h"
+
+namespace pvd = epics::pvData;
+
+const unsigned char PvObjectSerializer::FormatVersion(1);
+const size_t PvObjectSerializer::HeaderSize(12);
+const unsigned char PvObjectSerializer::BigEndianFlag(0x01);
+const unsigned char PvObjectSerializer::StructureReferenceFlag(0x02);
+const size_t PvObjectSerializer::ArrayAlignment(8);
+
+void PvObjectSerializer::StreamContext::reset()
+{
+    sentStructureIdSet.clear();
+    receivedStructureMap.clear();
+}
+
+// Counts serialized bytes without writing array data anywhere
+class SerializedSizeCounter : public pvd::SerializableControl
+{
+public:
+    SerializedSizeCounter(bool alignArrays_=false) : byteBuffer(ScratchBufferSize), alignArrays(alignArrays_), size(0) {}
+    virtual ~SerializedSizeCounter() {}
+
+    virtual void flushSerializeBuffer()
+    {
+        size += byteBuffer.getPosition();
+        byteBuffer.clear();
+    }
+
+    virtual void ensureBuffer(std::size_t n)
+    {
+        if (byteBuffer.getRemaining() < n) {
+            flushSerializeBuffer();
+        }
+    }
+
+    virtual void alignBuffer(std::size_t)
+    {
+    }
+
+    virtual bool directSerialize(pvd::ByteBuffer*, const char*, std::size_t elementCount, std::size_t elementSize)
+    {
+        if (alignArrays && elementSize > 1) {
+            size += PvObjectSerializer::getAlignmentPadding(getSize());
+        }
+        size += elementCount*elementSize;
+        return true;
+    }
+
+    virtual void cachedSerialize(const pvd::FieldConstPtr& field, pvd::ByteBuffer* buffer)
+    {
+        field->serialize(buffer, this);
+    }
+
+    size_t getSize()
+    {
+        return size + byteBuffer.getPosition();
+    }
+
+    static const size_t ScratchBufferSize = 4096;
+    pvd::ByteBuffer byteBuffer;
+
+private:
+    bool alignArrays;
+    size_t size;
+};
+
+// Writes into fixed size buffer
+class SerializedBufferWriter : public pvd::SerializableControl
+{
+public:
+    SerializedBufferWriter(char* buffer, size_t bufferSize, bool alignArrays_=false) : byteBuffer(buffer, bufferSize), alignArrays(alignArrays_) {}
+    virtual ~SerializedBufferWriter() {}
+
+    virtual void flushSerializeBuffer()
+    {
+        throw InvalidArgument("Serialization buffer is too small.");
+    }
+
+    virtual void ensureBuffer(std::size_t n)
+    {
+        if (byteBuffer.getRemaining() < n) {
+            flushSerializeBuffer();
+        }
+    }
+
+    virtual void alignBuffer(std::size_t)
+    {
+    }
+
+    virtual bool directSerialize(pvd::ByteBuffer* buffer, const char* data, std::size_t elementCount, std::size_t elementSize)
+    {
+        if (alignArrays && elementSize > 1) {
+            size_t padding = PvObjectSerializer::getAlignmentPadding(buffer->getPosition());
+            ensureBuffer(padding);
+            for (size_t i = 0; i < padding; i++) {
+                buffer->putByte(0);
+            }
+        }
+        size_t n = elementCount*elementSize;
+        ensureBuffer(n);
+        buffer->put(data, 0, n);
+        return true;
+    }
+
+    virtual void cachedSerialize(const pvd::FieldConstPtr& field, pvd::ByteBuffer* buffer)
+    {
+        field->serialize(buffer, this);
+    }
+
+    pvd::ByteBuffer byteBuffer;
+
+private:
+    bool alignArrays;
+};
+
+// Reads from fixed size buffer; array data is copied directly
+// unless byte order has to be swapped. If array data map is given,
+// array data is not copied at all, and its location in the buffer is
+// recorded instead, keyed by the array data pointer.
+class SerializedBufferReader : public pvd::DeserializableControl
+{
+public:
+    SerializedBufferReader(const char* buffer, size_t bufferSize, int byteOrder_, bool alignArrays_=false, std::map<const char*, const char*>* arrayDataMap_=NULL)
+        : byteBuffer(const_cast<char*>(buffer), bufferSize, byteOrder_)
+        , byteOrder(byteOrder_)
+        , alignArrays(alignArrays_)
+        , arrayDataMap(arrayDataMap_)
+    {}
+    virtual ~SerializedBufferReader() {}
+
+    virtual void ensureData(std::size_t n)
+    {
+        if (byteBuffer.getRemaining() < n) {
+            throw InvalidArgument("Serialized data is incomplete.");
+        }
+    }
+
+    virtual void alignData(std::size_t)
+    {
+    }
+
+    virtual bool directDeserialize(pvd::ByteBuffer* buffer, char* data, std::size_t elementCount, std::size_t elementSize)
+    {
+        if (elementSize > 1 && byteOrder != EPICS_BYTE_ORDER) {
+            return false;
+        }
+        if (alignArrays && elementSize > 1) {
+            size_t padding = PvObjectSerializer::getAlignmentPadding(buffer->getPosition());
+            ensureData(padding);
+            buffer->setPosition(buffer->getPosition() + padding);
+        }
+        size_t n = elementCount*elementSize;
+        ensureData(n);
+        if (arrayDataMap) {
+            (*arrayDataMap)[data] = buffer->getBuffer() + buffer->getPosition();
+            buffer->setPosition(buffer->getPosition() + n);
+        }
+        else {
+            buffer->get(data, 0, n);
+        }
+        return true;
+    }
+
+    virtual pvd::FieldConstPtr cachedDeserialize(pvd::ByteBuffer* buffer)
+    {
+        return pvd::getFieldCreate()->deserialize(buffer, this);
+    }
+
+    pvd::ByteBuffer byteBuffer;
+
+private:
+    int byteOrder;
+    bool alignArrays;
+    std::map<const char*, const char*>* arrayDataMap;
+};
+
+// Keeps buffer owner alive for as long as any array references
+// buffer data
+struct BufferOwnerDeleter
+{
+    BufferOwnerDeleter(const std::tr1::shared_ptr<void>& bufferOwner_) : bufferOwner(bufferOwner_) {}
+    template<typename T> void operator()(T*) { bufferOwner.reset(); }
+    std::tr1::shared_ptr<void> bufferOwner;
+};
+
+template<typename T>
+static void replaceArrayData(const pvd::PVScalarArrayPtr& pvScalarArrayPtr, const char* data, const std::tr1::shared_ptr<void>& bufferOwner)
+{
+    typedef pvd::PVValueArray<T> ArrayType;
+    std::tr1::shared_ptr<ArrayType> pvArrayPtr = std::tr1::static_pointer_cast<ArrayType>(pvScalarArrayPtr);
+    pvd::shared_vector<const T> value(reinterpret_cast<const T*>(data), BufferOwnerDeleter(bufferOwner), 0, pvArrayPtr->getLength());
+    pvArrayPtr->replace(value);
+}
+
+// Replaces data of all numeric scalar arrays found in the array data map
+// with references to serialized buffer
+static void replaceArrayData(const pvd::PVFieldPtr& pvFieldPtr, const std::map<const char*, const char*>& arrayDataMap, const std::tr1::shared_ptr<void>& bufferOwner)
+{
+    if (!pvFieldPtr) {
+        return;
+    }
+    switch (pvFieldPtr->getField()->getType()) {
+        case pvd::structure: {
+            const pvd::PVFieldPtrArray& pvFields = std::tr1::static_pointer_cast<pvd::PVStructure>(pvFieldPtr)->getPVFields();
+            for (size_t i = 0; i < pvFields.size(); i++) {
+                replaceArrayData(pvFields[i], arrayDataMap, bufferOwner);
+            }
+            break;
+        }
+        case pvd::structureArray: {
+            pvd::PVStructureArray::const_svector elements = std::tr1::static_pointer_cast<pvd::PVStructureArray>(pvFieldPtr)->view();
+            for (size_t i = 0; i < elements.size(); i++) {
+                replaceArrayData(elements[i], arrayDataMap, bufferOwner);
+            }
+            break;
+        }
+        case pvd::union_: {
+            replaceArrayData(std::tr1::static_pointer_cast<pvd::PVUnion>(pvFieldPtr)->get(), arrayDataMap, bufferOwner);
+            break;
+        }
+        case pvd::unionArray: {
+            pvd::PVUnionArray::const_svector elements = std::tr1::static_pointer_cast<pvd::PVUnionArray>(pvFieldPtr)->view();
+            for (size_t i = 0; i < elements.size(); i++) {
+                if (elements[i]) {
+                    replaceArrayData(elements[i]->get(), arrayDataMap, bufferOwner);
+                }
+            }
+            break;
+        }
+        case pvd::scalarArray: {
+            pvd::PVScalarArrayPtr pvScalarArrayPtr = std::tr1::static_pointer_cast<pvd::PVScalarArray>(pvFieldPtr);
+            pvd::shared_vector<const void> data;
+            pvScalarArrayPtr->PVScalarArray::getAs<void>(data);
+            std::map<const char*, const char*>::const_iterator it = arrayDataMap.find(static_cast<const char*>(data.data()));
+            if (it == arrayDataMap.end()) {
+                break;
+            }
+            switch (pvScalarArrayPtr->getScalarArray()->getElementType()) {
+                case pvd::pvBoolean: replaceArrayData<pvd::boolean>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvByte: replaceArrayData<pvd::int8>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvUByte: replaceArrayData<pvd::uint8>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvShort: replaceArrayData<pvd::int16>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvUShort: replaceArrayData<pvd::uint16>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvInt: replaceArrayData<pvd::int32>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvUInt: replaceArrayData<pvd::uint32>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvLong: replaceArrayData<pvd::int64>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvULong: replaceArrayData<pvd::uint64>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvFloat: replaceArrayData<float>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                case pvd::pvDouble: replaceArrayData<double>(pvScalarArrayPtr, it->second, bufferOwner); break;
+                default: break;
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+std::string PvObjectSerializer::getSerializedIntrospection(const pvd::StructureConstPtr& structurePtr, unsigned int& structureId)
+{
+    std::string introspectionData;
+    if (IntrospectionRegistry::findSerializedIntrospection(structurePtr, structureId, introspectionData)) {
+        return introspectionData;
+    }
+
+    SerializedSizeCounter counter;
+    structurePtr->serialize(&counter.byteBuffer, &counter);
+    introspectionData.resize(counter.getSize());
+    if (!introspectionData.empty()) {
+        SerializedBufferWriter writer(&introspectionData[0], introspectionData.size());
+        structurePtr->serialize(&writer.byteBuffer, &writer);
+    }
+    structureId = IntrospectionRegistry::registerStructure(structurePtr, introspectionData);
+    return introspectionData;
+}
+
+// Only introspection data in native byte order is registered, as it
+// is reused for serialization of structures found in the registry
+pvd::StructureConstPtr PvObjectSerializer::getDeserializedIntrospection(const std::string& introspectionData, int byteOrder, pvd::ByteBuffer& byteBuffer, pvd::DeserializableControl& control)
+{
+    unsigned int structureId = 0;
+    pvd::StructureConstPtr structurePtr;
+    bool isNativeByteOrder = (byteOrder == EPICS_BYTE_ORDER);
+    if (isNativeByteOrder && IntrospectionRegistry::findStructure(introspectionData, structureId, structurePtr)) {
+        return structurePtr;
+    }
+
+    pvd::FieldConstPtr fieldPtr = pvd::getFieldCreate()->deserialize(&byteBuffer, &control);
+    if (!fieldPtr || fieldPtr->getType() != pvd::structure) {
+        throw InvalidArgument("Serialized data does not contain PV structure.");
+    }
+    structurePtr = std::tr1::static_pointer_cast<const pvd::Structure>(fieldPtr);
+    if (isNativeByteOrder) {
+        IntrospectionRegistry::registerStructure(structurePtr, introspectionData);
+    }
+    else {
+        getSerializedIntrospection(structurePtr, structureId);
+    }
+    return structurePtr;
+}
+
+size_t PvObjectSerializer::getAlignmentPadding(size_t position)
+{
+    return (ArrayAlignment - position % ArrayAlignment) % ArrayAlignment;
+}
+
+std::string PvObjectSerializer::getIntrospectionData(const pvd::StructureConstPtr& structurePtr)
+{
+    unsigned int structureId = 0;
+    return getSerializedIntrospection(structurePtr, structureId);
+}
+
+pvd::StructureConstPtr PvObjectSerializer::getStructure(const std::string& introspectionData)
+{
+    SerializedBufferReader reader(introspectionData.data(), introspectionData.size(), EPICS_BYTE_ORDER);
+    return getDeserializedIntrospection(introspectionData, EPICS_BYTE_ORDER, reader.byteBuffer, reader);
+}
+
+size_t PvObjectSerializer::getSerializedDataSize(const pvd::PVStructurePtr& pvStructurePtr, bool alignArrays)
+{
+    SerializedSizeCounter counter(alignArrays);
+    pvStructurePtr->serialize(&counter.byteBuffer, &counter);
+    return counter.getSize();
+}
+
+size_t PvObjectSerializer::serializeData(const pvd::PVStructurePtr& pvStructurePtr, char* buffer, size_t bufferSize, bool alignArrays)
+{
+    SerializedBufferWriter writer(buffer, bufferSize, alignArrays);
+    pvStructurePtr->serialize(&writer.byteBuffer, &writer);
+    return writer.byteBuffer.getPosition();
+}
+
+pvd::PVStructurePtr PvObjectSerializer::deserializeData(const pvd::StructureConstPtr& structurePtr, const char* buffer, size_t bufferSize, bool alignArrays, const std::tr1::shared_ptr<void>& bufferOwner)
+{
+    std::map<const char*, const char*> arrayDataMap;
+    SerializedBufferReader reader(buffer, bufferSize, EPICS_BYTE_ORDER, alignArrays, (bufferOwner ? &arrayDataMap : NULL));
+    pvd::PVStructurePtr pvStructurePtr = pvd::getPVDataCreate()->createPVStructure(structurePtr);
+    pvStructurePtr->deserialize(&reader.byteBuffer, &reader);
+    if (!arrayDataMap.empty()) {
+        replaceArrayData(pvStructurePtr, arrayDataMap, bufferOwner);
+    }
+    return pvStructurePtr;
+}
+
+size_t PvObjectSerializer::getSerializedSize(const pvd::PVStructurePtr& pvStructurePtr, const StreamContext* context)
+{
+    unsigned int structureId = 0;
+    std::string introspectionData = getSerializedIntrospection(pvStructurePtr->getStructure(), structureId);
+    size_t introspectionSize = introspectionData.size();
+    if (context && context->sentStructureIdSet.find(structureId) != context->sentStructureIdSet.end()) {
+        introspectionSize = 0;
+    }
+    SerializedSizeCounter counter;
+    pvStructurePtr->serialize(&counter.byteBuffer, &counter);
+    return HeaderSize + introspectionSize + counter.getSize();
+}
+
+size_t PvObjectSerializer::serialize(const pvd::PVStructurePtr& pvStructurePtr, char* buffer, size_t bufferSize, StreamContext* context)
+{
+    unsigned int structureId = 0;
+    std::string introspectionData = getSerializedIntrospection(pvStructurePtr->getStructure(), structureId);
+    unsigned char flags = (EPICS_BYTE_ORDER == EPICS_ENDIAN_BIG ? BigEndianFlag : 0);
+    size_t introspectionSize = introspectionData.size();
+    if (context && context->sentStructureIdSet.find(structureId) != context->sentStructureIdSet.end()) {
+        flags |= StructureReferenceFlag;
+        introspectionSize = 0;
+    }
+    if (bufferSize < HeaderSize + introspectionSize) {
+        throw InvalidArgument("Serialization buffer is too small.");
+    }
+
+    SerializedBufferWriter writer(buffer, bufferSize);
+    pvd::ByteBuffer& byteBuffer = writer.byteBuffer;
+    byteBuffer.putByte('P');
+    byteBuffer.putByte('V');
+    byteBuffer.putByte(pvd::int8(FormatVersion));
+    byteBuffer.putByte(pvd::int8(flags));
+    byteBuffer.putInt(pvd::int32(structureId));
+    byteBuffer.putInt(pvd::int32(introspectionSize));
+    byteBuffer.put(introspectionData.data(), 0, introspectionSize);
+    pvStructurePtr->serialize(&byteBuffer, &writer);
+    if (context) {
+        context->sentStructureIdSet.insert(structureId);
+    }
+    return byteBuffer.getPosition();
+}
+
+pvd::PVStructurePtr PvObjectSerializer::deserialize(const char* buffer, size_t bufferSize, StreamContext* context)
+{
+    if (bufferSize < HeaderSize || buffer[0] != 'P' || buffer[1] != 'V') {
+        throw InvalidArgument("Buffer does not contain serialized PV object.");
+    }
+    if (static_cast<unsigned char>(buffer[2]) != FormatVersion) {
+        throw InvalidArgument("Unsupported serialization format version: %d.", int(static_cast<unsigned char>(buffer[2])));
+    }
+    unsigned char flags = static_cast<unsigned char>(buffer[3]);
+    int byteOrder = ((flags & BigEndianFlag) ? EPICS_ENDIAN_BIG : EPICS_ENDIAN_LITTLE);
+
+    SerializedBufferReader reader(buffer, bufferSize, byteOrder);
+    pvd::ByteBuffer& byteBuffer = reader.byteBuffer;
+    byteBuffer.setPosition(4);
+    unsigned int structureId = pvd::uint32(byteBuffer.getInt());
+    size_t introspectionSize = pvd::uint32(byteBuffer.getInt());
+    pvd::StructureConstPtr structurePtr;
+    if (flags & StructureReferenceFlag) {
+        std::map<unsigned int, pvd::StructureConstPtr>::const_iterator it;
+        if (!context || (it = context->receivedStructureMap.find(structureId)) == context->receivedStructureMap.end()) {
+            throw InvalidArgument("Serialized data references structure id %u that was not received.", structureId);
+        }
+        structurePtr = it->second;
+    }
+    else {
+        reader.ensureData(introspectionSize);
+        std::string introspectionData(buffer+HeaderSize, introspectionSize);
+        structurePtr = getDeserializedIntrospection(introspectionData, byteOrder, byteBuffer, reader);
+        if (context) {
+            context->receivedStructureMap[structureId] = structurePtr;
+        }
+    }
+    byteBuffer.setPosition(HeaderSize + introspectionSize);
+
+    pvd::PVStructurePtr pvStructurePtr = pvd::getPVDataCreate()->createPVStructure(structurePtr);
+    pvStructurePtr->deserialize(&byteBuffer, &reader);
+    return pvStructurePtr;
+}
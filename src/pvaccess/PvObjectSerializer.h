@@ -0,0 +1,76 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef PV_OBJECT_SERIALIZER_H
+#define PV_OBJECT_SERIALIZER_H
+
+#include <string>
+#include <map>
+#include <set>
+#include <pv/pvData.h>
+#include <pv/serialize.h>
+
+// Serializes PV structures using pvData binary encoding. Serialized
+// buffer contains short header, structure introspection data and
+// structure field data, all in the native byte order of the writer:
+//
+//   'P' 'V' <version> <flags> <structure id (uint32)>
+//   <introspection size (uint32)> <introspection data> <field data>
+//
+// Introspection data is encoded once per structure type and interned in
+// the IntrospectionRegistry, which also assigns structure id, and
+// structures decoded from identical introspection data are reused, so
+// that repeated serialization of objects of the same type only encodes
+// and decodes field data. Array data is copied directly between
+// PV arrays and serialized buffer.
+//
+// Serialization streams can keep a StreamContext on both ends (see
+// SerializationContext), in which case introspection data is sent only
+// with the first object of a given type, and subsequent objects reference
+// the structure by id. Contexts are not thread safe.
+class PvObjectSerializer
+{
+public:
+    static const unsigned char FormatVersion;
+    static const size_t HeaderSize;
+    static const unsigned char BigEndianFlag;
+    static const unsigned char StructureReferenceFlag;
+    static const size_t ArrayAlignment;
+
+    struct StreamContext
+    {
+        void reset();
+        std::set<unsigned int> sentStructureIdSet;
+        std::map<unsigned int, epics::pvData::StructureConstPtr> receivedStructureMap;
+    };
+
+    // Number of bytes needed for serialized structure
+    static size_t getSerializedSize(const epics::pvData::PVStructurePtr& pvStructurePtr, const StreamContext* context=NULL);
+
+    // Buffer must be at least getSerializedSize() bytes long; returns
+    // number of bytes written
+    static size_t serialize(const epics::pvData::PVStructurePtr& pvStructurePtr, char* buffer, size_t bufferSize, StreamContext* context=NULL);
+    static epics::pvData::PVStructurePtr deserialize(const char* buffer, size_t bufferSize, StreamContext* context=NULL);
+
+    // Interned introspection data for a given structure, and vice versa
+    static std::string getIntrospectionData(const epics::pvData::StructureConstPtr& structurePtr);
+    static epics::pvData::StructureConstPtr getStructure(const std::string& introspectionData);
+
+    // Field data only, without header and introspection, in native byte
+    // order. With aligned arrays, data of scalar arrays with multi-byte
+    // elements starts at ArrayAlignment boundary relative to the buffer
+    // start. If buffer owner is given, numeric scalar arrays of the
+    // deserialized structure reference buffer data instead of copying it,
+    // and keep the owner alive for as long as they are in use.
+    static size_t getSerializedDataSize(const epics::pvData::PVStructurePtr& pvStructurePtr, bool alignArrays=false);
+    static size_t serializeData(const epics::pvData::PVStructurePtr& pvStructurePtr, char* buffer, size_t bufferSize, bool alignArrays=false);
+    static epics::pvData::PVStructurePtr deserializeData(const epics::pvData::StructureConstPtr& structurePtr, const char* buffer, size_t bufferSize, bool alignArrays=false, const std::tr1::shared_ptr<void>& bufferOwner=std::tr1::shared_ptr<void>());
+
+    static size_t getAlignmentPadding(size_t position);
+
+private:
+    static std::string getSerializedIntrospection(const epics::pvData::StructureConstPtr& structurePtr, unsigned int& structureId);
+    static epics::pvData::StructureConstPtr getDeserializedIntrospection(const std::string& introspectionData, int byteOrder, epics::pvData::ByteBuffer& byteBuffer, epics::pvData::DeserializableControl& control);
+};
+
+#endif
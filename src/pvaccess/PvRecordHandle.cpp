@@ -0,0 +1,57 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "PvRecordHandle.h"
+#include "ObjectNotFound.h"
+
+PvRecordHandle::PvRecordHandle(const PyPvRecordPtr& record_)
+    : record(record_)
+{
+}
+
+PvRecordHandle::PvRecordHandle(const PvRecordHandle& recordHandle)
+    : record(recordHandle.record)
+{
+}
+
+PvRecordHandle::~PvRecordHandle()
+{
+}
+
+const PyPvRecordPtr& PvRecordHandle::getRecord() const
+{
+    if (record->isRemoved()) {
+        throw ObjectNotFound("Master database does not have record for channel: " + record->getRecordName());
+    }
+    return record;
+}
+
+std::string PvRecordHandle::getChannelName() const
+{
+    return record->getRecordName();
+}
+
+bool PvRecordHandle::isValid() const
+{
+    return !record->isRemoved();
+}
+
+void PvRecordHandle::update(const boost::python::dict& pyDict)
+{
+    getRecord()->update(pyDict);
+}
+
+void PvRecordHandle::update(const PvObject& pvObject)
+{
+    getRecord()->update(pvObject);
+}
+
+void PvRecordHandle::updateUnchecked(const PvObject& pvObject)
+{
+    getRecord()->updateUnchecked(pvObject);
+}
+
+unsigned int PvRecordHandle::updateChanged(const PvObject& pvObject)
+{
+    return getRecord()->updateChanged(pvObject);
+}
@@ -0,0 +1,34 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef PV_RECORD_HANDLE_H
+#define PV_RECORD_HANDLE_H
+
+#include <string>
+#include <boost/python/dict.hpp>
+#include "PvObject.h"
+#include "PyPvRecord.h"
+
+// Direct reference to a server record, which allows repeated updates
+// without channel name lookup.
+class PvRecordHandle
+{
+public:
+    PvRecordHandle(const PyPvRecordPtr& record);
+    PvRecordHandle(const PvRecordHandle& recordHandle);
+    virtual ~PvRecordHandle();
+
+    std::string getChannelName() const;
+    bool isValid() const;
+    void update(const boost::python::dict& pyDict);
+    void update(const PvObject& pvObject);
+    void updateUnchecked(const PvObject& pvObject);
+    unsigned int updateChanged(const PvObject& pvObject);
+
+private:
+    const PyPvRecordPtr& getRecord() const;
+
+    PyPvRecordPtr record;
+};
+
+#endif
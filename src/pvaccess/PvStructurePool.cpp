@@ -0,0 +1,250 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "PvStructurePool.h"
+#include "PvaPyConstants.h"
+
+namespace pvd = epics::pvData;
+
+const int PvStructurePool::DefaultMaxSize(64);
+
+// Release array data held by recycled structure, so that pool
+// does not keep large arrays (e.g., images) alive; arrays are replaced
+// with empty ones, as setting their length would only slice the data
+static void releaseArrays(const pvd::PVFieldPtr& pvFieldPtr)
+{
+    switch (pvFieldPtr->getField()->getType()) {
+        case pvd::structure: {
+            const pvd::PVFieldPtrArray& pvFields = std::tr1::static_pointer_cast<pvd::PVStructure>(pvFieldPtr)->getPVFields();
+            for (size_t i = 0; i < pvFields.size(); i++) {
+                releaseArrays(pvFields[i]);
+            }
+            break;
+        }
+        case pvd::union_: {
+            // Union value (e.g., NTNDArray image) is kept for reuse
+            pvd::PVFieldPtr pvValuePtr = std::tr1::static_pointer_cast<pvd::PVUnion>(pvFieldPtr)->get();
+            if (pvValuePtr) {
+                releaseArrays(pvValuePtr);
+            }
+            break;
+        }
+        case pvd::scalarArray: {
+            std::tr1::static_pointer_cast<pvd::PVScalarArray>(pvFieldPtr)->putFrom(pvd::shared_vector<const pvd::int8>());
+            break;
+        }
+        case pvd::structureArray: {
+            std::tr1::static_pointer_cast<pvd::PVStructureArray>(pvFieldPtr)->replace(pvd::PVStructureArray::const_svector());
+            break;
+        }
+        case pvd::unionArray: {
+            std::tr1::static_pointer_cast<pvd::PVUnionArray>(pvFieldPtr)->replace(pvd::PVUnionArray::const_svector());
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+}
+
+// Number of array data bytes held by a given field
+static unsigned int getArrayBytes(const pvd::PVFieldPtr& pvFieldPtr)
+{
+    unsigned int nBytes = 0;
+    switch (pvFieldPtr->getField()->getType()) {
+        case pvd::structure: {
+            const pvd::PVFieldPtrArray& pvFields = std::tr1::static_pointer_cast<pvd::PVStructure>(pvFieldPtr)->getPVFields();
+            for (size_t i = 0; i < pvFields.size(); i++) {
+                nBytes += getArrayBytes(pvFields[i]);
+            }
+            break;
+        }
+        case pvd::union_: {
+            pvd::PVFieldPtr pvValuePtr = std::tr1::static_pointer_cast<pvd::PVUnion>(pvFieldPtr)->get();
+            if (pvValuePtr) {
+                nBytes += getArrayBytes(pvValuePtr);
+            }
+            break;
+        }
+        case pvd::scalarArray: {
+            pvd::PVScalarArrayPtr pvScalarArrayPtr = std::tr1::static_pointer_cast<pvd::PVScalarArray>(pvFieldPtr);
+            nBytes += pvScalarArrayPtr->getCapacity()*pvd::ScalarTypeFunc::elementSize(pvScalarArrayPtr->getScalarArray()->getElementType());
+            break;
+        }
+        case pvd::structureArray:
+        case pvd::unionArray: {
+            nBytes += std::tr1::static_pointer_cast<pvd::PVArray>(pvFieldPtr)->getCapacity()*sizeof(pvd::PVFieldPtr);
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+    return nBytes;
+}
+
+// Handed out structures are aliases of pool structures, so that
+// references obtained via shared_from_this() or to sub-fields (e.g.,
+// arrays exposed to python) are not counted by them; such structure
+// cannot be reused until those references are gone
+static bool isReferenced(const pvd::PVStructurePtr& pvStructurePtr, long nOwners)
+{
+    if (pvStructurePtr.use_count() > nOwners) {
+        return true;
+    }
+    const pvd::PVFieldPtrArray& pvFields = pvStructurePtr->getPVFields();
+    for (size_t i = 0; i < pvFields.size(); i++) {
+        if (pvFields[i].use_count() > 1) {
+            return true;
+        }
+        switch (pvFields[i]->getField()->getType()) {
+            case pvd::structure: {
+                if (isReferenced(std::tr1::static_pointer_cast<pvd::PVStructure>(pvFields[i]), 1)) {
+                    return true;
+                }
+                break;
+            }
+            case pvd::union_: {
+                // Temporary value pointer is one more owner
+                pvd::PVFieldPtr pvValuePtr = std::tr1::static_pointer_cast<pvd::PVUnion>(pvFields[i])->get();
+                if (pvValuePtr && pvValuePtr.use_count() > 2) {
+                    return true;
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+PvStructurePool::Recycler::Recycler(const PvStructurePool::weak_pointer& poolPtr_, const pvd::PVStructurePtr& pvStructurePtr_)
+    : poolPtr(poolPtr_)
+    , pvStructurePtr(pvStructurePtr_)
+{
+}
+
+void PvStructurePool::Recycler::operator()(pvd::PVStructure*)
+{
+    PvStructurePool::shared_pointer pool = poolPtr.lock();
+    if (pool) {
+        pool->recycle(pvStructurePtr);
+    }
+    pvStructurePtr.reset();
+}
+
+PvStructurePool::PvStructurePool(int maxSize_)
+    : mutex()
+    , structurePtr()
+    , pvStructureList()
+    , maxSize(maxSize_)
+    , counterMap()
+    , nHits(0)
+    , nMisses(0)
+{
+}
+
+PvStructurePool::~PvStructurePool()
+{
+}
+
+void PvStructurePool::setMaxSize(int maxSize)
+{
+    pvd::Lock lock(mutex);
+    this->maxSize = maxSize;
+    while (pvStructureList.size() > 0 && int(pvStructureList.size()) > maxSize) {
+        pvStructureList.pop_back();
+    }
+}
+
+int PvStructurePool::getMaxSize()
+{
+    return maxSize;
+}
+
+unsigned int PvStructurePool::size()
+{
+    pvd::Lock lock(mutex);
+    return pvStructureList.size();
+}
+
+void PvStructurePool::preallocate(const pvd::StructureConstPtr& structurePtr)
+{
+    pvd::Lock lock(mutex);
+    if (this->structurePtr != structurePtr) {
+        pvStructureList.clear();
+        this->structurePtr = structurePtr;
+    }
+    while (int(pvStructureList.size()) < maxSize) {
+        pvStructureList.push_back(pvd::getPVDataCreate()->createPVStructure(structurePtr));
+    }
+}
+
+void PvStructurePool::clear()
+{
+    pvd::Lock lock(mutex);
+    pvStructureList.clear();
+    structurePtr = pvd::StructureConstPtr();
+}
+
+pvd::PVStructurePtr PvStructurePool::copy(const pvd::PVStructure& pvStructure)
+{
+    pvd::PVStructurePtr pvStructurePtr;
+    {
+        pvd::Lock lock(mutex);
+        if (!pvStructureList.empty() && structurePtr == pvStructure.getStructure()) {
+            pvStructurePtr = pvStructureList.front();
+            pvStructureList.pop_front();
+            nHits++;
+        }
+        else {
+            nMisses++;
+        }
+    }
+    if (!pvStructurePtr) {
+        pvStructurePtr = pvd::getPVDataCreate()->createPVStructure(pvStructure.getStructure());
+    }
+    // Array data is not copied here, it is shared with the source
+    // structure until this copy is recycled
+    pvStructurePtr->copyUnchecked(pvStructure);
+    return pvd::PVStructurePtr(pvStructurePtr.get(), Recycler(shared_from_this(), pvStructurePtr));
+}
+
+// Called when the last alias is released; recycler is the only
+// remaining owner of an unreferenced structure
+void PvStructurePool::recycle(const pvd::PVStructurePtr& pvStructurePtr)
+{
+    if (isReferenced(pvStructurePtr, 1)) {
+        return;
+    }
+    releaseArrays(pvStructurePtr);
+    pvd::Lock lock(mutex);
+    if (int(pvStructureList.size()) >= maxSize || pvStructurePtr->getStructure() != structurePtr) {
+        // Pool is full, or structure type has changed
+        return;
+    }
+    pvStructureList.push_back(pvStructurePtr);
+}
+
+void PvStructurePool::resetCounters()
+{
+    pvd::Lock lock(mutex);
+    nHits = 0;
+    nMisses = 0;
+}
+
+const std::map<std::string,unsigned int>& PvStructurePool::getCounterMap()
+{
+    pvd::Lock lock(mutex);
+    counterMap[PvaPyConstants::NumPoolHitsCounterKey] = nHits;
+    counterMap[PvaPyConstants::NumPoolMissesCounterKey] = nMisses;
+    counterMap[PvaPyConstants::NumPooledCounterKey] = pvStructureList.size();
+    unsigned int nPooledArrayBytes = 0;
+    for (std::list<pvd::PVStructurePtr>::const_iterator it = pvStructureList.begin(); it != pvStructureList.end(); it++) {
+        nPooledArrayBytes += getArrayBytes(*it);
+    }
+    counterMap[PvaPyConstants::NumPooledArrayBytesCounterKey] = nPooledArrayBytes;
+    return counterMap;
+}
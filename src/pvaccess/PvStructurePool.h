@@ -0,0 +1,67 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef PV_STRUCTURE_POOL_H
+#define PV_STRUCTURE_POOL_H
+
+#include <list>
+#include <map>
+#include <string>
+#include <pv/pvData.h>
+
+// Pool of preallocated PV structures of the same type. Structures handed
+// out by the pool are returned into it automatically once all references
+// to them (e.g., python PvObjects) are released; structures whose
+// sub-fields are still referenced elsewhere are not reused. Scalar array
+// fields are copied by sharing the underlying shared_vector data, and
+// are released when structures are returned into the pool.
+class PvStructurePool : public std::tr1::enable_shared_from_this<PvStructurePool>
+{
+public:
+    POINTER_DEFINITIONS(PvStructurePool);
+
+    static const int DefaultMaxSize;
+
+    PvStructurePool(int maxSize=DefaultMaxSize);
+    virtual ~PvStructurePool();
+    void setMaxSize(int maxSize);
+    int getMaxSize();
+    unsigned int size();
+
+    // Allocates pool structures for a given type, discarding
+    // all structures of a different type
+    void preallocate(const epics::pvData::StructureConstPtr& structurePtr);
+    void clear();
+
+    // Returns pooled copy of a given structure
+    epics::pvData::PVStructurePtr copy(const epics::pvData::PVStructure& pvStructure);
+
+    // Statistics
+    void resetCounters();
+    const std::map<std::string,unsigned int>& getCounterMap();
+
+private:
+    class Recycler
+    {
+    public:
+        Recycler(const PvStructurePool::weak_pointer& poolPtr, const epics::pvData::PVStructurePtr& pvStructurePtr);
+        void operator()(epics::pvData::PVStructure*);
+    private:
+        PvStructurePool::weak_pointer poolPtr;
+        epics::pvData::PVStructurePtr pvStructurePtr;
+    };
+
+    void recycle(const epics::pvData::PVStructurePtr& pvStructurePtr);
+
+    epics::pvData::Mutex mutex;
+    epics::pvData::StructureConstPtr structurePtr;
+    std::list<epics::pvData::PVStructurePtr> pvStructureList;
+    int maxSize;
+
+    // Statistics counters
+    std::map<std::string, unsigned int> counterMap;
+    unsigned int nHits;
+    unsigned int nMisses;
+};
+
+#endif
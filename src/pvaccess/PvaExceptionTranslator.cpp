@@ -27,7 +27,7 @@ PyObject* PvaExceptionTranslator::createExceptionClass(const char* name, PyObjec
     return excClass;
 }
 
-void PvaExceptionTranslator::translator(const PvaException& ex)
+PyObject* PvaExceptionTranslator::getExceptionClass(const PvaException& ex)
 {
     const char* pyExceptionClassName = ex.getPyExceptionClassName();
     std::map<std::string,PyObject*>::iterator iterator = exceptionClassMap.find(pyExceptionClassName);
@@ -35,7 +35,17 @@ void PvaExceptionTranslator::translator(const PvaException& ex)
     if (iterator != exceptionClassMap.end()) {
         exceptionClass = iterator->second;
     }
+    return exceptionClass;
+}
 
-    PyErr_SetString(exceptionClass, ex.what());
+void PvaExceptionTranslator::translator(const PvaException& ex)
+{
+    PyErr_SetString(getExceptionClass(ex), ex.what());
+}
+
+boost::python::object PvaExceptionTranslator::createPyException(const PvaException& ex)
+{
+    boost::python::object pyExceptionClass(boost::python::handle<>(boost::python::borrowed(getExceptionClass(ex))));
+    return pyExceptionClass(std::string(ex.what()));
 }
 
@@ -13,7 +13,11 @@ class PvaExceptionTranslator
 public:
     static PyObject* createExceptionClass(const char* name, PyObject* baseClass=PyExc_Exception);
     static void translator(const PvaException& ex);
+    // Returns python exception object for a given exception,
+    // e.g., for setting exceptions of python futures
+    static boost::python::object createPyException(const PvaException& ex);
 private:
+    static PyObject* getExceptionClass(const PvaException& ex);
     static std::map<std::string,PyObject*> exceptionClassMap;
 };
 
@@ -2,6 +2,8 @@
 // found in the file LICENSE that is included with the distribution
 
 
+#include <list>
+#include <vector>
 #include <pv/clientFactory.h>
 #include "StringUtility.h"
 #include "PyUtility.h"
@@ -22,40 +24,234 @@ namespace bp = boost::python;
 
 PvaPyLogger MirrorChannelDataProcessor::logger("MirrorChannelDataProcessor");
 
-MirrorChannelDataProcessor::MirrorChannelDataProcessor(PvaMirrorServer* pvaMirrorServer_, const std::string& mirrorChannelName_, unsigned int nSrcMonitors_)
+MirrorChannelDataProcessor::MirrorChannelDataProcessor(PvaMirrorServer* pvaMirrorServer_, const std::string& mirrorChannelName_, const std::string& fieldRequestDescriptor_)
     : pvaMirrorServer(pvaMirrorServer_)
     , mirrorChannelName(mirrorChannelName_)
+    , fieldRequestDescriptor(fieldRequestDescriptor_)
     , mutex()
     , recordAdded(false)
-    , nSrcMonitors(nSrcMonitors_)
-    , nUpdatesToSkip(nSrcMonitors)
+    , removed(false)
+    , nDelivered(0)
+    , minUpdatePeriod(0)
+    , lastUpdateTime()
+    , timerQueue(epicsTimerQueueActive::allocate(true))
+    , trailingUpdateTimer(timerQueue.createTimer())
+    , trailingUpdateScheduled(false)
+    , pendingPvStructurePtr()
+    , hasPendingUpdate(false)
+    , decimation(1)
+    , nUpdatesToDecimate(0)
+    , deadbandFieldName()
+    , deadband(0)
+    , deadbandStructurePtr()
+    , deadbandFieldOffset(0)
+    , hasLastDeadbandValue(false)
+    , lastDeadbandValue(0)
+    , nDecimated(0)
+    , nDeadbandSuppressed(0)
+    , nRateLimited(0)
 {
+#if PVA_API_VERSION >= 482
+    if (!fieldRequestDescriptor.empty()) {
+        pvRequestPtr = epvd::createRequest("field(" + fieldRequestDescriptor + ")");
+        if (!pvRequestPtr) {
+            throw InvalidRequest("Invalid field request descriptor for mirror channel " + mirrorChannelName + ": " + fieldRequestDescriptor);
+        }
+    }
+#endif // if PVA_API_VERSION >= 482
 }
 
 MirrorChannelDataProcessor::~MirrorChannelDataProcessor() 
 {
-    onChannelDisconnect();
+    remove();
+    // Waits for trailing update that might be in progress
+    trailingUpdateTimer.destroy();
+    timerQueue.release();
+}
+
+std::string MirrorChannelDataProcessor::getMirrorChannelName() const
+{
+    return mirrorChannelName;
+}
+
+// Must be called with mutex locked. Projected structure shares
+// array data with the source structure.
+epvd::PVStructurePtr MirrorChannelDataProcessor::projectData(const epvd::PVStructurePtr& pvStructurePtr)
+{
+#if PVA_API_VERSION >= 482
+    if (!pvRequestPtr) {
+        return pvStructurePtr;
+    }
+    if (srcStructurePtr != pvStructurePtr->getStructure()) {
+        // Source structure has changed
+        requestMapper.compute(*pvStructurePtr, *pvRequestPtr, epvd::PVRequestMapper::Slice);
+        if (!requestMapper.warnings().empty()) {
+            logger.warn("Field request for mirror channel %s: %s", mirrorChannelName.c_str(), requestMapper.warnings().c_str());
+        }
+        srcStructurePtr = pvStructurePtr->getStructure();
+        projectedPvStructurePtr = requestMapper.buildRequested();
+        srcBitSet.clear();
+        srcBitSet.set(0);
+    }
+    projectedBitSet.clear();
+    requestMapper.copyBaseToRequested(*pvStructurePtr, srcBitSet, *projectedPvStructurePtr, projectedBitSet);
+    return projectedPvStructurePtr;
+#else
+    return pvStructurePtr;
+#endif // if PVA_API_VERSION >= 482
+}
+
+// Must be called with mutex locked. Deadband field offset is cached
+// for a given source structure.
+bool MirrorChannelDataProcessor::getDeadbandValue(const epvd::PVStructurePtr& pvStructurePtr, double& value)
+{
+    if (deadbandStructurePtr != pvStructurePtr->getStructure()) {
+        deadbandStructurePtr = pvStructurePtr->getStructure();
+        deadbandFieldOffset = 0;
+        epvd::PVScalarPtr pvScalarPtr = pvStructurePtr->getSubField<epvd::PVScalar>(deadbandFieldName);
+        if (pvScalarPtr) {
+            deadbandFieldOffset = pvScalarPtr->getFieldOffset();
+        }
+        else {
+            logger.warn("Deadband field %s for mirror channel %s is not a scalar field of the source structure", deadbandFieldName.c_str(), mirrorChannelName.c_str());
+        }
+    }
+    if (!deadbandFieldOffset) {
+        return false;
+    }
+    epvd::PVScalarPtr pvScalarPtr = std::tr1::static_pointer_cast<epvd::PVScalar>(pvStructurePtr->getSubField(deadbandFieldOffset));
+    value = pvScalarPtr->getAs<double>();
+    return true;
+}
+
+// Must be called with mutex locked. Evaluates configured policies
+// on source data, without copying it; first update that creates
+// mirror record is always accepted. Updates suppressed by rate limit
+// are deferred, and the source keeps data for the trailing update.
+MirrorChannelDataProcessor::UpdateStatus MirrorChannelDataProcessor::acceptUpdate(const epvd::PVStructurePtr& pvStructurePtr)
+{
+    if (nUpdatesToDecimate > 0 && recordAdded) {
+        nUpdatesToDecimate--;
+        nDecimated++;
+        return UpdateSuppressed;
+    }
+    nUpdatesToDecimate = decimation-1;
+
+    double deadbandValue = 0;
+    bool hasDeadbandValue = (deadband > 0 && !deadbandFieldName.empty() && getDeadbandValue(pvStructurePtr, deadbandValue));
+    if (hasDeadbandValue && hasLastDeadbandValue && recordAdded) {
+        double change = deadbandValue - lastDeadbandValue;
+        if (change < deadband && change > -deadband) {
+            nDeadbandSuppressed++;
+            return UpdateSuppressed;
+        }
+    }
+
+    if (minUpdatePeriod > 0) {
+        epicsTimeStamp now;
+        epicsTimeGetCurrent(&now);
+        double timeSinceLastUpdate = epicsTimeDiffInSeconds(&now, &lastUpdateTime);
+        if (recordAdded && timeSinceLastUpdate < minUpdatePeriod) {
+            nRateLimited++;
+            if (hasDeadbandValue) {
+                lastDeadbandValue = deadbandValue;
+                hasLastDeadbandValue = true;
+            }
+            return UpdateDeferred;
+        }
+        lastUpdateTime = now;
+    }
+    hasPendingUpdate = false;
+    pendingPvStructurePtr.reset();
+
+    if (hasDeadbandValue) {
+        lastDeadbandValue = deadbandValue;
+        hasLastDeadbandValue = true;
+    }
+    return UpdatePublished;
+}
+
+// Keeps reference to source data snapshot for the trailing update;
+// snapshot is not modified by the source while it is referenced.
+void MirrorChannelDataProcessor::keepPendingUpdate(const epvd::PVStructurePtr& pvStructurePtr)
+{
+    epvd::Lock lock(mutex);
+    if (removed || !recordAdded || minUpdatePeriod <= 0) {
+        return;
+    }
+    pendingPvStructurePtr = pvStructurePtr;
+    hasPendingUpdate = true;
+    if (!trailingUpdateScheduled) {
+        epicsTimeStamp now;
+        epicsTimeGetCurrent(&now);
+        double delay = minUpdatePeriod - epicsTimeDiffInSeconds(&now, &lastUpdateTime);
+        trailingUpdateScheduled = true;
+        trailingUpdateTimer.start(*this, (delay > 0 ? delay : 0));
+    }
+}
+
+epicsTimerNotify::expireStatus MirrorChannelDataProcessor::expire(const epicsTime& currentTime)
+{
+    epvd::Lock lock(mutex);
+    trailingUpdateScheduled = false;
+    if (removed || !recordAdded || !hasPendingUpdate) {
+        return expireStatus(noRestart);
+    }
+    hasPendingUpdate = false;
+    epvd::PVStructurePtr pvStructurePtr = pendingPvStructurePtr;
+    pendingPvStructurePtr.reset();
+    epicsTimeGetCurrent(&lastUpdateTime);
+    try {
+        publishUpdate(pvStructurePtr);
+        // Update was not discarded after all
+        if (nRateLimited > 0) {
+            nRateLimited--;
+        }
+    }
+    catch (const std::exception& ex) {
+        logger.error("Cannot publish trailing update for mirror channel %s: %s", mirrorChannelName.c_str(), ex.what());
+    }
+    return expireStatus(noRestart);
 }
 
+// Source data must not be modified after it is passed to this method,
+// as it may be kept for the trailing update.
 void MirrorChannelDataProcessor::processMonitorData(epvd::PVStructurePtr pvStructurePtr)
+{
+    if (processSourceData(pvStructurePtr) == UpdateDeferred) {
+        keepPendingUpdate(pvStructurePtr);
+    }
+}
+
+MirrorChannelDataProcessor::UpdateStatus MirrorChannelDataProcessor::processSourceData(const epvd::PVStructurePtr& pvStructurePtr)
 {
     epvd::Lock lock(mutex);
+    if (removed) {
+        // Source update was delivered concurrently with record removal
+        return UpdateSuppressed;
+    }
+    UpdateStatus updateStatus = acceptUpdate(pvStructurePtr);
+    if (updateStatus == UpdatePublished) {
+        publishUpdate(pvStructurePtr);
+    }
+    return updateStatus;
+}
+
+// Must be called with mutex locked.
+void MirrorChannelDataProcessor::publishUpdate(const epvd::PVStructurePtr& pvStructurePtr)
+{
+    epvd::PVStructurePtr mirrorPvStructurePtr = projectData(pvStructurePtr);
     if (!recordAdded) {
-        epvd::PVStructurePtr pvStructurePtr2(epvd::getPVDataCreate()->createPVStructure(pvStructurePtr->getStructure()));
-        pvStructurePtr2->copyUnchecked(*pvStructurePtr);
+        epvd::PVStructurePtr pvStructurePtr2(epvd::getPVDataCreate()->createPVStructure(mirrorPvStructurePtr->getStructure()));
+        pvStructurePtr2->copyUnchecked(*mirrorPvStructurePtr);
         pvaMirrorServer->addRecord(mirrorChannelName, pvStructurePtr2);
         pvaMirrorServer->disableRecordProcessing(mirrorChannelName);
         recordAdded = true;
-        nUpdatesToSkip--;
-    }
-    else if (nUpdatesToSkip > 0) {
-        // This makes sure we do not generate first update
-        // multiple times in case we have multiple monitors
-        nUpdatesToSkip--;
     }
     else {
-        pvaMirrorServer->updateUnchecked(mirrorChannelName, pvStructurePtr);
+        pvaMirrorServer->updateUnchecked(mirrorChannelName, mirrorPvStructurePtr);
     }
+    nDelivered++;
 }
 
 void MirrorChannelDataProcessor::onChannelConnect()
@@ -65,6 +261,19 @@ void MirrorChannelDataProcessor::onChannelConnect()
 void MirrorChannelDataProcessor::onChannelDisconnect()
 {
     epvd::Lock lock(mutex);
+    removeRecord();
+}
+
+void MirrorChannelDataProcessor::remove()
+{
+    epvd::Lock lock(mutex);
+    removed = true;
+    removeRecord();
+}
+
+// Must be called with mutex locked.
+void MirrorChannelDataProcessor::removeRecord()
+{
     if (recordAdded) {
         if (pvaMirrorServer->hasRecord(mirrorChannelName)) {
             try {
@@ -76,8 +285,186 @@ void MirrorChannelDataProcessor::onChannelDisconnect()
 
         }
         recordAdded = false;
-        nUpdatesToSkip = nSrcMonitors;
     }
+    nUpdatesToDecimate = 0;
+    hasLastDeadbandValue = false;
+    hasPendingUpdate = false;
+    pendingPvStructurePtr.reset();
+}
+
+void MirrorChannelDataProcessor::resetCounters()
+{
+    epvd::Lock lock(mutex);
+    nDelivered = 0;
+    nDecimated = 0;
+    nDeadbandSuppressed = 0;
+    nRateLimited = 0;
+}
+
+std::map<std::string,unsigned int> MirrorChannelDataProcessor::getCounterMap()
+{
+    epvd::Lock lock(mutex);
+    std::map<std::string,unsigned int> counterMap;
+    counterMap[PvaPyConstants::NumDeliveredCounterKey] = nDelivered;
+    counterMap[PvaPyConstants::NumDecimatedCounterKey] = nDecimated;
+    counterMap[PvaPyConstants::NumDeadbandSuppressedCounterKey] = nDeadbandSuppressed;
+    counterMap[PvaPyConstants::NumRateLimitedCounterKey] = nRateLimited;
+    return counterMap;
+}
+
+void MirrorChannelDataProcessor::setMaxUpdateRate(double maxUpdateRate)
+{
+    epvd::Lock lock(mutex);
+    minUpdatePeriod = 0;
+    if (maxUpdateRate > 0) {
+        minUpdatePeriod = 1.0/maxUpdateRate;
+    }
+}
+
+void MirrorChannelDataProcessor::setDecimation(unsigned int decimation)
+{
+    epvd::Lock lock(mutex);
+    if (decimation < 1) {
+        decimation = 1;
+    }
+    this->decimation = decimation;
+    nUpdatesToDecimate = 0;
+}
+
+void MirrorChannelDataProcessor::setDeadband(const std::string& deadbandFieldName, double deadband)
+{
+    epvd::Lock lock(mutex);
+    this->deadbandFieldName = deadbandFieldName;
+    this->deadband = deadband;
+    deadbandStructurePtr.reset();
+    deadbandFieldOffset = 0;
+    hasLastDeadbandValue = false;
+}
+
+// Mirror Channel Source class
+
+PvaPyLogger MirrorChannelSource::logger("MirrorChannelSource");
+
+MirrorChannelSource::MirrorChannelSource(const std::string& srcChannelName_, unsigned int nSrcMonitors_)
+    : srcChannelName(srcChannelName_)
+    , mutex()
+    , dataProcessorMap()
+    , lastPvStructurePtr()
+    , hasReceivedData(false)
+    , nSrcMonitors(nSrcMonitors_)
+    , nUpdatesToSkip(0)
+{
+}
+
+MirrorChannelSource::~MirrorChannelSource()
+{
+}
+
+// Policies of all mirror records are evaluated on monitor data before
+// anything is copied. Monitor data is reused, so source keeps its own
+// snapshot only if some record accepted the update (for records added
+// later) or deferred it (for trailing rate limited updates); arrays are
+// not copied, their data is shared by reference count.
+void MirrorChannelSource::processMonitorData(epvd::PVStructurePtr pvStructurePtr)
+{
+    std::vector<MirrorChannelDataProcessorPtr> dataProcessors;
+    {
+        epvd::Lock lock(mutex);
+        if (!hasReceivedData) {
+            hasReceivedData = true;
+            nUpdatesToSkip = nSrcMonitors-1;
+        }
+        else if (nUpdatesToSkip > 0) {
+            // This makes sure we do not generate first update
+            // multiple times in case we have multiple monitors
+            nUpdatesToSkip--;
+            return;
+        }
+        typedef std::map<std::string, MirrorChannelDataProcessorPtr>::iterator MI;
+        for (MI it = dataProcessorMap.begin(); it != dataProcessorMap.end(); it++) {
+            dataProcessors.push_back(it->second);
+        }
+    }
+    bool keepData = false;
+    std::vector<MirrorChannelDataProcessorPtr> deferredDataProcessors;
+    for (size_t i = 0; i < dataProcessors.size(); i++) {
+        try {
+            MirrorChannelDataProcessor::UpdateStatus updateStatus = dataProcessors[i]->processSourceData(pvStructurePtr);
+            if (updateStatus == MirrorChannelDataProcessor::UpdateDeferred) {
+                deferredDataProcessors.push_back(dataProcessors[i]);
+            }
+            keepData = keepData || (updateStatus != MirrorChannelDataProcessor::UpdateSuppressed);
+        }
+        catch (const std::exception& ex) {
+            logger.error("Cannot update mirror channel %s from source channel %s: %s", dataProcessors[i]->getMirrorChannelName().c_str(), srcChannelName.c_str(), ex.what());
+        }
+    }
+    if (!keepData) {
+        return;
+    }
+
+    // Snapshot referenced by mirror records is never modified
+    epvd::PVStructurePtr snapshotPvStructurePtr;
+    {
+        epvd::Lock lock(mutex);
+        if (!hasReceivedData) {
+            // Source disconnected in the meantime
+            return;
+        }
+        if (!lastPvStructurePtr || !lastPvStructurePtr.unique() || lastPvStructurePtr->getStructure() != pvStructurePtr->getStructure()) {
+            lastPvStructurePtr = epvd::getPVDataCreate()->createPVStructure(pvStructurePtr->getStructure());
+        }
+        lastPvStructurePtr->copyUnchecked(*pvStructurePtr);
+        snapshotPvStructurePtr = lastPvStructurePtr;
+    }
+    for (size_t i = 0; i < deferredDataProcessors.size(); i++) {
+        deferredDataProcessors[i]->keepPendingUpdate(snapshotPvStructurePtr);
+    }
+}
+
+void MirrorChannelSource::onChannelConnect()
+{
+}
+
+void MirrorChannelSource::onChannelDisconnect()
+{
+    std::vector<MirrorChannelDataProcessorPtr> dataProcessors;
+    {
+        epvd::Lock lock(mutex);
+        lastPvStructurePtr.reset();
+        hasReceivedData = false;
+        nUpdatesToSkip = 0;
+        typedef std::map<std::string, MirrorChannelDataProcessorPtr>::iterator MI;
+        for (MI it = dataProcessorMap.begin(); it != dataProcessorMap.end(); it++) {
+            dataProcessors.push_back(it->second);
+        }
+    }
+    for (size_t i = 0; i < dataProcessors.size(); i++) {
+        dataProcessors[i]->onChannelDisconnect();
+    }
+}
+
+void MirrorChannelSource::addDataProcessor(const MirrorChannelDataProcessorPtr& dataProcessorPtr)
+{
+    // Keep lock, so that subsequent source updates are delivered after this one
+    epvd::Lock lock(mutex);
+    dataProcessorMap[dataProcessorPtr->getMirrorChannelName()] = dataProcessorPtr;
+    if (lastPvStructurePtr) {
+        // Source is already connected, create mirror record right away
+        dataProcessorPtr->processMonitorData(lastPvStructurePtr);
+    }
+}
+
+void MirrorChannelSource::removeDataProcessor(const std::string& mirrorChannelName)
+{
+    epvd::Lock lock(mutex);
+    dataProcessorMap.erase(mirrorChannelName);
+}
+
+unsigned int MirrorChannelSource::getNumDataProcessors()
+{
+    epvd::Lock lock(mutex);
+    return dataProcessorMap.size();
 }
 
 // Mirror Channel Monitor class
@@ -87,7 +474,7 @@ PvaClient MirrorChannelMonitor::pvaClient;
 CaClient MirrorChannelMonitor::caClient;
 epvc::PvaClientPtr MirrorChannelMonitor::pvaClientPtr(epvc::PvaClient::get("pva ca"));
 
-MirrorChannelMonitor::MirrorChannelMonitor(const std::string& channelName_, PvProvider::ProviderType providerType_, unsigned int serverQueueSize_, const std::string& fieldRequestDescriptor_, MirrorChannelDataProcessorPtr dataProcessorPtr_)
+MirrorChannelMonitor::MirrorChannelMonitor(const std::string& channelName_, PvProvider::ProviderType providerType_, unsigned int serverQueueSize_, const std::string& fieldRequestDescriptor_, MirrorChannelSourcePtr dataProcessorPtr_)
     : pvaClientChannelPtr(pvaClientPtr->createChannel(channelName_,PvProvider::getProviderName(providerType_)))
     , channelName(channelName_)
     , providerType(providerType_)
@@ -241,12 +628,18 @@ PvaPyLogger PvaMirrorServer::logger("PvaMirrorServer");
 
 PvaMirrorServer::PvaMirrorServer() 
     : PvaServer()
+    , mirrorDataProcessorMap()
+    , mirrorSourceKeyMap()
+    , mirrorChannelSourceMap()
     , mirrorChannelMonitorMap()
 {
 }
 
 PvaMirrorServer::PvaMirrorServer(const PvaMirrorServer& pvaMirrorServer)
     : PvaServer()
+    , mirrorDataProcessorMap()
+    , mirrorSourceKeyMap()
+    , mirrorChannelSourceMap()
     , mirrorChannelMonitorMap()
 {
 }
@@ -258,6 +651,16 @@ PvaMirrorServer::~PvaMirrorServer()
     stop();
 }
 
+// Mirror records with identical source channel settings share
+// source monitors
+std::string PvaMirrorServer::getSourceKey(const std::string& srcChannelName, PvProvider::ProviderType srcProviderType, unsigned int srcQueueSize, unsigned int nSrcMonitors, const std::string& srcFieldRequestDescriptor)
+{
+    return PvProvider::getProviderName(srcProviderType) + "://" + srcChannelName
+        + "?queueSize=" + StringUtility::toString<unsigned int>(srcQueueSize)
+        + "&nMonitors=" + StringUtility::toString<unsigned int>(nSrcMonitors)
+        + "&field=" + srcFieldRequestDescriptor;
+}
+
 void PvaMirrorServer::addMirrorRecord(const std::string& mirrorChannelName, const std::string& srcChannelName, PvProvider::ProviderType srcProviderType)
 {
     unsigned int srcQueueSize = 0;
@@ -274,57 +677,88 @@ void PvaMirrorServer::addMirrorRecord(const std::string& mirrorChannelName, cons
 }
 
 void PvaMirrorServer::addMirrorRecord(const std::string& mirrorChannelName, const std::string& srcChannelName, PvProvider::ProviderType srcProviderType, unsigned int srcQueueSize, unsigned int nSrcMonitors, const std::string& srcFieldRequestDescriptor)
+{
+    std::string mirrorFieldRequestDescriptor = "";
+    addMirrorRecord(mirrorChannelName, srcChannelName, srcProviderType, srcQueueSize, nSrcMonitors, srcFieldRequestDescriptor, mirrorFieldRequestDescriptor);
+}
+
+void PvaMirrorServer::addMirrorRecord(const std::string& mirrorChannelName, const std::string& srcChannelName, PvProvider::ProviderType srcProviderType, unsigned int srcQueueSize, unsigned int nSrcMonitors, const std::string& srcFieldRequestDescriptor, const std::string& mirrorFieldRequestDescriptor)
 {
     if (hasRecord(mirrorChannelName)) {
         throw ObjectAlreadyExists("Master database already has record for channel: " + mirrorChannelName);
     }
-    typedef std::multimap<std::string, MirrorChannelMonitorPtr>::iterator MI;
-    MI it = mirrorChannelMonitorMap.find(mirrorChannelName);
-    if (it != mirrorChannelMonitorMap.end()) {
+    if (hasMirrorRecord(mirrorChannelName)) {
         throw ObjectAlreadyExists("Master database already has mirror record for channel: " + mirrorChannelName);
     }
     if (nSrcMonitors < 1) {
         throw InvalidRequest("Number of source listeners for channel " + mirrorChannelName + " cannot be less than 1");
     }
-    MirrorChannelDataProcessorPtr dataProcessorPtr = MirrorChannelDataProcessorPtr(new MirrorChannelDataProcessor(this, mirrorChannelName, nSrcMonitors));
-    for (unsigned int i = 0; i < nSrcMonitors; i++) {
-        MirrorChannelMonitorPtr mirrorChannelMonitorPtr = MirrorChannelMonitorPtr(new MirrorChannelMonitor(srcChannelName, srcProviderType, srcQueueSize, srcFieldRequestDescriptor, dataProcessorPtr));
-        mirrorChannelMonitorMap.insert(std::make_pair(mirrorChannelName, mirrorChannelMonitorPtr));
+#if PVA_API_VERSION < 482
+    if (!mirrorFieldRequestDescriptor.empty()) {
+        throw InvalidRequest("Mirror field request descriptor is not supported with this version of EPICS.");
+    }
+#endif // if PVA_API_VERSION < 482
+    MirrorChannelDataProcessorPtr dataProcessorPtr = MirrorChannelDataProcessorPtr(new MirrorChannelDataProcessor(this, mirrorChannelName, mirrorFieldRequestDescriptor));
+    std::string srcKey = getSourceKey(srcChannelName, srcProviderType, srcQueueSize, nSrcMonitors, srcFieldRequestDescriptor);
+    std::map<std::string, MirrorChannelSourcePtr>::iterator it = mirrorChannelSourceMap.find(srcKey);
+    MirrorChannelSourcePtr sourcePtr;
+    if (it != mirrorChannelSourceMap.end()) {
+        sourcePtr = it->second;
+        logger.debug("Mirror record " + mirrorChannelName + " shares existing source " + srcKey);
+    }
+    else {
+        sourcePtr = MirrorChannelSourcePtr(new MirrorChannelSource(srcChannelName, nSrcMonitors));
+        mirrorChannelSourceMap[srcKey] = sourcePtr;
+        for (unsigned int i = 0; i < nSrcMonitors; i++) {
+            MirrorChannelMonitorPtr mirrorChannelMonitorPtr = MirrorChannelMonitorPtr(new MirrorChannelMonitor(srcChannelName, srcProviderType, srcQueueSize, srcFieldRequestDescriptor, sourcePtr));
+            mirrorChannelMonitorMap.insert(std::make_pair(srcKey, mirrorChannelMonitorPtr));
+        }
     }
-    logger.debug("Added mirror record: " + mirrorChannelName + " (source channel: " + srcChannelName + "; source queue size: " + StringUtility::toString<unsigned int>(srcQueueSize) + "; number of source listeners: " + StringUtility::toString<unsigned int>(nSrcMonitors) + "; source field request descriptor: " +  srcFieldRequestDescriptor + ")");
+    mirrorDataProcessorMap[mirrorChannelName] = dataProcessorPtr;
+    mirrorSourceKeyMap[mirrorChannelName] = srcKey;
+    sourcePtr->addDataProcessor(dataProcessorPtr);
+    logger.debug("Added mirror record: " + mirrorChannelName + " (source channel: " + srcChannelName + "; source queue size: " + StringUtility::toString<unsigned int>(srcQueueSize) + "; number of source listeners: " + StringUtility::toString<unsigned int>(nSrcMonitors) + "; source field request descriptor: " +  srcFieldRequestDescriptor + "; mirror field request descriptor: " + mirrorFieldRequestDescriptor + ")");
+}
+
+void PvaMirrorServer::removeSourceIfUnused(const std::string& srcKey)
+{
+    std::map<std::string, MirrorChannelSourcePtr>::iterator it = mirrorChannelSourceMap.find(srcKey);
+    if (it == mirrorChannelSourceMap.end() || it->second->getNumDataProcessors() > 0) {
+        return;
+    }
+    logger.debug("Removing mirror source " + srcKey);
+    mirrorChannelMonitorMap.erase(srcKey);
+    mirrorChannelSourceMap.erase(it);
 }
 
 void PvaMirrorServer::removeMirrorRecord(const std::string& mirrorChannelName)
 {
-    typedef std::multimap<std::string, MirrorChannelMonitorPtr>::iterator MI;
-    MI it = mirrorChannelMonitorMap.find(mirrorChannelName);
-    if (it == mirrorChannelMonitorMap.end()) {
+    std::map<std::string, MirrorChannelDataProcessorPtr>::iterator it = mirrorDataProcessorMap.find(mirrorChannelName);
+    if (it == mirrorDataProcessorMap.end()) {
         throw ObjectNotFound("Master database does not have mirror record for channel: " + mirrorChannelName);
     }
-    std::string srcChannelName;
-    for (it = mirrorChannelMonitorMap.begin(); it != mirrorChannelMonitorMap.end(); ) {
-        MirrorChannelMonitorPtr mirrorChannelMonitor = it->second;
-        if (it->first == mirrorChannelName) {
-            logger.debug("Removing mirror channel listener for " + srcChannelName);
-            srcChannelName = mirrorChannelMonitor->getChannelName();
-            mirrorChannelMonitorMap.erase(it++);
-        }
-        else {
-            it++;
-        }
-    }
-    logger.debug("Removing mirror channel for " + srcChannelName);
-    if (hasRecord(srcChannelName)) {
-        removeRecord(srcChannelName);
+    MirrorChannelDataProcessorPtr dataProcessorPtr = it->second;
+    std::string srcKey = mirrorSourceKeyMap[mirrorChannelName];
+    mirrorDataProcessorMap.erase(it);
+    mirrorSourceKeyMap.erase(mirrorChannelName);
+
+    logger.debug("Removing mirror channel listener for " + srcKey);
+    std::map<std::string, MirrorChannelSourcePtr>::iterator sit = mirrorChannelSourceMap.find(srcKey);
+    if (sit != mirrorChannelSourceMap.end()) {
+        sit->second->removeDataProcessor(mirrorChannelName);
     }
+    removeSourceIfUnused(srcKey);
+
+    logger.debug("Removing mirror channel " + mirrorChannelName);
+    dataProcessorPtr->remove();
     logger.debug("Removed mirror record: " + mirrorChannelName);
 }
 
 void PvaMirrorServer::removeAllMirrorRecords()
 {
     std::list<std::string> mirrorRecordNames;
-    typedef std::multimap<std::string, MirrorChannelMonitorPtr>::iterator MI;
-    for (MI it = mirrorChannelMonitorMap.begin(); it != mirrorChannelMonitorMap.end(); it = mirrorChannelMonitorMap.upper_bound(it->first)) {
+    typedef std::map<std::string, MirrorChannelDataProcessorPtr>::iterator MI;
+    for (MI it = mirrorDataProcessorMap.begin(); it != mirrorDataProcessorMap.end(); it++) {
         mirrorRecordNames.push_back(it->first);
     }
 
@@ -336,21 +770,44 @@ void PvaMirrorServer::removeAllMirrorRecords()
 
 bool PvaMirrorServer::hasMirrorRecord(const std::string& mirrorChannelName)
 {
-    if (mirrorChannelMonitorMap.find(mirrorChannelName) != mirrorChannelMonitorMap.end()) {
+    if (mirrorDataProcessorMap.find(mirrorChannelName) != mirrorDataProcessorMap.end()) {
         return true;
     }
     return false;
 }
 
-void PvaMirrorServer::resetMirrorRecordCounters(const std::string& mirrorChannelName)
+MirrorChannelDataProcessorPtr PvaMirrorServer::getMirrorDataProcessor(const std::string& mirrorChannelName)
 {
-    typedef std::multimap<std::string, MirrorChannelMonitorPtr>::iterator MI;
-    MI it = mirrorChannelMonitorMap.find(mirrorChannelName);
-    if (it == mirrorChannelMonitorMap.end()) {
+    std::map<std::string, MirrorChannelDataProcessorPtr>::iterator it = mirrorDataProcessorMap.find(mirrorChannelName);
+    if (it == mirrorDataProcessorMap.end()) {
         throw ObjectNotFound("Master database does not have mirror record for channel: " + mirrorChannelName);
     }
-    for (it = mirrorChannelMonitorMap.begin(); it != mirrorChannelMonitorMap.end(); it++) {
-        MirrorChannelMonitorPtr mirrorChannelMonitor = it->second;
+    return it->second;
+}
+
+void PvaMirrorServer::setMirrorRecordMaxUpdateRate(const std::string& mirrorChannelName, double maxUpdateRate)
+{
+    getMirrorDataProcessor(mirrorChannelName)->setMaxUpdateRate(maxUpdateRate);
+}
+
+void PvaMirrorServer::setMirrorRecordDecimation(const std::string& mirrorChannelName, unsigned int decimation)
+{
+    getMirrorDataProcessor(mirrorChannelName)->setDecimation(decimation);
+}
+
+void PvaMirrorServer::setMirrorRecordDeadband(const std::string& mirrorChannelName, const std::string& fieldName, double deadband)
+{
+    getMirrorDataProcessor(mirrorChannelName)->setDeadband(fieldName, deadband);
+}
+
+void PvaMirrorServer::resetMirrorRecordCounters(const std::string& mirrorChannelName)
+{
+    getMirrorDataProcessor(mirrorChannelName)->resetCounters();
+    std::string srcKey = mirrorSourceKeyMap[mirrorChannelName];
+    typedef std::multimap<std::string, MirrorChannelMonitorPtr>::iterator MI;
+    std::pair<MI,MI> range = mirrorChannelMonitorMap.equal_range(srcKey);
+    for (MI mit = range.first; mit != range.second; mit++) {
+        MirrorChannelMonitorPtr mirrorChannelMonitor = mit->second;
         mirrorChannelMonitor->resetMonitorCounters();
     }
 }
@@ -360,13 +817,12 @@ bp::dict PvaMirrorServer::getMirrorRecordCounters(const std::string& mirrorChann
     int nReceived = 0;
     int nOverruns = 0;
     int nSrcMonitors = 0;
+    MirrorChannelDataProcessorPtr dataProcessorPtr = getMirrorDataProcessor(mirrorChannelName);
+    std::string srcKey = mirrorSourceKeyMap[mirrorChannelName];
     typedef std::multimap<std::string, MirrorChannelMonitorPtr>::iterator MI;
-    MI it = mirrorChannelMonitorMap.find(mirrorChannelName);
-    if (it == mirrorChannelMonitorMap.end()) {
-        throw ObjectNotFound("Master database does not have mirror record for channel: " + mirrorChannelName);
-    }
-    for (it = mirrorChannelMonitorMap.begin(); it != mirrorChannelMonitorMap.end(); it++) {
-        MirrorChannelMonitorPtr mirrorChannelMonitor = it->second;
+    std::pair<MI,MI> range = mirrorChannelMonitorMap.equal_range(srcKey);
+    for (MI mit = range.first; mit != range.second; mit++) {
+        MirrorChannelMonitorPtr mirrorChannelMonitor = mit->second;
         bp::dict listenerDict = mirrorChannelMonitor->getMonitorCounters();
         nReceived += PyUtility::extractKeyValueFromPyDict<int>(PvaPyConstants::NumReceivedCounterKey, listenerDict, 0);
         nOverruns += PyUtility::extractKeyValueFromPyDict<int>(PvaPyConstants::NumOverrunsCounterKey, listenerDict, 0);
@@ -379,16 +835,21 @@ bp::dict PvaMirrorServer::getMirrorRecordCounters(const std::string& mirrorChann
     bp::dict recordDict;
     recordDict[PvaPyConstants::NumReceivedCounterKey] = nReceived;
     recordDict[PvaPyConstants::NumOverrunsCounterKey] = nOverruns;
+    std::map<std::string,unsigned int> counterMap = dataProcessorPtr->getCounterMap();
+    typedef std::map<std::string,unsigned int>::const_iterator CI;
+    for (CI cit = counterMap.begin(); cit != counterMap.end(); cit++) {
+        recordDict[cit->first] = cit->second;
+    }
+    recordDict[PvaPyConstants::NumMirrorRecordsCounterKey] = mirrorChannelSourceMap[srcKey]->getNumDataProcessors();
     return recordDict;
 }
 
 bp::list PvaMirrorServer::getMirrorRecordNames()
 {
     bp::list mirrorRecordNames;
-    typedef std::multimap<std::string, MirrorChannelMonitorPtr>::iterator MI;
-    for (MI it = mirrorChannelMonitorMap.begin(); it != mirrorChannelMonitorMap.end(); it = mirrorChannelMonitorMap.upper_bound(it->first)) {
+    typedef std::map<std::string, MirrorChannelDataProcessorPtr>::iterator MI;
+    for (MI it = mirrorDataProcessorMap.begin(); it != mirrorDataProcessorMap.end(); it++) {
         mirrorRecordNames.append(it->first);
     }
     return mirrorRecordNames;
 }
-
@@ -6,11 +6,17 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <boost/python/list.hpp>
+#include <epicsTime.h>
+#include <epicsTimer.h>
 #include <pv/pvData.h>
 #include <pv/pvAccess.h>
 #include <pv/serverContext.h>
 #include <pv/pvaClient.h>
+#if PVA_API_VERSION >= 482
+#include <pv/createRequest.h>
+#endif // if PVA_API_VERSION >= 482
 
 #include "ChannelMonitorRequesterImpl.h"
 #include "ChannelStateRequesterImpl.h"
@@ -24,28 +30,134 @@
 class PvaMirrorServer;
 class MirrorChannelDataProcessor;
 typedef std::tr1::shared_ptr<MirrorChannelDataProcessor> MirrorChannelDataProcessorPtr;
+class MirrorChannelSource;
+typedef std::tr1::shared_ptr<MirrorChannelSource> MirrorChannelSourcePtr;
 class MirrorChannelMonitor;
 typedef std::tr1::shared_ptr<MirrorChannelMonitor> MirrorChannelMonitorPtr;
  
-// This class updates PVA server record and handles source channel connection
-// changes
-
-class MirrorChannelDataProcessor : public ChannelMonitorDataProcessor
+// This class updates PVA server record from source channel data, projecting
+// source structure to the requested mirror fields, and handles source
+// channel connection changes. Optional update policies (decimation,
+// deadband and maximum update rate) are evaluated on source data before
+// anything is copied, so suppressed updates are discarded without
+// touching the record. For the latest update deferred by rate limit,
+// source data snapshot is referenced, and published from timer queue
+// thread when the update period expires.
+
+class MirrorChannelDataProcessor : public ChannelMonitorDataProcessor, public epicsTimerNotify
 {
 public:
-    MirrorChannelDataProcessor(PvaMirrorServer* pvaMirrorServer, const std::string& mirrorChannelName, unsigned int nSrcMonitors);
+    MirrorChannelDataProcessor(PvaMirrorServer* pvaMirrorServer, const std::string& mirrorChannelName, const std::string& fieldRequestDescriptor);
     virtual ~MirrorChannelDataProcessor();
 
+    enum UpdateStatus {
+        UpdatePublished,
+        UpdateSuppressed,
+        UpdateDeferred
+    };
+
     virtual void processMonitorData(epics::pvData::PVStructurePtr pvStructurePtr);
     virtual void onChannelConnect();
     virtual void onChannelDisconnect();
 
+    // Evaluates policies and publishes accepted update; for deferred
+    // update, source passes snapshot of its data to keepPendingUpdate()
+    UpdateStatus processSourceData(const epics::pvData::PVStructurePtr& pvStructurePtr);
+    void keepPendingUpdate(const epics::pvData::PVStructurePtr& pvStructurePtr);
+
+    // epicsTimerNotify, publishes trailing rate limited update
+    virtual expireStatus expire(const epicsTime& currentTime);
+
+    // Removes mirror record; updates that are already in flight
+    // will not re-add it
+    void remove();
+
+    std::string getMirrorChannelName() const;
+    void resetCounters();
+    std::map<std::string,unsigned int> getCounterMap();
+
+    // Update policies
+    void setMaxUpdateRate(double maxUpdateRate);
+    void setDecimation(unsigned int decimation);
+    void setDeadband(const std::string& deadbandFieldName, double deadband);
+
 private:
     static PvaPyLogger logger;
+    epics::pvData::PVStructurePtr projectData(const epics::pvData::PVStructurePtr& pvStructurePtr);
+    UpdateStatus acceptUpdate(const epics::pvData::PVStructurePtr& pvStructurePtr);
+    void publishUpdate(const epics::pvData::PVStructurePtr& pvStructurePtr);
+    bool getDeadbandValue(const epics::pvData::PVStructurePtr& pvStructurePtr, double& value);
+    void removeRecord();
+
     PvaMirrorServer *pvaMirrorServer;
     std::string mirrorChannelName;
+    std::string fieldRequestDescriptor;
     epics::pvData::Mutex mutex;
     bool recordAdded;
+    bool removed;
+    unsigned int nDelivered;
+
+    // Update policy settings and state
+    double minUpdatePeriod;
+    epicsTimeStamp lastUpdateTime;
+    epicsTimerQueueActive& timerQueue;
+    epicsTimer& trailingUpdateTimer;
+    bool trailingUpdateScheduled;
+    epics::pvData::PVStructurePtr pendingPvStructurePtr;
+    bool hasPendingUpdate;
+    unsigned int decimation;
+    unsigned int nUpdatesToDecimate;
+    std::string deadbandFieldName;
+    double deadband;
+    epics::pvData::StructureConstPtr deadbandStructurePtr;
+    size_t deadbandFieldOffset;
+    bool hasLastDeadbandValue;
+    double lastDeadbandValue;
+
+    // Suppressed update counters
+    unsigned int nDecimated;
+    unsigned int nDeadbandSuppressed;
+    unsigned int nRateLimited;
+
+#if PVA_API_VERSION >= 482
+    // Projection of source structure to mirror fields
+    epics::pvData::PVStructurePtr pvRequestPtr;
+    epics::pvData::PVRequestMapper requestMapper;
+    epics::pvData::StructureConstPtr srcStructurePtr;
+    epics::pvData::PVStructurePtr projectedPvStructurePtr;
+    epics::pvData::BitSet srcBitSet;
+    epics::pvData::BitSet projectedBitSet;
+#endif // if PVA_API_VERSION >= 482
+};
+
+// This class receives updates from source channel monitors, and distributes
+// them to all mirror records sharing the same source channel. The latest
+// source update accepted by any record is kept, so that records added for
+// an already connected source can be created without waiting for the next
+// update. Array data is shared by all mirror records (copied only if it is
+// modified).
+
+class MirrorChannelSource : public ChannelMonitorDataProcessor
+{
+public:
+    MirrorChannelSource(const std::string& srcChannelName, unsigned int nSrcMonitors);
+    virtual ~MirrorChannelSource();
+
+    virtual void processMonitorData(epics::pvData::PVStructurePtr pvStructurePtr);
+    virtual void onChannelConnect();
+    virtual void onChannelDisconnect();
+
+    void addDataProcessor(const MirrorChannelDataProcessorPtr& dataProcessorPtr);
+    void removeDataProcessor(const std::string& mirrorChannelName);
+    unsigned int getNumDataProcessors();
+
+private:
+    static PvaPyLogger logger;
+    std::string srcChannelName;
+    epics::pvData::Mutex mutex;
+    std::map<std::string, MirrorChannelDataProcessorPtr> dataProcessorMap;
+    epics::pvData::PVStructurePtr lastPvStructurePtr;
+    bool hasReceivedData;
     unsigned int nSrcMonitors;
     int nUpdatesToSkip;
 };
@@ -58,7 +170,7 @@ class MirrorChannelMonitor : public ChannelMonitorDataProcessor
 {
 public:
 
-    MirrorChannelMonitor(const std::string& channelName, PvProvider::ProviderType providerType, unsigned int serverQueueSize, const std::string& fieldRequestDescriptor, MirrorChannelDataProcessorPtr dataProcessorPtr);
+    MirrorChannelMonitor(const std::string& channelName, PvProvider::ProviderType providerType, unsigned int serverQueueSize, const std::string& fieldRequestDescriptor, MirrorChannelSourcePtr dataProcessorPtr);
     MirrorChannelMonitor(const MirrorChannelMonitor& mirrorChannelMonitor);
     virtual ~MirrorChannelMonitor();
 
@@ -92,7 +204,7 @@ private:
     PvProvider::ProviderType providerType;
     unsigned int serverQueueSize;
     std::string fieldRequestDescriptor;
-    MirrorChannelDataProcessorPtr dataProcessorPtr;
+    MirrorChannelSourcePtr dataProcessorPtr;
 
     bool isConnected;
     bool hasIssuedConnect;
@@ -110,10 +222,14 @@ public:
     virtual void addMirrorRecord(const std::string& mirrorChannelName, const std::string& srcChannelName, PvProvider::ProviderType srcProviderType);
     virtual void addMirrorRecord(const std::string& mirrorChannelName, const std::string& srcChannelName, PvProvider::ProviderType srcProviderType, unsigned int srcQueueSize);
     virtual void addMirrorRecord(const std::string& mirrorChannelName, const std::string& srcChannelName, PvProvider::ProviderType srcProviderType, unsigned int srcQueueSize, unsigned int nSrcMonitors, const std::string& srcFieldRequestDescriptor);
+    virtual void addMirrorRecord(const std::string& mirrorChannelName, const std::string& srcChannelName, PvProvider::ProviderType srcProviderType, unsigned int srcQueueSize, unsigned int nSrcMonitors, const std::string& srcFieldRequestDescriptor, const std::string& mirrorFieldRequestDescriptor);
     virtual void removeMirrorRecord(const std::string& mirrorChannelName);
 
     virtual void removeAllMirrorRecords();
     virtual bool hasMirrorRecord(const std::string& mirrorChannelName);
+    virtual void setMirrorRecordMaxUpdateRate(const std::string& mirrorChannelName, double maxUpdateRate);
+    virtual void setMirrorRecordDecimation(const std::string& mirrorChannelName, unsigned int decimation);
+    virtual void setMirrorRecordDeadband(const std::string& mirrorChannelName, const std::string& fieldName, double deadband);
     virtual void resetMirrorRecordCounters(const std::string& mirrorChannelName);
     virtual boost::python::dict getMirrorRecordCounters(const std::string& mirrorChannelName);
     virtual boost::python::list getMirrorRecordNames();
@@ -121,6 +237,16 @@ public:
 private:
 
     static PvaPyLogger logger;
+    static std::string getSourceKey(const std::string& srcChannelName, PvProvider::ProviderType srcProviderType, unsigned int srcQueueSize, unsigned int nSrcMonitors, const std::string& srcFieldRequestDescriptor);
+    void removeSourceIfUnused(const std::string& srcKey);
+    MirrorChannelDataProcessorPtr getMirrorDataProcessor(const std::string& mirrorChannelName);
+
+    // Mirror records and their source keys
+    std::map<std::string, MirrorChannelDataProcessorPtr> mirrorDataProcessorMap;
+    std::map<std::string, std::string> mirrorSourceKeyMap;
+
+    // Sources and their monitors, shared by mirror records
+    std::map<std::string, MirrorChannelSourcePtr> mirrorChannelSourceMap;
     std::multimap<std::string, MirrorChannelMonitorPtr> mirrorChannelMonitorMap;
 };
 
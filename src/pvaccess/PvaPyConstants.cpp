@@ -8,3 +8,48 @@ const char* PvaPyConstants::NumRejectedCounterKey("nRejected");
 const char* PvaPyConstants::NumDeliveredCounterKey("nDelivered");
 const char* PvaPyConstants::NumQueuedCounterKey("nQueued");
 const char* PvaPyConstants::NumOverrunsCounterKey("nOverruns");
+const char* PvaPyConstants::NumCacheHitsCounterKey("nCacheHits");
+const char* PvaPyConstants::NumCacheMissesCounterKey("nCacheMisses");
+const char* PvaPyConstants::NumCacheEvictionsCounterKey("nCacheEvictions");
+const char* PvaPyConstants::NumCacheInvalidationsCounterKey("nCacheInvalidations");
+const char* PvaPyConstants::NumCachedCounterKey("nCached");
+const char* PvaPyConstants::NumBatchesCounterKey("nBatches");
+const char* PvaPyConstants::BatchSizeHistogramKey("batchSizeHistogram");
+const char* PvaPyConstants::NumPoolHitsCounterKey("nPoolHits");
+const char* PvaPyConstants::NumPoolMissesCounterKey("nPoolMisses");
+const char* PvaPyConstants::NumPooledCounterKey("nPooled");
+const char* PvaPyConstants::NumPooledArrayBytesCounterKey("nPooledArrayBytes");
+const char* PvaPyConstants::NumDroppedCounterKey("nDropped");
+const char* PvaPyConstants::MaxQueuedCounterKey("maxQueued");
+const char* PvaPyConstants::SubscriberCountersKey("subscriberCounters");
+const char* PvaPyConstants::NumWorkersCounterKey("nWorkers");
+const char* PvaPyConstants::NumReadyCounterKey("nReady");
+const char* PvaPyConstants::NumDispatchesCounterKey("nDispatches");
+const char* PvaPyConstants::AvgLatencyCounterKey("avgLatency");
+const char* PvaPyConstants::MaxLatencyCounterKey("maxLatency");
+const char* PvaPyConstants::ChannelStatsKey("channels");
+const char* PvaPyConstants::CountKey("count");
+const char* PvaPyConstants::MinKey("min");
+const char* PvaPyConstants::MaxKey("max");
+const char* PvaPyConstants::MeanKey("mean");
+const char* PvaPyConstants::P50Key("p50");
+const char* PvaPyConstants::P90Key("p90");
+const char* PvaPyConstants::P99Key("p99");
+const char* PvaPyConstants::BucketsKey("buckets");
+const char* PvaPyConstants::EventToPushLatencyKey("eventToPush");
+const char* PvaPyConstants::QueueWaitLatencyKey("queueWait");
+const char* PvaPyConstants::GilWaitLatencyKey("gilWait");
+const char* PvaPyConstants::CallbackLatencyKey("callback");
+const char* PvaPyConstants::NumActiveCounterKey("nActive");
+const char* PvaPyConstants::NumCoalescedCounterKey("nCoalesced");
+const char* PvaPyConstants::NumMirrorRecordsCounterKey("nMirrorRecords");
+const char* PvaPyConstants::NumDecimatedCounterKey("nDecimated");
+const char* PvaPyConstants::NumDeadbandSuppressedCounterKey("nDeadbandSuppressed");
+const char* PvaPyConstants::NumRateLimitedCounterKey("nRateLimited");
+const char* PvaPyConstants::CacheHitRateCounterKey("hitRate");
+const char* PvaPyConstants::NumStructureIdsCounterKey("nStructureIds");
+const char* PvaPyConstants::NumInUseCounterKey("nInUse");
+const char* PvaPyConstants::NumWritingCounterKey("nWriting");
+const char* PvaPyConstants::StructureDictCacheKey("structureDict");
+const char* PvaPyConstants::SerializationCacheKey("serialization");
+const char* PvaPyConstants::DeserializationCacheKey("deserialization");
@@ -14,6 +14,51 @@ public:
     static const char* NumDeliveredCounterKey;
     static const char* NumQueuedCounterKey;
     static const char* NumOverrunsCounterKey;
+    static const char* NumCacheHitsCounterKey;
+    static const char* NumCacheMissesCounterKey;
+    static const char* NumCacheEvictionsCounterKey;
+    static const char* NumCacheInvalidationsCounterKey;
+    static const char* NumCachedCounterKey;
+    static const char* NumBatchesCounterKey;
+    static const char* BatchSizeHistogramKey;
+    static const char* NumPoolHitsCounterKey;
+    static const char* NumPoolMissesCounterKey;
+    static const char* NumPooledCounterKey;
+    static const char* NumPooledArrayBytesCounterKey;
+    static const char* NumDroppedCounterKey;
+    static const char* MaxQueuedCounterKey;
+    static const char* SubscriberCountersKey;
+    static const char* NumWorkersCounterKey;
+    static const char* NumReadyCounterKey;
+    static const char* NumDispatchesCounterKey;
+    static const char* AvgLatencyCounterKey;
+    static const char* MaxLatencyCounterKey;
+    static const char* ChannelStatsKey;
+    static const char* CountKey;
+    static const char* MinKey;
+    static const char* MaxKey;
+    static const char* MeanKey;
+    static const char* P50Key;
+    static const char* P90Key;
+    static const char* P99Key;
+    static const char* BucketsKey;
+    static const char* EventToPushLatencyKey;
+    static const char* QueueWaitLatencyKey;
+    static const char* GilWaitLatencyKey;
+    static const char* CallbackLatencyKey;
+    static const char* NumActiveCounterKey;
+    static const char* NumCoalescedCounterKey;
+    static const char* NumMirrorRecordsCounterKey;
+    static const char* NumDecimatedCounterKey;
+    static const char* NumDeadbandSuppressedCounterKey;
+    static const char* NumRateLimitedCounterKey;
+    static const char* CacheHitRateCounterKey;
+    static const char* NumStructureIdsCounterKey;
+    static const char* NumInUseCounterKey;
+    static const char* NumWritingCounterKey;
+    static const char* StructureDictCacheKey;
+    static const char* SerializationCacheKey;
+    static const char* DeserializationCacheKey;
 }; 
 
 #endif
@@ -2,18 +2,23 @@
 // found in the file LICENSE that is included with the distribution
 
 #include <boost/python.hpp>
-#include <list>
+#include <algorithm>
 
 #include <epicsThread.h>
+#include <epicsAtomic.h>
 #include <pv/channelProviderLocal.h>
 #include "PvaException.h"
 #include "ObjectAlreadyExists.h"
 #include "ObjectNotFound.h"
+#include "InvalidArgument.h"
 #include "InvalidRequest.h"
+#include "InvalidState.h"
 #include "QueueEmpty.h"
 #include "PvaServer.h"
 #include "PyGilManager.h"
+#include "PyGilRelease.h"
 #include "PyUtility.h"
+#include "PyPvDataUtility.h"
 
 namespace bp = boost::python;
 namespace epvd = epics::pvData;
@@ -21,13 +26,21 @@ namespace epvdb = epics::pvDatabase;
 
 const double PvaServer::ShutdownWaitTime(0.1);
 const double PvaServer::RecordUpdateTimeout(10.0);
+const int PvaServer::MinUpdatesPerThread(64);
+const int PvaServer::DefaultNumCallbackThreads(1);
+
+epvd::Mutex PvaServer::updateWorkerMutex;
+epicsEvent PvaServer::updateWorkerEvent;
+std::deque<PvaServer::RecordUpdateTask::shared_pointer> PvaServer::updateRequestQueue;
+int PvaServer::nIdleUpdateWorkers(0);
 PvaPyLogger PvaServer::logger("PvaServer");
 
 PvaServer::PvaServer() :
     recordMap(),
     isRunning(false),
-    callbackQueuePtr(new SynchronizedQueue<std::string>()),
-    callbackThreadRunning(false),
+    callbackQueuePtr(new RecordCallbackQueue()),
+    nCallbackThreads(DefaultNumCallbackThreads),
+    nRunningCallbackThreads(0),
     callbackThreadNeeded(false),
     callbackThreadMutex(),
     callbackThreadExitEvent()
@@ -39,8 +52,10 @@ PvaServer::PvaServer() :
 PvaServer::PvaServer(const std::string& channelName, const PvObject& pvObject) :
     recordMap(),
     isRunning(false),
-    callbackQueuePtr(new SynchronizedQueue<std::string>()),
-    callbackThreadRunning(false),
+    callbackQueuePtr(new RecordCallbackQueue()),
+    nCallbackThreads(DefaultNumCallbackThreads),
+    nRunningCallbackThreads(0),
+    callbackThreadNeeded(false),
     callbackThreadMutex(),
     callbackThreadExitEvent()
 {
@@ -51,8 +66,10 @@ PvaServer::PvaServer(const std::string& channelName, const PvObject& pvObject) :
 PvaServer::PvaServer(const std::string& channelName, const PvObject& pvObject, const boost::python::object& onWriteCallback) :
     recordMap(),
     isRunning(false),
-    callbackQueuePtr(new SynchronizedQueue<std::string>()),
-    callbackThreadRunning(false),
+    callbackQueuePtr(new RecordCallbackQueue()),
+    nCallbackThreads(DefaultNumCallbackThreads),
+    nRunningCallbackThreads(0),
+    callbackThreadNeeded(false),
     callbackThreadMutex(),
     callbackThreadExitEvent()
 {
@@ -63,8 +80,10 @@ PvaServer::PvaServer(const std::string& channelName, const PvObject& pvObject, c
 PvaServer::PvaServer(const PvaServer& pvaServer) :
     recordMap(),
     isRunning(false),
-    callbackQueuePtr(new SynchronizedQueue<std::string>()),
-    callbackThreadRunning(false),
+    callbackQueuePtr(new RecordCallbackQueue()),
+    nCallbackThreads(DefaultNumCallbackThreads),
+    nRunningCallbackThreads(0),
+    callbackThreadNeeded(false),
     callbackThreadMutex(),
     callbackThreadExitEvent()
 {
@@ -109,7 +128,7 @@ void PvaServer::start()
     isRunning = true;
     PyGilManager::evalInitThreads();
     if (callbackThreadNeeded) {
-        startCallbackThread();
+        startCallbackThreads();
     }
     epics::pvDatabase::ChannelProviderLocalPtr channelProvider = epics::pvDatabase::getChannelProviderLocal();
     bool printInfo = logger.hasLogLevel(PvaPyLogger::PVAPY_LOG_LEVEL_INFO|PvaPyLogger::PVAPY_LOG_LEVEL_DEBUG);
@@ -123,7 +142,7 @@ void PvaServer::stop()
     }
     server->shutdown();
     isRunning = false;
-    callbackQueuePtr->cancelWaitForItemPushed();
+    callbackQueuePtr->cancelWait();
     waitForCallbackThreadExit(ShutdownWaitTime);
 }
 
@@ -138,22 +157,21 @@ void PvaServer::initRecord(const std::string& channelName, const epics::pvData::
     if(!master->addRecord(record)) {
         throw PvaException("Cannot add record to master database for channel: " + channelName);
     }
-    recordMap[channelName] = record;
+    if (!recordMap.insert(channelName, record)) {
+        record->remove();
+        throw ObjectAlreadyExists("Master database already has record for channel: " + channelName);
+    }
 }
 
 void PvaServer::disableRecordProcessing(const std::string& channelName)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it == recordMap.end()) {
-        throw ObjectNotFound("Master database does not have record for channel: " + channelName);
-    }
-    it->second->disableProcessing();
+    findRecord(channelName)->disableProcessing();
 }
 
 void PvaServer::initRecord(const std::string& channelName, const PvObject& pvObject, const boost::python::object& onWriteCallback) 
 {
-    if (!callbackThreadRunning && !PyUtility::isPyNone(onWriteCallback)) {
-        startCallbackThread();
+    if (!PyUtility::isPyNone(onWriteCallback)) {
+        startCallbackThreads();
     }
     PyPvRecordPtr record(PyPvRecord::create(channelName, pvObject, callbackQueuePtr, onWriteCallback));
     if(!record.get()) {
@@ -164,15 +182,18 @@ void PvaServer::initRecord(const std::string& channelName, const PvObject& pvObj
     if(!master->addRecord(record)) {
         throw PvaException("Cannot add record to master database for channel: " + channelName);
     }
-    recordMap[channelName] = record;
+    if (!recordMap.insert(channelName, record)) {
+        record->remove();
+        throw ObjectAlreadyExists("Master database already has record for channel: " + channelName);
+    }
 }
 
 #if PVA_API_VERSION >= 483
 
 void PvaServer::initRecord(const std::string& channelName, const PvObject& pvObject, int asLevel, const std::string& asGroup, const boost::python::object& onWriteCallback) 
 {
-    if (!callbackThreadRunning && !PyUtility::isPyNone(onWriteCallback)) {
-        startCallbackThread();
+    if (!PyUtility::isPyNone(onWriteCallback)) {
+        startCallbackThreads();
     }
     PyPvRecordPtr record(PyPvRecord::create(channelName, pvObject, asLevel, asGroup, callbackQueuePtr, onWriteCallback));
     if(!record.get()) {
@@ -183,99 +204,289 @@ void PvaServer::initRecord(const std::string& channelName, const PvObject& pvObj
     if(!master->addRecord(record)) {
         throw PvaException("Cannot add record to master database for channel: " + channelName);
     }
-    recordMap[channelName] = record;
+    if (!recordMap.insert(channelName, record)) {
+        record->remove();
+        throw ObjectAlreadyExists("Master database already has record for channel: " + channelName);
+    }
 }
 
 #endif // if PVA_API_VERSION >= 483
 
 void PvaServer::update(const std::string& channelName, const epics::pvData::PVStructurePtr& pvStructurePtr)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it == recordMap.end()) {
-        throw ObjectNotFound("Master database does not have record for channel: " + channelName);
-    }
-    it->second->update(pvStructurePtr);
+    findRecord(channelName)->update(pvStructurePtr);
 }
 
 void PvaServer::updateUnchecked(const std::string& channelName, const epics::pvData::PVStructurePtr& pvStructurePtr)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it == recordMap.end()) {
-        throw ObjectNotFound("Master database does not have record for channel: " + channelName);
-    }
-    it->second->updateUnchecked(pvStructurePtr);
+    findRecord(channelName)->updateUnchecked(pvStructurePtr);
 }
 
 void PvaServer::update(const bp::dict& pyDict)
 {
-    if (recordMap.size() == 0) {
-        throw InvalidRequest("Master database does not have any records.");
-    }
-    if (recordMap.size() != 1) {
-        throw InvalidRequest("Master database has multiple records.");
+    getSingleRecord()->update(pyDict);
+}
+
+void PvaServer::update(const PvObject& pvObject)
+{
+    getSingleRecord()->update(pvObject);
+}
+
+void PvaServer::updateUnchecked(const PvObject& pvObject)
+{
+    getSingleRecord()->updateUnchecked(pvObject);
+}
+
+void PvaServer::update(const std::string& channelName, const bp::dict& pyDict)
+{
+    findRecord(channelName)->update(pyDict);
+}
+
+void PvaServer::update(const std::string& channelName, const PvObject& pvObject) 
+{
+    findRecord(channelName)->update(pvObject);
+}
+
+void PvaServer::updateUnchecked(const std::string& channelName, const PvObject& pvObject) 
+{
+    findRecord(channelName)->updateUnchecked(pvObject);
+}
+
+unsigned int PvaServer::updateChanged(const PvObject& pvObject)
+{
+    return getSingleRecord()->updateChanged(pvObject);
+}
+
+unsigned int PvaServer::updateChanged(const std::string& channelName, const PvObject& pvObject)
+{
+    return findRecord(channelName)->updateChanged(pvObject);
+}
+
+PvaServer::RecordUpdateTask::RecordUpdateTask()
+    : updates()
+    , nextUpdate(0)
+    , nUpdated(0)
+    , nActiveThreads(0)
+    , errorMessage()
+    , mutex()
+    , doneEvent()
+{
+}
+
+// Structures are checked in advance, so that mismatched object does
+// not cause partial update
+void PvaServer::addRecordUpdate(const RecordUpdateTask::shared_pointer& taskPtr, const PyPvRecordPtr& record, const epvd::PVStructurePtr& pvStructurePtr)
+{
+    if (*(pvStructurePtr->getStructure()) != *(record->getPVStructure()->getStructure())) {
+        throw InvalidArgument("Structure of the updated object does not match structure of record " + record->getRecordName() + ".");
     }
+    taskPtr->updates.push_back(std::make_pair(record, pvStructurePtr));
+}
 
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.begin();
-    it->second->update(pyDict);
+void PvaServer::updateMany(const std::map<std::string, epics::pvData::PVStructurePtr>& pvStructureMap)
+{
+    // Resolve and check all records before updating any of them
+    RecordUpdateTask::shared_pointer taskPtr(new RecordUpdateTask());
+    taskPtr->updates.reserve(pvStructureMap.size());
+    typedef std::map<std::string, epvd::PVStructurePtr>::const_iterator MI;
+    for (MI it = pvStructureMap.begin(); it != pvStructureMap.end(); it++) {
+        addRecordUpdate(taskPtr, findRecord(it->first), it->second);
+    }
+    try {
+        executeUpdateTask(taskPtr);
+    }
+    catch (const PvaException& ex) {
+        throw PvaException("%s (%d of %d records updated)", ex.what(), int(taskPtr->nUpdated), int(taskPtr->updates.size()));
+    }
 }
 
-void PvaServer::update(const PvObject& pvObject)
+void PvaServer::updateMany(const bp::dict& pyDict)
 {
-    if (recordMap.size() == 0) {
-        throw InvalidRequest("Master database does not have any records.");
+    // Resolve all records and check values before updating any of them;
+    // dictionaries are checked by applying them to a scratch structure
+    RecordUpdateTask::shared_pointer taskPtr(new RecordUpdateTask());
+    std::vector<std::pair<PyPvRecordPtr, bp::dict> > dictUpdates;
+    bp::list keys = pyDict.keys();
+    for (int i = 0; i < bp::len(keys); i++) {
+        bp::extract<std::string> channelNameExtract(keys[i]);
+        if (!channelNameExtract.check()) {
+            throw InvalidArgument("Dictionary keys must be channel names.");
+        }
+        std::string channelName = channelNameExtract();
+        PyPvRecordPtr record = findRecord(channelName);
+        bp::object pyObject = pyDict[keys[i]];
+        bp::extract<PvObject> pvObjectExtract(pyObject);
+        if (pvObjectExtract.check()) {
+            addRecordUpdate(taskPtr, record, pvObjectExtract().getPvStructurePtr());
+            continue;
+        }
+        bp::extract<bp::dict> dictExtract(pyObject);
+        if (dictExtract.check()) {
+            epvd::PVStructurePtr scratchPvStructurePtr = epvd::getPVDataCreate()->createPVStructure(record->getPVStructure()->getStructure());
+            try {
+                PyPvDataUtility::pyDictToStructure(dictExtract(), scratchPvStructurePtr);
+            }
+            catch (const std::exception& ex) {
+                throw InvalidArgument("Invalid update for channel " + channelName + ": " + ex.what());
+            }
+            dictUpdates.push_back(std::make_pair(record, dictExtract()));
+            continue;
+        }
+        throw InvalidArgument("Update for channel " + channelName + " must be either PvObject or dictionary.");
     }
-    if (recordMap.size() != 1) {
-        throw InvalidRequest("Master database has multiple records.");
+
+    // PvObject values are copied without GIL
+    std::string errorMessage;
+    try {
+        if (PyGILState_Check()) {
+            PyGilRelease pyGilRelease;
+            executeUpdateTask(taskPtr);
+        }
+        else {
+            executeUpdateTask(taskPtr);
+        }
+    }
+    catch (const PvaException& ex) {
+        errorMessage = ex.what();
     }
 
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.begin();
-    it->second->update(pvObject);
+    // Dictionary values are converted into record fields while we hold GIL
+    int nUpdated = taskPtr->nUpdated;
+    for (size_t i = 0; i < dictUpdates.size(); i++) {
+        try {
+            dictUpdates[i].first->update(dictUpdates[i].second);
+            nUpdated++;
+        }
+        catch (const std::exception& ex) {
+            if (errorMessage.empty()) {
+                errorMessage = "Cannot update record " + dictUpdates[i].first->getRecordName() + ": " + ex.what();
+            }
+        }
+    }
+    if (!errorMessage.empty()) {
+        throw PvaException("%s (%d of %d records updated)", errorMessage.c_str(), nUpdated, int(taskPtr->updates.size() + dictUpdates.size()));
+    }
 }
 
-void PvaServer::updateUnchecked(const PvObject& pvObject)
+// Records are distributed among calling thread and worker threads (up to
+// number of cores), each taking the next pending record. Worker requests
+// that were not picked up by the time calling thread ran out of records
+// are withdrawn.
+void PvaServer::executeUpdateTask(const RecordUpdateTask::shared_pointer& taskPtr)
 {
-    if (recordMap.size() == 0) {
-        throw InvalidRequest("Master database does not have any records.");
+    int nUpdates = int(taskPtr->updates.size());
+    int nThreads = std::max(std::min(epicsThreadGetCPUs(), nUpdates/MinUpdatesPerThread), 1);
+    taskPtr->nActiveThreads = nThreads;
+    if (nThreads > 1) {
+        requestUpdateWorkers(taskPtr, nThreads-1);
     }
-    if (recordMap.size() != 1) {
-        throw InvalidRequest("Master database has multiple records.");
+    updateRecords(taskPtr);
+    if (nThreads > 1) {
+        int nCancelled = cancelUpdateWorkers(taskPtr);
+        epvd::Lock lock(taskPtr->mutex);
+        taskPtr->nActiveThreads -= nCancelled;
+    }
+    while (true) {
+        {
+            epvd::Lock lock(taskPtr->mutex);
+            if (taskPtr->nActiveThreads == 0) {
+                break;
+            }
+        }
+        taskPtr->doneEvent.wait();
     }
+    if (!taskPtr->errorMessage.empty()) {
+        throw PvaException(taskPtr->errorMessage);
+    }
+}
 
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.begin();
-    it->second->updateUnchecked(pvObject);
+void PvaServer::requestUpdateWorkers(const RecordUpdateTask::shared_pointer& taskPtr, int nWorkers)
+{
+    epvd::Lock lock(updateWorkerMutex);
+    for (int i = 0; i < nWorkers; i++) {
+        updateRequestQueue.push_back(taskPtr);
+    }
+    int nNewWorkers = int(updateRequestQueue.size()) - nIdleUpdateWorkers;
+    for (int i = 0; i < nNewWorkers; i++) {
+        // If thread cannot be created, calling thread does the work
+        epicsThreadCreate("PvaServerUpdate", epicsThreadPriorityMedium, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)updateWorkerThread, NULL);
+    }
+    updateWorkerEvent.signal();
 }
 
-void PvaServer::update(const std::string& channelName, const bp::dict& pyDict)
+int PvaServer::cancelUpdateWorkers(const RecordUpdateTask::shared_pointer& taskPtr)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it == recordMap.end()) {
-        throw ObjectNotFound("Master database does not have record for channel: " + channelName);
+    epvd::Lock lock(updateWorkerMutex);
+    int nCancelled = 0;
+    std::deque<RecordUpdateTask::shared_pointer>::iterator it = updateRequestQueue.begin();
+    while (it != updateRequestQueue.end()) {
+        if (*it == taskPtr) {
+            it = updateRequestQueue.erase(it);
+            nCancelled++;
+        }
+        else {
+            it++;
+        }
     }
-    it->second->update(pyDict);
+    return nCancelled;
 }
 
-void PvaServer::update(const std::string& channelName, const PvObject& pvObject) 
+void PvaServer::updateWorkerThread(void*)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it == recordMap.end()) {
-        throw ObjectNotFound("Master database does not have record for channel: " + channelName);
+    while (true) {
+        RecordUpdateTask::shared_pointer taskPtr;
+        {
+            epvd::Lock lock(updateWorkerMutex);
+            if (!updateRequestQueue.empty()) {
+                taskPtr = updateRequestQueue.front();
+                updateRequestQueue.pop_front();
+                if (!updateRequestQueue.empty()) {
+                    updateWorkerEvent.signal();
+                }
+            }
+            else {
+                nIdleUpdateWorkers++;
+            }
+        }
+        if (taskPtr) {
+            updateRecords(taskPtr);
+            continue;
+        }
+        updateWorkerEvent.wait();
+        epvd::Lock lock(updateWorkerMutex);
+        nIdleUpdateWorkers--;
     }
-    it->second->update(pvObject);
 }
 
-void PvaServer::updateUnchecked(const std::string& channelName, const PvObject& pvObject) 
+void PvaServer::updateRecords(RecordUpdateTask::shared_pointer taskPtr)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it == recordMap.end()) {
-        throw ObjectNotFound("Master database does not have record for channel: " + channelName);
+    int nUpdates = int(taskPtr->updates.size());
+    while (true) {
+        int i = epicsAtomicIncrIntT(&taskPtr->nextUpdate) - 1;
+        if (i >= nUpdates) {
+            break;
+        }
+        try {
+            taskPtr->updates[i].first->update(taskPtr->updates[i].second);
+            epicsAtomicIncrIntT(&taskPtr->nUpdated);
+        }
+        catch (const std::exception& ex) {
+            epvd::Lock lock(taskPtr->mutex);
+            if (taskPtr->errorMessage.empty()) {
+                taskPtr->errorMessage = "Cannot update record " + taskPtr->updates[i].first->getRecordName() + ": " + ex.what();
+            }
+        }
+    }
+    epvd::Lock lock(taskPtr->mutex);
+    taskPtr->nActiveThreads--;
+    if (taskPtr->nActiveThreads == 0) {
+        taskPtr->doneEvent.signal();
     }
-    it->second->updateUnchecked(pvObject);
 }
 
 void PvaServer::addRecord(const std::string& channelName, const epics::pvData::PVStructurePtr& pvStructurePtr)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it != recordMap.end()) {
+    if (recordMap.find(channelName)) {
         throw ObjectAlreadyExists("Master database already has record for channel: " + channelName);
     }
     initRecord(channelName, pvStructurePtr);
@@ -283,8 +494,7 @@ void PvaServer::addRecord(const std::string& channelName, const epics::pvData::P
 
 void PvaServer::addRecord(const std::string& channelName, const PvObject& pvObject, const boost::python::object& onWriteCallback)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it != recordMap.end()) {
+    if (recordMap.find(channelName)) {
         throw ObjectAlreadyExists("Master database already has record for channel: " + channelName);
     }
 
@@ -295,8 +505,7 @@ void PvaServer::addRecord(const std::string& channelName, const PvObject& pvObje
 
 void PvaServer::addRecordWithAs(const std::string& channelName, const PvObject& pvObject, int asLevel, const std::string& asGroup, const boost::python::object& onWriteCallback)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it != recordMap.end()) {
+    if (recordMap.find(channelName)) {
         throw ObjectAlreadyExists("Master database already has record for channel: " + channelName);
     }
 
@@ -307,40 +516,53 @@ void PvaServer::addRecordWithAs(const std::string& channelName, const PvObject&
 
 void PvaServer::removeRecord(const std::string& channelName)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it == recordMap.end()) {
+    PyPvRecordPtr record = recordMap.remove(channelName);
+    if (!record) {
         throw ObjectNotFound("Master database does not have record for channel: " + channelName);
     }
-    it->second->remove();
-    recordMap.erase(it);
+    record->remove();
 }
 
 PyPvRecordPtr PvaServer::findRecord(const std::string& channelName)
 {
-    std::map<std::string, PyPvRecordPtr>::iterator it = recordMap.find(channelName);
-    if (it == recordMap.end()) {
+    PyPvRecordPtr record = recordMap.find(channelName);
+    if (!record) {
         throw ObjectNotFound("Master database does not have record for channel: " + channelName);
     }
-    return it->second;
+    return record;
 }
 
-void PvaServer::removeAllRecords() 
+PyPvRecordPtr PvaServer::getSingleRecord()
 {
-    std::list<std::string> recordNames;
-    typedef std::map<std::string, PyPvRecordPtr>::iterator MI;
-    for (MI it = recordMap.begin(); it != recordMap.end(); it++) {
-        recordNames.push_back(it->first);
+    if (recordMap.size() == 0) {
+        throw InvalidRequest("Master database does not have any records.");
+    }
+    PyPvRecordPtr record = recordMap.getSingleRecord();
+    if (!record) {
+        throw InvalidRequest("Master database has multiple records.");
     }
+    return record;
+}
 
-    typedef std::list<std::string>::iterator LI;
-    for (LI it = recordNames.begin(); it != recordNames.end(); ++it) {
-        removeRecord(*it);
+PvRecordHandle PvaServer::getRecordHandle(const std::string& channelName)
+{
+    return PvRecordHandle(findRecord(channelName));
+}
+
+void PvaServer::removeAllRecords() 
+{
+    std::vector<std::string> recordNames = recordMap.getChannelNames();
+    for (size_t i = 0; i < recordNames.size(); i++) {
+        PyPvRecordPtr record = recordMap.remove(recordNames[i]);
+        if (record) {
+            record->remove();
+        }
     }
 }
 
 bool PvaServer::hasRecord(const std::string& channelName)
 {
-    if (recordMap.find(channelName) != recordMap.end()) {
+    if (recordMap.find(channelName)) {
         return true;
     }
     return false;
@@ -349,16 +571,52 @@ bool PvaServer::hasRecord(const std::string& channelName)
 boost::python::list PvaServer::getRecordNames() 
 {
     boost::python::list recordNames;
-    typedef std::map<std::string, PyPvRecordPtr>::iterator MI;
-    for (MI it = recordMap.begin(); it != recordMap.end(); it++) {
-        recordNames.append(it->first);
+    std::vector<std::string> channelNames = recordMap.getChannelNames();
+    for (size_t i = 0; i < channelNames.size(); i++) {
+        recordNames.append(channelNames[i]);
     }
     return recordNames;
 }
 
+void PvaServer::setNumCallbackThreads(int nCallbackThreads)
+{
+    if (nCallbackThreads <= 0) {
+        throw InvalidArgument("Number of callback threads must be positive.");
+    }
+    epics::pvData::Lock lock(callbackThreadMutex);
+    if (nRunningCallbackThreads > 0) {
+        throw InvalidState("Number of callback threads cannot be changed while callback threads are running.");
+    }
+    this->nCallbackThreads = nCallbackThreads;
+}
+
+int PvaServer::getNumCallbackThreads()
+{
+    return nCallbackThreads;
+}
+
+unsigned int PvaServer::getCallbackQueueSize()
+{
+    return callbackQueuePtr->size();
+}
+
+bp::dict PvaServer::getCallbackCounters()
+{
+    return callbackQueuePtr->getCounters();
+}
+
+bp::dict PvaServer::getCallbackLatencyHistograms()
+{
+    return callbackQueuePtr->getLatencyHistograms();
+}
+
+void PvaServer::resetCallbackCounters()
+{
+    callbackQueuePtr->resetCounters();
+}
+
 void PvaServer::callbackThread(PvaServer* server)
 {
-    server->callbackThreadRunning = true;
     logger.debug("Started PVA Server callback thread %s", epicsThreadGetNameSelf());
     while (true) {
         if (!server->isRunning) {
@@ -367,15 +625,22 @@ void PvaServer::callbackThread(PvaServer* server)
 
         // Handle possible exceptions while retrieving data from empty queue.
         try {
-            std::string recordName = server->callbackQueuePtr->frontAndPop(RecordUpdateTimeout);
-            PyPvRecordPtr record = server->findRecord(recordName);
-            if (!server->isRunning) {
-                break;
+            std::string recordName = server->callbackQueuePtr->startCallback(RecordUpdateTimeout);
+            epicsTimeStamp startTime;
+            epicsTimeGetCurrent(&startTime);
+            try {
+                PyPvRecordPtr record = server->findRecord(recordName);
+                if (server->isRunning) {
+                    record->executeCallback();
+                }
             }
-            record->executeCallback();
-        }
-        catch (ObjectNotFound& ex) {
-            // Record has been deleted before we could get to update
+            catch (ObjectNotFound& ex) {
+                // Record has been deleted before we could get to update
+            }
+            catch (const std::exception& ex) {
+                logger.error("PVA Server callback thread caught exception: %s", ex.what());
+            }
+            server->callbackQueuePtr->endCallback(recordName, startTime);
         }
         catch (QueueEmpty& ex) {
             // Queue empty, no PV updates received.
@@ -386,36 +651,46 @@ void PvaServer::callbackThread(PvaServer* server)
         }
     }
 
-    // Callback thread done.
+    // Callback thread done; wake up remaining threads.
     logger.debug("Exiting PVA Server callback thread %s", epicsThreadGetNameSelf());
-    server->callbackQueuePtr->clear();
-    server->notifyCallbackThreadExit();
-    server->callbackThreadRunning = false;
+    server->callbackQueuePtr->cancelWait();
+    epics::pvData::Lock lock(server->callbackThreadMutex);
+    server->nRunningCallbackThreads--;
+    if (server->nRunningCallbackThreads == 0) {
+        server->callbackQueuePtr->clear();
+        server->notifyCallbackThreadExit();
+    }
 }
 
-void PvaServer::startCallbackThread()
+void PvaServer::startCallbackThreads()
 {
     epics::pvData::Lock lock(callbackThreadMutex);
-    if (!callbackThreadRunning) {
-        PyGilManager::evalInitThreads();
-        epicsThreadCreate("CallbackThread", epicsThreadPriorityHigh, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)callbackThread, this);
-        callbackThreadNeeded = true;
+    if (nRunningCallbackThreads > 0) {
+        return;
     }
-    else {
-        logger.warn("Callback thread is already running.");
+    PyGilManager::evalInitThreads();
+    callbackThreadExitEvent.tryWait();
+    logger.debug("Starting %d callback threads", nCallbackThreads);
+    for (int i = 0; i < nCallbackThreads; i++) {
+        epicsThreadCreate("CallbackThread", epicsThreadPriorityHigh, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)callbackThread, this);
     }
+    nRunningCallbackThreads = nCallbackThreads;
+    callbackThreadNeeded = true;
 }
 
 void PvaServer::waitForCallbackThreadExit(double timeout)
 {
-    if (callbackThreadRunning) {
-        logger.debug("Waiting on callback thread exit, timeout in %f seconds", timeout);
-        callbackThreadExitEvent.wait(timeout);
+    {
+        epics::pvData::Lock lock(callbackThreadMutex);
+        if (nRunningCallbackThreads == 0) {
+            return;
+        }
     }
+    logger.debug("Waiting on callback thread exit, timeout in %f seconds", timeout);
+    callbackThreadExitEvent.wait(timeout);
 }
 
 void PvaServer::notifyCallbackThreadExit()
 {
     callbackThreadExitEvent.signal();
 }
-
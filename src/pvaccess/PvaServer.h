@@ -6,6 +6,8 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <deque>
 #include <boost/python/list.hpp>
 #include <boost/python/dict.hpp>
 #include <pv/pvData.h>
@@ -14,8 +16,10 @@
 
 #include "PvObject.h"
 #include "PyPvRecord.h"
+#include "PyPvRecordMap.h"
+#include "PvRecordHandle.h"
 #include "PvaPyLogger.h"
-#include "SynchronizedQueue.h"
+#include "RecordCallbackQueue.h"
 
 class PvaServer 
 {
@@ -38,6 +42,10 @@ public:
     virtual void update(const std::string& channelName, const boost::python::dict& pyDict);
     virtual void update(const std::string& channelName, const PvObject& pvObject);
     virtual void updateUnchecked(const std::string& channelName, const PvObject& pvObject);
+    virtual unsigned int updateChanged(const PvObject& pvObject);
+    virtual unsigned int updateChanged(const std::string& channelName, const PvObject& pvObject);
+    virtual void updateMany(const std::map<std::string, epics::pvData::PVStructurePtr>& pvStructureMap);
+    virtual void updateMany(const boost::python::dict& pyDict);
 
     virtual void addRecord(const std::string& channelName, const epics::pvData::PVStructurePtr& pvStructurePtr);
 #ifndef WINDOWS
@@ -58,8 +66,16 @@ public:
     virtual void removeAllRecords();
     virtual bool hasRecord(const std::string& channelName);
     virtual boost::python::list getRecordNames();
+    virtual PvRecordHandle getRecordHandle(const std::string& channelName);
     virtual void disableRecordProcessing(const std::string& channelName);
 
+    virtual void setNumCallbackThreads(int nCallbackThreads);
+    virtual int getNumCallbackThreads();
+    virtual unsigned int getCallbackQueueSize();
+    virtual boost::python::dict getCallbackCounters();
+    virtual boost::python::dict getCallbackLatencyHistograms();
+    virtual void resetCallbackCounters();
+
     virtual void start();
     virtual void stop();
 
@@ -69,9 +85,39 @@ protected:
 private:
     static const double ShutdownWaitTime;
     static const double RecordUpdateTimeout;
+    static const int MinUpdatesPerThread;
+    static const int DefaultNumCallbackThreads;
+
+    // Shared state of a single updateMany() call
+    struct RecordUpdateTask
+    {
+        POINTER_DEFINITIONS(RecordUpdateTask);
+        RecordUpdateTask();
+        std::vector<std::pair<PyPvRecordPtr, epics::pvData::PVStructurePtr> > updates;
+        int nextUpdate;
+        int nUpdated;
+        int nActiveThreads;
+        std::string errorMessage;
+        epics::pvData::Mutex mutex;
+        epicsEvent doneEvent;
+    };
+
+    static void addRecordUpdate(const RecordUpdateTask::shared_pointer& taskPtr, const PyPvRecordPtr& record, const epics::pvData::PVStructurePtr& pvStructurePtr);
+    static void updateRecords(RecordUpdateTask::shared_pointer taskPtr);
+    static void executeUpdateTask(const RecordUpdateTask::shared_pointer& taskPtr);
+
+    // Update worker threads are shared by all servers; they are created
+    // on demand and kept for subsequent updateMany() calls
+    static void requestUpdateWorkers(const RecordUpdateTask::shared_pointer& taskPtr, int nWorkers);
+    static int cancelUpdateWorkers(const RecordUpdateTask::shared_pointer& taskPtr);
+    static void updateWorkerThread(void*);
+    static epics::pvData::Mutex updateWorkerMutex;
+    static epicsEvent updateWorkerEvent;
+    static std::deque<RecordUpdateTask::shared_pointer> updateRequestQueue;
+    static int nIdleUpdateWorkers;
 
     static void callbackThread(PvaServer* server);
-    void startCallbackThread();
+    void startCallbackThreads();
     void waitForCallbackThreadExit(double timeout);
     void notifyCallbackThreadExit();
 
@@ -80,14 +126,16 @@ private:
     void initRecord(const std::string& channelName, const PvObject& pvObject, int asLevel, const std::string& asGroup, const boost::python::object& onWriteCallback = boost::python::object());
 #endif // if PVA_API_VERSION >= 483
     PyPvRecordPtr findRecord(const std::string& channelName);
+    PyPvRecordPtr getSingleRecord();
 
     static PvaPyLogger logger;
     epics::pvAccess::ServerContext::shared_pointer server;
-    std::map<std::string, PyPvRecordPtr> recordMap;
+    PyPvRecordMap recordMap;
     bool isRunning;
 
-    StringQueuePtr callbackQueuePtr;
-    bool callbackThreadRunning;
+    RecordCallbackQueue::shared_pointer callbackQueuePtr;
+    int nCallbackThreads;
+    int nRunningCallbackThreads;
     bool callbackThreadNeeded;
     epics::pvData::Mutex callbackThreadMutex;
     epicsEvent callbackThreadExitEvent;
@@ -490,7 +490,7 @@ void pyObjectToScalarField(const bp::object& pyObject, const std::string& fieldN
 //
 // Conversion PY object => PV Scalar Array
 //
-void pyObjectToScalarArrayField(const bp::object& pyObject, const std::string& fieldName, pvd::PVStructurePtr& pvStructurePtr)
+void pyObjectToScalarArrayField(const bp::object& pyObject, const std::string& fieldName, pvd::PVStructurePtr& pvStructurePtr, bool copy)
 {
     if (PyUtility::isPyList(pyObject)) {
         bp::list pyList = PyUtility::extractValueFromPyObject<bp::list>(pyObject);
@@ -499,7 +499,7 @@ void pyObjectToScalarArrayField(const bp::object& pyObject, const std::string& f
 #if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
     else if (PyUtility::isNumPyNDArray(pyObject)) {
         np::ndarray ndArray = PyUtility::extractValueFromPyObject<np::ndarray>(pyObject);
-        setScalarArrayFieldFromNumPyArray(ndArray, fieldName, pvStructurePtr);
+        setScalarArrayFieldFromNumPyArray(ndArray, fieldName, pvStructurePtr, copy);
     }
 #endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
     else {
@@ -2169,12 +2169,9 @@ bool isFieldPathCharScalarArray(const std::string& fieldPath, const pvd::PVStruc
 // 
 pvd::ScalarArrayConstPtr getFieldPathAsScalarArray(const std::string& fieldPath, const pvd::PVStructurePtr& pvStructurePtr) 
 {
-    std::vector<std::string> fieldNames = StringUtility::split(fieldPath);
-    pvd::PVStructurePtr pvStructurePtr2 = getParentStructureForFieldPath(fieldNames, pvStructurePtr);
-
     // Last field in the path is what we want.
-    int nElements = fieldNames.size();
-    std::string fieldName = fieldNames[nElements-1];
+    std::string fieldName;
+    pvd::PVStructurePtr pvStructurePtr2 = FieldPathCache::getParentStructure(fieldPath, pvStructurePtr, fieldName);
     pvd::FieldConstPtr fieldPtr = getField(fieldName, pvStructurePtr2);
     pvd::Type type = fieldPtr->getType();
     pvd::ScalarArrayConstPtr scalarArrayPtr;
@@ -2185,37 +2182,30 @@ pvd::ScalarArrayConstPtr getFieldPathAsScalarArray(const std::string& fieldPath,
 }
 
 //
-// Return structure field as python object. Allow notation like 'x.y.z'
-// for the field path.
+// Return structure field as python object.
 //
-bp::object getFieldPathAsPyObject(const std::string& fieldPath, const pvd::PVStructurePtr& pvStructurePtr, bool useNumPyArrays)
+bp::object getFieldAsPyObject(const std::string& fieldName, const pvd::PVStructurePtr& pvStructurePtr, bool useNumPyArrays)
 {
-    std::vector<std::string> fieldNames = StringUtility::split(fieldPath);
-    pvd::PVStructurePtr pvStructurePtr2 = getParentStructureForFieldPath(fieldNames, pvStructurePtr);
-
-    // Last field in the path is what we want.
-    int nElements = fieldNames.size();
-    std::string fieldName = fieldNames[nElements-1];
-    pvd::FieldConstPtr fieldPtr = getField(fieldName, pvStructurePtr2);
+    pvd::FieldConstPtr fieldPtr = getField(fieldName, pvStructurePtr);
     pvd::Type type = fieldPtr->getType();
     switch (type) {
         case pvd::scalar: {
-            return getScalarFieldAsPyObject(fieldName, pvStructurePtr2);
+            return getScalarFieldAsPyObject(fieldName, pvStructurePtr);
         }
         case pvd::scalarArray: {
-            return getScalarArrayFieldAsPyObject(fieldName, pvStructurePtr2, useNumPyArrays);
+            return getScalarArrayFieldAsPyObject(fieldName, pvStructurePtr, useNumPyArrays);
         }
         case pvd::structure: {
-            return getStructureFieldAsPyObject(fieldName, pvStructurePtr2, useNumPyArrays);
+            return getStructureFieldAsPyObject(fieldName, pvStructurePtr, useNumPyArrays);
         }
         case pvd::structureArray: {
-            return getStructureArrayFieldAsPyObject(fieldName, pvStructurePtr2, useNumPyArrays);
+            return getStructureArrayFieldAsPyObject(fieldName, pvStructurePtr, useNumPyArrays);
         }
         case pvd::union_: {
-            return getUnionFieldAsPyObject(fieldName, pvStructurePtr2, useNumPyArrays);
+            return getUnionFieldAsPyObject(fieldName, pvStructurePtr, useNumPyArrays);
         }
         case pvd::unionArray: {
-            return getUnionArrayFieldAsPyObject(fieldName, pvStructurePtr2, useNumPyArrays);
+            return getUnionArrayFieldAsPyObject(fieldName, pvStructurePtr, useNumPyArrays);
         }
         default: {
             throw PvaException("Unrecognized field type: %d", type);
@@ -2223,18 +2213,27 @@ bp::object getFieldPathAsPyObject(const std::string& fieldPath, const pvd::PVStr
     }
 }
 
+//
+// Return structure field as python object. Allow notation like 'x.y.z'
+// for the field path. Path resolution is cached per structure type.
+//
+bp::object getFieldPathAsPyObject(const std::string& fieldPath, const pvd::PVStructurePtr& pvStructurePtr, bool useNumPyArrays)
+{
+    // Last field in the path is what we want.
+    std::string fieldName;
+    pvd::PVStructurePtr pvStructurePtr2 = FieldPathCache::getParentStructure(fieldPath, pvStructurePtr, fieldName);
+    return getFieldAsPyObject(fieldName, pvStructurePtr2, useNumPyArrays);
+}
+
 //
 // Set structure field from python object. Allow notation like 'x.y.z'
-// for the field path.
+// for the field path. Path resolution is cached per structure type.
 //
 void setPyObjectToFieldPath(const bp::object& pyObject, const std::string& fieldPath, const pvd::PVStructurePtr& pvStructurePtr)
 {
-    std::vector<std::string> fieldNames = StringUtility::split(fieldPath);
-    pvd::PVStructurePtr pvStructurePtr2 = getParentStructureForFieldPath(fieldNames, pvStructurePtr);
-    int nElements = fieldNames.size();
-    
     // Last field in the path is what we want.
-    std::string fieldName = fieldNames[nElements-1];
+    std::string fieldName;
+    pvd::PVStructurePtr pvStructurePtr2 = FieldPathCache::getParentStructure(fieldPath, pvStructurePtr, fieldName);
     pyObjectToField(pyObject, fieldName, pvStructurePtr2);
 }
 
@@ -2291,52 +2290,60 @@ np::ndarray getScalarArrayFieldAsNumPyArray(const std::string& fieldName, const
 //
 // Conversion NumPy Array => PV Scalar Array 
 //
-void setScalarArrayFieldFromNumPyArray(const np::ndarray& ndArray, const std::string& fieldName, pvd::PVStructurePtr& pvStructurePtr)
+void setScalarArrayFieldFromNumPyArray(const np::ndarray& ndArray, const std::string& fieldName, pvd::PVStructurePtr& pvStructurePtr, bool copy)
 {
-    pvd::ScalarType scalarType = getScalarArrayType(fieldName, pvStructurePtr);
+    // Verify that field is a scalar array
+    getScalarArrayType(fieldName, pvStructurePtr);
+    pvd::PVScalarArrayPtr pvScalarArrayPtr = pvStructurePtr->getSubField<pvd::PVScalarArray>(fieldName);
+    setScalarArrayFromNumPyArray(ndArray, pvScalarArrayPtr, copy);
+}
+
+void setScalarArrayFromNumPyArray(const np::ndarray& ndArray, const pvd::PVScalarArrayPtr& pvScalarArrayPtr, bool copy)
+{
+    pvd::ScalarType scalarType = pvScalarArrayPtr->getScalarArray()->getElementType();
     switch (scalarType) {
         case pvd::pvBoolean: {
-            setScalarArrayFieldFromNumPyArrayImpl<pvd::boolean, bool>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<pvd::boolean, bool>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvByte: {
-            setScalarArrayFieldFromNumPyArrayImpl<pvd::int8, boost::int8_t>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<pvd::int8, boost::int8_t>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvUByte: {
-            setScalarArrayFieldFromNumPyArrayImpl<pvd::uint8, boost::uint8_t>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<pvd::uint8, boost::uint8_t>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvShort: {
-            setScalarArrayFieldFromNumPyArrayImpl<pvd::int16, boost::int16_t>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<pvd::int16, boost::int16_t>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvUShort: {
-            setScalarArrayFieldFromNumPyArrayImpl<pvd::uint16, boost::uint16_t>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<pvd::uint16, boost::uint16_t>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvInt: {
-            setScalarArrayFieldFromNumPyArrayImpl<pvd::int32, boost::int32_t>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<pvd::int32, boost::int32_t>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvUInt: {
-            setScalarArrayFieldFromNumPyArrayImpl<pvd::uint32, boost::uint32_t>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<pvd::uint32, boost::uint32_t>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvLong: {
-            setScalarArrayFieldFromNumPyArrayImpl<pvd::int64, boost::int64_t>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<pvd::int64, boost::int64_t>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvULong: {
-            setScalarArrayFieldFromNumPyArrayImpl<pvd::uint64, boost::uint64_t>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<pvd::uint64, boost::uint64_t>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvFloat: {
-            setScalarArrayFieldFromNumPyArrayImpl<float, float>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<float, float>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         case pvd::pvDouble: {
-            setScalarArrayFieldFromNumPyArrayImpl<double, double>(ndArray, fieldName, pvStructurePtr);
+            setScalarArrayFromNumPyArrayImpl<double, double>(ndArray, pvScalarArrayPtr, copy);
             break;
         }
         default: {
@@ -11,6 +11,7 @@
 #include "boost/python/list.hpp"
 #include "boost/python/dict.hpp"
 #include "boost/python/tuple.hpp"
+#include "boost/python/import.hpp"
 #include "boost/shared_ptr.hpp"
 #include "pv/pvData.h"
 
@@ -23,6 +24,7 @@
 #include "PvType.h"
 #include "PyUtility.h"
 #include "ScalarArrayPyOwner.h"
+#include "NumPyArrayPvOwner.h"
 #include "InvalidDataType.h"
 
 class PvObject;
@@ -112,7 +114,7 @@ void pyObjectToScalarField(const boost::python::object& pyObject, const std::str
 //
 // Conversion PY object => PV Scalar Array
 //
-void pyObjectToScalarArrayField(const boost::python::object& pyObject, const std::string& fieldName, epics::pvData::PVStructurePtr& pvStructurePtr);
+void pyObjectToScalarArrayField(const boost::python::object& pyObject, const std::string& fieldName, epics::pvData::PVStructurePtr& pvStructurePtr, bool copy=true);
 
 //
 // Conversion PY object => PV Structure
@@ -325,6 +327,7 @@ boost::python::dict extractUnionStructureDict(const boost::python::dict& pyDict)
 //
 bool isFieldPathCharScalarArray(const std::string& fieldPath, const epics::pvData::PVStructurePtr& pvStructurePtr);
 epics::pvData::ScalarArrayConstPtr getFieldPathAsScalarArray(const std::string& fieldPath, const epics::pvData::PVStructurePtr& pvStructurePtr);
+boost::python::object getFieldAsPyObject(const std::string& fieldName, const epics::pvData::PVStructurePtr& pvStructurePtr, bool useNumPyArrays);
 boost::python::object getFieldPathAsPyObject(const std::string& fieldPath, const epics::pvData::PVStructurePtr& pvStructurePtr, bool useNumPyArrays);
 void setPyObjectToFieldPath(const boost::python::object& pyObject, const std::string& fieldPath, const epics::pvData::PVStructurePtr& pvStructurePtr);
 
@@ -344,10 +347,13 @@ numpy_::ndarray getScalarArrayAsNumPyArray(const epics::pvData::PVScalarArrayPtr
 //
 // Conversion NumPy Array => PV Scalar Array 
 //
-void setScalarArrayFieldFromNumPyArray(const numpy_::ndarray& ndArray, const std::string& fieldName, epics::pvData::PVStructurePtr& pvStructurePtr);
+// Unless copy is requested, C-contiguous NumPy array data is shared 
+// with PV scalar array, which keeps reference to NumPy array
+void setScalarArrayFieldFromNumPyArray(const numpy_::ndarray& ndArray, const std::string& fieldName, epics::pvData::PVStructurePtr& pvStructurePtr, bool copy=true);
+void setScalarArrayFromNumPyArray(const numpy_::ndarray& ndArray, const epics::pvData::PVScalarArrayPtr& pvScalarArrayPtr, bool copy=true);
 
-template<typename CppType>
-void setScalarArrayFieldFromNumPyArrayImpl(const numpy_::ndarray& ndArray, const std::string& fieldName, epics::pvData::PVStructurePtr& pvStructurePtr);
+template<typename CppType, typename NumPyType>
+void setScalarArrayFromNumPyArrayImpl(const numpy_::ndarray& ndArray, const epics::pvData::PVScalarArrayPtr& pvScalarArrayPtr, bool copy);
 #endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
 
 //
@@ -415,7 +421,7 @@ numpy_::ndarray getScalarArrayAsNumPyArray(const epics::pvData::PVScalarArrayPtr
 }
 
 template<typename CppType, typename NumPyType>
-void setScalarArrayFieldFromNumPyArrayImpl(const numpy_::ndarray& ndArray, const std::string& fieldName, epics::pvData::PVStructurePtr& pvStructurePtr)
+void setScalarArrayFromNumPyArrayImpl(const numpy_::ndarray& ndArray, const epics::pvData::PVScalarArrayPtr& pvScalarArrayPtr, bool copy)
 {
     int nDimensions = ndArray.get_nd();
     unsigned long long nDataElements = 1;
@@ -440,7 +446,22 @@ void setScalarArrayFieldFromNumPyArrayImpl(const numpy_::ndarray& ndArray, const
     CppType* data = reinterpret_cast<CppType*>(cData);
 
     std::tr1::shared_ptr<epics::pvData::PVValueArray<CppType> > valueArray =
-        pvStructurePtr->getSubField<epics::pvData::PVValueArray<CppType> >(fieldName);
+        std::tr1::static_pointer_cast<epics::pvData::PVValueArray<CppType> >(pvScalarArrayPtr);
+    int flags = ndArray.get_flags();
+    if (nDataElements && !(flags & numpy_::ndarray::C_CONTIGUOUS)) {
+        // Strided array data is copied into a new contiguous array, 
+        // which is then shared with PV array
+        boost::python::object pyObject = boost::python::import("numpy").attr("ascontiguousarray")(ndArray);
+        numpy_::ndarray contiguousArray = boost::python::extract<numpy_::ndarray>(pyObject);
+        setScalarArrayFromNumPyArrayImpl<CppType, NumPyType>(contiguousArray, pvScalarArrayPtr, false);
+        return;
+    }
+    if (!copy && nDataElements && (flags & numpy_::ndarray::ALIGNED)) {
+        // Zero-copy: NumPy array must not be modified afterwards
+        epics::pvData::shared_vector<CppType> v(data, NumPyArrayPvOwner(ndArray), 0, nDataElements);
+        valueArray->replace(freeze(v));
+        return;
+    }
     epics::pvData::shared_vector<CppType> v(valueArray->reuse());
     v.resize(nDataElements);
     if (nDataElements) {
@@ -7,6 +7,7 @@
 #include "PyUtility.h"
 #include "PyGilManager.h"
 #include "PyPvDataUtility.h"
+#include "InvalidArgument.h"
 
 namespace bp = boost::python;
 namespace epvd = epics::pvData;
@@ -23,7 +24,7 @@ PyPvRecordPtr PyPvRecord::create(const std::string& name, const epics::pvData::P
     return pvRecord;
 }
 
-PyPvRecordPtr PyPvRecord::create(const std::string& name, const PvObject& pvObject, const StringQueuePtr& callbackQueuePtr, const bp::object& onWriteCallback)
+PyPvRecordPtr PyPvRecord::create(const std::string& name, const PvObject& pvObject, const RecordCallbackQueue::shared_pointer& callbackQueuePtr, const bp::object& onWriteCallback)
 {
     PyPvRecordPtr pvRecord(new PyPvRecord(name, pvObject, callbackQueuePtr, onWriteCallback));
     if(!pvRecord->init()) {
@@ -34,7 +35,7 @@ PyPvRecordPtr PyPvRecord::create(const std::string& name, const PvObject& pvObje
 
 #if PVA_API_VERSION >= 483
 
-PyPvRecordPtr PyPvRecord::create(const std::string& name, const PvObject& pvObject, int asLevel, const std::string& asGroup, const StringQueuePtr& callbackQueuePtr, const bp::object& onWriteCallback)
+PyPvRecordPtr PyPvRecord::create(const std::string& name, const PvObject& pvObject, int asLevel, const std::string& asGroup, const RecordCallbackQueue::shared_pointer& callbackQueuePtr, const bp::object& onWriteCallback)
 {
     PyPvRecordPtr pvRecord(new PyPvRecord(name, pvObject, asLevel, asGroup, callbackQueuePtr, onWriteCallback));
     if(!pvRecord->init()) {
@@ -50,14 +51,16 @@ PyPvRecord::PyPvRecord(const std::string& name, const epics::pvData::PVStructure
     , callbackQueuePtr()
     , onWriteCallback()
     , processingEnabled(true)
+    , removed(false)
 {
 }
 
-PyPvRecord::PyPvRecord(const std::string& name, const PvObject& pvObject, const StringQueuePtr& callbackQueuePtr_, const bp::object& onWriteCallback_)
+PyPvRecord::PyPvRecord(const std::string& name, const PvObject& pvObject, const RecordCallbackQueue::shared_pointer& callbackQueuePtr_, const bp::object& onWriteCallback_)
     : epvdb::PVRecord(name, pvObject.getPvStructurePtr())
     , callbackQueuePtr(callbackQueuePtr_)
     , onWriteCallback(onWriteCallback_)
     , processingEnabled(true)
+    , removed(false)
 {
     if(!PyUtility::isPyNone(onWriteCallback)) {
         PyGilManager::evalInitThreads();
@@ -66,11 +69,12 @@ PyPvRecord::PyPvRecord(const std::string& name, const PvObject& pvObject, const
 
 #if PVA_API_VERSION >= 483
 
-PyPvRecord::PyPvRecord(const std::string& name, const PvObject& pvObject, int asLevel, const std::string& asGroup, const StringQueuePtr& callbackQueuePtr_, const bp::object& onWriteCallback_)
+PyPvRecord::PyPvRecord(const std::string& name, const PvObject& pvObject, int asLevel, const std::string& asGroup, const RecordCallbackQueue::shared_pointer& callbackQueuePtr_, const bp::object& onWriteCallback_)
     : epvdb::PVRecord(name, pvObject.getPvStructurePtr(), asLevel, asGroup)
     , callbackQueuePtr(callbackQueuePtr_)
     , onWriteCallback(onWriteCallback_)
     , processingEnabled(true)
+    , removed(false)
 {
     if(!PyUtility::isPyNone(onWriteCallback)) {
         PyGilManager::evalInitThreads();
@@ -181,8 +185,93 @@ void PyPvRecord::updateUnchecked(const epvd::PVStructurePtr& pvStructurePtr)
     unlock();
 }
 
+unsigned int PyPvRecord::updateChanged(const PvObject& pvObject)
+{
+    return updateChanged(pvObject.getPvStructurePtr());
+}
+
+unsigned int PyPvRecord::updateChanged(const epvd::PVStructurePtr& pvStructurePtr)
+{
+    epvd::BitSet changedBitSet;
+    return updateChanged(pvStructurePtr, changedBitSet);
+}
+
+#if PVA_API_VERSION >= 481
+
+// Copies only leaf fields that differ, so that record posts (and monitors
+// send) only those fields. Returns number of copied fields.
+static unsigned int copyChangedFields(const epvd::PVStructure& srcPvStructure, epvd::PVStructure& destPvStructure, epvd::BitSet& changedBitSet)
+{
+    unsigned int nChanged = 0;
+    const epvd::PVFieldPtrArray& srcPvFields = srcPvStructure.getPVFields();
+    const epvd::PVFieldPtrArray& destPvFields = destPvStructure.getPVFields();
+    for (size_t i = 0; i < srcPvFields.size(); i++) {
+        const epvd::PVFieldPtr& srcPvFieldPtr = srcPvFields[i];
+        const epvd::PVFieldPtr& destPvFieldPtr = destPvFields[i];
+        if (srcPvFieldPtr->getField()->getType() == epvd::structure) {
+            nChanged += copyChangedFields(
+                *std::tr1::static_pointer_cast<epvd::PVStructure>(srcPvFieldPtr),
+                *std::tr1::static_pointer_cast<epvd::PVStructure>(destPvFieldPtr),
+                changedBitSet);
+        }
+        else if (!(*srcPvFieldPtr == *destPvFieldPtr)) {
+            destPvFieldPtr->copyUnchecked(*srcPvFieldPtr);
+            changedBitSet.set(destPvFieldPtr->getFieldOffset());
+            nChanged++;
+        }
+    }
+    return nChanged;
+}
+
+unsigned int PyPvRecord::updateChanged(const epvd::PVStructurePtr& pvStructurePtr, epvd::BitSet& changedBitSet)
+{
+    epvd::PVStructurePtr recordPvStructurePtr = getPVStructure();
+    if (*(pvStructurePtr->getStructure()) != *(recordPvStructurePtr->getStructure())) {
+        throw InvalidArgument("Structure of the updated object does not match structure of record " + getRecordName() + ".");
+    }
+    changedBitSet.clear();
+    unsigned int nChanged = 0;
+    lock();
+    try {
+        beginGroupPut();
+        nChanged = copyChangedFields(*pvStructurePtr, *recordPvStructurePtr, changedBitSet);
+        endGroupPut();
+    }
+    catch(...) {
+        endGroupPut();
+        unlock();
+        throw;
+    }
+    unlock();
+    return nChanged;
+}
+
+#else
+
+// Older pvData releases cannot compare or copy individual fields,
+// so the entire structure is copied.
+unsigned int PyPvRecord::updateChanged(const epvd::PVStructurePtr& pvStructurePtr, epvd::BitSet& changedBitSet)
+{
+    update(pvStructurePtr);
+    changedBitSet.clear();
+    changedBitSet.set(0);
+    return pvStructurePtr->getNumberFields();
+}
+
+#endif // if PVA_API_VERSION >= 481
+
 void PyPvRecord::disableProcessing() 
 {
     processingEnabled = false;
 }
 
+void PyPvRecord::remove()
+{
+    removed = true;
+    epvdb::PVRecord::remove();
+}
+
+bool PyPvRecord::isRemoved() const
+{
+    return removed;
+}
@@ -13,7 +13,7 @@
 #include "pv/pvDatabase.h"
 #include "PvObject.h"
 #include "PvaPyLogger.h"
-#include "SynchronizedQueue.h"
+#include "RecordCallbackQueue.h"
 
 class PyPvRecord;
 typedef std::tr1::shared_ptr<PyPvRecord> PyPvRecordPtr;
@@ -23,10 +23,10 @@ class PyPvRecord :
 {
 public:
     static PyPvRecordPtr create(const std::string& name, const epics::pvData::PVStructurePtr& pvStructurePtr);
-    static PyPvRecordPtr create(const std::string& name, const PvObject& pvObject, const StringQueuePtr& callbackQueuePtr, const boost::python::object& onWriteCallback = boost::python::object());
+    static PyPvRecordPtr create(const std::string& name, const PvObject& pvObject, const RecordCallbackQueue::shared_pointer& callbackQueuePtr, const boost::python::object& onWriteCallback = boost::python::object());
 
 #if PVA_API_VERSION >= 483
-    static PyPvRecordPtr create(const std::string& name, const PvObject& pvObject, int asLevel, const std::string& asGroup, const StringQueuePtr& callbackQueuePtr, const boost::python::object& onWriteCallback = boost::python::object());
+    static PyPvRecordPtr create(const std::string& name, const PvObject& pvObject, int asLevel, const std::string& asGroup, const RecordCallbackQueue::shared_pointer& callbackQueuePtr, const boost::python::object& onWriteCallback = boost::python::object());
 #endif // if PVA_API_VERSION >= 483
 
     POINTER_DEFINITIONS(PyPvRecord);
@@ -38,21 +38,27 @@ public:
     void updateUnchecked(const PvObject& pvObject);
     void update(const epics::pvData::PVStructurePtr& pvStructurePtr);
     void updateUnchecked(const epics::pvData::PVStructurePtr& pvStructurePtr);
+    unsigned int updateChanged(const PvObject& pvObject);
+    unsigned int updateChanged(const epics::pvData::PVStructurePtr& pvStructurePtr);
+    unsigned int updateChanged(const epics::pvData::PVStructurePtr& pvStructurePtr, epics::pvData::BitSet& changedBitSet);
     void executeCallback();
     void disableProcessing();
+    virtual void remove();
+    bool isRemoved() const;
 
 private:
     static PvaPyLogger logger;
     PyPvRecord(const std::string& name, const epics::pvData::PVStructurePtr& pvStructurePtr);
-    PyPvRecord(const std::string& name, const PvObject& pvObject, const StringQueuePtr& callbackQueuePtr, const boost::python::object& onWriteCallback = boost::python::object());
+    PyPvRecord(const std::string& name, const PvObject& pvObject, const RecordCallbackQueue::shared_pointer& callbackQueuePtr, const boost::python::object& onWriteCallback = boost::python::object());
 
 #if PVA_API_VERSION >= 483
-    PyPvRecord(const std::string& name, const PvObject& pvObject, int asLevel, const std::string& asGroup, const StringQueuePtr& callbackQueuePtr, const boost::python::object& onWriteCallback = boost::python::object());
+    PyPvRecord(const std::string& name, const PvObject& pvObject, int asLevel, const std::string& asGroup, const RecordCallbackQueue::shared_pointer& callbackQueuePtr, const boost::python::object& onWriteCallback = boost::python::object());
 #endif // if PVA_API_VERSION >= 483
 
-    StringQueuePtr callbackQueuePtr; 
+    RecordCallbackQueue::shared_pointer callbackQueuePtr;
     boost::python::object onWriteCallback;
     bool processingEnabled;
+    bool removed;
 
 };
 
@@ -0,0 +1,104 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include <algorithm>
+#include <epicsAtomic.h>
+#include "PyPvRecordMap.h"
+
+namespace epvd = epics::pvData;
+
+// Must be power of two
+const unsigned int PyPvRecordMap::NumShards(64);
+
+PyPvRecordMap::PyPvRecordMap()
+    : shards(new Shard[NumShards])
+    , nRecords(0)
+{
+}
+
+PyPvRecordMap::~PyPvRecordMap()
+{
+    delete [] shards;
+}
+
+// FNV-1a hash of the channel name selects the shard
+PyPvRecordMap::Shard& PyPvRecordMap::getShard(const std::string& channelName) const
+{
+    unsigned int hash = 2166136261u;
+    for (std::string::const_iterator it = channelName.begin(); it != channelName.end(); it++) {
+        hash ^= static_cast<unsigned char>(*it);
+        hash *= 16777619u;
+    }
+    return shards[hash & (NumShards-1)];
+}
+
+PyPvRecordPtr PyPvRecordMap::find(const std::string& channelName) const
+{
+    Shard& shard = getShard(channelName);
+    epvd::Lock lock(shard.mutex);
+    std::map<std::string, PyPvRecordPtr>::const_iterator it = shard.recordMap.find(channelName);
+    if (it == shard.recordMap.end()) {
+        return PyPvRecordPtr();
+    }
+    return it->second;
+}
+
+bool PyPvRecordMap::insert(const std::string& channelName, const PyPvRecordPtr& record)
+{
+    Shard& shard = getShard(channelName);
+    epvd::Lock lock(shard.mutex);
+    if (!shard.recordMap.insert(std::make_pair(channelName, record)).second) {
+        return false;
+    }
+    epicsAtomicIncrSizeT(&nRecords);
+    return true;
+}
+
+PyPvRecordPtr PyPvRecordMap::remove(const std::string& channelName)
+{
+    Shard& shard = getShard(channelName);
+    epvd::Lock lock(shard.mutex);
+    std::map<std::string, PyPvRecordPtr>::iterator it = shard.recordMap.find(channelName);
+    if (it == shard.recordMap.end()) {
+        return PyPvRecordPtr();
+    }
+    PyPvRecordPtr record = it->second;
+    shard.recordMap.erase(it);
+    epicsAtomicDecrSizeT(&nRecords);
+    return record;
+}
+
+unsigned int PyPvRecordMap::size() const
+{
+    return epicsAtomicGetSizeT(&nRecords);
+}
+
+PyPvRecordPtr PyPvRecordMap::getSingleRecord() const
+{
+    PyPvRecordPtr record;
+    for (unsigned int i = 0; i < NumShards; i++) {
+        epvd::Lock lock(shards[i].mutex);
+        typedef std::map<std::string, PyPvRecordPtr>::const_iterator MI;
+        for (MI it = shards[i].recordMap.begin(); it != shards[i].recordMap.end(); it++) {
+            if (record) {
+                return PyPvRecordPtr();
+            }
+            record = it->second;
+        }
+    }
+    return record;
+}
+
+std::vector<std::string> PyPvRecordMap::getChannelNames() const
+{
+    std::vector<std::string> channelNames;
+    for (unsigned int i = 0; i < NumShards; i++) {
+        epvd::Lock lock(shards[i].mutex);
+        typedef std::map<std::string, PyPvRecordPtr>::const_iterator MI;
+        for (MI it = shards[i].recordMap.begin(); it != shards[i].recordMap.end(); it++) {
+            channelNames.push_back(it->first);
+        }
+    }
+    std::sort(channelNames.begin(), channelNames.end());
+    return channelNames;
+}
@@ -0,0 +1,59 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef PY_PV_RECORD_MAP_H
+#define PY_PV_RECORD_MAP_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <pv/pvData.h>
+#include "PyPvRecord.h"
+
+// Thread-safe map of server records. Records are distributed among
+// shards by hash of the channel name, and each shard has its own lock,
+// so that lookups from different threads rarely contend, and each
+// lookup searches only a small map.
+class PyPvRecordMap
+{
+public:
+    static const unsigned int NumShards;
+
+    PyPvRecordMap();
+    virtual ~PyPvRecordMap();
+
+    // Returns null pointer if there is no record for a given channel
+    PyPvRecordPtr find(const std::string& channelName) const;
+
+    // Returns false if map already has record for a given channel
+    bool insert(const std::string& channelName, const PyPvRecordPtr& record);
+
+    // Returns removed record, or null pointer if there was none
+    PyPvRecordPtr remove(const std::string& channelName);
+
+    unsigned int size() const;
+
+    // Returns the only record in the map, or null pointer if map has
+    // none or more than one record
+    PyPvRecordPtr getSingleRecord() const;
+
+    // Channel names are returned in sorted order
+    std::vector<std::string> getChannelNames() const;
+
+private:
+    struct Shard
+    {
+        epics::pvData::Mutex mutex;
+        std::map<std::string, PyPvRecordPtr> recordMap;
+    };
+
+    PyPvRecordMap(const PyPvRecordMap&);
+    PyPvRecordMap& operator=(const PyPvRecordMap&);
+
+    Shard& getShard(const std::string& channelName) const;
+
+    Shard* shards;
+    size_t nRecords;
+};
+
+#endif
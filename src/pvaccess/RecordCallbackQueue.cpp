@@ -0,0 +1,162 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "RecordCallbackQueue.h"
+#include "PvaPyConstants.h"
+#include "QueueEmpty.h"
+
+namespace pvd = epics::pvData;
+namespace bp = boost::python;
+
+RecordCallbackQueue::RecordEntry::RecordEntry()
+    : pending(false)
+    , running(false)
+    , pendingTime()
+{
+}
+
+RecordCallbackQueue::RecordCallbackQueue()
+    : mutex()
+    , readyEvent()
+    , recordEntryMap()
+    , readyQueue()
+    , nPending(0)
+    , nReceived(0)
+    , nCoalesced(0)
+    , nDelivered(0)
+    , maxPending(0)
+    , queueWaitHistogram()
+    , callbackHistogram()
+{
+}
+
+RecordCallbackQueue::~RecordCallbackQueue()
+{
+    readyEvent.signal();
+}
+
+void RecordCallbackQueue::push(const std::string& recordName)
+{
+    pvd::Lock lock(mutex);
+    nReceived++;
+    RecordEntry& entry = recordEntryMap[recordName];
+    if (entry.pending) {
+        nCoalesced++;
+        return;
+    }
+    entry.pending = true;
+    epicsTimeGetCurrent(&entry.pendingTime);
+    nPending++;
+    if (nPending > maxPending) {
+        maxPending = nPending;
+    }
+    // Running record is requeued once its current callback is done
+    if (!entry.running) {
+        readyQueue.push_back(recordName);
+        readyEvent.signal();
+    }
+}
+
+std::string RecordCallbackQueue::startCallback(double timeout)
+{
+    bool waited = false;
+    while (true) {
+        {
+            pvd::Lock lock(mutex);
+            if (!readyQueue.empty()) {
+                std::string recordName = readyQueue.front();
+                readyQueue.pop_front();
+                RecordEntry& entry = recordEntryMap[recordName];
+                entry.pending = false;
+                entry.running = true;
+                nPending--;
+                epicsTimeStamp now;
+                epicsTimeGetCurrent(&now);
+                queueWaitHistogram.record(entry.pendingTime, now);
+                if (!readyQueue.empty()) {
+                    // Wake up another thread for the remaining records
+                    readyEvent.signal();
+                }
+                return recordName;
+            }
+        }
+        if (waited) {
+            throw QueueEmpty("Record callback queue is empty.");
+        }
+        readyEvent.wait(timeout);
+        waited = true;
+    }
+}
+
+void RecordCallbackQueue::endCallback(const std::string& recordName, const epicsTimeStamp& startTime)
+{
+    epicsTimeStamp now;
+    epicsTimeGetCurrent(&now);
+    callbackHistogram.record(startTime, now);
+    pvd::Lock lock(mutex);
+    nDelivered++;
+    std::map<std::string, RecordEntry>::iterator it = recordEntryMap.find(recordName);
+    if (it == recordEntryMap.end()) {
+        return;
+    }
+    it->second.running = false;
+    if (it->second.pending) {
+        readyQueue.push_back(recordName);
+        readyEvent.signal();
+    }
+    else {
+        recordEntryMap.erase(it);
+    }
+}
+
+void RecordCallbackQueue::cancelWait()
+{
+    readyEvent.signal();
+}
+
+void RecordCallbackQueue::clear()
+{
+    pvd::Lock lock(mutex);
+    readyQueue.clear();
+    recordEntryMap.clear();
+    nPending = 0;
+}
+
+unsigned int RecordCallbackQueue::size()
+{
+    pvd::Lock lock(mutex);
+    return nPending;
+}
+
+void RecordCallbackQueue::resetCounters()
+{
+    {
+        pvd::Lock lock(mutex);
+        nReceived = 0;
+        nCoalesced = 0;
+        nDelivered = 0;
+        maxPending = nPending;
+    }
+    queueWaitHistogram.reset();
+    callbackHistogram.reset();
+}
+
+bp::dict RecordCallbackQueue::getCounters()
+{
+    pvd::Lock lock(mutex);
+    bp::dict pyDict;
+    pyDict[PvaPyConstants::NumReceivedCounterKey] = nReceived;
+    pyDict[PvaPyConstants::NumCoalescedCounterKey] = nCoalesced;
+    pyDict[PvaPyConstants::NumDeliveredCounterKey] = nDelivered;
+    pyDict[PvaPyConstants::NumQueuedCounterKey] = nPending;
+    pyDict[PvaPyConstants::MaxQueuedCounterKey] = maxPending;
+    return pyDict;
+}
+
+bp::dict RecordCallbackQueue::getLatencyHistograms()
+{
+    bp::dict pyDict;
+    pyDict[PvaPyConstants::QueueWaitLatencyKey] = queueWaitHistogram.toDict();
+    pyDict[PvaPyConstants::CallbackLatencyKey] = callbackHistogram.toDict();
+    return pyDict;
+}
@@ -0,0 +1,72 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef RECORD_CALLBACK_QUEUE_H
+#define RECORD_CALLBACK_QUEUE_H
+
+#include <string>
+#include <map>
+#include <deque>
+#include <epicsEvent.h>
+#include <epicsTime.h>
+#include "boost/python/dict.hpp"
+#include "pv/pvData.h"
+#include "LatencyHistogram.h"
+
+// Queue of pending record write callbacks, shared by server callback
+// threads. A record is handed to at most one thread at a time, so that
+// callbacks for the same record are executed in order, while callbacks
+// for different records may run concurrently. Writes to a record whose
+// callback is already pending are coalesced into that callback.
+class RecordCallbackQueue
+{
+public:
+    POINTER_DEFINITIONS(RecordCallbackQueue);
+
+    RecordCallbackQueue();
+    virtual ~RecordCallbackQueue();
+
+    // Called on record write
+    void push(const std::string& recordName);
+
+    // Returns name of the next record whose callback should be executed;
+    // throws QueueEmpty if there is none within a given timeout
+    std::string startCallback(double timeout);
+
+    // Must be called after callback for a given record has been executed
+    void endCallback(const std::string& recordName, const epicsTimeStamp& startTime);
+
+    void cancelWait();
+    void clear();
+    unsigned int size();
+
+    // Statistics
+    void resetCounters();
+    boost::python::dict getCounters();
+    boost::python::dict getLatencyHistograms();
+
+private:
+    struct RecordEntry
+    {
+        RecordEntry();
+        bool pending;
+        bool running;
+        epicsTimeStamp pendingTime;
+    };
+
+    epics::pvData::Mutex mutex;
+    epicsEvent readyEvent;
+    std::map<std::string, RecordEntry> recordEntryMap;
+    std::deque<std::string> readyQueue;
+    unsigned int nPending;
+
+    // Statistics counters
+    unsigned int nReceived;
+    unsigned int nCoalesced;
+    unsigned int nDelivered;
+    unsigned int maxPending;
+    LatencyHistogram queueWaitHistogram;
+    LatencyHistogram callbackHistogram;
+};
+
+#endif
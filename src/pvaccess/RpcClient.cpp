@@ -6,8 +6,24 @@
 #include "PvaException.h"
 #include "pv/rpcService.h"
 #include "ChannelTimeout.h"
+#include "InvalidArgument.h"
+#include "QueueEmpty.h"
+#include "PyGilManager.h"
+#include "PyGilRelease.h"
+#include "PyUtility.h"
+#include "PvaExceptionTranslator.h"
+
+namespace pvd = epics::pvData;
+namespace epvaccess = epics::pvAccess;
+namespace bp = boost::python;
 
 const int RpcClient::DefaultTimeout(1);
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+const int RpcClient::DefaultMaxOutstandingRequests(16);
+const double RpcClient::AsyncThreadIdleTimeout(30);
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+
+PvaPyLogger RpcClient::logger("RpcClient");
 
 RpcClient::RpcClient(const std::string& channelName_) :
     PvaClient(),
@@ -15,9 +31,15 @@ RpcClient::RpcClient(const std::string& channelName_) :
     rpcClient(),
     channelName(channelName_),
     timeout(DefaultTimeout)
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    , asyncContextPtr()
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 {
     PvObject::initializeBoostNumPy();
     pvRequest = epics::pvData::CreateRequest::create()->createRequest("");
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    asyncContextPtr = AsyncContextPtr(new AsyncContext(channelName, pvRequest, DefaultMaxOutstandingRequests));
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 }
 
 #if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 460
@@ -27,9 +49,15 @@ RpcClient::RpcClient(const std::string& channelName_, const PvObject& pvRequestO
     rpcClient(),
     channelName(channelName_),
     timeout(DefaultTimeout)
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    , asyncContextPtr()
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 {
     PvObject::initializeBoostNumPy();
     pvRequest = pvRequestObject.getPvStructurePtr();
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    asyncContextPtr = AsyncContextPtr(new AsyncContext(channelName, pvRequest, DefaultMaxOutstandingRequests));
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 }
 #endif
 
@@ -40,11 +68,17 @@ RpcClient::RpcClient(const RpcClient& pvaRpcClient) :
     channelName(pvaRpcClient.channelName),
     pvRequest(pvaRpcClient.pvRequest),
     timeout(pvaRpcClient.timeout)
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    , asyncContextPtr(new AsyncContext(pvaRpcClient.channelName, pvaRpcClient.pvRequest, pvaRpcClient.asyncContextPtr->maxOutstandingRequests))
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 {
 }
 
 RpcClient::~RpcClient()
 {
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    shutdownAsyncThread();
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
     if (rpcClientInitialized) {
         rpcClientInitialized = false;
         rpcClient->destroy();
@@ -111,3 +145,337 @@ PvObject* RpcClient::invoke(const PvObject& pvArgumentObject)
     return invoke(pvArgumentObject, timeout);
 }
 
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+void RpcClient::setMaxOutstandingRequests(int maxOutstandingRequests)
+{
+    if (maxOutstandingRequests <= 0) {
+        throw InvalidArgument("Maximum number of outstanding requests must be positive.");
+    }
+    asyncContextPtr->maxOutstandingRequests = maxOutstandingRequests;
+}
+
+int RpcClient::getMaxOutstandingRequests() const
+{
+    return asyncContextPtr->maxOutstandingRequests;
+}
+
+void RpcClient::invokeAsync(const PvObject& pvArgumentObject, const bp::object& pyCallback)
+{
+    invokeAsync(pvArgumentObject, pyCallback, bp::object());
+}
+
+void RpcClient::invokeAsync(const PvObject& pvArgumentObject, const bp::object& pyCallback, const bp::object& pyErrorCallback)
+{
+    AsyncRequestPtr asyncRequest(new AsyncRequest());
+    asyncRequest->arguments = pvArgumentObject.getPvStructurePtr();
+    asyncRequest->timeout = timeout;
+    asyncRequest->pyCallback = pyCallback;
+    asyncRequest->pyErrorCallback = pyErrorCallback;
+    submitAsyncRequest(asyncRequest);
+}
+
+bp::object RpcClient::invokeFuture(const PvObject& pvArgumentObject)
+{
+    AsyncRequestPtr asyncRequest(new AsyncRequest());
+    asyncRequest->arguments = pvArgumentObject.getPvStructurePtr();
+    asyncRequest->timeout = timeout;
+    asyncRequest->pyFuture = bp::import("concurrent.futures").attr("Future")();
+    submitAsyncRequest(asyncRequest);
+    return asyncRequest->pyFuture;
+}
+
+// All requests are submitted before waiting for the first response
+bp::list RpcClient::invokeBatch(const bp::list& pyArgumentList)
+{
+    bp::list pyFutureList;
+    for (int i = 0; i < bp::len(pyArgumentList); i++) {
+        bp::extract<PvObject> pvObjectExtract(pyArgumentList[i]);
+        if (!pvObjectExtract.check()) {
+            throw InvalidArgument("Batch argument list must contain PvObject instances only.");
+        }
+    }
+    for (int i = 0; i < bp::len(pyArgumentList); i++) {
+        PvObject pvArgumentObject = bp::extract<PvObject>(pyArgumentList[i]);
+        pyFutureList.append(invokeFuture(pvArgumentObject));
+    }
+    bp::list pyResponseList;
+    for (int i = 0; i < bp::len(pyFutureList); i++) {
+        pyResponseList.append(pyFutureList[i].attr("result")());
+    }
+    return pyResponseList;
+}
+
+RpcClient::AsyncContext::AsyncContext(const std::string& channelName_, const pvd::PVStructurePtr& pvRequest_, int maxOutstandingRequests_)
+    : channelName(channelName_)
+    , pvRequest(pvRequest_)
+    , asyncRequestQueue()
+    , idleRpcClients()
+    , maxOutstandingRequests(maxOutstandingRequests_)
+    , asyncThreadRunning(false)
+    , shutdownInProgress(false)
+    , asyncThreadId(0)
+    , mutex()
+    , asyncThreadExitEvent()
+{
+}
+
+bool RpcClient::AsyncContext::isShutdownInProgress()
+{
+    pvd::Lock lock(mutex);
+    return shutdownInProgress;
+}
+
+void RpcClient::submitAsyncRequest(const AsyncRequestPtr& asyncRequest)
+{
+    asyncContextPtr->asyncRequestQueue.push(asyncRequest);
+    pvd::Lock lock(asyncContextPtr->mutex);
+    if (!asyncContextPtr->asyncThreadRunning) {
+        // Thread state must be initialized for GIL handling
+        PyGilManager::evalInitThreads();
+        asyncContextPtr->asyncThreadRunning = true;
+        epicsThreadCreate("RpcClientAsyncThread", epicsThreadPriorityHigh, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)asyncThread, new AsyncContextPtr(asyncContextPtr));
+    }
+}
+
+// Called from async thread only; idle clients are not shared.
+RpcClient::AsyncOperation RpcClient::issueAsyncRequest(const AsyncContextPtr& asyncContextPtr, const AsyncRequestPtr& asyncRequest)
+{
+    AsyncOperation asyncOperation;
+    asyncOperation.asyncRequest = asyncRequest;
+    epvaccess::RPCClient::shared_pointer client;
+    try {
+        if (!asyncContextPtr->idleRpcClients.empty()) {
+            client = asyncContextPtr->idleRpcClients.front();
+            asyncContextPtr->idleRpcClients.pop_front();
+        }
+        else {
+            client = createRpcClient(asyncContextPtr->channelName, asyncContextPtr->pvRequest, asyncRequest->timeout);
+            if (!client->connect(asyncRequest->timeout)) {
+                throw ChannelTimeout("Could not connect to RPC channel %s.", asyncContextPtr->channelName.c_str());
+            }
+        }
+        client->issueRequest(asyncRequest->arguments);
+        asyncOperation.rpcClient = client;
+    }
+    catch (const std::exception& ex) {
+        if (client) {
+            client->destroy();
+        }
+        asyncOperation.errorMessage = ex.what();
+    }
+    return asyncOperation;
+}
+
+// Called from async thread only. Callbacks may release the last
+// reference to the client object, so only async context can be
+// used after they are invoked.
+void RpcClient::completeAsyncRequest(const AsyncContextPtr& asyncContextPtr, AsyncOperation& asyncOperation)
+{
+    const std::string& channelName = asyncContextPtr->channelName;
+    pvd::PVStructurePtr response;
+    std::string errorMessage = asyncOperation.errorMessage;
+    if (asyncOperation.rpcClient) {
+        bool reuseClient = true;
+        try {
+            response = asyncOperation.rpcClient->waitResponse(asyncOperation.asyncRequest->timeout);
+        }
+        catch (const epvaccess::RPCRequestException& ex) {
+            // Service error, connection is fine
+            errorMessage = ex.what();
+        }
+        catch (const std::exception& ex) {
+            // Late response must not be delivered to the next request
+            errorMessage = ex.what();
+            reuseClient = false;
+        }
+        if (reuseClient) {
+            asyncContextPtr->idleRpcClients.push_back(asyncOperation.rpcClient);
+        }
+        else {
+            asyncOperation.rpcClient->destroy();
+        }
+        asyncOperation.rpcClient.reset();
+    }
+    if (!response && errorMessage.empty()) {
+        errorMessage = "RPC service " + channelName + " did not return response.";
+    }
+
+    PyGilManager::gilStateEnsure();
+    AsyncRequestPtr asyncRequest = asyncOperation.asyncRequest;
+    asyncOperation.asyncRequest.reset();
+    notifyAsyncRequest(channelName, asyncRequest, response, errorMessage);
+    // Python objects held by request must be released with GIL
+    asyncRequest.reset();
+    PyGilManager::gilStateRelease();
+}
+
+// Delivers request result to future or callbacks; must be
+// called with GIL held
+void RpcClient::notifyAsyncRequest(const std::string& channelName, const AsyncRequestPtr& asyncRequest, const pvd::PVStructurePtr& response, const std::string& errorMessage)
+{
+    try {
+        if (response) {
+            PvObject pvObject(response);
+            if (!PyUtility::isPyNone(asyncRequest->pyFuture)) {
+                asyncRequest->pyFuture.attr("set_result")(pvObject);
+            }
+            else if (!PyUtility::isPyNone(asyncRequest->pyCallback)) {
+                asyncRequest->pyCallback(pvObject);
+            }
+        }
+        else if (!PyUtility::isPyNone(asyncRequest->pyFuture)) {
+            asyncRequest->pyFuture.attr("set_exception")(PvaExceptionTranslator::createPyException(PvaException(errorMessage)));
+        }
+        else if (!PyUtility::isPyNone(asyncRequest->pyErrorCallback)) {
+            asyncRequest->pyErrorCallback(errorMessage);
+        }
+        else {
+            logger.error("Async request for RPC service %s failed: %s", channelName.c_str(), errorMessage.c_str());
+        }
+    }
+    catch(const bp::error_already_set&) {
+        logger.error("Callback for RPC service " + channelName + " raised python exception.");
+        PyErr_Print();
+        PyErr_Clear();
+    }
+}
+
+// Fails requests that will not be completed, so that their futures
+// and error callbacks do not wait forever; python objects held by
+// requests must be released with GIL
+void RpcClient::releaseAsyncOperations(const AsyncContextPtr& asyncContextPtr, std::deque<AsyncOperation>& asyncOperations)
+{
+    std::deque<AsyncRequestPtr> asyncRequests;
+    for (std::deque<AsyncOperation>::iterator it = asyncOperations.begin(); it != asyncOperations.end(); it++) {
+        if (it->rpcClient) {
+            it->rpcClient->destroy();
+        }
+        if (it->asyncRequest) {
+            asyncRequests.push_back(it->asyncRequest);
+        }
+    }
+    std::deque<epvaccess::RPCClient::shared_pointer>& idleRpcClients = asyncContextPtr->idleRpcClients;
+    for (std::deque<epvaccess::RPCClient::shared_pointer>::iterator it = idleRpcClients.begin(); it != idleRpcClients.end(); it++) {
+        (*it)->destroy();
+    }
+    idleRpcClients.clear();
+    while (true) {
+        try {
+            asyncRequests.push_back(asyncContextPtr->asyncRequestQueue.frontAndPop());
+        }
+        catch (QueueEmpty& ex) {
+            break;
+        }
+    }
+    if (asyncRequests.empty()) {
+        return;
+    }
+    const std::string& channelName = asyncContextPtr->channelName;
+    std::string errorMessage = "RPC client for service " + channelName + " destroyed.";
+    PyGilManager::gilStateEnsure();
+    for (std::deque<AsyncRequestPtr>::iterator it = asyncRequests.begin(); it != asyncRequests.end(); it++) {
+        notifyAsyncRequest(channelName, *it, pvd::PVStructurePtr(), errorMessage);
+    }
+    asyncOperations.clear();
+    asyncRequests.clear();
+    PyGilManager::gilStateRelease();
+}
+
+void RpcClient::asyncThread(AsyncContextPtr* asyncContextPtrPtr)
+{
+    AsyncContextPtr asyncContextPtr(*asyncContextPtrPtr);
+    delete asyncContextPtrPtr;
+    {
+        pvd::Lock lock(asyncContextPtr->mutex);
+        asyncContextPtr->asyncThreadId = epicsThreadGetIdSelf();
+    }
+    logger.debug("Started RPC client async thread %s", epicsThreadGetNameSelf());
+    SynchronizedQueue<AsyncRequestPtr>& asyncRequestQueue = asyncContextPtr->asyncRequestQueue;
+    std::deque<AsyncOperation> inFlightQueue;
+    double idleTime = 0;
+    while (!asyncContextPtr->isShutdownInProgress()) {
+        try {
+            // Issue new requests while pipeline is not full; if there are
+            // no requests in flight, wait for new requests
+            while (int(inFlightQueue.size()) < asyncContextPtr->maxOutstandingRequests) {
+                AsyncRequestPtr asyncRequest;
+                try {
+                    asyncRequest = asyncRequestQueue.frontAndPop();
+                }
+                catch (QueueEmpty& ex) {
+                    if (inFlightQueue.empty()) {
+                        throw;
+                    }
+                    break;
+                }
+                idleTime = 0;
+                inFlightQueue.push_back(issueAsyncRequest(asyncContextPtr, asyncRequest));
+            }
+
+            // Requests complete in the order they were issued
+            completeAsyncRequest(asyncContextPtr, inFlightQueue.front());
+            inFlightQueue.pop_front();
+        }
+        catch (QueueEmpty& ex) {
+            if (idleTime >= AsyncThreadIdleTimeout) {
+                // Check queue again after acquiring thread lock, as
+                // requests may be submitted while we are exiting
+                pvd::Lock lock(asyncContextPtr->mutex);
+                if (asyncRequestQueue.isEmpty()) {
+                    logger.debug("Exiting RPC client async thread %s after idle timeout", epicsThreadGetNameSelf());
+                    asyncContextPtr->asyncThreadRunning = false;
+                    asyncContextPtr->asyncThreadId = 0;
+                    return;
+                }
+            }
+            asyncRequestQueue.waitForItemPushed(DefaultTimeout);
+            idleTime += DefaultTimeout;
+        }
+        catch (const std::exception& ex) {
+            // Not good.
+            logger.error("RPC client async thread caught exception: %s", ex.what());
+        }
+    }
+
+    // Client is being destroyed
+    logger.debug("Exiting RPC client async thread %s due to shutdown", epicsThreadGetNameSelf());
+    releaseAsyncOperations(asyncContextPtr, inFlightQueue);
+    pvd::Lock lock(asyncContextPtr->mutex);
+    asyncContextPtr->asyncThreadRunning = false;
+    asyncContextPtr->asyncThreadId = 0;
+    asyncContextPtr->asyncThreadExitEvent.signal();
+}
+
+// Async thread may need GIL in order to exit. If client is destroyed
+// from a callback invoked by async thread, that thread exits after
+// the callback returns, and releases remaining requests itself.
+void RpcClient::shutdownAsyncThread()
+{
+    {
+        pvd::Lock lock(asyncContextPtr->mutex);
+        asyncContextPtr->shutdownInProgress = true;
+        if (asyncContextPtr->asyncThreadRunning && asyncContextPtr->asyncThreadId == epicsThreadGetIdSelf()) {
+            return;
+        }
+    }
+    asyncContextPtr->asyncRequestQueue.cancelWaitForItemPushed();
+    while (true) {
+        {
+            pvd::Lock lock(asyncContextPtr->mutex);
+            if (!asyncContextPtr->asyncThreadRunning) {
+                break;
+            }
+        }
+        if (PyGILState_Check()) {
+            PyGilRelease pyGilRelease;
+            asyncContextPtr->asyncThreadExitEvent.wait(DefaultTimeout);
+        }
+        else {
+            asyncContextPtr->asyncThreadExitEvent.wait(DefaultTimeout);
+        }
+    }
+    // Thread is gone, release idle clients it left behind
+    std::deque<AsyncOperation> asyncOperations;
+    releaseAsyncOperations(asyncContextPtr, asyncOperations);
+}
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
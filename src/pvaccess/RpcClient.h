@@ -5,11 +5,18 @@
 #define RPC_CLIENT_H
 
 #include <string>
+#include <deque>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include "boost/python/object.hpp"
+#include "boost/python/list.hpp"
 
 #include "PvaClient.h"
 #include "PvObject.h"
 #include "pv/event.h" // this should really be in pv/rpcClient.h
 #include "pv/rpcClient.h"
+#include "SynchronizedQueue.h"
+#include "PvaPyLogger.h"
 
 /**
  * RPC client for PV access.
@@ -34,7 +41,22 @@ public:
     PvObject* invoke(const PvObject& pvArgumentObject, double timeout);
     PvObject* invoke(const PvObject& pvArgumentObject);
 
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    // Asynchronous requests are issued from a single client thread over
+    // a pool of reusable connected RPC clients, and complete in order
+    static const int DefaultMaxOutstandingRequests;
+    static const double AsyncThreadIdleTimeout;
+
+    void invokeAsync(const PvObject& pvArgumentObject, const boost::python::object& pyCallback);
+    void invokeAsync(const PvObject& pvArgumentObject, const boost::python::object& pyCallback, const boost::python::object& pyErrorCallback);
+    boost::python::object invokeFuture(const PvObject& pvArgumentObject);
+    boost::python::list invokeBatch(const boost::python::list& pyArgumentList);
+    void setMaxOutstandingRequests(int maxOutstandingRequests);
+    int getMaxOutstandingRequests() const;
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+
 private:
+    static PvaPyLogger logger;
     static epics::pvAccess::RPCClient::shared_pointer createRpcClient(const std::string& channelName, const epics::pvData::PVStructurePtr& pvRequest, double timeout=DefaultTimeout);
     epics::pvAccess::RPCClient::shared_pointer getRpcClient(const epics::pvData::PVStructurePtr& pvRequest, double timeout=DefaultTimeout);
 
@@ -43,6 +65,54 @@ private:
     std::string channelName;
     epics::pvData::PVStructure::shared_pointer pvRequest;
     double timeout;
+
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    struct AsyncRequest {
+        epics::pvData::PVStructurePtr arguments;
+        double timeout;
+        boost::python::object pyCallback;
+        boost::python::object pyErrorCallback;
+        boost::python::object pyFuture;
+    };
+    typedef std::tr1::shared_ptr<AsyncRequest> AsyncRequestPtr;
+
+    // Issued request; error message is set if request could not be
+    // issued, and is reported when request reaches the front of the
+    // pipeline, so that callbacks are always invoked in request order
+    struct AsyncOperation {
+        AsyncRequestPtr asyncRequest;
+        epics::pvAccess::RPCClient::shared_pointer rpcClient;
+        std::string errorMessage;
+    };
+
+    // State used by async thread; it is shared with the thread, as
+    // client may be destroyed from a callback invoked by that thread
+    struct AsyncContext {
+        AsyncContext(const std::string& channelName, const epics::pvData::PVStructurePtr& pvRequest, int maxOutstandingRequests);
+        bool isShutdownInProgress();
+        std::string channelName;
+        epics::pvData::PVStructurePtr pvRequest;
+        SynchronizedQueue<AsyncRequestPtr> asyncRequestQueue;
+        std::deque<epics::pvAccess::RPCClient::shared_pointer> idleRpcClients;
+        int maxOutstandingRequests;
+        bool asyncThreadRunning;
+        bool shutdownInProgress;
+        epicsThreadId asyncThreadId;
+        epics::pvData::Mutex mutex;
+        epicsEvent asyncThreadExitEvent;
+    };
+    typedef std::tr1::shared_ptr<AsyncContext> AsyncContextPtr;
+
+    static void asyncThread(AsyncContextPtr* asyncContextPtrPtr);
+    static AsyncOperation issueAsyncRequest(const AsyncContextPtr& asyncContextPtr, const AsyncRequestPtr& asyncRequest);
+    static void completeAsyncRequest(const AsyncContextPtr& asyncContextPtr, AsyncOperation& asyncOperation);
+    static void notifyAsyncRequest(const std::string& channelName, const AsyncRequestPtr& asyncRequest, const epics::pvData::PVStructurePtr& response, const std::string& errorMessage);
+    static void releaseAsyncOperations(const AsyncContextPtr& asyncContextPtr, std::deque<AsyncOperation>& asyncOperations);
+    void submitAsyncRequest(const AsyncRequestPtr& asyncRequest);
+    void shutdownAsyncThread();
+
+    AsyncContextPtr asyncContextPtr;
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 };
 
 inline std::string RpcClient::getChannelName() const
@@ -3,16 +3,34 @@
 
 #include "boost/python.hpp"
 #include "epicsThread.h"
+#include "epicsFindSymbol.h"
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif // if defined(_WIN32)
 #include "RpcServer.h"
 #include "PyGilManager.h"
+#include "PyUtility.h"
+#include "InvalidArgument.h"
 #include "InvalidState.h"
+#include "ConfigurationError.h"
+
+namespace pvd = epics::pvData;
+namespace bp = boost::python;
 
 PvaPyLogger RpcServer::logger("RpcServer");
 const double RpcServer::ShutdownWaitTime(0.1);
 
 RpcServer::RpcServer() :
     epics::pvAccess::RPCServer(),
-    destroyed(false)
+    destroyed(false),
+    nWorkers(0)
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    , mutex()
+    , workerPoolPtr()
+    , asyncServiceMap()
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 {
 }
 
@@ -24,6 +42,32 @@ RpcServer::~RpcServer()
 
 void RpcServer::registerService(const std::string& serviceName, const boost::python::object& pyService)
 {
+    registerService(serviceName, pyService, 0);
+}
+
+void RpcServer::registerService(const std::string& serviceName, const boost::python::object& pyService, int maxConcurrentRequests)
+{
+    if (maxConcurrentRequests < 0) {
+        throw InvalidArgument("Maximum number of concurrent requests cannot be negative.");
+    }
+    // Requests are limited only by the worker pool
+    if (maxConcurrentRequests > 0 && nWorkers == 0) {
+        throw InvalidArgument("Maximum number of concurrent requests can be set only when RPC server uses worker threads.");
+    }
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    if (nWorkers > 0) {
+        pvd::Lock lock(mutex);
+        if (!workerPoolPtr) {
+            PyGilManager::evalInitThreads();
+            workerPoolPtr = RpcWorkerPool::shared_pointer(new RpcWorkerPool(nWorkers));
+            RpcWorkerPool::start(workerPoolPtr);
+        }
+        RpcServiceAsyncImpl::shared_pointer rpcServiceAsyncImplPtr(new RpcServiceAsyncImpl(serviceName, pyService, workerPoolPtr, maxConcurrentRequests));
+        epics::pvAccess::RPCServer::registerService(serviceName, epics::pvAccess::RPCServiceAsync::shared_pointer(rpcServiceAsyncImplPtr));
+        asyncServiceMap[serviceName] = rpcServiceAsyncImplPtr;
+        return;
+    }
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
     epics::pvAccess::RPCService::shared_pointer rpcServiceImplPtr(new RpcServiceImpl(pyService));
     epics::pvAccess::RPCServer::registerService(serviceName, rpcServiceImplPtr);
 }
@@ -31,6 +75,109 @@ void RpcServer::registerService(const std::string& serviceName, const boost::pyt
 void RpcServer::unregisterService(const std::string& serviceName)
 {
     epics::pvAccess::RPCServer::unregisterService(serviceName);
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    pvd::Lock lock(mutex);
+    asyncServiceMap.erase(serviceName);
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+}
+
+void RpcServer::registerNativeService(const std::string& serviceName, const epics::pvAccess::RPCService::shared_pointer& serviceImplPtr)
+{
+    if (!serviceImplPtr) {
+        throw InvalidArgument("Native service implementation for %s cannot be null.", serviceName.c_str());
+    }
+    epics::pvAccess::RPCServer::registerService(serviceName, serviceImplPtr);
+}
+
+void RpcServer::registerNativeService(const std::string& serviceName, const std::string& libraryName)
+{
+    registerNativeService(serviceName, libraryName, PVAPY_RPC_SERVICE_FACTORY_NAME, "");
+}
+
+// Factory must be found in the given library; epicsFindSymbol() would
+// search all loaded libraries and could return the factory of another
+// plugin that uses the same name.
+static PvaPyRpcServiceFactory findServiceFactory(void* libraryHandle, const std::string& factoryName)
+{
+#if defined(_WIN32)
+    return (PvaPyRpcServiceFactory)GetProcAddress((HMODULE)libraryHandle, factoryName.c_str());
+#else
+    return (PvaPyRpcServiceFactory)dlsym(libraryHandle, factoryName.c_str());
+#endif // if defined(_WIN32)
+}
+
+// Plugin libraries are never unloaded, as service objects
+// may outlive the server.
+void RpcServer::registerNativeService(const std::string& serviceName, const std::string& libraryName, const std::string& factoryName, const std::string& configuration)
+{
+    void* libraryHandle = epicsLoadLibrary(libraryName.c_str());
+    if (!libraryHandle) {
+        const char* loadError = epicsLoadError();
+        throw ConfigurationError("Cannot load RPC service library %s: %s", libraryName.c_str(), loadError ? loadError : "unknown error");
+    }
+    PvaPyRpcServiceFactory factory = findServiceFactory(libraryHandle, factoryName);
+    if (!factory) {
+        throw ConfigurationError("Cannot find RPC service factory %s in library %s.", factoryName.c_str(), libraryName.c_str());
+    }
+    epics::pvAccess::RPCService::shared_pointer serviceImplPtr;
+    try {
+        serviceImplPtr = epics::pvAccess::RPCService::shared_pointer(factory(serviceName.c_str(), configuration.c_str()));
+    }
+    catch (const std::exception& ex) {
+        throw ConfigurationError("RPC service factory %s could not create service %s: %s", factoryName.c_str(), serviceName.c_str(), ex.what());
+    }
+    if (!serviceImplPtr) {
+        throw ConfigurationError("RPC service factory %s did not create service %s.", factoryName.c_str(), serviceName.c_str());
+    }
+    logger.debug("Registering native RPC service %s from library %s", serviceName.c_str(), libraryName.c_str());
+    registerNativeService(serviceName, serviceImplPtr);
+}
+
+void RpcServer::setNumWorkers(int nWorkers)
+{
+    if (nWorkers < 0) {
+        throw InvalidArgument("Number of RPC worker threads cannot be negative.");
+    }
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    pvd::Lock lock(mutex);
+    if (workerPoolPtr) {
+        throw InvalidState("Number of RPC worker threads cannot be changed after asynchronous services have been registered.");
+    }
+    this->nWorkers = nWorkers;
+#else
+    if (nWorkers > 0) {
+        throw InvalidState("RPC worker threads are not supported by this version of pvAccess.");
+    }
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+}
+
+int RpcServer::getNumWorkers() const
+{
+    return nWorkers;
+}
+
+bp::dict RpcServer::getServiceCounters()
+{
+    bp::dict pyDict;
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    pvd::Lock lock(mutex);
+    std::map<std::string, RpcServiceAsyncImpl::shared_pointer>::iterator it;
+    for (it = asyncServiceMap.begin(); it != asyncServiceMap.end(); it++) {
+        pyDict[it->first] = PyUtility::mapToDict<std::string,unsigned int>(it->second->getCounterMap());
+    }
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    return pyDict;
+}
+
+void RpcServer::resetServiceCounters()
+{
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    pvd::Lock lock(mutex);
+    std::map<std::string, RpcServiceAsyncImpl::shared_pointer>::iterator it;
+    for (it = asyncServiceMap.begin(); it != asyncServiceMap.end(); it++) {
+        it->second->resetCounters();
+    }
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 }
 
 void RpcServer::startListener()
@@ -96,5 +243,15 @@ void RpcServer::shutdown()
 {
     destroyed = true;
     epics::pvAccess::RPCServer::destroy();
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    RpcWorkerPool::shared_pointer workerPoolPtr2;
+    {
+        pvd::Lock lock(mutex);
+        workerPoolPtr2 = workerPoolPtr;
+    }
+    if (workerPoolPtr2) {
+        workerPoolPtr2->stop();
+    }
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 }
 
@@ -5,11 +5,16 @@
 #define RPC_SERVER_H
 
 #include <string>
+#include <map>
 #include "pv/pvData.h"
 #include "pv/pvAccess.h"
 #include "pv/rpcServer.h"
 #include "boost/python/object.hpp"
+#include "boost/python/dict.hpp"
 #include "RpcServiceImpl.h"
+#include "RpcServiceAsyncImpl.h"
+#include "RpcWorkerPool.h"
+#include "RpcServicePlugin.h"
 #include "PvaPyLogger.h"
 
 class RpcServer : public epics::pvAccess::RPCServer
@@ -18,8 +23,21 @@ public:
     RpcServer();
     virtual ~RpcServer();
     void registerService(const std::string& serviceName, const boost::python::object& pyService);
+    void registerService(const std::string& serviceName, const boost::python::object& pyService, int maxConcurrentRequests);
     void unregisterService(const std::string& serviceName);
 
+    // Native services are called from pvAccess server threads without GIL
+    void registerNativeService(const std::string& serviceName, const epics::pvAccess::RPCService::shared_pointer& serviceImplPtr);
+    void registerNativeService(const std::string& serviceName, const std::string& libraryName);
+    void registerNativeService(const std::string& serviceName, const std::string& libraryName, const std::string& factoryName, const std::string& configuration);
+
+    // Services registered after the number of workers is set to a
+    // positive value are executed by the RPC worker pool
+    void setNumWorkers(int nWorkers);
+    int getNumWorkers() const;
+    boost::python::dict getServiceCounters();
+    void resetServiceCounters();
+
     void startListener();
     void stopListener();
 
@@ -36,6 +54,12 @@ private:
     static PvaPyLogger logger;
     static void listenerThread(RpcServer* rpcServer);
     bool destroyed;
+    int nWorkers;
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    epics::pvData::Mutex mutex;
+    RpcWorkerPool::shared_pointer workerPoolPtr;
+    std::map<std::string, RpcServiceAsyncImpl::shared_pointer> asyncServiceMap;
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 };
 
 #endif
@@ -0,0 +1,135 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "RpcServiceAsyncImpl.h"
+#include "PvaPyConstants.h"
+
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+
+namespace pvd = epics::pvData;
+namespace epvaccess = epics::pvAccess;
+namespace bp = boost::python;
+
+PvaPyLogger RpcServiceAsyncImpl::logger("RpcServiceAsyncImpl");
+
+RpcServiceAsyncImpl::RpcServiceAsyncImpl(const std::string& serviceName_, const bp::object& pyService, const RpcWorkerPool::shared_pointer& workerPoolPtr_, int maxConcurrentRequests_)
+    : serviceName(serviceName_)
+    , rpcServiceImplPtr(new RpcServiceImpl(pyService))
+    , workerPoolPtr(workerPoolPtr_)
+    , maxConcurrentRequests(maxConcurrentRequests_)
+    , mutex()
+    , pendingQueue()
+    , nActive(0)
+    , nReceived(0)
+    , nDelivered(0)
+    , nRejected(0)
+{
+}
+
+RpcServiceAsyncImpl::~RpcServiceAsyncImpl()
+{
+}
+
+std::string RpcServiceAsyncImpl::getServiceName() const
+{
+    return serviceName;
+}
+
+int RpcServiceAsyncImpl::getMaxConcurrentRequests() const
+{
+    return maxConcurrentRequests;
+}
+
+// Called from pvAccess server thread; it must not block.
+void RpcServiceAsyncImpl::request(const pvd::PVStructurePtr& args, const epvaccess::RPCResponseCallback::shared_pointer& callback)
+{
+    std::deque<PendingRequest> rejectedRequests;
+    {
+        pvd::Lock lock(mutex);
+        nReceived++;
+        if (maxConcurrentRequests > 0 && nActive >= (unsigned int)maxConcurrentRequests) {
+            pendingQueue.push_back(PendingRequest(args, callback));
+            logger.trace("Queued request for service %s: %d requests are waiting", serviceName.c_str(), int(pendingQueue.size()));
+            return;
+        }
+        if (workerPoolPtr->submit(shared_from_this(), args, callback)) {
+            nActive++;
+            return;
+        }
+        rejectedRequests.push_back(PendingRequest(args, callback));
+    }
+    rejectRequests(rejectedRequests);
+}
+
+void RpcServiceAsyncImpl::execute(const pvd::PVStructurePtr& args, const epvaccess::RPCResponseCallback::shared_pointer& callback)
+{
+    try {
+        pvd::PVStructurePtr response = rpcServiceImplPtr->request(args);
+        callback->requestDone(pvd::Status::Ok, response);
+    }
+    catch (const epvaccess::RPCRequestException& ex) {
+        callback->requestDone(pvd::Status(ex.getStatus(), ex.what()), pvd::PVStructurePtr());
+    }
+    catch (const std::exception& ex) {
+        callback->requestDone(pvd::Status(pvd::Status::STATUSTYPE_ERROR, ex.what()), pvd::PVStructurePtr());
+    }
+
+    // Slot of completed request is handed over to the oldest waiting request
+    std::deque<PendingRequest> rejectedRequests;
+    {
+        pvd::Lock lock(mutex);
+        nDelivered++;
+        nActive--;
+        if (!pendingQueue.empty()) {
+            PendingRequest pendingRequest = pendingQueue.front();
+            pendingQueue.pop_front();
+            if (workerPoolPtr->submit(shared_from_this(), pendingRequest.first, pendingRequest.second)) {
+                nActive++;
+            }
+            else {
+                rejectedRequests.push_back(pendingRequest);
+                rejectedRequests.insert(rejectedRequests.end(), pendingQueue.begin(), pendingQueue.end());
+                pendingQueue.clear();
+            }
+        }
+    }
+    rejectRequests(rejectedRequests);
+}
+
+// Must be called without mutex locked.
+void RpcServiceAsyncImpl::rejectRequests(std::deque<PendingRequest>& rejectedRequests)
+{
+    if (rejectedRequests.empty()) {
+        return;
+    }
+    {
+        pvd::Lock lock(mutex);
+        nRejected += rejectedRequests.size();
+    }
+    pvd::Status status(pvd::Status::STATUSTYPE_ERROR, "RPC service " + serviceName + " is not accepting requests.");
+    for (std::deque<PendingRequest>::iterator it = rejectedRequests.begin(); it != rejectedRequests.end(); it++) {
+        it->second->requestDone(status, pvd::PVStructurePtr());
+    }
+}
+
+void RpcServiceAsyncImpl::resetCounters()
+{
+    pvd::Lock lock(mutex);
+    nReceived = 0;
+    nDelivered = 0;
+    nRejected = 0;
+}
+
+std::map<std::string,unsigned int> RpcServiceAsyncImpl::getCounterMap()
+{
+    std::map<std::string,unsigned int> counterMap;
+    pvd::Lock lock(mutex);
+    counterMap[PvaPyConstants::NumReceivedCounterKey] = nReceived;
+    counterMap[PvaPyConstants::NumDeliveredCounterKey] = nDelivered;
+    counterMap[PvaPyConstants::NumRejectedCounterKey] = nRejected;
+    counterMap[PvaPyConstants::NumActiveCounterKey] = nActive;
+    counterMap[PvaPyConstants::NumQueuedCounterKey] = pendingQueue.size();
+    return counterMap;
+}
+
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
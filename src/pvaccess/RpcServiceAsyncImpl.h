@@ -0,0 +1,66 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef RPC_SERVICE_ASYNC_IMPL_H
+#define RPC_SERVICE_ASYNC_IMPL_H
+
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+
+#include <string>
+#include <map>
+#include <deque>
+#include <pv/pvData.h>
+#include <pv/pvAccess.h>
+#include <pv/rpcService.h>
+#include <boost/python/object.hpp>
+#include "RpcServiceImpl.h"
+#include "RpcWorkerPool.h"
+#include "PvaPyLogger.h"
+
+// Asynchronous RPC service: requests are handed off from pvAccess
+// server threads to the RPC worker pool, and responses are returned
+// via response callbacks. At most maxConcurrentRequests requests of
+// the same service are executed at once (0 means no limit other
+// than the pool size); remaining requests wait in service queue.
+class RpcServiceAsyncImpl : public epics::pvAccess::RPCServiceAsync, public std::tr1::enable_shared_from_this<RpcServiceAsyncImpl>
+{
+public:
+    POINTER_DEFINITIONS(RpcServiceAsyncImpl);
+    RpcServiceAsyncImpl(const std::string& serviceName, const boost::python::object& pyService, const RpcWorkerPool::shared_pointer& workerPoolPtr, int maxConcurrentRequests);
+    virtual ~RpcServiceAsyncImpl();
+    virtual void request(const epics::pvData::PVStructurePtr& args, const epics::pvAccess::RPCResponseCallback::shared_pointer& callback);
+
+    // Called by RPC worker thread
+    void execute(const epics::pvData::PVStructurePtr& args, const epics::pvAccess::RPCResponseCallback::shared_pointer& callback);
+
+    std::string getServiceName() const;
+    int getMaxConcurrentRequests() const;
+
+    // Statistics
+    void resetCounters();
+    std::map<std::string,unsigned int> getCounterMap();
+
+private:
+    typedef std::pair<epics::pvData::PVStructurePtr, epics::pvAccess::RPCResponseCallback::shared_pointer> PendingRequest;
+
+    static PvaPyLogger logger;
+    void rejectRequests(std::deque<PendingRequest>& rejectedRequests);
+
+    std::string serviceName;
+    RpcServiceImpl::shared_pointer rpcServiceImplPtr;
+    RpcWorkerPool::shared_pointer workerPoolPtr;
+    int maxConcurrentRequests;
+
+    epics::pvData::Mutex mutex;
+    std::deque<PendingRequest> pendingQueue;
+    unsigned int nActive;
+
+    // Statistics counters
+    unsigned int nReceived;
+    unsigned int nDelivered;
+    unsigned int nRejected;
+};
+
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+
+#endif
@@ -25,33 +25,43 @@ RpcServiceImpl::~RpcServiceImpl()
     //bp::incref(pyObject.ptr());
 }
 
+// May be called concurrently from RPC worker threads; python
+// objects are touched only while GIL is held.
 epics::pvData::PVStructurePtr RpcServiceImpl::request(const epics::pvData::PVStructurePtr& args)
 {
     PvObject pyRequest(args);
+    epics::pvData::PVStructurePtr response;
+    std::string errorMessage;
+
     // Acquire GIL
     PyGilManager::gilStateEnsure();
 
     // Call python code
     try {
         pyObject = pyService(pyRequest);
+        boost::python::extract<PvObject> pvObjectExtract(pyObject);
+        if (pvObjectExtract.check()) {
+            PvObject pyResponse = pvObjectExtract();
+            response = static_cast<epics::pvData::PVStructurePtr>(pyResponse);
+        }
+        else {
+            errorMessage = "Callable python service object must return instance of PvObject.";
+        }
     }
     catch(bp::error_already_set& ex) {
-        std::string errorMessage = PyUtility::getErrorMessageFromTraceback(ex);
-        throw epics::pvAccess::RPCRequestException(epics::pvData::Status::STATUSTYPE_ERROR, errorMessage);
+        errorMessage = PyUtility::getErrorMessageFromTraceback(ex);
     }
     catch (const std::exception& ex) {
-        throw epics::pvAccess::RPCRequestException(epics::pvData::Status::STATUSTYPE_ERROR, ex.what());
         logger.error(ex.what());
+        errorMessage = ex.what();
     }
 
-    // Release GIL. 
+    // Release GIL before reporting errors
     PyGilManager::gilStateRelease();
 
-    boost::python::extract<PvObject> pvObjectExtract(pyObject);
-    if (!pvObjectExtract.check()) {
-        throw epics::pvAccess::RPCRequestException(epics::pvData::Status::STATUSTYPE_ERROR, "Callable python service object must return instance of PvObject.");
+    if (!response) {
+        throw epics::pvAccess::RPCRequestException(epics::pvData::Status::STATUSTYPE_ERROR, errorMessage);
     }
-    PvObject pyResponse = pvObjectExtract();
-    return static_cast<epics::pvData::PVStructurePtr>(pyResponse);
+    return response;
 }
 
@@ -0,0 +1,28 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef RPC_SERVICE_PLUGIN_H
+#define RPC_SERVICE_PLUGIN_H
+
+#include <pv/pvData.h>
+#include <pv/pvAccess.h>
+#include <pv/rpcService.h>
+
+// Interface for native RPC services loaded into RpcServer from shared
+// libraries. Plugin library must export a factory function with C
+// linkage, which creates service object for a given service name and
+// plugin specific configuration string:
+//
+//   extern "C" epics::pvAccess::RPCService* createPvaPyRpcService(const char* serviceName, const char* configuration);
+//
+// Returned object is owned by the RPC server. Its request() method is
+// called directly from pvAccess server threads without python GIL, so
+// it must be thread safe and must not call python code. Errors are
+// reported by throwing epics::pvAccess::RPCRequestException. Libraries
+// that provide more than one factory should give them distinct names.
+
+#define PVAPY_RPC_SERVICE_FACTORY_NAME "createPvaPyRpcService"
+
+typedef epics::pvAccess::RPCService* (*PvaPyRpcServiceFactory)(const char* serviceName, const char* configuration);
+
+#endif
@@ -0,0 +1,124 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "RpcWorkerPool.h"
+#include "RpcServiceAsyncImpl.h"
+#include "PyGilManager.h"
+
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+
+namespace pvd = epics::pvData;
+namespace epvaccess = epics::pvAccess;
+
+const double RpcWorkerPool::WorkerWaitTimeout(1.0);
+
+PvaPyLogger RpcWorkerPool::logger("RpcWorkerPool");
+
+RpcWorkerPool::RpcWorkerPool(int nWorkers_)
+    : nWorkers(nWorkers_ > 0 ? nWorkers_ : epicsThreadGetCPUs())
+    , active(false)
+    , mutex()
+    , requestQueue()
+    , requestEvent()
+{
+}
+
+RpcWorkerPool::~RpcWorkerPool()
+{
+}
+
+int RpcWorkerPool::getNumWorkers() const
+{
+    return nWorkers;
+}
+
+bool RpcWorkerPool::isActive() const
+{
+    return active;
+}
+
+void RpcWorkerPool::start(const RpcWorkerPool::shared_pointer& poolPtr)
+{
+    if (poolPtr->active) {
+        return;
+    }
+    poolPtr->active = true;
+    logger.debug("Starting %d RPC worker threads", poolPtr->nWorkers);
+    for (int i = 0; i < poolPtr->nWorkers; i++) {
+        epicsThreadCreate("RpcWorker", epicsThreadPriorityLow, epicsThreadGetStackSize(epicsThreadStackMedium), (EPICSTHREADFUNC)workerThread, new RpcWorkerPool::shared_pointer(poolPtr));
+    }
+}
+
+// Requests that have not been started are failed, so that
+// clients do not have to wait for timeout.
+void RpcWorkerPool::stop()
+{
+    std::deque<Request> requestQueue2;
+    {
+        pvd::Lock lock(mutex);
+        active = false;
+        requestQueue2.swap(requestQueue);
+    }
+    for (int i = 0; i < nWorkers; i++) {
+        requestEvent.signal();
+    }
+    pvd::Status status(pvd::Status::STATUSTYPE_ERROR, "RPC server is shutting down.");
+    for (std::deque<Request>::iterator it = requestQueue2.begin(); it != requestQueue2.end(); it++) {
+        it->callback->requestDone(status, pvd::PVStructurePtr());
+    }
+}
+
+bool RpcWorkerPool::submit(const RpcServiceAsyncImpl::shared_pointer& serviceImplPtr, const pvd::PVStructurePtr& args, const epvaccess::RPCResponseCallback::shared_pointer& callback)
+{
+    pvd::Lock lock(mutex);
+    if (!active) {
+        return false;
+    }
+    Request request;
+    request.serviceImplPtr = serviceImplPtr;
+    request.args = args;
+    request.callback = callback;
+    requestQueue.push_back(request);
+    requestEvent.signal();
+    return true;
+}
+
+void RpcWorkerPool::workerThread(RpcWorkerPool::shared_pointer* poolPtr)
+{
+    RpcWorkerPool* pool = poolPtr->get();
+    logger.debug("Started RPC worker thread %s", epicsThreadGetNameSelf());
+    while (pool->active) {
+        Request request;
+        {
+            pvd::Lock lock(pool->mutex);
+            if (!pool->requestQueue.empty()) {
+                request = pool->requestQueue.front();
+                pool->requestQueue.pop_front();
+                if (!pool->requestQueue.empty()) {
+                    // Wake up another worker
+                    pool->requestEvent.signal();
+                }
+            }
+        }
+        if (!request.serviceImplPtr) {
+            pool->requestEvent.wait(WorkerWaitTimeout);
+            continue;
+        }
+        try {
+            request.serviceImplPtr->execute(request.args, request.callback);
+        }
+        catch (const std::exception& ex) {
+            logger.error("RPC worker thread caught exception: %s", ex.what());
+        }
+        if (request.serviceImplPtr.unique()) {
+            // Service has been unregistered; it holds python object
+            PyGilManager::gilStateEnsure();
+            request.serviceImplPtr.reset();
+            PyGilManager::gilStateRelease();
+        }
+    }
+    logger.debug("Exiting RPC worker thread %s", epicsThreadGetNameSelf());
+    delete poolPtr;
+}
+
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
@@ -0,0 +1,62 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef RPC_WORKER_POOL_H
+#define RPC_WORKER_POOL_H
+
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+
+#include <deque>
+#include <epicsEvent.h>
+#include <epicsThread.h>
+#include "pv/pvData.h"
+#include "pv/rpcService.h"
+#include "PvaPyLogger.h"
+
+class RpcServiceAsyncImpl;
+
+// Fixed pool of worker threads that execute RPC requests for
+// asynchronous services of a single RPC server. Requests are executed
+// in the order they were submitted; concurrency limits are enforced
+// by services before requests are submitted to the pool.
+class RpcWorkerPool
+{
+public:
+    POINTER_DEFINITIONS(RpcWorkerPool);
+
+    static const double WorkerWaitTimeout;
+
+    RpcWorkerPool(int nWorkers);
+    virtual ~RpcWorkerPool();
+    int getNumWorkers() const;
+
+    // Worker threads keep pool alive until they exit, so that
+    // stop() does not need to wait for python services to return
+    static void start(const RpcWorkerPool::shared_pointer& poolPtr);
+    void stop();
+    bool isActive() const;
+
+    // Returns false if pool has been stopped
+    bool submit(const std::tr1::shared_ptr<RpcServiceAsyncImpl>& serviceImplPtr, const epics::pvData::PVStructurePtr& args, const epics::pvAccess::RPCResponseCallback::shared_pointer& callback);
+
+private:
+    struct Request
+    {
+        std::tr1::shared_ptr<RpcServiceAsyncImpl> serviceImplPtr;
+        epics::pvData::PVStructurePtr args;
+        epics::pvAccess::RPCResponseCallback::shared_pointer callback;
+    };
+
+    static PvaPyLogger logger;
+    static void workerThread(RpcWorkerPool::shared_pointer* poolPtr);
+
+    int nWorkers;
+    bool active;
+    epics::pvData::Mutex mutex;
+    std::deque<Request> requestQueue;
+    epicsEvent requestEvent;
+};
+
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+
+#endif
@@ -0,0 +1,36 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "SerializationContext.h"
+
+namespace pvd = epics::pvData;
+
+SerializationContext::SerializationContext()
+    : statePtr(new State())
+{
+}
+
+SerializationContext::SerializationContext(const SerializationContext& serializationContext)
+    : statePtr(serializationContext.statePtr)
+{
+}
+
+SerializationContext::~SerializationContext()
+{
+}
+
+void SerializationContext::reset()
+{
+    pvd::Lock lock(statePtr->mutex);
+    statePtr->streamContext.reset();
+}
+
+PvObjectSerializer::StreamContext* SerializationContext::getStreamContext()
+{
+    return &statePtr->streamContext;
+}
+
+pvd::Mutex& SerializationContext::getMutex()
+{
+    return statePtr->mutex;
+}
@@ -0,0 +1,34 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef SERIALIZATION_CONTEXT_H
+#define SERIALIZATION_CONTEXT_H
+
+#include <pv/lock.h>
+#include "PvObjectSerializer.h"
+
+// Serialization stream state shared by all copies of the context object.
+// Each end of the stream keeps its own context, so that introspection
+// data is sent only with the first object of a given type.
+class SerializationContext
+{
+public:
+    SerializationContext();
+    SerializationContext(const SerializationContext& serializationContext);
+    virtual ~SerializationContext();
+
+    void reset();
+
+    PvObjectSerializer::StreamContext* getStreamContext();
+    epics::pvData::Mutex& getMutex();
+
+private:
+    struct State
+    {
+        PvObjectSerializer::StreamContext streamContext;
+        epics::pvData::Mutex mutex;
+    };
+    std::tr1::shared_ptr<State> statePtr;
+};
+
+#endif
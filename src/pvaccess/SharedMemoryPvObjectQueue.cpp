@@ -0,0 +1,820 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include <string.h>
+#include <errno.h>
+#if !defined(_WIN32)
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif // if !defined(_WIN32)
+
+#include <epicsTime.h>
+#include "SharedMemoryPvObjectQueue.h"
+#include "PvObjectSerializer.h"
+#include "PvaPyConstants.h"
+#include "PyGilRelease.h"
+#include "PyUtility.h"
+#include "InvalidArgument.h"
+#include "InvalidRequest.h"
+#include "InvalidState.h"
+#include "ObjectAlreadyExists.h"
+#include "QueueEmpty.h"
+#include "QueueFull.h"
+
+namespace pvd = epics::pvData;
+namespace bp = boost::python;
+
+const int SharedMemoryPvObjectQueue::Unlimited(-1);
+const unsigned long long SharedMemoryPvObjectQueue::DefaultSegmentSize(256*1024*1024ULL);
+const unsigned long long SharedMemoryPvObjectQueue::MinSegmentSize(1024*1024ULL);
+const unsigned int SharedMemoryPvObjectQueue::IntrospectionTableSize(256*1024);
+
+static const pvd::uint32 SegmentMagic(0x50565351);    // "PVSQ"
+static const pvd::uint32 SegmentVersion(1);
+static const size_t SegmentAlignment(64);
+static const size_t RecordAlignment(32);
+
+enum RecordState {
+    RecordWriting = 1,
+    RecordReady,
+    RecordReading,
+    RecordReleased,
+    RecordSkipped
+};
+
+// Queue header at the start of the segment; positions are monotonic byte
+// offsets into the record ring. Records between release and read
+// positions have been claimed by consumers, and records between read and
+// write positions are being written, or are ready to be claimed.
+struct SharedMemoryQueueHeader
+{
+    pvd::uint32 magic;
+    pvd::uint32 version;
+    pvd::uint64 segmentSize;
+    pvd::uint64 tableOffset;
+    pvd::uint64 tableSize;
+    pvd::uint64 tableUsed;
+    pvd::uint64 dataOffset;
+    pvd::uint64 dataSize;
+    pvd::uint64 writePosition;
+    pvd::uint64 readPosition;
+    pvd::uint64 releasePosition;
+    pvd::uint32 nTableEntries;
+    pvd::int32 maxLength;
+    pvd::uint32 nPending;
+    pvd::uint32 nQueued;
+    pvd::uint32 nReceived;
+    pvd::uint32 nRejected;
+    pvd::uint32 nDelivered;
+    pvd::uint32 putCancelCount;     // cancels waitForPut() only
+    pvd::uint32 getCancelCount;     // cancels waitForGet() only
+    epicsTimeStamp lastPutTime;
+    epicsTimeStamp lastGetTime;
+#if !defined(_WIN32)
+    pthread_mutex_t mutex;
+    pthread_cond_t itemPushedCond;
+    pthread_cond_t itemPoppedCond;
+#endif // if !defined(_WIN32)
+};
+
+// Record header; serialized field data follows. Record sizes are
+// multiples of the header size, so that a padding record always fits
+// at the end of the ring.
+struct SharedMemoryRecordHeader
+{
+    pvd::uint32 state;
+    pvd::uint32 tableId;
+    pvd::uint64 recordSize;
+    pvd::uint64 dataSize;
+    pvd::uint64 reserved;
+};
+
+// Introspection table entry; introspection data follows
+struct SharedMemoryTableEntry
+{
+    pvd::uint32 tableId;
+    pvd::uint32 size;
+};
+
+static size_t alignSize(size_t size, size_t alignment)
+{
+    return (size + alignment - 1)/alignment*alignment;
+}
+
+//
+// Segment mapping
+//
+class SharedMemoryPvObjectQueue::Segment
+{
+public:
+    Segment(const std::string& name, int maxLength, unsigned long long segmentSize);
+    Segment(const std::string& name);
+    ~Segment();
+
+    void lock();
+    void unlock();
+    bool wait(bool itemPushed, double deadline, bool cancellable);
+    void broadcast(bool itemPushed);
+    static double getDeadline(double timeout);
+
+    SharedMemoryRecordHeader* getRecord(pvd::uint64 position) { return reinterpret_cast<SharedMemoryRecordHeader*>(data + position % header->dataSize); }
+    void releaseRecords();
+
+    std::string name;
+    size_t size;
+    char* base;
+    char* table;
+    char* data;
+    SharedMemoryQueueHeader* header;
+    bool owner;
+#if !defined(_WIN32)
+    pid_t ownerPid;
+#endif // if !defined(_WIN32)
+};
+
+class SegmentLock
+{
+public:
+    SegmentLock(SharedMemoryPvObjectQueue::Segment& segment_) : segment(segment_) { segment.lock(); }
+    ~SegmentLock() { segment.unlock(); }
+private:
+    SharedMemoryPvObjectQueue::Segment& segment;
+};
+
+static std::string getSegmentName(const std::string& name)
+{
+    if (name.empty()) {
+        throw InvalidArgument("Shared memory queue name cannot be empty.");
+    }
+    return (name[0] == '/' ? name : "/" + name);
+}
+
+#if !defined(_WIN32)
+
+SharedMemoryPvObjectQueue::Segment::Segment(const std::string& name_, int maxLength, unsigned long long segmentSize)
+    : name(getSegmentName(name_))
+    , size(segmentSize)
+    , base(NULL)
+    , table(NULL)
+    , data(NULL)
+    , header(NULL)
+    , owner(true)
+    , ownerPid(getpid())
+{
+    if (segmentSize < MinSegmentSize) {
+        throw InvalidArgument("Shared memory segment size must be at least %llu bytes.", MinSegmentSize);
+    }
+
+    // Existing segment may still be used by other processes, so it
+    // is never replaced
+    int fd = shm_open(name.c_str(), O_CREAT|O_EXCL|O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        throw ObjectAlreadyExists("Shared memory segment %s already exists.", name.c_str());
+    }
+    if (fd < 0) {
+        throw InvalidRequest("Cannot create shared memory segment %s: %s", name.c_str(), strerror(errno));
+    }
+    if (ftruncate(fd, size) != 0) {
+        int error = errno;
+        close(fd);
+        shm_unlink(name.c_str());
+        throw InvalidRequest("Cannot resize shared memory segment %s: %s", name.c_str(), strerror(error));
+    }
+    void* address = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        int error = errno;
+        shm_unlink(name.c_str());
+        throw InvalidRequest("Cannot map shared memory segment %s: %s", name.c_str(), strerror(error));
+    }
+    base = static_cast<char*>(address);
+    header = reinterpret_cast<SharedMemoryQueueHeader*>(base);
+    memset(header, 0, sizeof(SharedMemoryQueueHeader));
+    header->segmentSize = size;
+    header->tableOffset = alignSize(sizeof(SharedMemoryQueueHeader), SegmentAlignment);
+    header->tableSize = IntrospectionTableSize;
+    header->dataOffset = header->tableOffset + header->tableSize;
+    header->dataSize = (size - header->dataOffset)/RecordAlignment*RecordAlignment;
+    header->maxLength = maxLength;
+    epicsTimeGetCurrent(&header->lastPutTime);
+    epicsTimeGetCurrent(&header->lastGetTime);
+
+    pthread_mutexattr_t mutexAttr;
+    pthread_mutexattr_init(&mutexAttr);
+    pthread_mutexattr_setpshared(&mutexAttr, PTHREAD_PROCESS_SHARED);
+#if defined(__linux__)
+    // Allows recovery if process dies while holding the lock
+    pthread_mutexattr_setrobust(&mutexAttr, PTHREAD_MUTEX_ROBUST);
+#endif // if defined(__linux__)
+    pthread_mutex_init(&header->mutex, &mutexAttr);
+    pthread_mutexattr_destroy(&mutexAttr);
+
+    pthread_condattr_t condAttr;
+    pthread_condattr_init(&condAttr);
+    pthread_condattr_setpshared(&condAttr, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&header->itemPushedCond, &condAttr);
+    pthread_cond_init(&header->itemPoppedCond, &condAttr);
+    pthread_condattr_destroy(&condAttr);
+
+    table = base + header->tableOffset;
+    data = base + header->dataOffset;
+    header->version = SegmentVersion;
+    __sync_synchronize();
+    header->magic = SegmentMagic;
+}
+
+SharedMemoryPvObjectQueue::Segment::Segment(const std::string& name_)
+    : name(getSegmentName(name_))
+    , size(0)
+    , base(NULL)
+    , table(NULL)
+    , data(NULL)
+    , header(NULL)
+    , owner(false)
+    , ownerPid(0)
+{
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        throw InvalidRequest("Cannot open shared memory segment %s: %s", name.c_str(), strerror(errno));
+    }
+    struct stat fdStat;
+    if (fstat(fd, &fdStat) != 0 || size_t(fdStat.st_size) < sizeof(SharedMemoryQueueHeader)) {
+        close(fd);
+        throw InvalidRequest("Invalid shared memory segment %s.", name.c_str());
+    }
+    size = fdStat.st_size;
+    void* address = mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        throw InvalidRequest("Cannot map shared memory segment %s: %s", name.c_str(), strerror(errno));
+    }
+    base = static_cast<char*>(address);
+    header = reinterpret_cast<SharedMemoryQueueHeader*>(base);
+    if (header->magic != SegmentMagic || header->version != SegmentVersion || header->segmentSize != size) {
+        munmap(base, size);
+        throw InvalidRequest("Shared memory segment %s does not contain PvObject queue.", name.c_str());
+    }
+    table = base + header->tableOffset;
+    data = base + header->dataOffset;
+}
+
+SharedMemoryPvObjectQueue::Segment::~Segment()
+{
+    munmap(base, size);
+    // Forked children inherit owner's mapping, but not the segment
+    if (owner && ownerPid == getpid()) {
+        shm_unlink(name.c_str());
+    }
+}
+
+void SharedMemoryPvObjectQueue::Segment::lock()
+{
+#if defined(__linux__)
+    if (pthread_mutex_lock(&header->mutex) == EOWNERDEAD) {
+        pthread_mutex_consistent(&header->mutex);
+    }
+#else
+    pthread_mutex_lock(&header->mutex);
+#endif // if defined(__linux__)
+}
+
+void SharedMemoryPvObjectQueue::Segment::unlock()
+{
+    pthread_mutex_unlock(&header->mutex);
+}
+
+// Returns absolute deadline for a given timeout, or zero if
+// caller should not wait
+double SharedMemoryPvObjectQueue::Segment::getDeadline(double timeout)
+{
+    if (timeout <= 0) {
+        return 0;
+    }
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return now.tv_sec + now.tv_nsec*1.0e-9 + timeout;
+}
+
+// Must be called with the lock held; returns false once deadline
+// expires, or if cancellable wait was cancelled. Callers waiting in
+// a loop pass the same deadline, so that wakeups consumed by other
+// processes do not extend the wait.
+bool SharedMemoryPvObjectQueue::Segment::wait(bool itemPushed, double deadline, bool cancellable)
+{
+    if (deadline <= 0) {
+        return false;
+    }
+    struct timespec deadlineSpec;
+    deadlineSpec.tv_sec = time_t(deadline);
+    deadlineSpec.tv_nsec = long((deadline - deadlineSpec.tv_sec)*1.0e9);
+
+    pvd::uint32* cancelCount = NULL;
+    if (cancellable) {
+        cancelCount = (itemPushed ? &header->putCancelCount : &header->getCancelCount);
+    }
+    pvd::uint32 cancelCount0 = (cancelCount ? *cancelCount : 0);
+    pthread_cond_t* cond = (itemPushed ? &header->itemPushedCond : &header->itemPoppedCond);
+    int result = pthread_cond_timedwait(cond, &header->mutex, &deadlineSpec);
+#if defined(__linux__)
+    if (result == EOWNERDEAD) {
+        pthread_mutex_consistent(&header->mutex);
+    }
+#endif // if defined(__linux__)
+    return (result != ETIMEDOUT && (!cancelCount || *cancelCount == cancelCount0));
+}
+
+void SharedMemoryPvObjectQueue::Segment::broadcast(bool itemPushed)
+{
+    pthread_cond_broadcast(itemPushed ? &header->itemPushedCond : &header->itemPoppedCond);
+}
+
+#else
+
+SharedMemoryPvObjectQueue::Segment::Segment(const std::string&, int, unsigned long long)
+{
+    throw InvalidRequest("Shared memory queues are not supported on this platform.");
+}
+
+SharedMemoryPvObjectQueue::Segment::Segment(const std::string&)
+{
+    throw InvalidRequest("Shared memory queues are not supported on this platform.");
+}
+
+SharedMemoryPvObjectQueue::Segment::~Segment() {}
+void SharedMemoryPvObjectQueue::Segment::lock() {}
+void SharedMemoryPvObjectQueue::Segment::unlock() {}
+bool SharedMemoryPvObjectQueue::Segment::wait(bool, double, bool) { return false; }
+void SharedMemoryPvObjectQueue::Segment::broadcast(bool) {}
+double SharedMemoryPvObjectQueue::Segment::getDeadline(double) { return 0; }
+
+#endif // if !defined(_WIN32)
+
+// Must be called with the lock held; advances release position over
+// consecutive records that are no longer in use
+void SharedMemoryPvObjectQueue::Segment::releaseRecords()
+{
+    while (header->releasePosition < header->readPosition) {
+        SharedMemoryRecordHeader* record = getRecord(header->releasePosition);
+        if (record->state != RecordReleased && record->state != RecordSkipped) {
+            break;
+        }
+        header->releasePosition += record->recordSize;
+    }
+    broadcast(false);
+}
+
+//
+// Record lease; record is released when the last reference is gone
+//
+class SharedMemoryPvObjectQueue::RecordLease
+{
+public:
+    RecordLease(const SegmentPtr& segmentPtr_, SharedMemoryRecordHeader* record_) : segmentPtr(segmentPtr_), record(record_) {}
+    ~RecordLease()
+    {
+        SegmentLock lock(*segmentPtr);
+        record->state = RecordReleased;
+        segmentPtr->releaseRecords();
+    }
+private:
+    SegmentPtr segmentPtr;
+    SharedMemoryRecordHeader* record;
+};
+
+//
+// Queue
+//
+SharedMemoryPvObjectQueue::SharedMemoryPvObjectQueue(const std::string& name)
+    : segmentPtr(new Segment(name))
+    , localStatePtr(new LocalState())
+{
+}
+
+SharedMemoryPvObjectQueue::SharedMemoryPvObjectQueue(const std::string& name, int maxLength, unsigned long long segmentSize)
+    : segmentPtr(new Segment(name, maxLength, segmentSize))
+    , localStatePtr(new LocalState())
+{
+}
+
+SharedMemoryPvObjectQueue::SharedMemoryPvObjectQueue(const SharedMemoryPvObjectQueue& queue)
+    : segmentPtr(queue.segmentPtr)
+    , localStatePtr(queue.localStatePtr)
+{
+}
+
+SharedMemoryPvObjectQueue::~SharedMemoryPvObjectQueue()
+{
+}
+
+std::string SharedMemoryPvObjectQueue::getName() const
+{
+    return segmentPtr->name;
+}
+
+unsigned long long SharedMemoryPvObjectQueue::getSegmentSize() const
+{
+    return segmentPtr->size;
+}
+
+void SharedMemoryPvObjectQueue::setMaxLength(int maxLength)
+{
+    SegmentLock lock(*segmentPtr);
+    segmentPtr->header->maxLength = maxLength;
+    segmentPtr->broadcast(false);
+}
+
+int SharedMemoryPvObjectQueue::getMaxLength()
+{
+    SegmentLock lock(*segmentPtr);
+    return segmentPtr->header->maxLength;
+}
+
+unsigned int SharedMemoryPvObjectQueue::size()
+{
+    SegmentLock lock(*segmentPtr);
+    return segmentPtr->header->nQueued;
+}
+
+bool SharedMemoryPvObjectQueue::isEmpty()
+{
+    return size() == 0;
+}
+
+unsigned int SharedMemoryPvObjectQueue::getIntrospectionTableId(const pvd::StructureConstPtr& structurePtr)
+{
+    {
+        pvd::Lock lock(localStatePtr->mutex);
+        std::map<pvd::StructureConstPtr, unsigned int>::const_iterator it = localStatePtr->tableIdMap.find(structurePtr);
+        if (it != localStatePtr->tableIdMap.end()) {
+            return it->second;
+        }
+    }
+
+    std::string introspectionData = PvObjectSerializer::getIntrospectionData(structurePtr);
+    unsigned int tableId = 0;
+    {
+        SegmentLock lock(*segmentPtr);
+        SharedMemoryQueueHeader* header = segmentPtr->header;
+        size_t offset = 0;
+        for (unsigned int i = 0; i < header->nTableEntries; i++) {
+            SharedMemoryTableEntry* entry = reinterpret_cast<SharedMemoryTableEntry*>(segmentPtr->table + offset);
+            if (entry->size == introspectionData.size() && memcmp(entry+1, introspectionData.data(), entry->size) == 0) {
+                tableId = entry->tableId;
+                break;
+            }
+            offset += alignSize(sizeof(SharedMemoryTableEntry) + entry->size, PvObjectSerializer::ArrayAlignment);
+        }
+        if (!tableId) {
+            size_t entrySize = alignSize(sizeof(SharedMemoryTableEntry) + introspectionData.size(), PvObjectSerializer::ArrayAlignment);
+            if (header->tableUsed + entrySize > header->tableSize) {
+                throw InvalidState("Introspection table of shared memory queue %s is full.", segmentPtr->name.c_str());
+            }
+            SharedMemoryTableEntry* entry = reinterpret_cast<SharedMemoryTableEntry*>(segmentPtr->table + header->tableUsed);
+            entry->tableId = header->nTableEntries + 1;
+            entry->size = introspectionData.size();
+            memcpy(entry+1, introspectionData.data(), entry->size);
+            header->tableUsed += entrySize;
+            header->nTableEntries++;
+            tableId = entry->tableId;
+        }
+    }
+
+    pvd::Lock lock(localStatePtr->mutex);
+    localStatePtr->tableIdMap[structurePtr] = tableId;
+    return tableId;
+}
+
+pvd::StructureConstPtr SharedMemoryPvObjectQueue::getIntrospectionTableStructure(unsigned int tableId)
+{
+    {
+        pvd::Lock lock(localStatePtr->mutex);
+        std::map<unsigned int, pvd::StructureConstPtr>::const_iterator it = localStatePtr->structureMap.find(tableId);
+        if (it != localStatePtr->structureMap.end()) {
+            return it->second;
+        }
+    }
+
+    std::string introspectionData;
+    {
+        SegmentLock lock(*segmentPtr);
+        SharedMemoryQueueHeader* header = segmentPtr->header;
+        size_t offset = 0;
+        for (unsigned int i = 0; i < header->nTableEntries; i++) {
+            SharedMemoryTableEntry* entry = reinterpret_cast<SharedMemoryTableEntry*>(segmentPtr->table + offset);
+            if (entry->tableId == tableId) {
+                introspectionData.assign(reinterpret_cast<const char*>(entry+1), entry->size);
+                break;
+            }
+            offset += alignSize(sizeof(SharedMemoryTableEntry) + entry->size, PvObjectSerializer::ArrayAlignment);
+        }
+    }
+    if (introspectionData.empty()) {
+        throw InvalidState("Introspection table of shared memory queue %s does not contain entry %u.", segmentPtr->name.c_str(), tableId);
+    }
+
+    pvd::StructureConstPtr structurePtr = PvObjectSerializer::getStructure(introspectionData);
+    pvd::Lock lock(localStatePtr->mutex);
+    localStatePtr->structureMap[tableId] = structurePtr;
+    return structurePtr;
+}
+
+SharedMemoryRecordHeader* SharedMemoryPvObjectQueue::reserveRecord(size_t recordSize, unsigned int tableId, double deadline)
+{
+    SegmentLock lock(*segmentPtr);
+    SharedMemoryQueueHeader* header = segmentPtr->header;
+    if (recordSize > header->dataSize) {
+        header->nRejected++;
+        throw InvalidArgument("Object size of %llu bytes exceeds capacity of shared memory queue %s.", (unsigned long long)recordSize, segmentPtr->name.c_str());
+    }
+    while (true) {
+        if (header->writePosition == header->releasePosition) {
+            // Ring is empty, start from the beginning
+            pvd::uint64 position = alignSize(header->writePosition, header->dataSize);
+            header->writePosition = position;
+            header->readPosition = position;
+            header->releasePosition = position;
+        }
+        if (header->maxLength <= 0 || header->nPending < pvd::uint32(header->maxLength)) {
+            pvd::uint64 contiguous = header->dataSize - header->writePosition % header->dataSize;
+            pvd::uint64 available = header->dataSize - (header->writePosition - header->releasePosition);
+            pvd::uint64 needed = recordSize + (recordSize > contiguous ? contiguous : 0);
+            if (needed <= available) {
+                if (recordSize > contiguous) {
+                    // Skip to the beginning of the ring
+                    SharedMemoryRecordHeader* padding = segmentPtr->getRecord(header->writePosition);
+                    padding->state = RecordSkipped;
+                    padding->recordSize = contiguous;
+                    header->writePosition += contiguous;
+                }
+                SharedMemoryRecordHeader* record = segmentPtr->getRecord(header->writePosition);
+                record->state = RecordWriting;
+                record->tableId = tableId;
+                record->recordSize = recordSize;
+                record->dataSize = 0;
+                header->writePosition += recordSize;
+                header->nPending++;
+                return record;
+            }
+        }
+        if (!segmentPtr->wait(false, deadline, false)) {
+            header->nRejected++;
+            throw QueueFull("Shared memory queue %s is full.", segmentPtr->name.c_str());
+        }
+    }
+}
+
+SharedMemoryRecordHeader* SharedMemoryPvObjectQueue::claimRecord(double deadline)
+{
+    SegmentLock lock(*segmentPtr);
+    SharedMemoryQueueHeader* header = segmentPtr->header;
+    while (true) {
+        while (header->readPosition < header->writePosition) {
+            SharedMemoryRecordHeader* record = segmentPtr->getRecord(header->readPosition);
+            if (record->state == RecordSkipped) {
+                header->readPosition += record->recordSize;
+                continue;
+            }
+            if (record->state != RecordReady) {
+                // Record is still being written
+                break;
+            }
+            record->state = RecordReading;
+            header->readPosition += record->recordSize;
+            header->nQueued--;
+            header->nPending--;
+            header->nDelivered++;
+            epicsTimeGetCurrent(&header->lastGetTime);
+            segmentPtr->broadcast(false);
+            return record;
+        }
+        if (!segmentPtr->wait(true, deadline, false)) {
+            throw QueueEmpty("Shared memory queue %s is empty.", segmentPtr->name.c_str());
+        }
+    }
+}
+
+void SharedMemoryPvObjectQueue::push(const PvObject& pvObject, double timeout)
+{
+    double deadline = Segment::getDeadline(timeout);
+    pvd::PVStructurePtr pvStructurePtr = pvObject.getPvStructurePtr();
+    unsigned int tableId = getIntrospectionTableId(pvStructurePtr->getStructure());
+    size_t dataSize = PvObjectSerializer::getSerializedDataSize(pvStructurePtr, true);
+    size_t recordSize = alignSize(sizeof(SharedMemoryRecordHeader) + dataSize, RecordAlignment);
+    SharedMemoryRecordHeader* record = reserveRecord(recordSize, tableId, deadline);
+
+    // Data is serialized without holding the lock
+    try {
+        record->dataSize = PvObjectSerializer::serializeData(pvStructurePtr, reinterpret_cast<char*>(record+1), dataSize, true);
+    }
+    catch (...) {
+        SegmentLock lock(*segmentPtr);
+        record->state = RecordSkipped;
+        segmentPtr->header->nPending--;
+        segmentPtr->header->nRejected++;
+        segmentPtr->broadcast(true);
+        throw;
+    }
+
+    SegmentLock lock(*segmentPtr);
+    SharedMemoryQueueHeader* header = segmentPtr->header;
+    record->state = RecordReady;
+    header->nQueued++;
+    header->nReceived++;
+    epicsTimeGetCurrent(&header->lastPutTime);
+    segmentPtr->broadcast(true);
+}
+
+pvd::PVStructurePtr SharedMemoryPvObjectQueue::pop(double timeout, bool view)
+{
+    SharedMemoryRecordHeader* record = claimRecord(Segment::getDeadline(timeout));
+    std::tr1::shared_ptr<RecordLease> leasePtr(new RecordLease(segmentPtr, record));
+    pvd::StructureConstPtr structurePtr = getIntrospectionTableStructure(record->tableId);
+    const char* data = reinterpret_cast<const char*>(record+1);
+    if (view) {
+        return PvObjectSerializer::deserializeData(structurePtr, data, record->dataSize, true, leasePtr);
+    }
+    return PvObjectSerializer::deserializeData(structurePtr, data, record->dataSize, true);
+}
+
+PvObject SharedMemoryPvObjectQueue::get()
+{
+    return get(0);
+}
+
+PvObject SharedMemoryPvObjectQueue::get(double timeout)
+{
+    pvd::PVStructurePtr pvStructurePtr;
+    if (PyGILState_Check()) {
+        PyGilRelease pyGilRelease;
+        pvStructurePtr = pop(timeout, false);
+    }
+    else {
+        pvStructurePtr = pop(timeout, false);
+    }
+    return PvObject(pvStructurePtr);
+}
+
+PvObject SharedMemoryPvObjectQueue::getView()
+{
+    return getView(0);
+}
+
+PvObject SharedMemoryPvObjectQueue::getView(double timeout)
+{
+    pvd::PVStructurePtr pvStructurePtr;
+    if (PyGILState_Check()) {
+        PyGilRelease pyGilRelease;
+        pvStructurePtr = pop(timeout, true);
+    }
+    else {
+        pvStructurePtr = pop(timeout, true);
+    }
+    return PvObject(pvStructurePtr);
+}
+
+void SharedMemoryPvObjectQueue::put(const PvObject& pvObject)
+{
+    put(pvObject, 0);
+}
+
+void SharedMemoryPvObjectQueue::put(const PvObject& pvObject, double timeout)
+{
+    if (PyGILState_Check()) {
+        PyGilRelease pyGilRelease;
+        push(pvObject, timeout);
+    }
+    else {
+        push(pvObject, timeout);
+    }
+}
+
+void SharedMemoryPvObjectQueue::waitForItem(bool itemPushed, double timeout)
+{
+    SegmentLock lock(*segmentPtr);
+    segmentPtr->wait(itemPushed, Segment::getDeadline(timeout), true);
+}
+
+void SharedMemoryPvObjectQueue::waitForPut(double timeout)
+{
+    PyGilRelease pyGilRelease;
+    waitForItem(true, timeout);
+}
+
+void SharedMemoryPvObjectQueue::waitForGet(double timeout)
+{
+    PyGilRelease pyGilRelease;
+    waitForItem(false, timeout);
+}
+
+void SharedMemoryPvObjectQueue::cancelWaitForPut()
+{
+    SegmentLock lock(*segmentPtr);
+    segmentPtr->header->putCancelCount++;
+    segmentPtr->broadcast(true);
+}
+
+void SharedMemoryPvObjectQueue::cancelWaitForGet()
+{
+    SegmentLock lock(*segmentPtr);
+    segmentPtr->header->getCancelCount++;
+    segmentPtr->broadcast(false);
+}
+
+// Records that are being written, or are in use by consumers are kept
+void SharedMemoryPvObjectQueue::clear()
+{
+    SegmentLock lock(*segmentPtr);
+    SharedMemoryQueueHeader* header = segmentPtr->header;
+    while (header->readPosition < header->writePosition) {
+        SharedMemoryRecordHeader* record = segmentPtr->getRecord(header->readPosition);
+        if (record->state == RecordReady) {
+            record->state = RecordReleased;
+            header->nQueued--;
+            header->nPending--;
+        }
+        else if (record->state != RecordSkipped) {
+            break;
+        }
+        header->readPosition += record->recordSize;
+    }
+    segmentPtr->releaseRecords();
+}
+
+void SharedMemoryPvObjectQueue::resetCounters()
+{
+    {
+        SegmentLock lock(*segmentPtr);
+        SharedMemoryQueueHeader* header = segmentPtr->header;
+        header->nReceived = 0;
+        header->nRejected = 0;
+        header->nDelivered = 0;
+    }
+    pvd::Lock lock(localStatePtr->mutex);
+    typedef std::map<std::string, unsigned int>::iterator MI;
+    for (MI it = localStatePtr->counterMap.begin(); it != localStatePtr->counterMap.end(); it++) {
+        it->second = 0;
+    }
+}
+
+bp::dict SharedMemoryPvObjectQueue::getCounters()
+{
+    std::map<std::string, unsigned int> counterMap;
+    {
+        pvd::Lock lock(localStatePtr->mutex);
+        counterMap = localStatePtr->counterMap;
+    }
+    SegmentLock lock(*segmentPtr);
+    SharedMemoryQueueHeader* header = segmentPtr->header;
+    counterMap[PvaPyConstants::NumReceivedCounterKey] = header->nReceived;
+    counterMap[PvaPyConstants::NumRejectedCounterKey] = header->nRejected;
+    counterMap[PvaPyConstants::NumDeliveredCounterKey] = header->nDelivered;
+    counterMap[PvaPyConstants::NumQueuedCounterKey] = header->nQueued;
+    counterMap[PvaPyConstants::NumWritingCounterKey] = header->nPending - header->nQueued;
+
+    // Claimed records are released in ring order, so records still held
+    // by consumers (e.g., views) or by producers that died while writing
+    // prevent reuse of all records that follow them
+    unsigned int nInUse = 0;
+    pvd::uint64 position = header->releasePosition;
+    while (position < header->readPosition) {
+        SharedMemoryRecordHeader* record = segmentPtr->getRecord(position);
+        if (record->state == RecordReading) {
+            nInUse++;
+        }
+        position += record->recordSize;
+    }
+    counterMap[PvaPyConstants::NumInUseCounterKey] = nInUse;
+    return PyUtility::mapToDict<std::string,unsigned int>(counterMap);
+}
+
+void SharedMemoryPvObjectQueue::setCounter(const std::string& key, unsigned int value)
+{
+    pvd::Lock lock(localStatePtr->mutex);
+    localStatePtr->counterMap[key] = value;
+}
+
+void SharedMemoryPvObjectQueue::addToCounter(const std::string& key, unsigned int value)
+{
+    pvd::Lock lock(localStatePtr->mutex);
+    localStatePtr->counterMap[key] += value;
+}
+
+double SharedMemoryPvObjectQueue::getTimeSinceLastPut()
+{
+    epicsTimeStamp ts;
+    epicsTimeGetCurrent(&ts);
+    SegmentLock lock(*segmentPtr);
+    return epicsTimeDiffInSeconds(&ts, &segmentPtr->header->lastPutTime);
+}
+
+double SharedMemoryPvObjectQueue::getTimeSinceLastGet()
+{
+    epicsTimeStamp ts;
+    epicsTimeGetCurrent(&ts);
+    SegmentLock lock(*segmentPtr);
+    return epicsTimeDiffInSeconds(&ts, &segmentPtr->header->lastGetTime);
+}
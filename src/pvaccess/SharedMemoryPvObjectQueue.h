@@ -0,0 +1,117 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef SHARED_MEMORY_PV_OBJECT_QUEUE_H
+#define SHARED_MEMORY_PV_OBJECT_QUEUE_H
+
+#include <string>
+#include <map>
+
+#include "boost/python/module.hpp"
+#include "boost/python/dict.hpp"
+#include "boost/python/tuple.hpp"
+#include "pv/pvData.h"
+#include "PvObject.h"
+
+struct SharedMemoryQueueHeader;
+struct SharedMemoryRecordHeader;
+
+// Queue of PvObjects stored in a POSIX shared memory segment, which can
+// be used for passing objects between processes without pickling.
+// Segment contains queue header with process-shared mutex and condition
+// variables, introspection table, and a ring of records that hold
+// serialized object field data. Introspection data for each structure
+// type is stored in the table once, and records reference it by table id.
+// Array data is serialized with alignment, so that consumers can either
+// copy objects out of the segment, or get objects whose numeric arrays
+// reference segment memory directly; in the latter case the record space
+// is released only after all such arrays are gone.
+//
+// Queue created with maximum length and segment size owns the segment,
+// which is removed when the owner is destroyed; creating a queue fails
+// if segment with the same name already exists. Other processes attach
+// to the existing segment by name. Any number of producers and consumers
+// can use the queue at the same time.
+class SharedMemoryPvObjectQueue
+{
+public:
+    POINTER_DEFINITIONS(SharedMemoryPvObjectQueue);
+
+    static const int Unlimited;
+    static const unsigned long long DefaultSegmentSize;
+    static const unsigned long long MinSegmentSize;
+    static const unsigned int IntrospectionTableSize;
+
+    SharedMemoryPvObjectQueue(const std::string& name);
+    SharedMemoryPvObjectQueue(const std::string& name, int maxLength, unsigned long long segmentSize=DefaultSegmentSize);
+    SharedMemoryPvObjectQueue(const SharedMemoryPvObjectQueue& queue);
+    virtual ~SharedMemoryPvObjectQueue();
+
+    std::string getName() const;
+    unsigned long long getSegmentSize() const;
+    void setMaxLength(int maxLength);
+    int getMaxLength();
+    unsigned int size();
+    bool isEmpty();
+
+    // Python interface
+    PvObject get();
+    PvObject get(double timeout);
+    PvObject getView();
+    PvObject getView(double timeout);
+    void put(const PvObject& pvObject);
+    void put(const PvObject& pvObject, double timeout);
+    void waitForPut(double timeout);
+    void waitForGet(double timeout);
+    void cancelWaitForPut();
+    void cancelWaitForGet();
+    void clear();
+    void resetCounters();
+    boost::python::dict getCounters();
+    void setCounter(const std::string& key, unsigned int value);
+    void addToCounter(const std::string& key, unsigned int value);
+    double getTimeSinceLastPut();
+    double getTimeSinceLastGet();
+
+    // Segment mapping, shared by queue copies and by arrays that
+    // reference segment memory
+    class Segment;
+    typedef std::tr1::shared_ptr<Segment> SegmentPtr;
+
+private:
+    class RecordLease;
+
+    // Process-local state shared by queue copies: introspection table
+    // ids of known structures and vice versa, and user counters
+    struct LocalState
+    {
+        epics::pvData::Mutex mutex;
+        std::map<epics::pvData::StructureConstPtr, unsigned int> tableIdMap;
+        std::map<unsigned int, epics::pvData::StructureConstPtr> structureMap;
+        std::map<std::string, unsigned int> counterMap;
+    };
+    typedef std::tr1::shared_ptr<LocalState> LocalStatePtr;
+
+    unsigned int getIntrospectionTableId(const epics::pvData::StructureConstPtr& structurePtr);
+    epics::pvData::StructureConstPtr getIntrospectionTableStructure(unsigned int tableId);
+    void push(const PvObject& pvObject, double timeout);
+    epics::pvData::PVStructurePtr pop(double timeout, bool view);
+    SharedMemoryRecordHeader* reserveRecord(size_t recordSize, unsigned int tableId, double deadline);
+    SharedMemoryRecordHeader* claimRecord(double deadline);
+    void waitForItem(bool pushed, double timeout);
+
+    SegmentPtr segmentPtr;
+    LocalStatePtr localStatePtr;
+};
+
+// Unpickled queues attach to the existing segment, which allows passing
+// queues to processes started with the spawn method
+struct SharedMemoryPvObjectQueuePickleSuite : boost::python::pickle_suite
+{
+    static boost::python::tuple getinitargs(const SharedMemoryPvObjectQueue& queue)
+    {
+        return boost::python::make_tuple(queue.getName());
+    }
+};
+
+#endif
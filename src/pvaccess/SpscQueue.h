@@ -0,0 +1,466 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <new>
+#include <string>
+#include <map>
+#include <epicsEvent.h>
+#include <epicsTime.h>
+#include <epicsAtomic.h>
+#include <pv/pvData.h>
+#include "QueueEmpty.h"
+#include "QueueFull.h"
+#include "InvalidArgument.h"
+#include "PvaPyConstants.h"
+
+// Bounded lock-free single-producer/single-consumer ring buffer with
+// the same interface as SynchronizedQueue. Push methods must be called
+// from a single producer thread, and front/pop methods from a single
+// consumer thread. Wait events are signaled only when the other
+// side is actually waiting, and counters are updated atomically, so
+// there are no mutexes or clock reads on the data path. Push and pop
+// times are therefore determined when they are queried, with the
+// resolution of calls to getTimeSinceLastPush()/getTimeSinceLastPop().
+template <class T>
+class SpscQueue
+{
+public:
+    POINTER_DEFINITIONS(SpscQueue<T>);
+
+    SpscQueue(int maxLength);
+    virtual ~SpscQueue();
+    void setMaxLength(int maxLength);
+    int getMaxLength();
+    int getCapacity();
+    bool isFull();
+    bool isEmpty();
+    unsigned int size();
+    T back();
+    T front();
+    T frontAndPop();
+    T frontAndPop(double timeout);
+    void pop();
+    void push(const T& t);
+    void push(const T& t, double timeout);
+
+    // No exception, return true if operation succeeded
+    bool popIfNotEmpty();
+    bool pushIfNotFull(const T& t);
+
+    void waitForItemPushed(double timeout);
+    void waitForItemPushedIfEmpty(double timeout);
+    void waitForItemPopped(double timeout);
+    void waitForItemPoppedIfFull(double timeout);
+    void cancelWaitForItemPushed();
+    void cancelWaitForItemPopped();
+    void clear();
+
+    // Statistics
+    void resetCounters();
+    const std::map<std::string,unsigned int>& getCounterMap();
+    void setCounter(const std::string& key, unsigned int value);
+    void addToCounter(const std::string& key, unsigned int value);
+    double getTimeSinceLastPush();
+    double getTimeSinceLastPop();
+
+private:
+    SpscQueue(const SpscQueue& q);
+    SpscQueue& operator=(const SpscQueue& q);
+
+    bool tryPop();
+    bool tryPush(const T& t);
+    void notifyConsumer();
+    void notifyProducer();
+
+    T* slots;
+    size_t capacityMask;
+    int maxLength;
+
+    // Head is written only by consumer, tail only by producer
+    size_t head;
+    size_t tail;
+    int consumerWaiting;
+    int producerWaiting;
+
+    epicsEvent itemPushedEvent;
+    epicsEvent itemPoppedEvent;
+
+    // Statistics counters, incremented atomically
+    size_t nReceived;
+    size_t nRejected;
+    size_t nDelivered;
+
+    // Counter map and push/pop times are guarded by mutex; times
+    // are updated when counter changes are observed
+    epics::pvData::Mutex counterMutex;
+    std::map<std::string, unsigned int> counterMap;
+    size_t nObservedReceived;
+    size_t nObservedDelivered;
+    epicsTimeStamp lastPushedTime;
+    epicsTimeStamp lastPoppedTime;
+};
+
+template <class T>
+SpscQueue<T>::SpscQueue(int maxLength_)
+    : slots(0)
+    , capacityMask(0)
+    , maxLength(maxLength_)
+    , head(0)
+    , tail(0)
+    , consumerWaiting(0)
+    , producerWaiting(0)
+    , itemPushedEvent()
+    , itemPoppedEvent()
+    , nReceived(0)
+    , nRejected(0)
+    , nDelivered(0)
+    , counterMutex()
+    , counterMap()
+    , nObservedReceived(0)
+    , nObservedDelivered(0)
+    , lastPushedTime()
+    , lastPoppedTime()
+{
+    if (maxLength <= 0) {
+        throw InvalidArgument("Lock-free queue requires positive maximum length.");
+    }
+    // Round capacity up to power of two, so that slot index is a simple mask
+    size_t capacity = 1;
+    while (capacity < size_t(maxLength)) {
+        capacity <<= 1;
+    }
+    capacityMask = capacity - 1;
+    slots = static_cast<T*>(::operator new(capacity*sizeof(T)));
+    epicsTimeGetCurrent(&lastPushedTime);
+    lastPoppedTime = lastPushedTime;
+}
+
+template <class T>
+SpscQueue<T>::~SpscQueue()
+{
+    for (size_t i = head; i != tail; i++) {
+        slots[i & capacityMask].~T();
+    }
+    ::operator delete(slots);
+    itemPushedEvent.signal();
+    itemPoppedEvent.signal();
+}
+
+template <class T>
+int SpscQueue<T>::getMaxLength()
+{
+    return epicsAtomicGetIntT(&maxLength);
+}
+
+template <class T>
+int SpscQueue<T>::getCapacity()
+{
+    return int(capacityMask + 1);
+}
+
+template <class T>
+void SpscQueue<T>::setMaxLength(int maxLength)
+{
+    if (maxLength <= 0 || maxLength > getCapacity()) {
+        throw InvalidArgument("Lock-free queue length must be between 1 and its capacity of %d.", getCapacity());
+    }
+    epicsAtomicSetIntT(&this->maxLength, maxLength);
+}
+
+template <class T>
+unsigned int SpscQueue<T>::size()
+{
+    size_t h = epicsAtomicGetSizeT(&head);
+    size_t t = epicsAtomicGetSizeT(&tail);
+    return t - h;
+}
+
+template <class T>
+bool SpscQueue<T>::isFull()
+{
+    return size() >= (unsigned int)getMaxLength();
+}
+
+template <class T>
+bool SpscQueue<T>::isEmpty()
+{
+    return size() == 0;
+}
+
+// Called by consumer only.
+template <class T>
+T SpscQueue<T>::front()
+{
+    size_t h = head;
+    if (h == epicsAtomicGetSizeT(&tail)) {
+        throw QueueEmpty("Queue is empty.");
+    }
+    return slots[h & capacityMask];
+}
+
+// Called by producer only.
+template <class T>
+T SpscQueue<T>::back()
+{
+    size_t t = tail;
+    if (epicsAtomicGetSizeT(&head) == t) {
+        throw QueueEmpty("Queue is empty.");
+    }
+    return slots[(t-1) & capacityMask];
+}
+
+template <class T>
+bool SpscQueue<T>::tryPop()
+{
+    size_t h = head;
+    if (h == epicsAtomicGetSizeT(&tail)) {
+        return false;
+    }
+    slots[h & capacityMask].~T();
+    // Slot is released to the producer only after object is destroyed
+    epicsAtomicSetSizeT(&head, h+1);
+    epicsAtomicIncrSizeT(&nDelivered);
+    notifyProducer();
+    return true;
+}
+
+template <class T>
+bool SpscQueue<T>::tryPush(const T& t)
+{
+    size_t tl = tail;
+    if (tl - epicsAtomicGetSizeT(&head) >= size_t(getMaxLength())) {
+        return false;
+    }
+    new (&slots[tl & capacityMask]) T(t);
+    // Object is published to the consumer only after it is constructed
+    epicsAtomicSetSizeT(&tail, tl+1);
+    epicsAtomicIncrSizeT(&nReceived);
+    notifyConsumer();
+    return true;
+}
+
+// Compare-and-swap acts as a full memory barrier, so either the waiting
+// side sees the new head/tail index, or we see its waiting flag.
+template <class T>
+void SpscQueue<T>::notifyConsumer()
+{
+    if (epicsAtomicCmpAndSwapIntT(&consumerWaiting, 1, 0) == 1) {
+        itemPushedEvent.signal();
+    }
+}
+
+template <class T>
+void SpscQueue<T>::notifyProducer()
+{
+    if (epicsAtomicCmpAndSwapIntT(&producerWaiting, 1, 0) == 1) {
+        itemPoppedEvent.signal();
+    }
+}
+
+template <class T>
+T SpscQueue<T>::frontAndPop()
+{
+    size_t h = head;
+    if (h == epicsAtomicGetSizeT(&tail)) {
+        throw QueueEmpty("Queue is empty.");
+    }
+    T t(slots[h & capacityMask]);
+    tryPop();
+    return t;
+}
+
+template <class T>
+T SpscQueue<T>::frontAndPop(double timeout)
+{
+    if (isEmpty()) {
+        waitForItemPushedIfEmpty(timeout);
+    }
+    return frontAndPop();
+}
+
+template <class T>
+void SpscQueue<T>::pop()
+{
+    if (!tryPop()) {
+        throw QueueEmpty("Queue is empty.");
+    }
+}
+
+template <class T>
+bool SpscQueue<T>::popIfNotEmpty()
+{
+    return tryPop();
+}
+
+template <class T>
+void SpscQueue<T>::push(const T& t)
+{
+    if (!tryPush(t)) {
+        // We are full, throw exception
+        epicsAtomicIncrSizeT(&nRejected);
+        throw QueueFull("Queue is full.");
+    }
+}
+
+template <class T>
+void SpscQueue<T>::push(const T& t, double timeout)
+{
+    if (tryPush(t)) {
+        return;
+    }
+    waitForItemPoppedIfFull(timeout);
+    push(t);
+}
+
+template <class T>
+bool SpscQueue<T>::pushIfNotFull(const T& t)
+{
+    if (!tryPush(t)) {
+        // We are full, ignore push request
+        epicsAtomicIncrSizeT(&nRejected);
+        return false;
+    }
+    return true;
+}
+
+template <class T>
+void SpscQueue<T>::waitForItemPushed(double timeout)
+{
+    epicsAtomicCmpAndSwapIntT(&consumerWaiting, 0, 1);
+    itemPushedEvent.wait(timeout);
+    epicsAtomicSetIntT(&consumerWaiting, 0);
+}
+
+template <class T>
+void SpscQueue<T>::waitForItemPushedIfEmpty(double timeout)
+{
+    // Clear push event before announcing that we are waiting
+    itemPushedEvent.tryWait();
+    epicsAtomicCmpAndSwapIntT(&consumerWaiting, 0, 1);
+    if (isEmpty()) {
+        // Queue is empty, wait for push
+        itemPushedEvent.wait(timeout);
+    }
+    epicsAtomicSetIntT(&consumerWaiting, 0);
+}
+
+template <class T>
+void SpscQueue<T>::waitForItemPopped(double timeout)
+{
+    epicsAtomicCmpAndSwapIntT(&producerWaiting, 0, 1);
+    itemPoppedEvent.wait(timeout);
+    epicsAtomicSetIntT(&producerWaiting, 0);
+}
+
+template <class T>
+void SpscQueue<T>::waitForItemPoppedIfFull(double timeout)
+{
+    // Clear pop event before announcing that we are waiting
+    itemPoppedEvent.tryWait();
+    epicsAtomicCmpAndSwapIntT(&producerWaiting, 0, 1);
+    if (isFull()) {
+        // Queue is full, wait for pop
+        itemPoppedEvent.wait(timeout);
+    }
+    epicsAtomicSetIntT(&producerWaiting, 0);
+}
+
+template <class T>
+void SpscQueue<T>::cancelWaitForItemPushed()
+{
+    itemPushedEvent.signal();
+}
+
+template <class T>
+void SpscQueue<T>::cancelWaitForItemPopped()
+{
+    itemPoppedEvent.signal();
+}
+
+// Called by consumer only.
+template <class T>
+void SpscQueue<T>::clear()
+{
+    while (tryPop()) {
+    }
+    itemPoppedEvent.signal();
+}
+
+template <class T>
+void SpscQueue<T>::resetCounters()
+{
+    epics::pvData::Lock lock(counterMutex);
+    typedef std::map<std::string, unsigned int>::iterator MI;
+    for (MI it = counterMap.begin(); it != counterMap.end(); it++) {
+        it->second = 0;
+    }
+    epicsAtomicSetSizeT(&nReceived, 0);
+    epicsAtomicSetSizeT(&nRejected, 0);
+    epicsAtomicSetSizeT(&nDelivered, 0);
+    nObservedReceived = 0;
+    nObservedDelivered = 0;
+}
+
+template <class T>
+const std::map<std::string,unsigned int>& SpscQueue<T>::getCounterMap()
+{
+    epics::pvData::Lock lock(counterMutex);
+    counterMap[PvaPyConstants::NumReceivedCounterKey] = (unsigned int)epicsAtomicGetSizeT(&nReceived);
+    counterMap[PvaPyConstants::NumRejectedCounterKey] = (unsigned int)epicsAtomicGetSizeT(&nRejected);
+    counterMap[PvaPyConstants::NumDeliveredCounterKey] = (unsigned int)epicsAtomicGetSizeT(&nDelivered);
+    counterMap[PvaPyConstants::NumQueuedCounterKey] = size();
+    return counterMap;
+}
+
+template <class T>
+void SpscQueue<T>::setCounter(const std::string& key, unsigned int value)
+{
+    epics::pvData::Lock lock(counterMutex);
+    counterMap[key] = value;
+}
+
+template <class T>
+void SpscQueue<T>::addToCounter(const std::string& key, unsigned int value)
+{
+    epics::pvData::Lock lock(counterMutex);
+    std::map<std::string,unsigned int>::iterator it = counterMap.find(key);
+    if (it != counterMap.end()) {
+        it->second = it->second + value;
+    }
+    else {
+        counterMap[key] = value;
+    }
+}
+
+template <class T>
+double SpscQueue<T>::getTimeSinceLastPush()
+{
+    epics::pvData::Lock lock(counterMutex);
+    epicsTimeStamp ts;
+    epicsTimeGetCurrent(&ts);
+    size_t n = epicsAtomicGetSizeT(&nReceived);
+    if (n != nObservedReceived) {
+        nObservedReceived = n;
+        lastPushedTime = ts;
+    }
+    return epicsTimeDiffInSeconds(&ts, &lastPushedTime);
+}
+
+template <class T>
+double SpscQueue<T>::getTimeSinceLastPop()
+{
+    epics::pvData::Lock lock(counterMutex);
+    epicsTimeStamp ts;
+    epicsTimeGetCurrent(&ts);
+    size_t n = epicsAtomicGetSizeT(&nDelivered);
+    if (n != nObservedDelivered) {
+        nObservedDelivered = n;
+        lastPoppedTime = ts;
+    }
+    return epicsTimeDiffInSeconds(&ts, &lastPoppedTime);
+}
+
+#endif
@@ -0,0 +1,160 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include <epicsThread.h>
+#include "SubscriberDispatcher.h"
+#include "PvaPyConstants.h"
+#include "PyGilManager.h"
+#include "QueueEmpty.h"
+
+namespace pvd = epics::pvData;
+namespace bp = boost::python;
+
+const double SubscriberDispatcher::WorkerWaitTimeout(1.0);
+
+PvaPyLogger SubscriberDispatcher::logger("SubscriberDispatcher");
+
+SubscriberDispatcher::SubscriberDispatcher(const std::string& subscriberName_, const bp::object& pySubscriber_, int maxQueueLength)
+    : subscriberName(subscriberName_)
+    , pySubscriber(pySubscriber_)
+    , pvObjectQueue(maxQueueLength)
+    , active(false)
+    , counterMutex()
+    , maxQueued(0)
+    , timingEnabled(false)
+    , gilWaitHistogramPtr()
+    , callbackHistogramPtr()
+{
+}
+
+SubscriberDispatcher::~SubscriberDispatcher()
+{
+}
+
+void SubscriberDispatcher::start(const SubscriberDispatcher::shared_pointer& dispatcherPtr)
+{
+    if (dispatcherPtr->active) {
+        return;
+    }
+    dispatcherPtr->active = true;
+    std::string threadName = "Subscriber-" + dispatcherPtr->subscriberName;
+    epicsThreadCreate(threadName.c_str(), epicsThreadPriorityLow, epicsThreadGetStackSize(epicsThreadStackSmall), (EPICSTHREADFUNC)workerThread, new SubscriberDispatcher::shared_pointer(dispatcherPtr));
+}
+
+void SubscriberDispatcher::stop()
+{
+    active = false;
+    pvObjectQueue.cancelWaitForItemPushed();
+}
+
+bool SubscriberDispatcher::dispatch(const PvObject& pvObject)
+{
+    if (!pvObjectQueue.pushIfNotFull(pvObject)) {
+        logger.trace("Dropped monitor update for slow subscriber %s", subscriberName.c_str());
+        return false;
+    }
+    unsigned int nQueued = pvObjectQueue.size();
+    pvd::Lock lock(counterMutex);
+    if (nQueued > maxQueued) {
+        maxQueued = nQueued;
+    }
+    return true;
+}
+
+void SubscriberDispatcher::clear()
+{
+    pvObjectQueue.clear();
+}
+
+void SubscriberDispatcher::resetCounters()
+{
+    pvObjectQueue.resetCounters();
+    pvd::Lock lock(counterMutex);
+    maxQueued = 0;
+}
+
+std::map<std::string,unsigned int> SubscriberDispatcher::getCounterMap()
+{
+    std::map<std::string,unsigned int> queueCounterMap = pvObjectQueue.getCounterMap();
+    std::map<std::string,unsigned int> counterMap;
+    counterMap[PvaPyConstants::NumReceivedCounterKey] = queueCounterMap[PvaPyConstants::NumReceivedCounterKey];
+    counterMap[PvaPyConstants::NumDeliveredCounterKey] = queueCounterMap[PvaPyConstants::NumDeliveredCounterKey];
+    counterMap[PvaPyConstants::NumDroppedCounterKey] = queueCounterMap[PvaPyConstants::NumRejectedCounterKey];
+    counterMap[PvaPyConstants::NumQueuedCounterKey] = queueCounterMap[PvaPyConstants::NumQueuedCounterKey];
+    pvd::Lock lock(counterMutex);
+    counterMap[PvaPyConstants::MaxQueuedCounterKey] = maxQueued;
+    return counterMap;
+}
+
+void SubscriberDispatcher::setLatencyHistograms(const LatencyHistogram::shared_pointer& gilWaitHistogramPtr, const LatencyHistogram::shared_pointer& callbackHistogramPtr)
+{
+    this->gilWaitHistogramPtr = gilWaitHistogramPtr;
+    this->callbackHistogramPtr = callbackHistogramPtr;
+}
+
+void SubscriberDispatcher::setTimingEnabled(bool timingEnabled)
+{
+    this->timingEnabled = timingEnabled && gilWaitHistogramPtr && callbackHistogramPtr;
+}
+
+void SubscriberDispatcher::callSubscriber(PvObject& pvObject)
+{
+    bool recordTiming = timingEnabled;
+    epicsTimeStamp startTime;
+    if (recordTiming) {
+        epicsTimeGetCurrent(&startTime);
+    }
+    PyGilManager::gilStateEnsure();
+    if (recordTiming) {
+        epicsTimeStamp gilTime;
+        epicsTimeGetCurrent(&gilTime);
+        gilWaitHistogramPtr->record(startTime, gilTime);
+    }
+    try {
+        pySubscriber(pvObject);
+    }
+    catch(const bp::error_already_set&) {
+        logger.error("Channel subscriber " + subscriberName + " raised python exception.");
+        PyErr_Print();
+        PyErr_Clear();
+    }
+    catch (const std::exception& ex) {
+        logger.error(ex.what());
+    }
+    PyGilManager::gilStateRelease();
+    if (recordTiming) {
+        epicsTimeStamp endTime;
+        epicsTimeGetCurrent(&endTime);
+        callbackHistogramPtr->record(startTime, endTime);
+    }
+}
+
+void SubscriberDispatcher::workerThread(SubscriberDispatcher::shared_pointer* dispatcherPtr)
+{
+    SubscriberDispatcher* dispatcher = dispatcherPtr->get();
+    logger.debug("Started subscriber dispatch thread %s", epicsThreadGetNameSelf());
+    while (dispatcher->active) {
+        // Handle possible exceptions while retrieving data from empty queue.
+        try {
+            PvObject pvObject = dispatcher->pvObjectQueue.frontAndPop(WorkerWaitTimeout);
+            if (!dispatcher->active) {
+                break;
+            }
+            dispatcher->callSubscriber(pvObject);
+        }
+        catch (QueueEmpty& ex) {
+            // Queue empty, no PV changes received.
+        }
+        catch (const std::exception& ex) {
+            // Not good.
+            logger.error("Subscriber dispatch thread caught exception: %s", ex.what());
+        }
+    }
+    logger.debug("Exiting subscriber dispatch thread %s", epicsThreadGetNameSelf());
+    dispatcher->pvObjectQueue.clear();
+
+    // Dispatcher holds python subscriber, and may be destroyed here
+    PyGilManager::gilStateEnsure();
+    delete dispatcherPtr;
+    PyGilManager::gilStateRelease();
+}
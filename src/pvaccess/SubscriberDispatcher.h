@@ -0,0 +1,80 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef SUBSCRIBER_DISPATCHER_H
+#define SUBSCRIBER_DISPATCHER_H
+
+#include <string>
+#include <map>
+#include "boost/python/object.hpp"
+#include "pv/pvData.h"
+#include "PvObject.h"
+#include "PvObjectQueue.h"
+#include "PvaPyLogger.h"
+#include "LatencyHistogram.h"
+
+// Delivers monitor updates to a single channel subscriber from its own
+// bounded queue and worker thread, so that a slow subscriber cannot
+// delay other subscribers of the same channel. Updates that do not fit
+// into the subscriber queue are dropped and counted.
+class SubscriberDispatcher
+{
+public:
+    POINTER_DEFINITIONS(SubscriberDispatcher);
+
+    static const double WorkerWaitTimeout;
+
+    SubscriberDispatcher(const std::string& subscriberName, const boost::python::object& pySubscriber, int maxQueueLength);
+    virtual ~SubscriberDispatcher();
+
+    std::string getSubscriberName() const;
+    bool isActive() const;
+
+    // Worker thread keeps dispatcher alive until it exits, so that
+    // stop() does not need to wait for python subscriber to return
+    static void start(const SubscriberDispatcher::shared_pointer& dispatcherPtr);
+    void stop();
+
+    // Returns false if update was dropped
+    bool dispatch(const PvObject& pvObject);
+    void clear();
+
+    // Statistics
+    void resetCounters();
+    std::map<std::string,unsigned int> getCounterMap();
+
+    // Timing of GIL acquisition and subscriber calls is recorded into
+    // given histograms while enabled
+    void setLatencyHistograms(const LatencyHistogram::shared_pointer& gilWaitHistogramPtr, const LatencyHistogram::shared_pointer& callbackHistogramPtr);
+    void setTimingEnabled(bool timingEnabled);
+
+private:
+    static PvaPyLogger logger;
+    static void workerThread(SubscriberDispatcher::shared_pointer* dispatcherPtr);
+
+    void callSubscriber(PvObject& pvObject);
+
+    std::string subscriberName;
+    boost::python::object pySubscriber;
+    PvObjectQueue pvObjectQueue;
+    bool active;
+
+    // Statistics counters
+    epics::pvData::Mutex counterMutex;
+    unsigned int maxQueued;
+    bool timingEnabled;
+    LatencyHistogram::shared_pointer gilWaitHistogramPtr;
+    LatencyHistogram::shared_pointer callbackHistogramPtr;
+};
+
+inline std::string SubscriberDispatcher::getSubscriberName() const
+{
+    return subscriberName;
+}
+
+inline bool SubscriberDispatcher::isActive() const
+{
+    return active;
+}
+
+#endif
@@ -0,0 +1,109 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#ifndef TIME_STAMP_RING_H
+#define TIME_STAMP_RING_H
+
+#include <vector>
+#include <epicsTime.h>
+#include <epicsAtomic.h>
+#include <pv/pvData.h>
+
+// Fixed size lock-free ring of time stamps that accompany items of
+// a FIFO queue with a single producer and a single consumer. Producer
+// stores time stamp before it pushes an item, and commits it after push
+// succeeds; consumer takes time stamp after it pops an item. Slots are
+// tagged with item sequence numbers, so that time stamps overwritten
+// while the queue holds more items than the ring size are skipped.
+class TimeStampRing
+{
+public:
+    POINTER_DEFINITIONS(TimeStampRing);
+
+    static const size_t DefaultSize = 1024;
+
+    TimeStampRing(size_t size=DefaultSize);
+    virtual ~TimeStampRing() {}
+
+    // Called by producer only.
+    void put(const epicsTimeStamp& timeStamp);
+    void commit();
+
+    // Called by consumer only; returns false if time stamp
+    // is not available
+    bool take(epicsTimeStamp& timeStamp);
+
+    // Called by consumer after queue is cleared.
+    void reset();
+
+private:
+    static const size_t InvalidSequence = ~size_t(0);
+
+    struct Slot {
+        size_t sequence;
+        epicsTimeStamp timeStamp;
+    };
+
+    std::vector<Slot> slots;
+    size_t sizeMask;
+
+    // Push sequence is written only by producer, pop sequence
+    // only by consumer
+    size_t pushSequence;
+    size_t popSequence;
+};
+
+inline TimeStampRing::TimeStampRing(size_t size)
+    : slots()
+    , sizeMask(0)
+    , pushSequence(0)
+    , popSequence(0)
+{
+    // Round size up to power of two, so that slot index is a simple mask
+    size_t capacity = 1;
+    while (capacity < size) {
+        capacity <<= 1;
+    }
+    Slot slot;
+    slot.sequence = InvalidSequence;
+    slots.resize(capacity, slot);
+    sizeMask = capacity - 1;
+}
+
+inline void TimeStampRing::put(const epicsTimeStamp& timeStamp)
+{
+    Slot& slot = slots[pushSequence & sizeMask];
+    epicsAtomicSetSizeT(&slot.sequence, InvalidSequence);
+    epicsAtomicWriteMemoryBarrier();
+    slot.timeStamp = timeStamp;
+    epicsAtomicSetSizeT(&slot.sequence, pushSequence);
+}
+
+inline void TimeStampRing::commit()
+{
+    epicsAtomicSetSizeT(&pushSequence, pushSequence+1);
+}
+
+// Slot may be overwritten by producer while we read it, in which
+// case its sequence number changes
+inline bool TimeStampRing::take(epicsTimeStamp& timeStamp)
+{
+    size_t sequence = popSequence++;
+    Slot& slot = slots[sequence & sizeMask];
+    if (epicsAtomicGetSizeT(&slot.sequence) != sequence) {
+        return false;
+    }
+    epicsAtomicReadMemoryBarrier();
+    timeStamp = slot.timeStamp;
+    return (epicsAtomicGetSizeT(&slot.sequence) == sequence);
+}
+
+// Items pushed after the queue was cleared may be paired with
+// wrong time stamps until the next reset, so this should be called
+// while producer is not active.
+inline void TimeStampRing::reset()
+{
+    popSequence = epicsAtomicGetSizeT(&pushSequence);
+}
+
+#endif
@@ -78,12 +78,13 @@ class_<CaIoc>("CaIoc",
         args("name", "value"),
         "Put field. This method is equivalent to dbpf(), which does not throw any exceptions.\n\n"
         ":Parameter: *name* (str) - Field name.\n\n"
-        ":Parameter: *value* (object) - Field value as a python object.\n\n"
-        ":Raises: *InvalidArgument* - in case of empty field name.\n\n"
+        ":Parameter: *value* (object) - Field value as a python object. NumPy arrays are converted to the record field type if needed, and their data is written into the record directly.\n\n"
+        ":Raises: *InvalidArgument* - in case of empty field name, or NumPy array that does not fit into the record field.\n\n"
         ":Raises: *ObjectNotFound* - in case of unknown field name.\n\n"
         ":Raises: *InvalidState* - in case of attempting to call this method before initializing IOC, out of memory, or any other errors.\n\n"
         "::\n\n"
-        "    caIoc.putField('I1', 5)\n\n")
+        "    caIoc.putField('I1', 5)\n\n"
+        "    caIoc.putField('W1', numpy.arange(1000, dtype=numpy.float64))\n\n")
 
     .def("putField",
         static_cast<void(CaIoc::*)(const std::string&, const std::string&)>(&CaIoc::putField),
@@ -109,6 +110,44 @@ class_<CaIoc>("CaIoc",
         "::\n\n"
         "    value = caIoc.getField('I1')\n\n")
 
+    .def("getField",
+        static_cast<bp::object(CaIoc::*)(const std::string&, bool)>(&CaIoc::getField),
+        args("name", "useNumPyArrays"),
+        "Get field, optionally returning array data as NumPy array. Array data is read directly into the NumPy array buffer, without creating python objects for individual elements.\n\n"
+        ":Parameter: *name* (str) - Field name.\n\n"
+        ":Parameter: *useNumPyArrays* (bool) - If true, numeric arrays will be returned as NumPy arrays.\n\n"
+        ":Returns: Field value, which may be a NumPy array or a list if the number if elements in the record is greater than 1.\n\n"
+        ":Raises: *InvalidArgument* - in case of empty field name.\n\n"
+        ":Raises: *ObjectNotFound* - in case of unknown field name.\n\n"
+        ":Raises: *InvalidState* - in case of attempting to call this method before initializing IOC, out of memory, or any other errors.\n\n"
+        "::\n\n"
+        "    waveform = caIoc.getField('W1', True)\n\n")
+
+    .def("getFields",
+        static_cast<bp::dict(CaIoc::*)(const bp::list&)>(&CaIoc::getFields),
+        args("names"),
+        "Get multiple fields. Record addresses are resolved once and reused for subsequent calls.\n\n"
+        ":Parameter: *names* (list) - List of field names.\n\n"
+        ":Returns: Dictionary of field values keyed by field name.\n\n"
+        ":Raises: *InvalidArgument* - in case of empty field name.\n\n"
+        ":Raises: *ObjectNotFound* - in case of unknown field name.\n\n"
+        ":Raises: *InvalidState* - in case of attempting to call this method before initializing IOC, out of memory, or any other errors.\n\n"
+        "::\n\n"
+        "    valueDict = caIoc.getFields(['I1', 'I2'])\n\n")
+
+    .def("getFields",
+        static_cast<bp::dict(CaIoc::*)(const bp::list&, bool)>(&CaIoc::getFields),
+        args("names", "useNumPyArrays"),
+        "Get multiple fields, optionally returning array data as NumPy arrays. Record addresses are resolved once and reused for subsequent calls.\n\n"
+        ":Parameter: *names* (list) - List of field names.\n\n"
+        ":Parameter: *useNumPyArrays* (bool) - If true, numeric arrays will be returned as NumPy arrays.\n\n"
+        ":Returns: Dictionary of field values keyed by field name.\n\n"
+        ":Raises: *InvalidArgument* - in case of empty field name.\n\n"
+        ":Raises: *ObjectNotFound* - in case of unknown field name.\n\n"
+        ":Raises: *InvalidState* - in case of attempting to call this method before initializing IOC, out of memory, or any other errors.\n\n"
+        "::\n\n"
+        "    valueDict = caIoc.getFields(['W1', 'W2'], True)\n\n")
+
     .def("printRecord",
         static_cast<void(CaIoc::*)(const std::string&, int)>(&CaIoc::printRecord),
         args("name", "level"),
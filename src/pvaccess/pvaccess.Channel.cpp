@@ -8,7 +8,11 @@ namespace bp = boost::python;
 
 
 #ifndef WINDOWS
+#if PVA_API_VERSION >= 482
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ChannelMonitor, Channel::monitor, 1, 4)
+#else
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(ChannelMonitor, Channel::monitor, 1, 2)
+#endif // if PVA_API_VERSION >= 482
 #endif
 
 //
@@ -1217,6 +1221,24 @@ class_<Channel>("Channel",
         "    channel.startMonitor()\n\n")
 
 #ifndef WINDOWS
+#if PVA_API_VERSION >= 482
+    .def("monitor",
+        static_cast<void(Channel::*)(const boost::python::object&, const std::string&, int, double)>(&Channel::monitor),
+        ChannelMonitor(args("subscriber", "requestDescriptor", "batchSize", "maxLatency"),
+        "Subscribes python object to notifications of changes in PV value and starts channel monitor. This method is appropriate when there is only one subscriber.\n\n"
+        ":Parameter: *subscriber* (object) - reference to python subscriber object (e.g., python function) that will be executed when PV value changes\n\n"
+        ":Parameter: *requestDescriptor* (str) - (optional) describes what PV data should be sent to subscribed channel clients; default is 'field(value)'\n\n"
+        ":Parameter: *batchSize* (int) - (optional) if greater than 1, monitor updates are delivered in batches: subscriber is invoked with a list of up to *batchSize* PvObjects under a single GIL acquisition; default is 0 (batching disabled)\n\n"
+        ":Parameter: *maxLatency* (float) - (optional) in batch mode, maximum time in seconds to wait for the batch to fill after its first PvObject was received; default is 0.1 seconds\n\n"
+        "If batching is enabled and the monitor queue is disabled, the monitor queue length will be set to 10 times the batch size until the monitor is stopped. Batch counters (number of batches and histogram of batch sizes keyed by powers of two) are reported by getMonitorCounters().\n\n"
+        "::\n\n"
+        "    def echo(x):\n\n"
+        "        print('New PV value: %s' % x)\n\n"
+        "    channel.monitor(echo, 'field(value,alarm,timeStamp)')\n\n"
+        "    def echoBatch(pvList):\n\n"
+        "        print('Received %s PV values' % len(pvList))\n\n"
+        "    channel.monitor(echoBatch, 'field(value)', batchSize=100, maxLatency=0.01)\n\n"))
+#else
     .def("monitor",
         static_cast<void(Channel::*)(const boost::python::object&, const std::string&)>(&Channel::monitor),
         ChannelMonitor(args("subscriber", "requestDescriptor=field(value)"),
@@ -1227,6 +1249,7 @@ class_<Channel>("Channel",
         "    def echo(x):\n\n"
         "        print('New PV value: %s' % x)\n\n"
         "    channel.monitor(echo, 'field(value,alarm,timeStamp)')\n\n"))
+#endif // if PVA_API_VERSION >= 482
 #else
     .def("monitor",
         static_cast<void(Channel::*)(const boost::python::object&, const std::string&)>(&Channel::monitor),
@@ -1238,6 +1261,21 @@ class_<Channel>("Channel",
         "    def echo(x):\n\n"
         "        print('New PV value: %s' % x)\n\n"
         "    channel.monitor(echo, 'field(value,alarm,timeStamp)')\n\n")
+
+#if PVA_API_VERSION >= 482
+    .def("monitor",
+        static_cast<void(Channel::*)(const boost::python::object&, const std::string&, int, double)>(&Channel::monitor),
+        args("subscriber", "requestDescriptor", "batchSize", "maxLatency"),
+        "Subscribes python object to batched notifications of changes in PV value and starts channel monitor. Subscriber is invoked with a list of up to *batchSize* PvObjects under a single GIL acquisition.\n\n"
+        ":Parameter: *subscriber* (object) - reference to python subscriber object (e.g., python function) that will be executed with a list of PV values\n\n"
+        ":Parameter: *requestDescriptor* (str) - describes what PV data should be sent to subscribed channel clients\n\n"
+        ":Parameter: *batchSize* (int) - maximum number of PvObjects delivered in a single batch; values of 0 and 1 disable batching\n\n"
+        ":Parameter: *maxLatency* (float) - maximum time in seconds to wait for the batch to fill after its first PvObject was received\n\n"
+        "::\n\n"
+        "    def echoBatch(pvList):\n\n"
+        "        print('Received %s PV values' % len(pvList))\n\n"
+        "    channel.monitor(echoBatch, 'field(value)', 100, 0.01)\n\n")
+#endif // if PVA_API_VERSION >= 482
 #endif
 
 #if PVA_API_VERSION >= 482
@@ -1277,7 +1315,7 @@ class_<Channel>("Channel",
 
     .def("getMonitorCounters",
         static_cast<dict(Channel::*)()>(&Channel::getMonitorCounters),
-        "Retrieve dictionary with monitor counters, which include number of updates received and number of monitor overruns.\n\n"
+        "Retrieve dictionary with monitor counters, which include number of updates received and number of monitor overruns. For batched monitors, the dictionary also contains number of delivered batches and histogram of batch sizes. When monitor queue is used, the dictionary also contains number of monitor copies reused from (nPoolHits) or allocated outside of (nPoolMisses) the pool of preallocated PV structures, as well as the number of structures currently available in the pool (nPooled) and the number of array data bytes they hold (nPooledArrayBytes). If per-subscriber queues are used, the dictionary also contains received, delivered, dropped, queued and maximum queued update counters for each subscriber.\n\n"
         ":Returns: dictionary containing available statistics counters\n\n"
         "::\n\n"
         "    counterDict = channel.getMonitorCounters()\n\n")
@@ -1322,8 +1360,9 @@ class_<Channel>("Channel",
     .def("setMonitorMaxQueueLength",
         &Channel::setMonitorMaxQueueLength,
         args("maxQueueLength"),
-        "Sets maximum monitor queue length. Negative number means unlimited length, while the value of zero disables monitor queue. When monitor queue is disabled, incoming data is processed immediately by all python subscribers (i.e., there is no processing thread running in the background). When monitoring queue is full, channel will not be polled for new data. Default monitor queue length is zero.\n\n"
+        "Sets maximum monitor queue length. Negative number means unlimited length, while the value of zero disables monitor queue. When monitor queue is disabled, incoming data is processed immediately by all python subscribers (i.e., there is no processing thread running in the background). When monitoring queue is full, channel will not be polled for new data. Default monitor queue length is zero. Batched monitor requires monitor queue, which therefore cannot be disabled while such monitor is active.\n\n"
         ":Parameter: *maxQueueLength* (int) - maximum queue length\n\n"
+        ":Raises: *InvalidState* - when queue length is set to zero while batched monitor is active\n\n"
         "::\n\n"
         "    channel.setMonitorMaxQueueLength(10)\n\n")
 
@@ -1353,6 +1392,131 @@ class_<Channel>("Channel",
         "::\n\n"
         "    connected = channel.isConnected()\n\n")
 
+    .def("getOperationCacheSize",
+        &Channel::getOperationCacheSize,
+        "Retrieves maximum number of initialized get, put and putGet operations that are cached per operation type for reuse by subsequent calls with the same request descriptor.\n\n"
+        ":Returns: maximum operation cache size\n\n"
+        "::\n\n"
+        "    cacheSize = channel.getOperationCacheSize()\n\n")
+
+    .def("setOperationCacheSize",
+        &Channel::setOperationCacheSize,
+        args("cacheSize"),
+        "Sets maximum number of initialized get, put and putGet operations that are cached per operation type. Cached operations avoid creating and initializing a new channel operation for every get(), put() or putGet() call with the same request descriptor. Least recently used operations are discarded first, and the cache is invalidated whenever the channel disconnects or reconnects. The value of zero disables operation caching.\n\n"
+        ":Parameter: *cacheSize* (int) - maximum operation cache size\n\n"
+        "::\n\n"
+        "    channel.setOperationCacheSize(16)\n\n")
+
+    .def("resetOperationCacheCounters",
+        &Channel::resetOperationCacheCounters,
+        "Reset all operation cache counters to zero.\n\n"
+        "::\n\n"
+        "    channel.resetOperationCacheCounters()\n\n")
+
+    .def("getOperationCacheCounters",
+        &Channel::getOperationCacheCounters,
+        "Retrieve dictionary with operation cache counters for get, put and putGet operations, which include number of cache hits, misses, evictions and invalidations, as well as the number of currently cached operations.\n\n"
+        ":Returns: dictionary containing operation cache counters keyed by operation type\n\n"
+        "::\n\n"
+        "    counterDict = channel.getOperationCacheCounters()\n\n")
+
+    .def("getAsyncRequestPipelineDepth",
+        &Channel::getAsyncRequestPipelineDepth,
+        "Retrieves maximum number of asyncGet() and asyncPut() requests that can be in flight at the same time.\n\n"
+        ":Returns: async request pipeline depth\n\n"
+        "::\n\n"
+        "    depth = channel.getAsyncRequestPipelineDepth()\n\n")
+
+    .def("setAsyncRequestPipelineDepth",
+        &Channel::setAsyncRequestPipelineDepth,
+        args("depth"),
+        "Sets maximum number of asyncGet() and asyncPut() requests that can be in flight at the same time. With the default depth of 1, each async request is issued only after the previous one completes. Larger depth allows several requests to be issued without waiting for responses, which increases throughput on high latency connections. Regardless of depth, request callbacks are always invoked in the order in which requests were made.\n\n"
+        ":Parameter: *depth* (int) - async request pipeline depth\n\n"
+        ":Raises: *InvalidArgument* - when depth is not positive\n\n"
+        "::\n\n"
+        "    channel.setAsyncRequestPipelineDepth(8)\n\n")
+
+    .def("isMonitorQueueLockFree",
+        &Channel::isMonitorQueueLockFree,
+        "Checks whether internal monitor queue is backed by a lock-free ring buffer.\n\n"
+        ":Returns: True if monitor queue is lock-free, False otherwise\n\n"
+        "::\n\n"
+        "    lockFree = channel.isMonitorQueueLockFree()\n\n")
+
+    .def("setMonitorQueueLockFree",
+        &Channel::setMonitorQueueLockFree,
+        args("lockFree"),
+        "Selects lock-free ring buffer for the internal monitor queue. Lock-free queue hands off updates between the monitor thread and the processing thread without taking a mutex, and is used only if maximum queue length is positive; its length cannot be increased while monitor is running. Lock-free queue is disabled by default.\n\n"
+        ":Parameter: *lockFree* (bool) - if True, internal monitor queue will be lock-free\n\n"
+        ":Raises: *InvalidState* - when monitor is active\n\n"
+        "::\n\n"
+        "    channel.setMonitorQueueLockFree(True)\n\n"
+        "    channel.setMonitorMaxQueueLength(1000)\n\n")
+
+    .def("getMonitorSubscriberQueueLength",
+        &Channel::getMonitorSubscriberQueueLength,
+        "Retrieves maximum length of per-subscriber monitor queues.\n\n"
+        ":Returns: maximum subscriber queue length; value of 0 means that all subscribers are called sequentially from the same thread\n\n"
+        "::\n\n"
+        "    maxLength = channel.getMonitorSubscriberQueueLength()\n\n")
+
+    .def("setMonitorSubscriberQueueLength",
+        &Channel::setMonitorSubscriberQueueLength,
+        args("maxLength"),
+        "Sets maximum length of per-subscriber monitor queues. If positive, each subscriber gets its own queue of the given length and its own worker thread, so that a slow subscriber does not delay other subscribers; updates that do not fit into subscriber queue are dropped. Number of received, delivered, dropped and queued updates, as well as maximum number of queued updates for each subscriber are reported by getMonitorCounters() under the 'subscriberCounters' key. Per-subscriber queues cannot be used with batched monitors. By default, this feature is disabled.\n\n"
+        ":Parameter: *maxLength* (int) - maximum subscriber queue length; value of 0 disables per-subscriber queues\n\n"
+        ":Raises: *InvalidArgument* - when queue length is negative\n\n"
+        ":Raises: *InvalidState* - when monitor is active\n\n"
+        "::\n\n"
+        "    channel.setMonitorSubscriberQueueLength(100)\n\n")
+
+    .def("isMonitorSharedDispatch",
+        &Channel::isMonitorSharedDispatch,
+        "Checks whether monitor updates are delivered by the process-wide monitor dispatcher.\n\n"
+        ":Returns: True if shared dispatcher is used, False otherwise\n\n"
+        "::\n\n"
+        "    sharedDispatch = channel.isMonitorSharedDispatch()\n\n")
+
+    .def("setMonitorSharedDispatch",
+        &Channel::setMonitorSharedDispatch,
+        args("sharedDispatch"),
+        "Selects process-wide monitor dispatcher (see MonitorDispatcher class) for delivering monitor updates. In this mode channel does not start its own processing thread; updates are queued (if monitor queue is disabled, its length will be set to 100 while the monitor is active) and delivered by a fixed pool of worker threads shared by all channels. Shared dispatcher cannot be used with batched monitors, and is disabled by default.\n\n"
+        ":Parameter: *sharedDispatch* (bool) - if True, monitor updates will be delivered by shared dispatcher\n\n"
+        ":Raises: *InvalidState* - when monitor is active\n\n"
+        "::\n\n"
+        "    channel.setMonitorSharedDispatch(True)\n\n"
+        "    channel.monitor(echo)\n\n")
+
+    .def("isMonitorTimingEnabled",
+        &Channel::isMonitorTimingEnabled,
+        "Checks whether monitor latency histograms are being recorded.\n\n"
+        ":Returns: True if monitor timing is enabled, False otherwise\n\n"
+        "::\n\n"
+        "    timingEnabled = channel.isMonitorTimingEnabled()\n\n")
+
+    .def("setMonitorTimingEnabled",
+        &Channel::setMonitorTimingEnabled,
+        args("timingEnabled"),
+        "Enables or disables recording of monitor latency histograms. When enabled, channel records time between monitor event arrival and queue push, time updates spend waiting in the internal monitor queue, time spent waiting for the python GIL, and time spent in subscriber callbacks (including GIL wait). Timing is disabled by default.\n\n"
+        ":Parameter: *timingEnabled* (bool) - if True, monitor latency histograms will be recorded\n\n"
+        ":Raises: *InvalidState* - when monitor is active\n\n"
+        "::\n\n"
+        "    channel.setMonitorTimingEnabled(True)\n\n")
+
+    .def("resetMonitorLatencyHistograms",
+        &Channel::resetMonitorLatencyHistograms,
+        "Resets monitor latency histograms. Histograms are also reset by resetMonitorCounters().\n\n"
+        "::\n\n"
+        "    channel.resetMonitorLatencyHistograms()\n\n")
+
+    .def("getMonitorLatencyHistograms",
+        &Channel::getMonitorLatencyHistograms,
+        "Retrieves monitor latency histograms. Returned dictionary contains 'eventToPush', 'queueWait', 'gilWait' and 'callback' entries, each of which holds number of samples ('count'), minimum, mean and maximum latency ('min', 'mean', 'max'), estimated percentiles ('p50', 'p90', 'p99'), all in seconds, and histogram bucket counts ('buckets') keyed by bucket upper bound in microseconds. Buckets are powers of two, so percentiles are accurate to within a factor of two.\n\n"
+        ":Returns: dictionary of latency histograms\n\n"
+        "::\n\n"
+        "    histograms = channel.getMonitorLatencyHistograms()\n\n"
+        "    print(histograms['callback']['p99'])\n\n")
+
 #endif // if PVA_API_VERSION >= 482
 
 ;
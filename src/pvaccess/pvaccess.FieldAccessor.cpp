@@ -0,0 +1,49 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "boost/python/class.hpp"
+#include "pvapy.environment.h"
+#include "FieldAccessor.h"
+
+using namespace boost::python;
+
+//
+// FieldAccessor class
+//
+void wrapFieldAccessor()
+{
+
+class_<FieldAccessor>("FieldAccessor", 
+    "FieldAccessor is a precompiled field path that can be used for repeated access to the same field of many PvObject instances. Path resolution is performed only once per PV structure type, which makes it faster than PvObject item access for high-rate updates.\n\n"
+    "**FieldAccessor(fieldPath)**\n\n"
+    "\t:Parameter: *fieldPath* (str) - field path, which may use notation like 'x.y.z' for nested structure fields\n\n"
+    "\tExample:\n\n"
+    "\t::\n\n"
+    "\t\tvalueAccessor = FieldAccessor('value.index')\n\n"
+    "\n\n", 
+    init<std::string>(args("fieldPath")))
+
+    .def("get",
+        static_cast<object(FieldAccessor::*)(const PvObject&)>(&FieldAccessor::get),
+        args("pvObject"),
+        "Retrieves field value from a given PV object.\n\n"
+        ":Parameter: *pvObject* (PvObject) - PV object\n\n"
+        ":Returns: python object representing field value\n\n"
+        ":Raises: *FieldNotFound* - when field path does not exist in the object\n\n"
+        "::\n\n"
+        "    index = valueAccessor.get(pv)\n\n")
+
+    .def("set",
+        static_cast<void(FieldAccessor::*)(PvObject&, const object&)>(&FieldAccessor::set),
+        args("pvObject", "value"),
+        "Sets field value for a given PV object.\n\n"
+        ":Parameter: *pvObject* (PvObject) - PV object\n\n"
+        ":Parameter: *value* (object) - field value\n\n"
+        ":Raises: *FieldNotFound* - when field path does not exist in the object\n\n"
+        "::\n\n"
+        "    valueAccessor.set(pv, 1)\n\n")
+
+    .add_property("fieldPath", &FieldAccessor::getFieldPath, "Field path.")
+;
+
+} // wrapFieldAccessor()
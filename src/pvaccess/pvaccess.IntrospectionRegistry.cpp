@@ -0,0 +1,62 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "boost/python/class.hpp"
+#include "pvapy.environment.h"
+#include "IntrospectionRegistry.h"
+
+using namespace boost::python;
+
+//
+// IntrospectionRegistry class
+//
+void wrapIntrospectionRegistry()
+{
+
+class_<IntrospectionRegistry>("IntrospectionRegistry", 
+    "IntrospectionRegistry is a process-wide registry of PV structure types. Structures created from identical python dictionaries are interned, so that PvObject constructors reuse existing structure instead of creating a new one, and serialized structure introspection data is encoded and decoded only once per structure type. Each registered structure is also assigned a small integer id, which allows serialization streams to reference structure by id after its first transmission (see SerializationContext). Registry caches are cleared when they reach maximum size. All instances of this class refer to the same registry.\n\n"
+    "**IntrospectionRegistry()**\n\n"
+    "\tExample:\n\n"
+    "\t::\n\n"
+    "\t\tregistry = IntrospectionRegistry()\n\n"
+    "\t\tprint(registry.getCounters())\n\n"
+    "\n\n", 
+    init<>())
+
+    .def("setMaxSize",
+        &IntrospectionRegistry::setMaxSize,
+        args("maxSize"),
+        "Sets maximum number of structures kept in each of the registry caches.\n\n"
+        ":Parameter: *maxSize* (int) - maximum cache size (default: 1024)\n\n"
+        ":Raises: *InvalidArgument* - when size is zero\n\n"
+        "::\n\n"
+        "    registry.setMaxSize(4096)\n\n")
+
+    .def("getMaxSize",
+        &IntrospectionRegistry::getMaxSize,
+        "Retrieves maximum number of structures kept in each of the registry caches.\n\n"
+        ":Returns: maximum cache size\n\n"
+        "::\n\n"
+        "    maxSize = registry.getMaxSize()\n\n")
+
+    .def("getCounters",
+        &IntrospectionRegistry::getCounters,
+        "Retrieves registry counters. Dictionaries stored under the 'structureDict', 'serialization' and 'deserialization' keys describe structure lookups for PvObject constructors, object serialization and object deserialization, respectively, and contain number of cache hits (nCacheHits), misses (nCacheMisses) and evictions (nCacheEvictions), number of cached structures (nCached), and cache hit rate (hitRate). Total number of structure ids assigned so far is stored under the 'nStructureIds' key.\n\n"
+        ":Returns: dictionary containing registry counters\n\n"
+        "::\n\n"
+        "    counterDict = registry.getCounters()\n\n")
+
+    .def("resetCounters",
+        &IntrospectionRegistry::resetCounters,
+        "Resets registry counters.\n\n"
+        "::\n\n"
+        "    registry.resetCounters()\n\n")
+
+    .def("clear",
+        &IntrospectionRegistry::clear,
+        "Removes all structures from the registry. Structure ids are not reused after this call.\n\n"
+        "::\n\n"
+        "    registry.clear()\n\n")
+;
+
+} // wrapIntrospectionRegistry()
@@ -0,0 +1,56 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "boost/python/class.hpp"
+#include "pvapy.environment.h"
+#include "MonitorDispatcher.h"
+
+using namespace boost::python;
+
+//
+// MonitorDispatcher class
+//
+void wrapMonitorDispatcher()
+{
+
+class_<MonitorDispatcher>("MonitorDispatcher", 
+    "MonitorDispatcher is a process-wide pool of worker threads that delivers queued monitor updates for all channels configured with Channel.setMonitorSharedDispatch(True), instead of using one processing thread per channel. Channels with pending updates are serviced in round-robin order, and updates for any given channel are always delivered in order. All instances of this class refer to the same dispatcher.\n\n"
+    "**MonitorDispatcher()**\n\n"
+    "\tExample:\n\n"
+    "\t::\n\n"
+    "\t\tdispatcher = MonitorDispatcher()\n\n"
+    "\t\tdispatcher.setNumWorkers(4)\n\n"
+    "\n\n", 
+    init<>())
+
+    .def("setNumWorkers",
+        &MonitorDispatcher::setNumWorkers,
+        args("nWorkers"),
+        "Sets number of dispatcher worker threads. This must be done before the first channel monitor that uses shared dispatcher is started.\n\n"
+        ":Parameter: *nWorkers* (int) - number of worker threads; value of 0 means that number of threads will be equal to the number of available cores (default)\n\n"
+        ":Raises: *InvalidState* - when dispatcher has already been started\n\n"
+        "::\n\n"
+        "    dispatcher.setNumWorkers(4)\n\n")
+
+    .def("getNumWorkers",
+        &MonitorDispatcher::getNumWorkers,
+        "Retrieves number of dispatcher worker threads.\n\n"
+        ":Returns: number of worker threads\n\n"
+        "::\n\n"
+        "    nWorkers = dispatcher.getNumWorkers()\n\n")
+
+    .def("getStats",
+        &MonitorDispatcher::getStats,
+        "Retrieves dispatcher statistics, which include number of running worker threads (nWorkers), number of channels waiting for a worker (nReady), and total number of queued updates (nQueued). Dictionary stored under the 'channels' key contains statistics for each channel: number of queued (nQueued) and delivered (nDelivered) updates, number of times channel was serviced by a worker (nDispatches), and average and maximum time in seconds that channel with pending updates waited for a worker (avgLatency, maxLatency).\n\n"
+        ":Returns: dictionary containing dispatcher statistics\n\n"
+        "::\n\n"
+        "    statsDict = dispatcher.getStats()\n\n")
+
+    .def("resetStats",
+        &MonitorDispatcher::resetStats,
+        "Resets dispatcher statistics for all channels.\n\n"
+        "::\n\n"
+        "    dispatcher.resetStats()\n\n")
+;
+
+} // wrapMonitorDispatcher()
@@ -50,6 +50,15 @@ class_<NtNdArray, bases<NtType> >("NtNdArray",
         "::\n\n"
         "    array.setValue({'byteValue' : [34, 56, 77, ... ]})\n\n")
 
+    .def("setValue", static_cast<void(NtNdArray::*)(const boost::python::dict&,bool)>(&NtNdArray::setValue),
+        args("valueDict", "copy"),
+        "Sets array value. If copy flag is False and the array value is C-contiguous NumPy array of the matching data type, NtNdArray object will share array data with NumPy array instead of copying it; in this case NumPy array must not be modified afterwards.\n\n"
+        ":Parameter: *valueDict* (dict) - array value dictionary (must contain array value with one of the allowed field names: booleanValue, byteValue, ubyteValue, shortValue, uShortValue, intValue, uintValue, longValue, ulongValue, floatValue, doubleValue)\n\n"
+        ":Parameter: *copy* (bool) - if False, NumPy array data will not be copied when possible\n\n"
+        ":Raises: *InvalidDataType* - when object's field name/type do not match allowed fields\n\n"
+        "::\n\n"
+        "    array.setValue({'ubyteValue' : image.flatten()}, copy=False)\n\n")
+
     .def("setValue", static_cast<void(NtNdArray::*)(const PvObject&)>(&NtNdArray::setValue),
         args("valueObject"),
         "Sets array value.\n\n"
@@ -230,6 +239,67 @@ class_<NtNdArray, bases<NtType> >("NtNdArray",
         "    display = PvDisplay(10, 100, 'Test Display', 'Test Format', 'Seconds')\n\n"
         "    a.setDisplay(display)\n\n")
 
+    .def("compress", static_cast<void(NtNdArray::*)(const std::string&)>(&NtNdArray::compress),
+        args("codecName"),
+        "Compresses array value using native codec implementation with default compression level (5) and a single thread. Compressed data replaces array value as ubyteValue field, codec name and parameters (original data type) are set, as well as compressed and uncompressed size fields. Supported codecs are lz4, bslz4 and blosc (lz4 compressor with byte shuffle). Python GIL is released during compression.\n\n"
+        ":Parameter: *codecName* (str) - codec name\n\n"
+        ":Raises: *InvalidRequest* - for unsupported codecs\n\n"
+        ":Raises: *InvalidState* - if array is already compressed\n\n"
+        "::\n\n"
+        "    a.compress('lz4')\n\n")
+
+    .def("compress", static_cast<void(NtNdArray::*)(const std::string&,int)>(&NtNdArray::compress),
+        args("codecName", "level"),
+        "Compresses array value using native codec implementation and a single thread. Compressed data replaces array value as ubyteValue field, codec name and parameters (original data type) are set, as well as compressed and uncompressed size fields. Supported codecs are lz4, bslz4 and blosc (lz4 compressor with byte shuffle). Python GIL is released during compression.\n\n"
+        ":Parameter: *codecName* (str) - codec name\n\n"
+        ":Parameter: *level* (int) - compression level between 0 and 9; higher levels trade speed for compression ratio, and blosc level 0 stores data without compression\n\n"
+        ":Raises: *InvalidRequest* - for unsupported codecs\n\n"
+        ":Raises: *InvalidState* - if array is already compressed\n\n"
+        "::\n\n"
+        "    a.compress('bslz4', 5)\n\n")
+
+    .def("compress", static_cast<void(NtNdArray::*)(const std::string&,int,int)>(&NtNdArray::compress),
+        args("codecName", "level", "threads"),
+        "Compresses array value using native codec implementation. Data is split into blocks that are compressed by the given number of threads; lz4 blocks are merged into a single LZ4 block, so that the result can be decompressed by any LZ4 decoder. Compressed data replaces array value as ubyteValue field, codec name and parameters (original data type) are set, as well as compressed and uncompressed size fields. Supported codecs are lz4, bslz4 and blosc (lz4 compressor with byte shuffle). Python GIL is released during compression.\n\n"
+        ":Parameter: *codecName* (str) - codec name\n\n"
+        ":Parameter: *level* (int) - compression level between 0 and 9; higher levels trade speed for compression ratio, and blosc level 0 stores data without compression\n\n"
+        ":Parameter: *threads* (int) - number of compression threads; values less than 1 mean number of available CPUs\n\n"
+        ":Raises: *InvalidRequest* - for unsupported codecs\n\n"
+        ":Raises: *InvalidState* - if array is already compressed\n\n"
+        "::\n\n"
+        "    a.compress('blosc', 5, 4)\n\n")
+
+    .def("decompress",
+        &NtNdArray::decompress,
+        "Decompresses array value using native codec implementation. Uncompressed data type is taken from codec parameters, and expected size from array dimensions or uncompressed size field. Uncompressed data replaces array value, codec name and parameters are cleared, and compressed size is set to uncompressed size. Arrays that are not compressed are not modified. Python GIL is released during decompression.\n\n"
+        ":Raises: *InvalidRequest* - for unsupported codecs\n\n"
+        "::\n\n"
+        "    a.decompress()\n\n")
+
+#if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+    .def("getImage",
+        &NtNdArray::getImage,
+        "Retrieves image as NumPy array shaped according to array dimensions and ColorMode attribute. Mono images have shape (NY, NX), and RGB1, RGB2 and RGB3 images have shape (NY, NX, 3). Returned array shares data with the NTNDArray value field whenever possible, and color images are described via strides rather than copied. Compressed images (lz4, bslz4 and blosc codecs) are decompressed into internal buffer, with codec parameters specifying uncompressed data type. If array does not have dimensions, None is returned. InvalidRequest exception is thrown for unsupported codecs.\n\n"
+        ":Returns: NumPy image array\n\n"
+        "::\n\n"
+        "    image = a.getImage()\n\n")
+
+    .def("decompressArray",
+        &NtNdArray::decompressArray,
+        args("codecName", "compressedData", "dataType", "uncompressedSize"),
+        "Decompresses data using native codec implementation, without creating NTNDArray object. Decoded data is placed into internal buffer that is owned by the returned array.\n\n"
+        ":Parameter: *codecName* (str) - codec name (lz4, bslz4 or blosc)\n\n"
+        ":Parameter: *compressedData* (object) - contiguous bytes-like object (bytes, bytearray, NumPy ubyte array, etc.) containing compressed data\n\n"
+        ":Parameter: *dataType* (PVTYPE) - uncompressed data type\n\n"
+        ":Parameter: *uncompressedSize* (int) - uncompressed data size in bytes\n\n"
+        ":Returns: one-dimensional NumPy array of the given data type\n\n"
+        ":Raises: *InvalidArgument* - when data type or uncompressed size is invalid, or compressed data is corrupted\n\n"
+        ":Raises: *InvalidRequest* - when codec or codec variant is not supported\n\n"
+        "::\n\n"
+        "    value = NtNdArray.decompressArray('lz4', compressedData, USHORT, 2*nx*ny)\n\n")
+    .staticmethod("decompressArray")
+#endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
+
 ;
 
 } // wrapNtNdArray()
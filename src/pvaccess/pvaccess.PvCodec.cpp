@@ -58,6 +58,14 @@ class_<PvCodec, bases<PvObject> >("PvCodec",
         "    p = PvObject({'value':{'compressor':STRING,'compressionFactor':FLOAT,'quality': INT}},{'value':{'compressor':'BloscLZ','compressionFactor':1.0,'quality':75}}))\n\n"
         "    codec.setParameters(p)\n\n")
 
+    .def("getNativeCodecNames",
+        &PvCodec::getNativeCodecNames,
+        "Retrieves names of codecs that are implemented natively and can be used with NtNdArray compress() and decompress() methods.\n\n"
+        ":Returns: list of codec names\n\n"
+        "::\n\n"
+        "    codecNames = PvCodec.getNativeCodecNames()\n\n")
+    .staticmethod("getNativeCodecNames")
+
 ;
 
 } // wrapPvCodec()
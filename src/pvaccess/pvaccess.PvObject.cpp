@@ -7,6 +7,7 @@
 #include "pvapy.environment.h"
 #include "PvObject.h"
 #include "PvObjectPickleSuite.h"
+#include "SerializationContext.h"
 
 using namespace boost::python;
 
@@ -824,6 +825,30 @@ class_<PvObject>("PvObject",
         "    pv = PvObject({'aScalarArray' : [INT], 'aString' : STRING})\n\n"
         "    pv.setScalarArray('aScalarArray', [0,1,2,3,4])\n\n")
 
+    .def("setScalarArray", 
+        static_cast<void(PvObject::*)(const boost::python::object&,bool)>(&PvObject::setScalarArray),
+        args("valueList", "copy"),
+        "Sets scalar array value for a single-field structure, or for a structure that has scalar array field named 'value'. If copy flag is False and the value is C-contiguous NumPy array of the matching data type, PV object will share array data with NumPy array instead of copying it; in this case NumPy array must not be modified afterwards.\n\n"
+        ":Parameter: *valueList* (list) - list of scalar values, or NumPy array\n\n"
+        ":Parameter: *copy* (bool) - if False, NumPy array data will not be copied when possible\n\n"
+        ":Raises: *InvalidRequest* - when single-field structure has no scalar array field or multiple-field structure has no scalar array 'value' field\n\n"
+        "::\n\n"
+        "    pv = PvObject({'aScalarArray' : [INT]})\n\n"
+        "    pv.setScalarArray(numpy.arange(0,5,dtype=numpy.int32), copy=False)\n\n")
+
+    .def("setScalarArray", 
+        static_cast<void(PvObject::*)(const std::string&,const boost::python::object&,bool)>(&PvObject::setScalarArray),
+        args("fieldName", "valueList", "copy"),
+        "Sets scalar array value for the given PV field. If copy flag is False and the value is C-contiguous NumPy array of the matching data type, PV object will share array data with NumPy array instead of copying it; in this case NumPy array must not be modified afterwards.\n\n"
+        ":Parameter: *fieldName* (str) - field name\n\n"
+        ":Parameter: *valueList* (list) - list of scalar values, or NumPy array\n\n"
+        ":Parameter: *copy* (bool) - if False, NumPy array data will not be copied when possible\n\n"
+        ":Raises: *FieldNotFound* - when PV structure does not have specified field\n\n"
+        ":Raises: *InvalidRequest* - when specified field is not a scalar array\n\n"
+        "::\n\n"
+        "    pv = PvObject({'aScalarArray' : [INT], 'aString' : STRING})\n\n"
+        "    pv.setScalarArray('aScalarArray', numpy.arange(0,5,dtype=numpy.int32), copy=False)\n\n")
+
     .def("getScalarArray", 
         static_cast<boost::python::object(PvObject::*)()const>(&PvObject::getScalarArray), 
         "Retrieves scalar array value from a single-field structure, or from a structure that has scalar array field named 'value'.\n\n"
@@ -1301,6 +1326,47 @@ class_<PvObject>("PvObject",
         "    pv = PvObject({'anUnion' : ({'anInt' : INT, 'aFloat' : FLOAT},)})\n\n"
         "    pv2 = pv.copy()\n\n")
 
+    .def("serialize",
+        static_cast<boost::python::object(PvObject::*)() const>(&PvObject::serialize),
+        "Serializes PvObject instance using pvData binary encoding. Serialized data contains structure introspection and field values, and is used for pickling PvObject instances.\n\n"
+        ":Returns: bytes object containing serialized PV object\n\n"
+        "::\n\n"
+        "    pv = PvObject({'anInt' : INT, 'aFloatArray' : [FLOAT]}, {'anInt' : 1, 'aFloatArray' : [1.1, 2.2]})\n\n"
+        "    buffer = pv.serialize()\n\n")
+
+    .def("serialize",
+        static_cast<boost::python::object(PvObject::*)(SerializationContext&) const>(&PvObject::serialize),
+        args("context"),
+        "Serializes PvObject instance as part of serialization stream. Structure introspection is included only with the first object of a given type that is serialized with the given context; subsequent objects of the same type reference the structure by id. Such data can only be deserialized in order, using context that was passed to all previous *deserialize()* calls on the receiving end of the stream.\n\n"
+        ":Parameter: *context* (SerializationContext) - serialization context of the sending end of the stream\n\n"
+        ":Returns: bytes object containing serialized PV object\n\n"
+        "::\n\n"
+        "    context = SerializationContext()\n\n"
+        "    buffer = pv.serialize(context)\n\n")
+
+    .def("deserialize",
+        static_cast<PvObject(*)(const boost::python::object&)>(&PvObject::deserialize),
+        args("buffer"),
+        "Creates PvObject instance from serialized data. Structures deserialized from identical introspection data are reused.\n\n"
+        ":Parameter: *buffer* (object) - bytes-like object (bytes, bytearray, memoryview, etc.) containing serialized PV object\n\n"
+        ":Returns: deserialized PV object\n\n"
+        ":Raises: *InvalidArgument* - when buffer does not contain valid serialized PV object\n\n"
+        "::\n\n"
+        "    pv2 = PvObject.deserialize(buffer)\n\n")
+
+    .def("deserialize",
+        static_cast<PvObject(*)(const boost::python::object&, SerializationContext&)>(&PvObject::deserialize),
+        args("buffer", "context"),
+        "Creates PvObject instance from data that was serialized as part of serialization stream.\n\n"
+        ":Parameter: *buffer* (object) - bytes-like object (bytes, bytearray, memoryview, etc.) containing serialized PV object\n\n"
+        ":Parameter: *context* (SerializationContext) - serialization context of the receiving end of the stream\n\n"
+        ":Returns: deserialized PV object\n\n"
+        ":Raises: *InvalidArgument* - when buffer does not contain valid serialized PV object, or when it references structure that was not received using the given context\n\n"
+        "::\n\n"
+        "    context = SerializationContext()\n\n"
+        "    pv2 = PvObject.deserialize(buffer, context)\n\n")
+    .staticmethod("deserialize")
+
 #if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
     .add_property("useNumPyArrays", &PvObject::getUseNumPyArraysFlag, &PvObject::setUseNumPyArraysFlag)
 #endif // if defined HAVE_NUMPY_SUPPORT && HAVE_NUMPY_SUPPORT == 1
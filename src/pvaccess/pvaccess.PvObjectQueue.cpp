@@ -18,16 +18,20 @@ void wrapPvObjectQueue()
 
 class_<PvObjectQueue>("PvObjectQueue", 
     "PvObjectQueue is a class that can be used for receiving channel updates.\n\n"
-    "**PvObjectQueue([maxLength])**\n\n"
+    "**PvObjectQueue([maxLength, lockFree])**\n\n"
     "\t:Parameter: *maxLength* (int) - (optional) maximum queue length; if not provided, queue length will be unlimited\n\n"
+    "\t:Parameter: *lockFree* (bool) - (optional) if True, queue will be backed by a lock-free ring buffer (default: False); lock-free queue must have a positive maximum length, which cannot be increased later, and may only be used by a single producer thread and a single consumer thread\n\n"
     "\tExample:\n\n"
     "\t::\n\n"
     "\t\tpvq = PvObjectQueue(10000)\n\n"
+    "\t\tpvq2 = PvObjectQueue(10000, True)\n\n"
     "\n\n", 
     init<>())
 
     .def(init<int>(args("maxLength")))
 
+    .def(init<int, bool>(args("maxLength", "lockFree")))
+
     .def("__len__",
         static_cast<unsigned int(PvObjectQueue::*)()>(&PvObjectQueue::size),
         "Retrieves queue size.\n\n"
@@ -135,20 +139,22 @@ class_<PvObjectQueue>("PvObjectQueue",
 
     .def("getTimeSinceLastPut",
         static_cast<double(PvObjectQueue::*)()>(&PvObjectQueue::getTimeSinceLastPush),
-        "Returns number of seconds since last item was pushed into the queue.\n\n"
+        "Returns number of seconds since last item was pushed into the queue. For lock-free queues, push time is not recorded for each item, and is determined with the resolution of calls to this method.\n\n"
         ":Returns: seconds after last push\n\n"
         "::\n\n"
         "    t = pvq.getTimeSinceLastPut()\n\n")
 
     .def("getTimeSinceLastGet",
         static_cast<double(PvObjectQueue::*)()>(&PvObjectQueue::getTimeSinceLastPop),
-        "Returns number of seconds since last item was popped from the queue.\n\n"
+        "Returns number of seconds since last item was popped from the queue. For lock-free queues, pop time is not recorded for each item, and is determined with the resolution of calls to this method.\n\n"
         ":Returns: seconds after last pop\n\n"
         "::\n\n"
         "    t = pvq.getTimeSinceLastGet()\n\n")
 
     .add_property("maxLength", &PvObjectQueue::getMaxLength, &PvObjectQueue::setMaxLength)
 
+    .add_property("lockFree", &PvObjectQueue::isLockFree)
+
 ;
 
 } // wrapPvObjectQueue()
@@ -0,0 +1,73 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "boost/python/class.hpp"
+#include "boost/python/dict.hpp"
+
+#include "PvRecordHandle.h"
+
+using namespace boost::python;
+
+//
+// PV Record Handle class
+//
+void wrapPvRecordHandle() 
+{
+
+class_<PvRecordHandle>("PvRecordHandle", 
+    "PvRecordHandle is a direct reference to a PvaServer record. It is obtained via PvaServer.getRecordHandle() method, and can be used for repeated updates of the same record without channel name lookup.\n\n"
+    "\t::\n\n"
+    "\t\tpvaServer = PvaServer('pair', PvObject({'x': INT, 'y' : INT}))\n\n" 
+    "\t\th = pvaServer.getRecordHandle('pair')\n\n"
+    "\t\th.update(PvObject({'x': INT, 'y' : INT}, {'x' : 3, 'y' : 5}))\n\n",
+    no_init)
+
+    .def("update",
+        static_cast<void(PvRecordHandle::*)(const boost::python::dict&)>(&PvRecordHandle::update),
+        args("pyDict"),
+        "Updates record's PV object. This method is atomic.\n\n"
+        ":Parameter: *pyDict* (dict) - python dictionary containing updated field values.\n\n"
+        ":Raises: *ObjectNotFound* - when record has been removed from the server\n\n"
+        "::\n\n"
+        "    h.update({'x' : 3, 'y' : 5})\n\n")
+
+    .def("update",
+        static_cast<void(PvRecordHandle::*)(const PvObject&)>(&PvRecordHandle::update),
+        args("pvObject"),
+        "Updates record's PV object. This method is atomic.\n\n"
+        ":Parameter: *pvObject* (PvObject) - PV object with a structure equivalent to the structure of the record's object.\n\n"
+        ":Raises: *ObjectNotFound* - when record has been removed from the server\n\n"
+        "::\n\n"
+        "    h.update(PvObject({'x' : INT, 'y' : INT}, {'x' : 3, 'y' : 5}))\n\n")
+
+    .def("updateUnchecked",
+        static_cast<void(PvRecordHandle::*)(const PvObject&)>(&PvRecordHandle::updateUnchecked),
+        args("pvObject"),
+        "Updates record's PV object without checking that structures match. This method is atomic, and should be used only in those cases where the structure of the updated object is guaranteed to match the structure of the record's object.\n\n"
+        ":Parameter: *pvObject* (PvObject) - PV object with a structure equivalent to the structure of the record's object.\n\n"
+        ":Raises: *ObjectNotFound* - when record has been removed from the server\n\n"
+        "::\n\n"
+        "    h.updateUnchecked(PvObject({'x' : INT, 'y' : INT}, {'x' : 3, 'y' : 5}))\n\n")
+
+    .def("updateChanged",
+        static_cast<unsigned int(PvRecordHandle::*)(const PvObject&)>(&PvRecordHandle::updateChanged),
+        args("pvObject"),
+        "Updates record's PV object by copying only those fields whose values differ from the current record values. This method is atomic.\n\n"
+        ":Parameter: *pvObject* (PvObject) - PV object with a structure equivalent to the structure of the record's object.\n\n"
+        ":Returns: number of updated fields\n\n"
+        ":Raises: *ObjectNotFound* - when record has been removed from the server\n\n"
+        ":Raises: *InvalidArgument* - when object structure does not match record structure\n\n"
+        "::\n\n"
+        "    nUpdated = h.updateChanged(PvObject({'x' : INT, 'y' : INT}, {'x' : 3, 'y' : 5}))\n\n")
+
+    .def("isValid",
+        &PvRecordHandle::isValid,
+        "Checks whether record is still served, i.e., that it has not been removed from the server.\n\n"
+        ":Returns: True if record can be updated via this handle, False otherwise\n\n"
+        "::\n\n"
+        "    valid = h.isValid()\n\n")
+
+    .add_property("channelName", &PvRecordHandle::getChannelName, "Record channel name.")
+;
+
+} // wrapPvRecordHandle()
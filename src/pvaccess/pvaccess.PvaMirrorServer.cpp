@@ -48,7 +48,7 @@ class_<PvaMirrorServer, bases<PvaServer> >("PvaMirrorServer",
 
     .def("addMirrorRecord",
         static_cast<void(PvaMirrorServer::*)(const std::string&,const std::string&,PvProvider::ProviderType, unsigned int, unsigned int, const std::string&)>(&PvaMirrorServer::addMirrorRecord),
-        args("mirrorChannelName", "srcChannelName", "srcProviderType", "srcQueueSize, nSrcMonitors, srcFieldRequestDescriptor"),
+        args("mirrorChannelName", "srcChannelName", "srcProviderType", "srcQueueSize", "nSrcMonitors", "srcFieldRequestDescriptor"),
         "Adds mirror PV record to the server database. This method allows users to set server queue size and to use multiple monitors for the source channel, typically in combination with the data distributor plugin.\n\n"
         ":Parameter: *mirrorChannelName* (str) - mirror channel name\n\n"
         ":Parameter: *srcChannelName* (str) - source channel name\n\n"
@@ -62,6 +62,24 @@ class_<PvaMirrorServer, bases<PvaServer> >("PvaMirrorServer",
         "::\n\n"
         "    pvaMirrorServer.addMirrorRecord('mirrorPair', 'pair', PVA, 10, 2, '_[pydistributor=updates:1]')\n\n")
 
+    .def("addMirrorRecord",
+        static_cast<void(PvaMirrorServer::*)(const std::string&,const std::string&,PvProvider::ProviderType, unsigned int, unsigned int, const std::string&, const std::string&)>(&PvaMirrorServer::addMirrorRecord),
+        args("mirrorChannelName", "srcChannelName", "srcProviderType", "srcQueueSize", "nSrcMonitors", "srcFieldRequestDescriptor", "mirrorFieldRequestDescriptor"),
+        "Adds mirror PV record to the server database, which contains only selected fields of the source channel structure. Mirror records with the same source channel settings (name, provider type, queue size, number of monitors and field request descriptor) share source channel monitors, and each source update is projected to the fields selected for a given mirror record. Array data is shared between source and mirror records without copying.\n\n"
+        ":Parameter: *mirrorChannelName* (str) - mirror channel name\n\n"
+        ":Parameter: *srcChannelName* (str) - source channel name\n\n"
+        ":Parameter: *srcProviderType* (PROVIDERTYPE) - provider type, either PVA (PV Access) or CA (Channel Access)\n\n"
+        ":Parameter: *srcQueueSize* (int) - source queue size (should be >= 0)\n\n"
+        ":Parameter: *nSrcMonitors* (int) - number of listeners to use for the source channel\n\n"
+        ":Parameter: *srcFieldRequestDescriptor* (str) - field descriptor for the source channel name, typically used for turning on the data distributor plugin\n\n"
+        ":Parameter: *mirrorFieldRequestDescriptor* (str) - descriptor of source fields that will be included in the mirror record (e.g., 'value,timeStamp'); empty descriptor selects all fields\n\n"
+        ":Raises: *ObjectAlreadyExists* - when database already contains record associated with a given mirror channel name\n\n"
+        ":Raises: *InvalidRequest* - in case of invalid parameter values\n\n"
+        ":Raises: *PvaException* - in case of any other errors\n\n"
+        "::\n\n"
+        "    pvaMirrorServer.addMirrorRecord('mirrorImage', 'image', PVA, 0, 1, '', 'value,timeStamp')\n\n"
+        "    pvaMirrorServer.addMirrorRecord('mirrorImageAttributes', 'image', PVA, 0, 1, '', 'attribute,timeStamp')\n\n")
+
     .def("removeMirrorRecord",
         static_cast<void(PvaMirrorServer::*)(const std::string&)>(&PvaMirrorServer::removeMirrorRecord),
         args("mirrorChannelName"),
@@ -88,6 +106,37 @@ class_<PvaMirrorServer, bases<PvaServer> >("PvaMirrorServer",
         "::\n\n"
         "    if pvaMirrorServer.hasMirrorRecord('pair'): print('Server contains mirror pair channel.)'\n\n")
 
+    .def("setMirrorRecordMaxUpdateRate",
+        static_cast<void(PvaMirrorServer::*)(const std::string&,double)>(&PvaMirrorServer::setMirrorRecordMaxUpdateRate),
+        args("mirrorChannelName", "maxUpdateRate"),
+        "Limits rate of mirror record updates. Source updates arriving sooner than 1/maxUpdateRate seconds after the last record update are not copied into the record; the latest of those updates is published when the update period expires, so that the mirror record does not keep a stale value after a burst of source updates.\n\n"
+        ":Parameter: *mirrorChannelName* (str) - mirror channel name\n\n"
+        ":Parameter: *maxUpdateRate* (float) - maximum number of record updates per second; values <= 0 disable rate limit\n\n"
+        ":Raises: *ObjectNotFound* - when database does not contain mirror record associated with a given channel name\n\n"
+        "::\n\n"
+        "    pvaMirrorServer.setMirrorRecordMaxUpdateRate('mirrorImage', 5)\n\n")
+
+    .def("setMirrorRecordDecimation",
+        static_cast<void(PvaMirrorServer::*)(const std::string&,unsigned int)>(&PvaMirrorServer::setMirrorRecordDecimation),
+        args("mirrorChannelName", "decimation"),
+        "Updates mirror record with every N-th source update only; remaining source updates are discarded before they are copied into the record.\n\n"
+        ":Parameter: *mirrorChannelName* (str) - mirror channel name\n\n"
+        ":Parameter: *decimation* (int) - decimation factor N; values <= 1 disable decimation\n\n"
+        ":Raises: *ObjectNotFound* - when database does not contain mirror record associated with a given channel name\n\n"
+        "::\n\n"
+        "    pvaMirrorServer.setMirrorRecordDecimation('mirrorImage', 100)\n\n")
+
+    .def("setMirrorRecordDeadband",
+        static_cast<void(PvaMirrorServer::*)(const std::string&,const std::string&,double)>(&PvaMirrorServer::setMirrorRecordDeadband),
+        args("mirrorChannelName", "fieldName", "deadband"),
+        "Updates mirror record only if the given scalar field of the source structure changes by at least deadband value since the last record update.\n\n"
+        ":Parameter: *mirrorChannelName* (str) - mirror channel name\n\n"
+        ":Parameter: *fieldName* (str) - source scalar field name (e.g., 'value' or 'uniqueId'); empty string disables deadband\n\n"
+        ":Parameter: *deadband* (float) - minimum absolute field change; values <= 0 disable deadband\n\n"
+        ":Raises: *ObjectNotFound* - when database does not contain mirror record associated with a given channel name\n\n"
+        "::\n\n"
+        "    pvaMirrorServer.setMirrorRecordDeadband('mirrorTemperature', 'value', 0.5)\n\n")
+
     .def("resetMirrorRecordCounters",
         static_cast<void(PvaMirrorServer::*)(const std::string&)>(&PvaMirrorServer::resetMirrorRecordCounters),
         "Reset all record counters to zero.\n\n"
@@ -97,7 +146,7 @@ class_<PvaMirrorServer, bases<PvaServer> >("PvaMirrorServer",
 
     .def("getMirrorRecordCounters",
         static_cast<dict(PvaMirrorServer::*)(const std::string&)>(&PvaMirrorServer::getMirrorRecordCounters),
-        "Retrieve dictionary with record counters, which include number of updates received and number of monitor overruns.\n\n"
+        "Retrieve dictionary with record counters, which include number of updates received from the source channel, number of source monitor overruns, number of mirror record updates, numbers of source updates suppressed by decimation, deadband and rate limit policies, and number of mirror records sharing the same source channel.\n\n"
         ":Parameter: *mirrorChannelName* (str) - mirror channel name\n\n"
         ":Returns: dictionary containing available statistics counters\n\n"
         "::\n\n"
@@ -146,6 +146,42 @@ class_<PvaServer>("PvaServer",
         "    pv = PvObject({'x' : INT, 'y' : INT}, {'x' : 3, 'y' : 5})\n\n"
         "    pvaServer.update('myChannel', pv)\n\n")
 
+    .def("updateChanged",
+        static_cast<unsigned int(PvaServer::*)(const PvObject&)>(&PvaServer::updateChanged),
+        args("pvObject"),
+        "Updates server's PV object by copying only those fields whose values differ from the current record values, so that monitor clients receive only changed fields. This method is atomic, but can be used only when there is a single record in the master database.\n\n"
+        ":Parameter: *pvObject* (PvObject) - PV object with a structure equivalent to the structure of the object registered on the server's PV channel.\n\n"
+        ":Returns: number of updated fields\n\n"
+        ":Raises: *InvalidRequest* - when there is none or more than one record in the database\n\n"
+        ":Raises: *InvalidArgument* - when object structure does not match record structure\n\n"
+        "::\n\n"
+        "    pv2 = PvObject({'x' : INT, 'y' : INT}, {'x' : 3, 'y' : 5})\n\n"
+        "    nUpdated = pvaServer.updateChanged(pv2)\n\n")
+
+    .def("updateChanged",
+        static_cast<unsigned int(PvaServer::*)(const std::string&, const PvObject&)>(&PvaServer::updateChanged),
+        args("channelName", "pvObject"),
+        "Updates server's PV object on a given channel by copying only those fields whose values differ from the current record values, so that monitor clients receive only changed fields. This method is atomic, and should be used when there are multiple records in the master database.\n\n"
+        ":Parameter: *channelName* (str) - channel name.\n\n"
+        ":Parameter: *pvObject* (PvObject) - PV object with a structure equivalent to the structure of the object registered on the server's PV channel.\n\n"
+        ":Returns: number of updated fields\n\n"
+        ":Raises: *ObjectNotFound* - when there is no record associated with a given channel\n\n"
+        ":Raises: *InvalidArgument* - when object structure does not match record structure\n\n"
+        "::\n\n"
+        "    pv = PvObject({'x' : INT, 'y' : INT}, {'x' : 3, 'y' : 5})\n\n"
+        "    nUpdated = pvaServer.updateChanged('myChannel', pv)\n\n")
+
+    .def("updateMany",
+        static_cast<void(PvaServer::*)(const boost::python::dict&)>(&PvaServer::updateMany),
+        args("updateDict"),
+        "Updates PV objects on multiple channels. All channel records are resolved, and all update values are checked against record structures, before any of the records is updated. PvObject values are copied into records without holding python GIL, and are distributed over a pool of worker threads for large number of records; dictionary values are applied afterwards.\n\n"
+        ":Parameter: *updateDict* (dict) - dictionary mapping channel names to PvObject instances or to python dictionaries containing updated field values.\n\n"
+        ":Raises: *ObjectNotFound* - when there is no record associated with one of the channels\n\n"
+        ":Raises: *InvalidArgument* - when dictionary contains invalid channel name or update value; no records are updated in this case\n\n"
+        ":Raises: *PvaException* - when some of the records could not be updated after validation; error message contains number of records that were updated\n\n"
+        "::\n\n"
+        "    pvaServer.updateMany({'x1' : PvInt(3), 'x2' : PvInt(5), 'y' : {'value' : 7}})\n\n")
+
 #ifndef WINDOWS
     .def("addRecord",
         static_cast<void(PvaServer::*)(const std::string&,const PvObject&,const boost::python::object&)>(&PvaServer::addRecord),
@@ -252,6 +288,61 @@ class_<PvaServer>("PvaServer",
         ":Returns: list of known channel names\n\n"
         "::\n\n"
         "    recordNames = pvaServer.getRecordNames()\n\n")
+
+    .def("getRecordHandle",
+        static_cast<PvRecordHandle(PvaServer::*)(const std::string&)>(&PvaServer::getRecordHandle),
+        args("channelName"),
+        "Retrieves handle for the record associated with a given channel. Record handle can be used for repeated updates without channel name lookup.\n\n"
+        ":Parameter: *channelName* (str) - channel name\n\n"
+        ":Returns: record handle\n\n"
+        ":Raises: *ObjectNotFound* - when there is no record associated with a given channel\n\n"
+        "::\n\n"
+        "    h = pvaServer.getRecordHandle('myChannel')\n\n"
+        "    h.update(PvObject({'x' : INT, 'y' : INT}, {'x' : 3, 'y' : 5}))\n\n")
+
+    .def("setNumCallbackThreads",
+        &PvaServer::setNumCallbackThreads,
+        args("nCallbackThreads"),
+        "Sets number of threads executing record write callbacks. Callbacks for the same record are always executed in order, while callbacks for different records may be executed concurrently. Repeated writes to a record whose callback is still pending are coalesced into a single callback. The number of threads cannot be changed after callback threads have been started, i.e., after the first record with write callback has been added. By default, the server uses a single callback thread.\n\n"
+        ":Parameter: *nCallbackThreads* (int) - number of callback threads (must be positive)\n\n"
+        ":Raises: *InvalidArgument* - when number of threads is not positive\n\n"
+        ":Raises: *InvalidState* - when callback threads are already running\n\n"
+        "::\n\n"
+        "    pvaServer.setNumCallbackThreads(4)\n\n")
+
+    .def("getNumCallbackThreads",
+        &PvaServer::getNumCallbackThreads,
+        "Retrieves number of threads executing record write callbacks.\n\n"
+        ":Returns: number of callback threads\n\n"
+        "::\n\n"
+        "    nCallbackThreads = pvaServer.getNumCallbackThreads()\n\n")
+
+    .def("getCallbackQueueSize",
+        &PvaServer::getCallbackQueueSize,
+        "Retrieves number of records with pending write callbacks.\n\n"
+        ":Returns: callback queue size\n\n"
+        "::\n\n"
+        "    queueSize = pvaServer.getCallbackQueueSize()\n\n")
+
+    .def("getCallbackCounters",
+        &PvaServer::getCallbackCounters,
+        "Retrieves record write callback counters: number of received writes (nReceived), writes coalesced into already pending callbacks (nCoalesced), executed callbacks (nDelivered), currently pending callbacks (nQueued), and maximum number of pending callbacks (maxQueued).\n\n"
+        ":Returns: dictionary containing callback counters\n\n"
+        "::\n\n"
+        "    counterDict = pvaServer.getCallbackCounters()\n\n")
+
+    .def("getCallbackLatencyHistograms",
+        &PvaServer::getCallbackLatencyHistograms,
+        "Retrieves latency histograms for record write callbacks: time between record write and callback start (queueWait), and callback execution time including GIL wait (callback). Each histogram is a dictionary containing count, min, mean, max and estimated p50/p90/p99 latencies in seconds, as well as non-empty buckets keyed by their upper bound in microseconds.\n\n"
+        ":Returns: dictionary containing callback latency histograms\n\n"
+        "::\n\n"
+        "    histogramDict = pvaServer.getCallbackLatencyHistograms()\n\n")
+
+    .def("resetCallbackCounters",
+        &PvaServer::resetCallbackCounters,
+        "Resets record write callback counters and latency histograms.\n\n"
+        "::\n\n"
+        "    pvaServer.resetCallbackCounters()\n\n")
 ;
 } // wrapPvaServer()
 
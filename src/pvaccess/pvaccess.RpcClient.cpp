@@ -82,6 +82,68 @@ class_<RpcClient>("RpcClient",
         "    pvArgument.set({'nRows' : 10, 'nColumns' : 10})\n\n"
         "    pvResponse = rpcClient(pvArgument)\n\n"
         "    ntTable = NtTable(pvResponse)\n\n")
+
+#if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
+    .def("invokeAsync", 
+        static_cast<void(RpcClient::*)(const PvObject&, const object&, const object&)>(&RpcClient::invokeAsync),
+        args("pvArgument", "callback", "errorCallback"),
+        "Invokes asynchronous RPC call against service registered on the PV specified channel. Requests are issued from a client thread over a pool of connected RPC clients that are reused across calls, so that multiple requests can be outstanding at the same time (see *setMaxOutstandingRequests()*). Callbacks are invoked from the same thread, in request order. Request uses client timeout that was set at the time of the call. Requests that are still pending when the client is destroyed fail with an error.\n\n"
+        ":Parameter: *pvArgument* (PvObject) - PV argument object with a structure conforming to requirements of the RPC service registered on the given PV channel\n\n"
+        ":Parameter: *callback* (object) - reference to python function that will be invoked with PV response object\n\n"
+        ":Parameter: *errorCallback* (object) - reference to python function that will be invoked with error message if request fails\n\n"
+        "::\n\n"
+        "    def echo(pv):\n\n"
+        "        print(pv)\n\n"
+        "    def error(msg):\n\n"
+        "        print('ERROR: %s' % msg)\n\n"
+        "    rpcClient.invokeAsync(pvArgument, echo, error)\n\n")
+
+    .def("invokeAsync", 
+        static_cast<void(RpcClient::*)(const PvObject&, const object&)>(&RpcClient::invokeAsync),
+        args("pvArgument", "callback"),
+        "Invokes asynchronous RPC call against service registered on the PV specified channel. This method is equivalent to *invokeAsync(pvArgument, callback, errorCallback)*, except that errors are only logged.\n\n"
+        ":Parameter: *pvArgument* (PvObject) - PV argument object with a structure conforming to requirements of the RPC service registered on the given PV channel\n\n"
+        ":Parameter: *callback* (object) - reference to python function that will be invoked with PV response object\n\n"
+        "::\n\n"
+        "    rpcClient.invokeAsync(pvArgument, echo)\n\n")
+
+    .def("invokeFuture", 
+        &RpcClient::invokeFuture,
+        args("pvArgument"),
+        "Invokes asynchronous RPC call against service registered on the PV specified channel, and returns future for the response. Requests are handled in the same way as for *invokeAsync()*.\n\n"
+        ":Parameter: *pvArgument* (PvObject) - PV argument object with a structure conforming to requirements of the RPC service registered on the given PV channel\n\n"
+        ":Returns: concurrent.futures.Future object, whose result is PV response object; if request fails, future raises PvaException\n\n"
+        "::\n\n"
+        "    future = rpcClient.invokeFuture(pvArgument)\n\n"
+        "    pvResponse = future.result()\n\n")
+
+    .def("invokeBatch", 
+        &RpcClient::invokeBatch,
+        args("pvArgumentList"),
+        "Invokes RPC call for each argument in the list, and waits for all responses. All requests are submitted before waiting for the first response, so that up to the maximum number of outstanding requests are in progress at any time.\n\n"
+        ":Parameter: *pvArgumentList* (list) - list of PV argument objects\n\n"
+        ":Returns: list of PV response objects, in the argument list order\n\n"
+        ":Raises: *InvalidArgument* - when argument list contains objects other than PvObject instances\n\n"
+        ":Raises: *PvaException* - when any of the requests fails\n\n"
+        "::\n\n"
+        "    pvResponseList = rpcClient.invokeBatch(pvArgumentList)\n\n")
+
+    .def("getMaxOutstandingRequests",
+        &RpcClient::getMaxOutstandingRequests,
+        "Retrieves maximum number of outstanding asynchronous requests.\n\n"
+        ":Returns: maximum number of outstanding requests\n\n"
+        "::\n\n"
+        "    maxOutstandingRequests = rpcClient.getMaxOutstandingRequests()\n\n")
+
+    .def("setMaxOutstandingRequests",
+        &RpcClient::setMaxOutstandingRequests,
+        args("maxOutstandingRequests"),
+        "Sets maximum number of asynchronous requests that may be in progress at the same time. Each outstanding request uses its own connected RPC client; clients are kept and reused for subsequent requests. Default value is 16.\n\n"
+        ":Parameter: *maxOutstandingRequests* (int) - maximum number of outstanding requests\n\n"
+        ":Raises: *InvalidArgument* - when value is not positive\n\n"
+        "::\n\n"
+        "    rpcClient.setMaxOutstandingRequests(32)\n\n")
+#endif // if defined PVA_RPC_API_VERSION && PVA_RPC_API_VERSION >= 480
 ;
 
 } // wrapRpcClient()
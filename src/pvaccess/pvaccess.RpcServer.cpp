@@ -17,7 +17,7 @@ BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(RpcServerListen, RpcServer::listen, 0, 1)
 void wrapRpcServer() 
 {
 
-class_<RpcServer>("RpcServer", 
+class_<RpcServer, boost::noncopyable>("RpcServer", 
     "RpcServer is class used for hosting PVA RPC services. One instance of RpcServer can host multiple RPC services.\n\n"
     "**RpcServer()**:\n\n"
     "\t::\n\n"
@@ -25,7 +25,7 @@ class_<RpcServer>("RpcServer",
     init<>())
 
     .def("registerService", 
-        &RpcServer::registerService, 
+        static_cast<void(RpcServer::*)(const std::string&,const object&)>(&RpcServer::registerService), 
         args("serviceName", "serviceImpl"), 
         "Registers service implementation with RPC server. Typically, all services are registered before RPC server starts listening for client requests.\n\n"
         ":Parameter: *serviceName* (str) - service name (name of the PV channel used for RPC client/server communication)\n\n"
@@ -54,6 +54,40 @@ class_<RpcServer>("RpcServer",
         "    rpcServer.registerService('createNtTable', createNtTable)\n\n"
         "    rpcServer.listen()\n\n")
 
+    .def("registerService", 
+        static_cast<void(RpcServer::*)(const std::string&,const object&,int)>(&RpcServer::registerService), 
+        args("serviceName", "serviceImpl", "maxConcurrentRequests"), 
+        "Registers service implementation with RPC server, and limits number of requests for this service that may be executed at the same time. Limit can be set only if RPC server uses worker threads (see *setNumWorkers()*), which must be configured before the service is registered; requests exceeding the limit wait in the service queue, so that a busy service does not occupy all worker threads.\n\n"
+        ":Parameter: *serviceName* (str) - service name (name of the PV channel used for RPC client/server communication)\n\n"
+        ":Parameter: *serviceImpl* (object) - reference to service implementation object (e.g., python function) that returns PV Object upon invocation\n\n"
+        ":Parameter: *maxConcurrentRequests* (int) - maximum number of concurrently executing requests; value of 0 means no limit other than the number of worker threads\n\n"
+        ":Raises: *InvalidArgument* - when maximum number of concurrent requests is negative, or when it is positive and RPC server does not use worker threads\n\n"
+        "::\n\n"
+        "    rpcServer.setNumWorkers(8)\n\n"
+        "    rpcServer.registerService('createNtTable', createNtTable, 2)\n\n")
+
+    .def("registerNativeService", 
+        static_cast<void(RpcServer::*)(const std::string&,const std::string&)>(&RpcServer::registerNativeService), 
+        args("serviceName", "libraryName"), 
+        "Loads native (C++) service implementation from a shared library and registers it with RPC server. Library must export factory function 'createPvaPyRpcService' with C linkage, as described in RpcServicePlugin.h header. Native services are called directly from pvAccess server threads without acquiring python GIL, and can be registered together with python services in the same server.\n\n"
+        ":Parameter: *serviceName* (str) - service name (name of the PV channel used for RPC client/server communication)\n\n"
+        ":Parameter: *libraryName* (str) - shared library name or path\n\n"
+        ":Raises: *ConfigurationError* - when library or factory function cannot be loaded, or when factory function fails to create service\n\n"
+        "::\n\n"
+        "    rpcServer.registerNativeService('arrayStatistics', './libarrayStatisticsService.so')\n\n")
+
+    .def("registerNativeService", 
+        static_cast<void(RpcServer::*)(const std::string&,const std::string&,const std::string&,const std::string&)>(&RpcServer::registerNativeService), 
+        args("serviceName", "libraryName", "factoryName", "configuration"), 
+        "Loads native (C++) service implementation from a shared library using a given factory function, and registers it with RPC server. Factory function receives service name and configuration string, and must have the same signature as 'createPvaPyRpcService' described in RpcServicePlugin.h header. Factory function is looked up only in the given library, so different libraries may use the same factory name.\n\n"
+        ":Parameter: *serviceName* (str) - service name (name of the PV channel used for RPC client/server communication)\n\n"
+        ":Parameter: *libraryName* (str) - shared library name or path\n\n"
+        ":Parameter: *factoryName* (str) - name of the factory function\n\n"
+        ":Parameter: *configuration* (str) - service configuration passed to factory function\n\n"
+        ":Raises: *ConfigurationError* - when library or factory function cannot be loaded, or when factory function fails to create service\n\n"
+        "::\n\n"
+        "    rpcServer.registerNativeService('tableQuery', './libtableServices.so', 'createTableQueryService', 'nRows=100')\n\n")
+
     .def("unregisterService", 
         &RpcServer::unregisterService, 
         args("serviceName"), 
@@ -62,6 +96,36 @@ class_<RpcServer>("RpcServer",
         "::\n\n"
         "    rpcServer.unregisterService('createNtTable')\n\n")
 
+    .def("setNumWorkers", 
+        &RpcServer::setNumWorkers, 
+        args("nWorkers"), 
+        "Sets number of worker threads used for executing RPC requests. By default, services are called directly from pvAccess server threads, so a single slow request may delay other clients. Services registered after the number of workers is set to a positive value are executed asynchronously by a pool of worker threads shared by all such services, and responses are returned to clients as soon as requests complete. Note that worker threads still need python GIL for calling services, so services benefit from multiple workers only if they release GIL (e.g., while waiting for I/O or in native code).\n\n"
+        ":Parameter: *nWorkers* (int) - number of worker threads; value of 0 means that services are called from pvAccess server threads\n\n"
+        ":Raises: *InvalidArgument* - when number of workers is negative\n\n"
+        ":Raises: *InvalidState* - when worker threads have already been started\n\n"
+        "::\n\n"
+        "    rpcServer.setNumWorkers(8)\n\n")
+
+    .def("getNumWorkers", 
+        &RpcServer::getNumWorkers, 
+        "Retrieves number of worker threads used for executing RPC requests.\n\n"
+        ":Returns: number of worker threads; value of 0 means that services are called from pvAccess server threads\n\n"
+        "::\n\n"
+        "    nWorkers = rpcServer.getNumWorkers()\n\n")
+
+    .def("getServiceCounters", 
+        &RpcServer::getServiceCounters, 
+        "Retrieves request counters for services executed by worker threads. Dictionary is keyed by service name, and counters include number of received, delivered (completed), rejected, active and queued requests.\n\n"
+        ":Returns: dictionary of service counters\n\n"
+        "::\n\n"
+        "    counters = rpcServer.getServiceCounters()\n\n")
+
+    .def("resetServiceCounters", 
+        &RpcServer::resetServiceCounters, 
+        "Resets request counters for services executed by worker threads.\n\n"
+        "::\n\n"
+        "    rpcServer.resetServiceCounters()\n\n")
+
     .def("startListener", 
         &RpcServer::startListener, 
         "Starts RPC listener in its own thread. This method is typically used for multi-threaded programs, or for testing and debugging in python interactive mode. It should be used in conjunction with *stopListener()* call.\n\n"
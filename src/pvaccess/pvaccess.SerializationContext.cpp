@@ -0,0 +1,35 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "boost/python/class.hpp"
+#include "pvapy.environment.h"
+#include "SerializationContext.h"
+
+using namespace boost::python;
+
+//
+// SerializationContext class
+//
+void wrapSerializationContext()
+{
+
+class_<SerializationContext>("SerializationContext", 
+    "SerializationContext keeps track of structure types that were sent or received over a serialization stream (e.g., socket or file). Each end of the stream uses its own context with PvObject *serialize()* and *deserialize()* methods, so that structure introspection is included only with the first object of a given type, and subsequent objects reference the structure by id assigned by IntrospectionRegistry. Objects must be deserialized in the order in which they were serialized, and neither end of the stream may skip objects.\n\n"
+    "**SerializationContext()**\n\n"
+    "\tExample:\n\n"
+    "\t::\n\n"
+    "\t\tsenderContext = SerializationContext()\n\n"
+    "\t\tbuffer = pv.serialize(senderContext)\n\n"
+    "\t\treceiverContext = SerializationContext()\n\n"
+    "\t\tpv2 = PvObject.deserialize(buffer, receiverContext)\n\n"
+    "\n\n", 
+    init<>())
+
+    .def("reset",
+        &SerializationContext::reset,
+        "Forgets all structures sent or received using this context. Both ends of the stream must be reset at the same point in the stream.\n\n"
+        "::\n\n"
+        "    context.reset()\n\n")
+;
+
+} // wrapSerializationContext()
@@ -0,0 +1,185 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+#include "boost/python/class.hpp"
+#include "pvapy.environment.h"
+#include "SharedMemoryPvObjectQueue.h"
+
+using namespace boost::python;
+
+//
+// SharedMemoryPvObjectQueue class
+//
+void wrapSharedMemoryPvObjectQueue()
+{
+
+class_<SharedMemoryPvObjectQueue>("SharedMemoryPvObjectQueue", 
+    "SharedMemoryPvObjectQueue is a PvObject queue stored in POSIX shared memory, which can be used for passing PvObjects between processes instead of multiprocessing.Queue. Objects are serialized directly into the shared memory segment without pickling, and array data is stored so that consumers can either copy objects out of the segment using get(), or use getView() to receive objects whose numeric arrays (and NumPy arrays created from them) reference shared memory directly. Queue created with maximum length owns the shared memory segment, which is removed when the queue is destroyed. Other processes attach to an existing segment using queue name; queue instances passed to processes via pickling attach automatically. Any number of producer and consumer processes may use the same queue.\n\n"
+    "**SharedMemoryPvObjectQueue(name [, maxLength, segmentSize])**\n\n"
+    "\t:Parameter: *name* (str) - shared memory segment name\n\n"
+    "\t:Parameter: *maxLength* (int) - (optional) maximum queue length; if provided, new shared memory segment will be created, and value of -1 or 0 indicates that the queue length is limited only by the segment size\n\n"
+    "\t:Parameter: *segmentSize* (int) - (optional) shared memory segment size in bytes (default: 256MB); it must be at least 1MB\n\n"
+    "\t:Raises: *ObjectAlreadyExists* - when creating new shared memory segment, and segment with the same name already exists\n\n"
+    "\t:Raises: *InvalidRequest* - when shared memory segment cannot be created or attached to\n\n"
+    "\tExample:\n\n"
+    "\t::\n\n"
+    "\t\tpvq = SharedMemoryPvObjectQueue('pvapy_queue', 100)\n\n"
+    "\t\tpvq2 = SharedMemoryPvObjectQueue('pvapy_queue')\n\n"
+    "\n\n", 
+    init<std::string>(args("name")))
+
+    .def(init<std::string, int>(args("name", "maxLength")))
+
+    .def(init<std::string, int, unsigned long long>(args("name", "maxLength", "segmentSize")))
+
+    .def_pickle(SharedMemoryPvObjectQueuePickleSuite())
+
+    .def("__len__",
+        &SharedMemoryPvObjectQueue::size,
+        "Retrieves queue size.\n\n"
+        "::\n\n"
+        "    size = len(pvq)\n\n")
+
+    .def("get",
+        static_cast<PvObject(SharedMemoryPvObjectQueue::*)()>(&SharedMemoryPvObjectQueue::get),
+        "Retrieves copy of the PvObject from the queue.\n\n"
+        ":Returns: PvObject from the queue\n\n"
+        ":Raises: *QueueEmpty* - when the queue is empty\n\n"
+        "::\n\n"
+        "    pv = pvq.get()\n\n")
+
+    .def("get",
+        static_cast<PvObject(SharedMemoryPvObjectQueue::*)(double)>(&SharedMemoryPvObjectQueue::get),
+        args("timeout"),
+        "Retrieves copy of the PvObject from the queue with wait if the queue is empty.\n\n"
+        ":Parameter: *timeout* (float) - amount of time to wait for a new PvObject if queue is empty\n\n"
+        ":Returns: PvObject from the queue\n\n"
+        ":Raises: *QueueEmpty* - when the queue is empty after the specified timeout\n\n"
+        "::\n\n"
+        "    pv = pvq.get(10)\n\n")
+
+    .def("getView",
+        static_cast<PvObject(SharedMemoryPvObjectQueue::*)()>(&SharedMemoryPvObjectQueue::getView),
+        "Retrieves PvObject from the queue without copying its numeric array data out of shared memory. Queue space used by the object is released only after the object and all NumPy arrays obtained from it are deleted. Since queue space is reused in queue order, a view that is kept (or held by a process that died) blocks all objects queued after it, and producers will eventually get QueueFull errors; number of objects held by consumers is reported by getCounters() under the 'nInUse' key. Views should therefore not be kept longer than necessary.\n\n"
+        ":Returns: PvObject from the queue\n\n"
+        ":Raises: *QueueEmpty* - when the queue is empty\n\n"
+        "::\n\n"
+        "    pv = pvq.getView()\n\n")
+
+    .def("getView",
+        static_cast<PvObject(SharedMemoryPvObjectQueue::*)(double)>(&SharedMemoryPvObjectQueue::getView),
+        args("timeout"),
+        "Retrieves PvObject from the queue without copying its numeric array data out of shared memory, with wait if the queue is empty.\n\n"
+        ":Parameter: *timeout* (float) - amount of time to wait for a new PvObject if queue is empty\n\n"
+        ":Returns: PvObject from the queue\n\n"
+        ":Raises: *QueueEmpty* - when the queue is empty after the specified timeout\n\n"
+        "::\n\n"
+        "    pv = pvq.getView(10)\n\n"
+        "    image = pv['value'][0]['ushortValue']\n\n")
+
+    .def("put",
+        static_cast<void(SharedMemoryPvObjectQueue::*)(const PvObject&)>(&SharedMemoryPvObjectQueue::put),
+        args("pvObject"),
+        "Puts PvObject into the queue.\n\n"
+        ":Parameter: *pvObject* (PvObject) - PV object that will be pushed into the queue\n\n"
+        ":Raises: *QueueFull* - when the queue is full\n\n"
+        ":Raises: *InvalidArgument* - when the object is larger than the queue capacity\n\n"
+        "::\n\n"
+        "    pvq.put(PvInt(1))\n\n")
+
+    .def("put",
+        static_cast<void(SharedMemoryPvObjectQueue::*)(const PvObject&,double)>(&SharedMemoryPvObjectQueue::put),
+        args("pvObject", "timeout"),
+        "Puts PvObject into the queue with wait if the queue is full.\n\n"
+        ":Parameter: *pvObject* (PvObject) - PV object that will be pushed into the queue\n\n"
+        ":Parameter: *timeout* (float) - amount of time to wait if the queue is full\n\n"
+        ":Raises: *QueueFull* - when the queue is full after the specified timeout\n\n"
+        ":Raises: *InvalidArgument* - when the object is larger than the queue capacity\n\n"
+        "::\n\n"
+        "    pvq.put(PvInt(1), 10)\n\n")
+
+    .def("waitForPut",
+        &SharedMemoryPvObjectQueue::waitForPut,
+        args("timeout"),
+        "Waits until the new PvObject is pushed into the queue.\n\n"
+        "::\n\n"
+        "    pvq.waitForPut(1.0)\n\n")
+
+    .def("waitForGet",
+        &SharedMemoryPvObjectQueue::waitForGet,
+        args("timeout"),
+        "Waits until the new PvObject is retrieved from the queue.\n\n"
+        "::\n\n"
+        "    pvq.waitForGet(1.0)\n\n")
+
+    .def("cancelWaitForPut",
+        &SharedMemoryPvObjectQueue::cancelWaitForPut,
+        "Cancels waitForPut() calls in all processes; get() calls waiting for queued objects are not affected.\n\n"
+        "::\n\n"
+        "    pvq.cancelWaitForPut()\n\n")
+
+    .def("cancelWaitForGet",
+        &SharedMemoryPvObjectQueue::cancelWaitForGet,
+        "Cancels waitForGet() calls in all processes; put() calls waiting for queue space are not affected.\n\n"
+        "::\n\n"
+        "    pvq.cancelWaitForGet()\n\n")
+
+    .def("clear",
+        &SharedMemoryPvObjectQueue::clear,
+        "Clear queue.\n\n"
+        "::\n\n"
+        "    pvq.clear()\n\n")
+
+    .def("resetCounters",
+        &SharedMemoryPvObjectQueue::resetCounters,
+        "Reset all statistics counters to zero.\n\n"
+        "::\n\n"
+        "    pvq.resetCounters()\n\n")
+
+    .def("getCounters",
+        &SharedMemoryPvObjectQueue::getCounters,
+        "Retrieve dictionary with all statistics counters, which include number of PvObjects accepted (pushed into the queue), rejected (not pushed into the queue), retrieved (popped from the queue), currently queued, being written by producers ('nWriting'), and retrieved but still held by consumers ('nInUse'); these counters are shared by all processes using the queue. The dictionary might also contain user defined counters, which are local to the calling process.\n\n"
+        ":Returns: dictionary containing available statistics counters\n\n"
+        "::\n\n"
+        "    counterDict = pvq.getCounters()\n\n")
+
+    .def("setCounter",
+        &SharedMemoryPvObjectQueue::setCounter,
+        args("key", "value"),
+        "Sets value for the user defined statistics counter identified with a given key.\n\n"
+        ":Parameter: *key* (str) - counter key\n\n"
+        ":Parameter: *value* (int) - counter value (should be >= 0)\n\n"
+        "::\n\n"
+        "    pvq.setCounter('myCnt', 1)\n\n")
+
+    .def("addToCounter",
+        &SharedMemoryPvObjectQueue::addToCounter,
+        args("key", "value"),
+        "Adds value to the user defined statistics counter identified with a given key.\n\n"
+        ":Parameter: *key* (str) - counter key\n\n"
+        ":Parameter: *value* (int) - counter value (should be >= 0)\n\n"
+        "::\n\n"
+        "    pvq.addToCounter('myCnt', 1)\n\n")
+
+    .def("getTimeSinceLastPut",
+        &SharedMemoryPvObjectQueue::getTimeSinceLastPut,
+        "Returns number of seconds since last item was pushed into the queue.\n\n"
+        ":Returns: seconds after last push\n\n"
+        "::\n\n"
+        "    t = pvq.getTimeSinceLastPut()\n\n")
+
+    .def("getTimeSinceLastGet",
+        &SharedMemoryPvObjectQueue::getTimeSinceLastGet,
+        "Returns number of seconds since last item was popped from the queue.\n\n"
+        ":Returns: seconds after last pop\n\n"
+        "::\n\n"
+        "    t = pvq.getTimeSinceLastGet()\n\n")
+
+    .add_property("maxLength", &SharedMemoryPvObjectQueue::getMaxLength, &SharedMemoryPvObjectQueue::setMaxLength)
+
+    .add_property("name", &SharedMemoryPvObjectQueue::getName)
+
+    .add_property("segmentSize", &SharedMemoryPvObjectQueue::getSegmentSize)
+;
+
+} // wrapSharedMemoryPvObjectQueue()
@@ -33,6 +33,8 @@ void wrapPvType();
 
 void wrapPvObject();
 void wrapPvObjectQueue();
+void wrapSharedMemoryPvObjectQueue();
+void wrapFieldAccessor();
 void wrapPvScalar();
 void wrapPvBoolean();
 void wrapPvByte();
@@ -66,11 +68,15 @@ void wrapNtScalar();
 void wrapNtTable();
 
 void wrapChannel();
+void wrapMonitorDispatcher();
+void wrapIntrospectionRegistry();
+void wrapSerializationContext();
 void wrapRpcServer();
 void wrapRpcClient();
 
 #if PVA_API_VERSION >= 450
 void wrapPvaServer();
+void wrapPvRecordHandle();
 #endif // if PVA_API_VERSION >= 450
 
 #if PVA_API_VERSION >= 481
@@ -129,6 +135,7 @@ BOOST_PYTHON_MODULE(pvaccess)
 
     // Class wrappers
     wrapPvObject();
+    wrapFieldAccessor();
     wrapPvScalar();
     wrapPvBoolean();
     wrapPvByte();
@@ -162,12 +169,17 @@ BOOST_PYTHON_MODULE(pvaccess)
     wrapNtTable();
 
     wrapChannel();
+    wrapMonitorDispatcher();
+    wrapIntrospectionRegistry();
+    wrapSerializationContext();
     wrapPvObjectQueue();
+    wrapSharedMemoryPvObjectQueue();
     wrapRpcClient();
     wrapRpcServer(); 
 
 #if PVA_API_VERSION >= 450
     wrapPvaServer();
+    wrapPvRecordHandle();
 #endif // if PVA_API_VERSION >= 450
 
 #if PVA_API_VERSION >= 481
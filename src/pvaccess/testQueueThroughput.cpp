@@ -0,0 +1,140 @@
+// Copyright information and license terms for this software can be
+// found in the file LICENSE that is included with the distribution
+
+// Compares monitor hand-off cost of SynchronizedQueue and SpscQueue.
+// Producer pushes copies of a small PV structure at a fixed rate,
+// consumer pops them in a separate thread, and the program reports
+// average push time and average/maximum push-to-pop latency.
+
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <epicsThread.h>
+#include <epicsTime.h>
+#include <pv/pvData.h>
+#include <pv/standardField.h>
+#include "SynchronizedQueue.h"
+#include "SpscQueue.h"
+
+namespace pvd = epics::pvData;
+
+struct MonitorUpdate
+{
+    MonitorUpdate() : timeStamp(), pvStructurePtr() {}
+    MonitorUpdate(const epicsTimeStamp& ts, const pvd::PVStructurePtr& pvs) : timeStamp(ts), pvStructurePtr(pvs) {}
+    epicsTimeStamp timeStamp;
+    pvd::PVStructurePtr pvStructurePtr;
+};
+
+template <class Q>
+struct QueueTest
+{
+    QueueTest(Q& queue_, int nUpdates_)
+        : queue(queue_), nUpdates(nUpdates_), nReceived(0), totalLatency(0), maxLatency(0), doneEvent() {}
+
+    static void consumerThread(void* arg)
+    {
+        QueueTest<Q>* test = static_cast<QueueTest<Q>*>(arg);
+        while (test->nReceived < test->nUpdates) {
+            try {
+                MonitorUpdate update = test->queue.frontAndPop(1.0);
+                epicsTimeStamp now;
+                epicsTimeGetCurrent(&now);
+                double latency = epicsTimeDiffInSeconds(&now, &update.timeStamp);
+                test->totalLatency += latency;
+                if (latency > test->maxLatency) {
+                    test->maxLatency = latency;
+                }
+                test->nReceived++;
+            }
+            catch (QueueEmpty&) {
+                // Producer is done or slow
+            }
+        }
+        test->doneEvent.signal();
+    }
+
+    void run(const std::string& label, double rate)
+    {
+        pvd::PVStructurePtr pvStructurePtr = pvd::getPVDataCreate()->createPVStructure(
+            pvd::getStandardField()->scalar(pvd::pvDouble, "alarm,timeStamp"));
+        pvd::PVDoublePtr pvValuePtr = pvStructurePtr->getSubField<pvd::PVDouble>("value");
+
+        epicsThreadCreate("consumer", epicsThreadPriorityHigh,
+            epicsThreadGetStackSize(epicsThreadStackSmall),
+            (EPICSTHREADFUNC)consumerThread, this);
+
+        epicsTimeStamp startTime;
+        epicsTimeGetCurrent(&startTime);
+        double totalPushTime = 0;
+        int nRejected = 0;
+        for (int i = 0; i < nUpdates; i++) {
+            // Pace producer to the requested update rate
+            epicsTimeStamp now;
+            do {
+                epicsTimeGetCurrent(&now);
+            } while (epicsTimeDiffInSeconds(&now, &startTime) < i/rate);
+
+            // Copy update, as done for the channel monitor queue
+            pvValuePtr->put(i);
+            pvd::PVStructurePtr pvStructurePtr2 = pvd::getPVDataCreate()->createPVStructure(pvStructurePtr->getStructure());
+            pvStructurePtr2->copyUnchecked(*pvStructurePtr);
+            MonitorUpdate update(now, pvStructurePtr2);
+            while (!queue.pushIfNotFull(update)) {
+                nRejected++;
+                queue.waitForItemPoppedIfFull(1.0);
+            }
+            epicsTimeStamp pushTime;
+            epicsTimeGetCurrent(&pushTime);
+            totalPushTime += epicsTimeDiffInSeconds(&pushTime, &now);
+        }
+        doneEvent.wait();
+        epicsTimeStamp endTime;
+        epicsTimeGetCurrent(&endTime);
+        double runTime = epicsTimeDiffInSeconds(&endTime, &startTime);
+
+        std::cout << std::setw(14) << std::left << label
+            << std::fixed << std::setprecision(0)
+            << " rate: " << std::setw(8) << nReceived/runTime << " updates/s"
+            << std::setprecision(3)
+            << ", push: " << std::setw(7) << totalPushTime/nUpdates*1.0e6 << " us"
+            << ", latency avg: " << std::setw(7) << totalLatency/nReceived*1.0e6 << " us"
+            << ", max: " << std::setw(9) << maxLatency*1.0e6 << " us"
+            << ", full: " << nRejected << std::endl;
+    }
+
+    Q& queue;
+    int nUpdates;
+    int nReceived;
+    double totalLatency;
+    double maxLatency;
+    epicsEvent doneEvent;
+};
+
+int main(int argc, char** argv)
+{
+    int nUpdates = 1000000;
+    double rate = 100000;
+    int queueLength = 1000;
+    if (argc > 1) {
+        nUpdates = atoi(argv[1]);
+    }
+    if (argc > 2) {
+        rate = atof(argv[2]);
+    }
+    if (argc > 3) {
+        queueLength = atoi(argv[3]);
+    }
+    std::cout << "Updates: " << nUpdates << ", target rate: " << rate
+        << " updates/s, queue length: " << queueLength << std::endl;
+
+    SynchronizedQueue<MonitorUpdate> sQueue(queueLength);
+    QueueTest<SynchronizedQueue<MonitorUpdate> > sTest(sQueue, nUpdates);
+    sTest.run("synchronized", rate);
+
+    SpscQueue<MonitorUpdate> spscQueue(queueLength);
+    QueueTest<SpscQueue<MonitorUpdate> > spscTest(spscQueue, nUpdates);
+    spscTest.run("lock-free", rate);
+    return 0;
+}
@@ -54,3 +54,38 @@ class TestChannelGet:
         print('Testing error message is not None: %s' % (self.retrievalError))
         assert(self.retrievalError != None)
 
+
+    #
+    # Get With Cached Operation
+    #
+    def testGet_OperationCache(self):
+        c = TestUtility.getStructChannel()
+        c.resetOperationCacheCounters()
+        i = TestUtility.getRandomInt()
+        pv = c.get('')
+        pv['int'] = i
+        c.put(pv, '')
+        pv2 = c.get('')
+        pv3 = c.get('')
+        counters = c.getOperationCacheCounters()
+        print('Operation cache counters: %s' % (counters))
+        assert(counters['get']['nCacheHits'] >= 1)
+        # Objects returned by cached operations must not share data
+        pv3['int'] = i+1
+        print('Testing equality: %s == %s' % (pv2['int'], i))
+        assert(pv2['int'] == i)
+
+    #
+    # Pipelined Async Get
+    #
+    def testAsyncGet_Pipelined(self):
+        c = TestUtility.getStructChannel()
+        c.setAsyncRequestPipelineDepth(4)
+        assert(c.getAsyncRequestPipelineDepth() == 4)
+        self.completedRequests = []
+        nRequests = 10
+        for i in range(0,nRequests):
+            c.asyncGet(lambda pv, i=i: self.completedRequests.append(i), None, '')
+        time.sleep(1.0)
+        print('Completed requests: %s' % (self.completedRequests))
+        assert(self.completedRequests == list(range(0,nRequests)))
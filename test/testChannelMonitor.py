@@ -0,0 +1,326 @@
+#!/usr/bin/env python
+
+import time
+import pvaccess as pva
+from testUtility import TestUtility
+
+class TestChannelMonitor:
+
+    def monitorCallback(self, pvList):
+        self.batchSizes.append(len(pvList))
+        for pv in pvList:
+            self.receivedValues.append(pv['value'])
+
+    #
+    # Batched Monitor
+    #
+    def testMonitor_Batched(self):
+        s = pva.PvaServer()
+        cName = 'c' + TestUtility.getRandomString(5)
+        s.addRecord(cName, pva.PvInt())
+        c = pva.Channel(cName)
+        c.setMonitorMaxQueueLength(0)
+        self.batchSizes = []
+        self.receivedValues = []
+        batchSize = 10
+        c.monitor(self.monitorCallback, 'field(value)', batchSize=batchSize, maxLatency=0.1)
+        time.sleep(1.0)
+        nUpdates = 100
+        for i in range(1,nUpdates+1):
+            s.update(cName, pva.PvInt(i))
+        time.sleep(1.0)
+        try:
+            c.setMonitorMaxQueueLength(0)
+            assert(False)
+        except pva.InvalidState:
+            pass
+        c.stopMonitor()
+        counters = c.getMonitorCounters()
+        print('Batch sizes: %s' % (self.batchSizes))
+        print('Monitor counters: %s' % (counters))
+        assert(max(self.batchSizes) <= batchSize)
+        assert(counters['nBatches'] == len(self.batchSizes))
+        assert(self.receivedValues[-1] == nUpdates)
+        # Queue required for batching is removed after monitor stops
+        time.sleep(1.0)
+        assert(c.getMonitorMaxQueueLength() == 0)
+        self.receivedValues = []
+        c.monitor(lambda pv: self.receivedValues.append(pv['value']), 'field(value)')
+        time.sleep(1.0)
+        s.update(cName, pva.PvInt(nUpdates+1))
+        time.sleep(1.0)
+        c.stopMonitor()
+        assert(self.receivedValues[-1] == nUpdates+1)
+        assert(c.getMonitorMaxQueueLength() == 0)
+        s.stop()
+
+    #
+    # Lock-Free Monitor Queue
+    #
+    def testMonitor_LockFreeQueue(self):
+        s = pva.PvaServer()
+        cName = 'c' + TestUtility.getRandomString(5)
+        s.addRecord(cName, pva.PvInt())
+        c = pva.Channel(cName)
+        c.setMonitorQueueLockFree(True)
+        c.setMonitorMaxQueueLength(100)
+        assert(c.isMonitorQueueLockFree())
+        self.receivedValues = []
+        c.monitor(lambda pv: self.receivedValues.append(pv['value']), 'field(value)')
+        time.sleep(1.0)
+        nUpdates = 100
+        for i in range(1,nUpdates+1):
+            s.update(cName, pva.PvInt(i))
+        time.sleep(1.0)
+        c.stopMonitor()
+        print('Monitor counters: %s' % (c.getMonitorCounters()))
+        assert(self.receivedValues == sorted(self.receivedValues))
+        assert(self.receivedValues[-1] == nUpdates)
+        s.stop()
+
+    def testMonitor_LockFreePvObjectQueue(self):
+        q = pva.PvObjectQueue(10, True)
+        assert(q.lockFree)
+        for i in range(0,10):
+            q.put(pva.PvInt(i))
+        try:
+            q.put(pva.PvInt(10))
+            assert(False)
+        except pva.QueueFull:
+            pass
+        for i in range(0,10):
+            assert(q.get()['value'] == i)
+        assert(len(q) == 0)
+
+    def testMonitor_SharedMemoryPvObjectQueue(self):
+        name = 'q' + TestUtility.getRandomString(5)
+        q = pva.SharedMemoryPvObjectQueue(name, 10, 1024*1024)
+        assert(q.name == '/' + name)
+        for i in range(0,10):
+            q.put(pva.PvObject({'value' : pva.INT, 'array' : [pva.DOUBLE]}, {'value' : i, 'array' : [i]*100}))
+        try:
+            q.put(pva.PvInt(10))
+            assert(False)
+        except pva.QueueFull:
+            pass
+        # Segment of a live queue cannot be replaced
+        try:
+            pva.SharedMemoryPvObjectQueue(name, 10, 1024*1024)
+            assert(False)
+        except pva.ObjectAlreadyExists:
+            pass
+        # Attached queue shares segment with the owner
+        q2 = pva.SharedMemoryPvObjectQueue(name)
+        assert(len(q2) == 10)
+        for i in range(0,5):
+            pv = q2.get()
+            assert(pv['value'] == i)
+            assert(list(pv['array']) == [i]*100)
+        for i in range(5,10):
+            pv = q2.getView()
+            assert(pv['value'] == i)
+            assert(list(pv['array']) == [i]*100)
+            assert(q.getCounters()['nInUse'] == 1)
+            pv = None
+        assert(q.getCounters()['nInUse'] == 0)
+        assert(len(q) == 0)
+        try:
+            q.get()
+            assert(False)
+        except pva.QueueEmpty:
+            pass
+        counters = q.getCounters()
+        print('Queue counters: %s' % (counters))
+        assert(counters['nReceived'] == 10)
+        assert(counters['nRejected'] == 1)
+
+    #
+    # Monitor Structure Pool
+    #
+    def testMonitor_StructurePool(self):
+        s = pva.PvaServer()
+        cName = 'c' + TestUtility.getRandomString(5)
+        s.addRecord(cName, pva.PvObject({'value' : [pva.DOUBLE]}))
+        c = pva.Channel(cName)
+        c.setMonitorMaxQueueLength(10)
+        self.receivedValues = []
+        c.monitor(lambda pv: self.receivedValues.append(pv['value']), 'field(value)')
+        time.sleep(1.0)
+        nUpdates = 100
+        for i in range(1,nUpdates+1):
+            s.update(cName, pva.PvObject({'value' : [pva.DOUBLE]}, {'value' : [i]*10}))
+            time.sleep(0.001)
+        time.sleep(1.0)
+        c.stopMonitor()
+        counters = c.getMonitorCounters()
+        print('Monitor counters: %s' % (counters))
+        assert(counters['nPoolHits'] > 0)
+        assert(self.receivedValues[-1] == [nUpdates]*10)
+        s.stop()
+
+    # Arrays that share data with pooled structures must stay valid after
+    # monitored objects are released
+    def testMonitor_StructurePoolArrayViews(self):
+        s = pva.PvaServer()
+        cName = 'c' + TestUtility.getRandomString(5)
+        nx = 64
+        ny = 32
+        def createImage(i):
+            nda = pva.NtNdArray()
+            nda['dimension'] = [pva.PvDimension(nx, 0, nx, 1, False), pva.PvDimension(ny, 0, ny, 1, False)]
+            nda['value'] = {'ushortValue' : [i]*(nx*ny)}
+            return nda
+        s.addRecord(cName, createImage(0))
+        c = pva.Channel(cName)
+        c.setMonitorMaxQueueLength(4)
+        images = []
+        c.monitor(lambda pv: images.append(pva.NtNdArray(pv).getImage()), 'field()')
+        time.sleep(1.0)
+        nUpdates = 50
+        for i in range(1,nUpdates+1):
+            s.update(cName, createImage(i))
+            time.sleep(0.005)
+        time.sleep(1.0)
+        c.stopMonitor()
+        print('Monitor counters: %s' % (c.getMonitorCounters()))
+        assert(len(images) > 1)
+        values = [int(image[0][0]) for image in images]
+        for image,value in zip(images,values):
+            assert(image.shape == (ny,nx))
+            assert((image == value).all())
+        assert(values[-1] == nUpdates)
+        s.stop()
+
+    # Pooled structures must not keep image data of released objects
+    def testMonitor_StructurePoolReleasesImages(self):
+        s = pva.PvaServer()
+        cName = 'c' + TestUtility.getRandomString(5)
+        nx = 512
+        ny = 512
+        def createImage(i):
+            nda = pva.NtNdArray()
+            nda['dimension'] = [pva.PvDimension(nx, 0, nx, 1, False), pva.PvDimension(ny, 0, ny, 1, False)]
+            nda['value'] = {'ushortValue' : [i]*(nx*ny)}
+            return nda
+        s.addRecord(cName, createImage(0))
+        c = pva.Channel(cName)
+        c.setMonitorMaxQueueLength(4)
+        values = []
+        c.monitor(lambda pv: values.append(pv['uniqueId']), 'field()')
+        time.sleep(1.0)
+        nUpdates = 20
+        for i in range(1,nUpdates+1):
+            s.update(cName, createImage(i))
+            time.sleep(0.01)
+        time.sleep(1.0)
+        c.stopMonitor()
+        counters = c.getMonitorCounters()
+        print('Monitor counters: %s' % (counters))
+        assert(len(values) > 1)
+        assert(counters['nPooled'] > 0)
+        assert(counters['nPooledArrayBytes'] < nx*ny*2)
+        s.stop()
+
+    #
+    # Per-Subscriber Dispatch
+    #
+    def testMonitor_SubscriberQueues(self):
+        s = pva.PvaServer()
+        cName = 'c' + TestUtility.getRandomString(5)
+        s.addRecord(cName, pva.PvInt())
+        c = pva.Channel(cName)
+        c.setMonitorSubscriberQueueLength(10)
+        assert(c.getMonitorSubscriberQueueLength() == 10)
+        self.fastValues = []
+        self.slowValues = []
+        def slowSubscriber(pv):
+            time.sleep(0.1)
+            self.slowValues.append(pv['value'])
+        c.subscribe('fast', lambda pv: self.fastValues.append(pv['value']))
+        c.subscribe('slow', slowSubscriber)
+        c.startMonitor('field(value)')
+        time.sleep(1.0)
+        nUpdates = 100
+        for i in range(1,nUpdates+1):
+            s.update(cName, pva.PvInt(i))
+            time.sleep(0.001)
+        time.sleep(1.0)
+        c.stopMonitor()
+        counters = c.getMonitorCounters()
+        print('Monitor counters: %s' % (counters))
+        subscriberCounters = counters['subscriberCounters']
+        assert(self.fastValues[-1] == nUpdates)
+        assert(subscriberCounters['fast']['nDropped'] == 0)
+        assert(subscriberCounters['slow']['nDropped'] > 0)
+        assert(subscriberCounters['slow']['maxQueued'] <= 10)
+        # Queued updates must not be overwritten by later monitor events
+        assert(self.fastValues == sorted(set(self.fastValues)))
+        assert(self.slowValues == sorted(set(self.slowValues)))
+        s.stop()
+
+    #
+    # Shared Monitor Dispatcher
+    #
+    def testMonitor_SharedDispatch(self):
+        s = pva.PvaServer()
+        nChannels = 10
+        cNames = ['c' + TestUtility.getRandomString(5) for i in range(0,nChannels)]
+        channels = []
+        self.receivedValueMap = {}
+        for cName in cNames:
+            s.addRecord(cName, pva.PvInt())
+            c = pva.Channel(cName)
+            c.setMonitorSharedDispatch(True)
+            assert(c.isMonitorSharedDispatch())
+            self.receivedValueMap[cName] = []
+            c.monitor(lambda pv, cName=cName: self.receivedValueMap[cName].append(pv['value']), 'field(value)')
+            channels.append(c)
+        time.sleep(1.0)
+        nUpdates = 10
+        for i in range(1,nUpdates+1):
+            for cName in cNames:
+                s.update(cName, pva.PvInt(i))
+        time.sleep(1.0)
+        stats = pva.MonitorDispatcher().getStats()
+        print('Dispatcher stats: %s' % (stats))
+        for c in channels:
+            c.stopMonitor()
+        assert(stats['nWorkers'] > 0)
+        for cName in cNames:
+            assert(cName in stats['channels'])
+            receivedValues = self.receivedValueMap[cName]
+            assert(receivedValues == sorted(receivedValues))
+            assert(receivedValues[-1] == nUpdates)
+        s.stop()
+
+    #
+    # Monitor Latency Histograms
+    #
+    def testMonitor_LatencyHistograms(self):
+        s = pva.PvaServer()
+        cName = 'c' + TestUtility.getRandomString(5)
+        s.addRecord(cName, pva.PvInt())
+        c = pva.Channel(cName)
+        c.setMonitorMaxQueueLength(10)
+        c.setMonitorTimingEnabled(True)
+        assert(c.isMonitorTimingEnabled())
+        self.receivedValues = []
+        c.monitor(lambda pv: self.receivedValues.append(pv['value']), 'field(value)')
+        time.sleep(1.0)
+        nUpdates = 100
+        for i in range(1,nUpdates+1):
+            s.update(cName, pva.PvInt(i))
+            time.sleep(0.001)
+        time.sleep(1.0)
+        c.stopMonitor()
+        histograms = c.getMonitorLatencyHistograms()
+        print('Latency histograms: %s' % (histograms))
+        for key in ['eventToPush', 'queueWait', 'gilWait', 'callback']:
+            h = histograms[key]
+            assert(h['count'] > 0)
+            assert(h['min'] <= h['p50'] <= h['p90'] <= h['p99'] <= h['max'])
+            assert(sum(h['buckets'].values()) == h['count'])
+        assert(histograms['callback']['count'] == len(self.receivedValues))
+        c.resetMonitorCounters()
+        assert(c.getMonitorLatencyHistograms()['callback']['count'] == 0)
+        s.stop()
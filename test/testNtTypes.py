@@ -14,8 +14,24 @@ from pvaccess import PvCodec
 from pvaccess import PvInt
 from pvaccess import INT
 from pvaccess import UBYTE
+from pvaccess import USHORT
+from pvaccess import InvalidState
 from testUtility import TestUtility
 
+# Reference codecs are optional
+try:
+    import lz4.block
+except ImportError:
+    pass
+try:
+    import blosc
+except ImportError:
+    pass
+try:
+    import bitshuffle
+except ImportError:
+    pass
+
 
 class TestNtTypes:
 
@@ -79,6 +95,107 @@ class TestNtTypes:
         print('After pickling, comparing image arrays {} to {}'.format(value2, value))
         assert(np.array_equiv(value, value2))
 
+    def test_NtNdArrayImage(self):
+        print()
+        nx = 4
+        ny = 3
+        nz = 3
+        nda = NtNdArray()
+        nda['dimension'] = [PvDimension(nx, 0, nx, 1, False), PvDimension(ny, 0, ny, 1, False)]
+        nda['attribute'] = [NtAttribute('ColorMode', PvInt(0))]
+        value = np.arange(nx*ny, dtype=np.uint16)
+        nda['value'] = {'ushortValue' : value}
+        image = nda.getImage()
+        print('Mono image: {}'.format(image))
+        assert(image.shape == (ny,nx))
+        assert(np.array_equal(image, np.reshape(value, (ny,nx))))
+
+        # RGB3: [NX, NY, 3]
+        nda['dimension'] = [PvDimension(nx, 0, nx, 1, False), PvDimension(ny, 0, ny, 1, False), PvDimension(nz, 0, nz, 1, False)]
+        nda['attribute'] = [NtAttribute('ColorMode', PvInt(4))]
+        value = np.arange(nx*ny*nz, dtype=np.uint16)
+        nda['value'] = {'ushortValue' : value}
+        image = nda.getImage()
+        expectedImage = np.swapaxes(np.swapaxes(np.reshape(value, (nz,ny,nx)), 0, 2), 0, 1)
+        print('RGB3 image: {}'.format(image))
+        assert(image.shape == (ny,nx,nz))
+        assert(np.array_equal(image, expectedImage))
+
+        # LZ4 block with a single match
+        nda = NtNdArray()
+        nda['dimension'] = [PvDimension(4, 0, 4, 1, False), PvDimension(4, 0, 4, 1, False)]
+        nda['codec'] = PvCodec('lz4', PvInt(int(UBYTE)))
+        nda['uncompressedSize'] = 16
+        nda['value'] = {'ubyteValue' : np.array([0x1A,7,1,0,0x10,7], dtype=np.uint8)}
+        image = nda.getImage()
+        print('Decompressed image: {}'.format(image))
+        assert(image.shape == (4,4))
+        assert(np.array_equal(image, np.full((4,4), 7, dtype=np.uint8)))
+
+    def test_NtNdArrayCompression(self):
+        print()
+        nx = 512
+        ny = 256
+        value = np.random.poisson(100, size=nx*ny).astype(np.uint16)
+        for codecName in PvCodec.getNativeCodecNames():
+            for nThreads in [1, 4]:
+                nda = NtNdArray()
+                nda['dimension'] = [PvDimension(nx, 0, nx, 1, False), PvDimension(ny, 0, ny, 1, False)]
+                nda['attribute'] = [NtAttribute('ColorMode', PvInt(0))]
+                nda['value'] = {'ushortValue' : value}
+                nda.compress(codecName, 5, nThreads)
+                compressedSize = nda['compressedSize']
+                print('Codec {}, threads {}: compressed {} bytes to {} bytes'.format(codecName, nThreads, nda['uncompressedSize'], compressedSize))
+                assert(nda['codec.name'] == codecName)
+                assert(nda['codec.parameters'][0]['value'] == int(USHORT))
+                assert(nda['uncompressedSize'] == value.nbytes)
+                assert(compressedSize < value.nbytes)
+                assert(len(nda['value'][0]['ubyteValue']) == compressedSize)
+                try:
+                    nda.compress(codecName)
+                    assert(False)
+                except InvalidState:
+                    pass
+                assert(np.array_equal(nda.getImage(), np.reshape(value, (ny,nx))))
+                nda.decompress()
+                assert(nda['codec.name'] == '')
+                assert(nda['compressedSize'] == value.nbytes)
+                assert(np.array_equal(nda['value'][0]['ushortValue'], value))
+
+    # Image must be large enough for lz4 compression to be split into
+    # chunks that are compressed by different threads
+    def test_NtNdArrayLargeImageCompression(self):
+        print()
+        nx = 1024
+        ny = 1024
+        value = np.random.poisson(100, size=nx*ny).astype(np.uint16)
+        assert(value.nbytes >= 1024*1024)
+        for codecName in PvCodec.getNativeCodecNames():
+            for nThreads in [1, 8]:
+                nda = NtNdArray()
+                nda['dimension'] = [PvDimension(nx, 0, nx, 1, False), PvDimension(ny, 0, ny, 1, False)]
+                nda['attribute'] = [NtAttribute('ColorMode', PvInt(0))]
+                nda['value'] = {'ushortValue' : value}
+                nda.compress(codecName, 5, nThreads)
+                compressed = np.array(nda['value'][0]['ubyteValue'], dtype=np.uint8)
+                print('Codec {}, threads {}: compressed {} bytes to {} bytes'.format(codecName, nThreads, value.nbytes, len(compressed)))
+                assert(len(compressed) == nda['compressedSize'])
+                assert(np.array_equal(nda.getImage(), np.reshape(value, (ny,nx))))
+                assert(np.array_equal(NtNdArray.decompressArray(codecName, compressed, USHORT, value.nbytes), value))
+                try:
+                    if codecName == 'lz4':
+                        decoded = np.frombuffer(lz4.block.decompress(compressed.tobytes(), uncompressed_size=value.nbytes), dtype=np.uint16)
+                    elif codecName == 'blosc':
+                        decoded = np.frombuffer(blosc.decompress(compressed.tobytes()), dtype=np.uint16)
+                    elif codecName == 'bslz4':
+                        decoded = bitshuffle.decompress_lz4(compressed, value.shape, value.dtype, 0)
+                    else:
+                        continue
+                except NameError:
+                    print('Reference decompressor for codec {} is not available'.format(codecName))
+                    continue
+                assert(np.array_equal(decoded, value))
+
     #
     # NtScalar
     #
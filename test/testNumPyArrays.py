@@ -143,3 +143,25 @@ class TestNumPyArrays:
      
        
 
+
+    #
+    # Zero-copy
+    #
+
+    def test_DoubleNoCopy(self):
+        a = np.random.uniform(-1000,1000, size=100)
+        pv = PvObject({'a' : [DOUBLE]})
+        pv.setScalarArray('a', a, copy=False)
+        a2 = pv['a']
+        assert(a2.ctypes.data == a.ctypes.data)
+        c = a == a2
+        assert(c.all())
+
+    def test_DoubleNoCopyNonContiguous(self):
+        a = np.random.uniform(-1000,1000, size=200)[::2]
+        pv = PvObject({'a' : [DOUBLE]})
+        pv.setScalarArray('a', a, copy=False)
+        a2 = pv['a']
+        assert(a2.ctypes.data != a.ctypes.data)
+        c = a == a2
+        assert(c.all())
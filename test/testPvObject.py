@@ -1,5 +1,7 @@
 #!/usr/bin/env python
 
+import pickle
+import struct
 from pvaccess import PvObject
 from pvaccess import PvInt
 from pvaccess import PvString
@@ -17,6 +19,11 @@ from pvaccess import ULONG
 from pvaccess import FLOAT
 from pvaccess import DOUBLE
 from pvaccess import STRING
+from pvaccess import FieldAccessor
+from pvaccess import FieldNotFound
+from pvaccess import InvalidArgument
+from pvaccess import IntrospectionRegistry
+from pvaccess import SerializationContext
 from testUtility import TestUtility
 
 class TestPvObject:
@@ -524,5 +531,126 @@ class TestPvObject:
             assert(pv2['st']['i'] == structureList[i]['st.i'])
             assert(pv2['st']['s'] == structureList[i]['st.s'])
             assert(pv2['st']['d'] == structureList[i]['st.d'])
-       
 
+    #
+    # Field Accessor
+    #
+    def test_FieldAccessor(self):
+        a = FieldAccessor('st.d')
+        assert(a.fieldPath == 'st.d')
+        for i in range(0,10):
+            value = TestUtility.getRandomDouble()
+            pv = PvObject({'i' : INT, 'st' : {'i' : INT, 'd' : DOUBLE}}, {'st' : {'d' : value}})
+            assert(a.get(pv) == value)
+            assert(pv['st.d'] == value)
+            a.set(pv, value+1)
+            assert(pv['st.d'] == value+1)
+        pv = PvObject({'st' : {'s' : STRING, 'd' : FLOAT}})
+        a.set(pv, 1.5)
+        assert(a.get(pv) == 1.5)
+        try:
+            a.get(PvObject({'st' : {'i' : INT}}))
+            assert(False)
+        except FieldNotFound:
+            pass
+
+    #
+    # Binary Serialization
+    #
+    def test_Serialization(self):
+        value = TestUtility.getRandomInt()
+        pv = PvObject({'i' : INT, 's' : STRING, 'da' : [DOUBLE], 'st' : {'i' : INT, 'sa' : [STRING]}, 'vu' : ()},
+            {'i' : value, 's' : 'abc', 'da' : [1.1, 2.2, 3.3], 'st' : {'i' : value+1, 'sa' : ['a', 'b']}, 'vu' : PvInt(value)},
+            'test:Structure:1.0')
+        buffer = pv.serialize()
+        pv2 = PvObject.deserialize(buffer)
+        print('Deserialized object: %s' % pv2)
+        assert(pv2.getStructureDict() == pv.getStructureDict())
+        assert(str(pv2) == str(pv))
+        pv3 = PvObject.deserialize(memoryview(bytearray(buffer)))
+        assert(pv3['st.i'] == value+1)
+        assert(pv3['vu'][0]['value'] == value)
+        pv4 = pickle.loads(pickle.dumps(pv))
+        assert(str(pv4) == str(pv))
+        try:
+            PvObject.deserialize(b'invalid')
+            assert(False)
+        except InvalidArgument:
+            pass
+
+    def test_SerializationContext(self):
+        structureDict = {'i' : INT, 'da' : [DOUBLE], 'st' : {'s' : STRING, 'sa' : [STRING]}}
+        pv = PvObject(structureDict, {'i' : 1, 'da' : [1.1], 'st' : {'s' : 'a'}}, 'test:Stream:1.0')
+        pv2 = PvObject(structureDict, {'i' : 2, 'da' : [2.2], 'st' : {'s' : 'b'}}, 'test:Stream:1.0')
+        senderContext = SerializationContext()
+        buffer = pv.serialize(senderContext)
+        buffer2 = pv2.serialize(senderContext)
+        print('Stream buffer sizes: %s, %s' % (len(buffer), len(buffer2)))
+        assert(len(buffer2) < len(buffer))
+        assert(len(buffer) == len(pv.serialize()))
+        receiverContext = SerializationContext()
+        pv3 = PvObject.deserialize(buffer, receiverContext)
+        pv4 = PvObject.deserialize(buffer2, receiverContext)
+        assert(str(pv3) == str(pv))
+        assert(str(pv4) == str(pv2))
+        assert(pv4.getStructureDict() == pv2.getStructureDict())
+        # Structure reference cannot be resolved without context
+        try:
+            PvObject.deserialize(buffer2, SerializationContext())
+            assert(False)
+        except InvalidArgument:
+            pass
+        senderContext.reset()
+        assert(len(pv2.serialize(senderContext)) == len(buffer))
+
+    def test_SerializationByteOrder(self):
+        # Field name longer than 253 characters has byte order dependent
+        # introspection data
+        fieldName = 'f' + 'x'*300
+        pv = PvObject({fieldName : INT}, {fieldName : 7})
+        buffer = pv.serialize()
+        nativeOrder = (buffer[3] & 0x01) and '>' or '<'
+        foreignOrder = (nativeOrder == '<') and '>' or '<'
+        def swap(data, fmt):
+            return struct.pack(foreignOrder+fmt, struct.unpack(nativeOrder+fmt, data)[0])
+        introspectionSize = struct.unpack(nativeOrder+'I', buffer[8:12])[0]
+        introspectionData = buffer[12:12+introspectionSize]
+        nameSize = b'\xfe' + struct.pack(nativeOrder+'i', len(fieldName))
+        assert(nameSize in introspectionData)
+        foreignBuffer = buffer[0:3] + bytes([buffer[3] ^ 0x01]) + swap(buffer[4:8], 'I') + swap(buffer[8:12], 'I') \
+            + introspectionData.replace(nameSize, b'\xfe' + swap(nameSize[1:], 'i')) \
+            + swap(buffer[12+introspectionSize:], 'i')
+        IntrospectionRegistry().clear()
+        pv2 = PvObject.deserialize(foreignBuffer)
+        assert(pv2[fieldName] == 7)
+        # Objects decoded from foreign byte order serialize natively
+        buffer2 = pv2.serialize()
+        assert(buffer2[3] == buffer[3])
+        assert(buffer2[8:] == buffer[8:])
+        assert(PvObject.deserialize(buffer2)[fieldName] == 7)
+        pv3 = PvObject({fieldName : INT}, {fieldName : 8})
+        assert(PvObject.deserialize(pv3.serialize())[fieldName] == 8)
+
+    def test_IntrospectionRegistry(self):
+        registry = IntrospectionRegistry()
+        registry.resetCounters()
+        structureDict = {'i' : INT, 'da' : [DOUBLE], 'st' : {'s' : STRING}, 'vu' : ()}
+        pv = PvObject(structureDict, {'i' : 1}, 'test:Registry:1.0')
+        pv2 = PvObject(structureDict, {'i' : 2}, 'test:Registry:1.0')
+        pv3 = PvObject(structureDict, {'i' : 3}, 'test:Registry:2.0')
+        counters = registry.getCounters()
+        print('Registry counters: %s' % counters)
+        assert(counters['structureDict']['nCacheHits'] >= 1)
+        assert(counters['structureDict']['nCacheMisses'] >= 2)
+        assert(pv2['i'] == 2 and pv3.getStructureDict() == pv.getStructureDict())
+        for i in range(0,10):
+            pv4 = PvObject.deserialize(pv.serialize())
+            assert(pv4['i'] == 1)
+        counters = registry.getCounters()
+        print('Registry counters: %s' % counters)
+        assert(counters['serialization']['nCacheHits'] >= 9)
+        assert(counters['deserialization']['nCacheHits'] >= 10)
+        assert(0 < counters['serialization']['hitRate'] <= 1)
+        assert(counters['nStructureIds'] > 0)
+        registry.resetCounters()
+        assert(registry.getCounters()['structureDict']['nCacheHits'] == 0)
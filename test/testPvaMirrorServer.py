@@ -30,3 +30,73 @@ class TestPvaMirrorServer:
         assert(len(s.getMirrorRecordNames()) == 0)
         assert(len(s.getRecordNames()) == 0)
         s.stop()
+
+    def testSharedSourceMirrorRecords(self):
+        srcServer = pva.PvaServer()
+        srcChannelName = 'src_' + TestUtility.getRandomString(5)
+        srcServer.addRecord(srcChannelName, pva.PvObject({'x' : pva.INT, 'y' : [pva.DOUBLE]}, {'x' : 1, 'y' : [1.0, 2.0]}))
+        s = pva.PvaMirrorServer()
+        mirrorChannelName = 'mirror_' + TestUtility.getRandomString(5)
+        mirrorChannelName2 = 'mirror2_' + TestUtility.getRandomString(5)
+        s.addMirrorRecord(mirrorChannelName, srcChannelName, pva.PVA)
+        time.sleep(1.0)
+        s.addMirrorRecord(mirrorChannelName2, srcChannelName, pva.PVA, 0, 1, '', 'x')
+        srcServer.update(srcChannelName, pva.PvObject({'x' : pva.INT, 'y' : [pva.DOUBLE]}, {'x' : 2, 'y' : [3.0]}))
+        time.sleep(1.0)
+        pv = pva.Channel(mirrorChannelName).get('field()')
+        pv2 = pva.Channel(mirrorChannelName2).get('field()')
+        print('Retrieved value from mirror channels: %s, %s' % (pv, pv2))
+        assert(pv['x'] == 2 and pv['y'] == [3.0])
+        assert(pv2['x'] == 2 and not pv2.hasField('y'))
+        counters = s.getMirrorRecordCounters(mirrorChannelName2)
+        print('Mirror record counters: %s' % (counters))
+        assert(counters['nMirrorRecords'] == 2)
+        s.removeMirrorRecord(mirrorChannelName)
+        assert(s.getMirrorRecordCounters(mirrorChannelName2)['nMirrorRecords'] == 1)
+        s.removeAllMirrorRecords()
+        assert(len(s.getRecordNames()) == 0)
+        s.stop()
+        srcServer.stop()
+
+    def testMirrorRecordPolicies(self):
+        srcServer = pva.PvaServer()
+        srcChannelName = 'src_' + TestUtility.getRandomString(5)
+        srcServer.addRecord(srcChannelName, pva.PvObject({'x' : pva.INT}, {'x' : 0}))
+        s = pva.PvaMirrorServer()
+        decimatedChannelName = 'decimated_' + TestUtility.getRandomString(5)
+        deadbandChannelName = 'deadband_' + TestUtility.getRandomString(5)
+        rateChannelName = 'rate_' + TestUtility.getRandomString(5)
+        for cName in [decimatedChannelName, deadbandChannelName, rateChannelName]:
+            s.addMirrorRecord(cName, srcChannelName, pva.PVA)
+        time.sleep(1.0)
+        s.setMirrorRecordDecimation(decimatedChannelName, 10)
+        s.setMirrorRecordDeadband(deadbandChannelName, 'x', 5)
+        s.setMirrorRecordMaxUpdateRate(rateChannelName, 1)
+        for cName in [decimatedChannelName, deadbandChannelName, rateChannelName]:
+            s.resetMirrorRecordCounters(cName)
+        nUpdates = 100
+        for i in range(1,nUpdates+1):
+            srcServer.update(srcChannelName, pva.PvObject({'x' : pva.INT}, {'x' : i}))
+            time.sleep(0.001)
+        # Wait for trailing rate limited update
+        time.sleep(1.5)
+
+        # Source monitor may squash updates, so only bounds are checked
+        counters = s.getMirrorRecordCounters(decimatedChannelName)
+        print('Decimated mirror record counters: %s' % (counters))
+        assert(counters['nDelivered'] >= 1 and counters['nDelivered'] <= nUpdates/10+1)
+        assert(counters['nDelivered'] + counters['nDecimated'] <= nUpdates)
+        assert(pva.Channel(decimatedChannelName).get('field()')['x'] <= nUpdates)
+        counters = s.getMirrorRecordCounters(deadbandChannelName)
+        print('Deadband mirror record counters: %s' % (counters))
+        assert(counters['nDelivered'] >= 1 and counters['nDelivered'] <= nUpdates/5+1)
+        assert(counters['nDelivered'] + counters['nDeadbandSuppressed'] <= nUpdates)
+        assert(nUpdates - pva.Channel(deadbandChannelName).get('field()')['x'] < 5)
+        counters = s.getMirrorRecordCounters(rateChannelName)
+        print('Rate limited mirror record counters: %s' % (counters))
+        assert(counters['nRateLimited'] > 0)
+        assert(counters['nDelivered'] + counters['nRateLimited'] <= nUpdates)
+        # Latest suppressed update is published when update period expires
+        assert(pva.Channel(rateChannelName).get('field()')['x'] == nUpdates)
+        s.stop()
+        srcServer.stop()
@@ -1,4 +1,5 @@
 #!/usr/bin/env python
+import time
 import pvaccess as pva
 from testUtility import TestUtility
 
@@ -21,3 +22,99 @@ class TestPvaServer:
         s.removeRecord(cName)
         assert(len(s.getRecordNames()) == 0)
         s.stop()
+
+    def testUpdateChanged(self):
+        s = pva.PvaServer()
+        cName = 'c' + TestUtility.getRandomString(5)
+        s.addRecord(cName, pva.PvObject({'x' : pva.INT, 'y' : pva.INT, 'z' : [pva.DOUBLE]}, {'x' : 1, 'y' : 2, 'z' : [1.0, 2.0]}))
+        assert(s.updateChanged(cName, pva.PvObject({'x' : pva.INT, 'y' : pva.INT, 'z' : [pva.DOUBLE]}, {'x' : 1, 'y' : 5, 'z' : [1.0, 2.0]})) == 1)
+        assert(s.updateChanged(cName, pva.PvObject({'x' : pva.INT, 'y' : pva.INT, 'z' : [pva.DOUBLE]}, {'x' : 3, 'y' : 5, 'z' : [3.0]})) == 2)
+        assert(s.updateChanged(cName, pva.PvObject({'x' : pva.INT, 'y' : pva.INT, 'z' : [pva.DOUBLE]}, {'x' : 3, 'y' : 5, 'z' : [3.0]})) == 0)
+        c = pva.Channel(cName)
+        pv = c.get('field()')
+        print('Retrieved value from channel %s: %s' % (cName, pv))
+        assert(pv['x'] == 3 and pv['y'] == 5 and pv['z'] == [3.0])
+        s.stop()
+
+    def testUpdateMany(self):
+        s = pva.PvaServer()
+        nRecords = 200
+        cNames = ['c%s%d' % (TestUtility.getRandomString(5), i) for i in range(0,nRecords)]
+        for cName in cNames:
+            s.addRecord(cName, pva.PvInt())
+        dName = 'd' + TestUtility.getRandomString(5)
+        s.addRecord(dName, pva.PvObject({'x' : pva.INT, 'y' : pva.INT}))
+        updateDict = dict([(cNames[i], pva.PvInt(i)) for i in range(0,nRecords)])
+        updateDict[dName] = {'y' : 5}
+        s.updateMany(updateDict)
+        for i in range(0,nRecords,20):
+            assert(pva.Channel(cNames[i]).get().getPyObject() == i)
+        assert(pva.Channel(dName).get('field()')['y'] == 5)
+        try:
+            s.updateMany({cNames[0] : pva.PvInt(1), 'invalid' + dName : pva.PvInt(1)})
+            assert(False)
+        except pva.ObjectNotFound:
+            pass
+        assert(pva.Channel(cNames[0]).get().getPyObject() == 0)
+        # Invalid values are rejected before any record is updated
+        for invalidValue in [pva.PvFloat(1.0), {'z' : 1}]:
+            try:
+                s.updateMany({dName : {'y' : 7}, cNames[0] : pva.PvInt(1), cNames[1] : invalidValue})
+                assert(False)
+            except pva.InvalidArgument:
+                pass
+            assert(pva.Channel(dName).get('field()')['y'] == 5)
+            assert(pva.Channel(cNames[0]).get().getPyObject() == 0)
+        s.stop()
+
+    def testRecordHandle(self):
+        s = pva.PvaServer()
+        cName = 'c' + TestUtility.getRandomString(5)
+        s.addRecord(cName, pva.PvInt())
+        h = s.getRecordHandle(cName)
+        assert(h.channelName == cName)
+        assert(h.isValid())
+        value = TestUtility.getRandomInt()
+        h.update(pva.PvInt(value))
+        assert(pva.Channel(cName).get().getPyObject() == value)
+        s.removeRecord(cName)
+        assert(not h.isValid())
+        try:
+            h.update(pva.PvInt(value))
+            assert(False)
+        except pva.ObjectNotFound:
+            pass
+        s.stop()
+
+    def testParallelCallbacks(self):
+        s = pva.PvaServer()
+        s.setNumCallbackThreads(4)
+        assert(s.getNumCallbackThreads() == 4)
+        nRecords = 4
+        cNames = ['c%s%d' % (TestUtility.getRandomString(5), i) for i in range(0,nRecords)]
+        self.writtenValueMap = {}
+        for cName in cNames:
+            self.writtenValueMap[cName] = []
+            s.addRecord(cName, pva.PvInt(), lambda pv, cName=cName: self.writtenValueMap[cName].append(pv['value']))
+        nPuts = 10
+        for i in range(1,nPuts+1):
+            for cName in cNames:
+                pva.Channel(cName).put(pva.PvInt(i))
+        time.sleep(1.0)
+        counters = s.getCallbackCounters()
+        histograms = s.getCallbackLatencyHistograms()
+        print('Callback counters: %s' % (counters))
+        print('Callback latency histograms: %s' % (histograms))
+        assert(counters['nReceived'] == nRecords*nPuts)
+        assert(counters['nDelivered'] + counters['nCoalesced'] == counters['nReceived'])
+        assert(histograms['callback']['count'] == counters['nDelivered'])
+        for cName in cNames:
+            writtenValues = self.writtenValueMap[cName]
+            assert(writtenValues == sorted(writtenValues))
+            assert(writtenValues[-1] == nPuts)
+        try:
+            s.setNumCallbackThreads(2)
+            assert(False)
+        except pva.InvalidState:
+            pass
+        s.stop()
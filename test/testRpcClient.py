@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+import time
+import threading
+import pvaccess as pva
+from testUtility import TestUtility
+
+class TestRpcClient:
+
+    @classmethod
+    def setup_class(cls):
+        cls.serviceName = 'rpc' + TestUtility.getRandomString(5)
+        cls.server = pva.RpcServer()
+        cls.server.setNumWorkers(4)
+        cls.server.registerService(cls.serviceName, lambda pv: pva.PvInt(pv['value']))
+        cls.slowServiceName = 'rpc' + TestUtility.getRandomString(5)
+        def slowService(pv):
+            time.sleep(0.5)
+            return pva.PvInt(pv['value'])
+        cls.server.registerService(cls.slowServiceName, slowService)
+        cls.server.startListener()
+        time.sleep(1)
+
+    @classmethod
+    def teardown_class(cls):
+        cls.server.stopListener()
+
+    def getArgument(self, value):
+        return pva.PvObject({'value' : pva.INT}, {'value' : value})
+
+    def testInvokeAsync(self):
+        nRequests = 100
+        responses = []
+        event = threading.Event()
+        def callback(pv):
+            responses.append(pv['value'])
+            if len(responses) == nRequests:
+                event.set()
+        def errorCallback(msg):
+            print('Error: %s' % msg)
+            event.set()
+        c = pva.RpcClient(self.serviceName)
+        c.setMaxOutstandingRequests(8)
+        for i in range(0,nRequests):
+            c.invokeAsync(self.getArgument(i), callback, errorCallback)
+        assert(event.wait(10))
+        assert(responses == list(range(0,nRequests)))
+
+    def testInvokeFuture(self):
+        c = pva.RpcClient(self.serviceName)
+        futures = [c.invokeFuture(self.getArgument(i)) for i in range(0,50)]
+        assert([f.result(10)['value'] for f in futures] == list(range(0,50)))
+
+    def testInvokeBatch(self):
+        c = pva.RpcClient(self.serviceName)
+        for maxOutstandingRequests in [1,16]:
+            c.setMaxOutstandingRequests(maxOutstandingRequests)
+            responses = c.invokeBatch([self.getArgument(i) for i in range(0,50)])
+            assert([r['value'] for r in responses] == list(range(0,50)))
+
+    def testReleaseClientFromCallback(self):
+        # Last client reference is dropped on the client async thread
+        clients = {'c' : pva.RpcClient(self.serviceName)}
+        event = threading.Event()
+        def callback(pv):
+            clients.clear()
+            event.set()
+        clients['c'].invokeAsync(self.getArgument(1), callback)
+        assert(event.wait(10))
+        time.sleep(1)
+        c = pva.RpcClient(self.serviceName)
+        assert(c.invokeFuture(self.getArgument(2)).result(10)['value'] == 2)
+
+    def testReleaseClientWithPendingRequests(self):
+        # Pending futures must fail when client is destroyed
+        c = pva.RpcClient(self.slowServiceName)
+        c.setMaxOutstandingRequests(1)
+        futures = [c.invokeFuture(self.getArgument(i)) for i in range(0,5)]
+        time.sleep(0.1)
+        c = None
+        nFailed = 0
+        for f in futures:
+            try:
+                f.result(10)
+            except pva.PvaException:
+                nFailed += 1
+        assert(nFailed > 0)
+
+    def testRegisterServiceLimitWithoutWorkers(self):
+        # Request limit is not supported without worker threads
+        server = pva.RpcServer()
+        try:
+            server.registerService(self.serviceName + 'x', lambda pv: pv, 2)
+            assert(False)
+        except pva.InvalidArgument:
+            pass